@@ -0,0 +1,128 @@
+#include <string.h>
+#include <immintrin.h>
+#include "monitor.h"
+
+// Alertas de muchas zonas a la vez, sobre los niveles en columnas (un
+// arreglo por contaminante) y con un byte por zona de salida. Las reglas son
+// las de nivel_alerta, reducidas a dos máscaras por zona:
+//   - emergencia: algún contaminante pasa el 100% de su límite;
+//   - preventiva: alguno pasa el 75%, o PM2.5 pasa el 80%.
+// La escalada por dos o más elevados no agrega nada: un contaminante entre
+// 75% y 100% solo cuenta si ninguno anterior estaba elevado, así que con
+// dos elevados al menos uno pasa el 100% y la alerta ya es de emergencia.
+// El nivel es preventiva + emergencia (pasar el 100% implica pasar el 75%).
+// Las cuentas son las mismas (división y después por 100, en float) y las
+// comparaciones son ordenadas, así que un NaN no alerta, igual que en la
+// regla escalar. PM2.5 se compara en double con 0.8; r > 0.8 en double es lo
+// mismo que r >= 0.8f en float, porque 0.8f es el float más chico que
+// supera a 0.8.
+
+static int simd_alertas = -1;       // -1 = según la CPU
+
+void configurar_alertas(int simd) {
+    simd_alertas = simd;
+}
+
+static int modo_alertas(void) {
+    int avx2 = __builtin_cpu_supports("avx2");
+    if(simd_alertas < 0) return avx2 ? ALERTAS_AVX2 : ALERTAS_SSE;
+    if(simd_alertas == ALERTAS_AVX2 && !avx2) return ALERTAS_SSE;
+    return simd_alertas;
+}
+
+// Función para evaluar el nivel de alerta de una zona (0=normal,
+// 1=preventiva, 2=emergencia)
+int nivel_alerta(const float *contaminantes) {
+    int alerta = 0; // Por defecto sin alerta
+    int contaminantes_elevados = 0;
+
+    for(int i = 0; i < NUM_CONTAMINANTES; i++) {
+        float porcentaje = (contaminantes[i] / limites_ecuador[i]) * 100;
+
+        if(porcentaje > 100) {
+            alerta = 2; // Emergencia
+            contaminantes_elevados++;
+        } else if(porcentaje > 75 && alerta < 1) {
+            alerta = 1; // Alerta preventiva
+            contaminantes_elevados++;
+        }
+    }
+
+    // Ajuste especial para PM2.5 (más peligroso)
+    if((contaminantes[PM2_5] / limites_ecuador[PM2_5]) > 0.8 && alerta < 1) {
+        alerta = 1;
+    }
+
+    // Si múltiples contaminantes están elevados, aumentar alerta
+    if(contaminantes_elevados >= 2 && alerta < 2) {
+        alerta = 2;
+    }
+    return alerta;
+}
+
+static void alertas_escalar(const float *const niveles[NUM_CONTAMINANTES], int desde, int hasta, uint8_t *alertas) {
+    for(int z = desde; z < hasta; z++) {
+        float valores[NUM_CONTAMINANTES];
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) valores[c] = niveles[c][z];
+        alertas[z] = (uint8_t)nivel_alerta(valores);
+    }
+}
+
+static int alertas_sse(const float *const niveles[NUM_CONTAMINANTES], int n, uint8_t *alertas) {
+    const __m128 cien = _mm_set1_ps(100), setenta_cinco = _mm_set1_ps(75), pm25 = _mm_set1_ps(0.8f);
+    int z = 0;
+    for(; z + 4 <= n; z += 4) {
+        __m128 emergencia = _mm_setzero_ps(), preventiva = _mm_setzero_ps();
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            __m128 razon = _mm_div_ps(_mm_loadu_ps(&niveles[c][z]), _mm_set1_ps(limites_ecuador[c]));
+            __m128 porcentaje = _mm_mul_ps(razon, cien);
+            emergencia = _mm_or_ps(emergencia, _mm_cmpgt_ps(porcentaje, cien));
+            preventiva = _mm_or_ps(preventiva, _mm_cmpgt_ps(porcentaje, setenta_cinco));
+            if(c == PM2_5) preventiva = _mm_or_ps(preventiva, _mm_cmpge_ps(razon, pm25));
+        }
+        // Las máscaras valen -1: el nivel es -(preventiva + emergencia),
+        // que se empaqueta de 32 a 8 bits
+        __m128i nivel = _mm_sub_epi32(_mm_setzero_si128(),
+                                      _mm_add_epi32(_mm_castps_si128(preventiva), _mm_castps_si128(emergencia)));
+        nivel = _mm_packs_epi32(nivel, nivel);
+        int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(nivel, nivel));
+        memcpy(&alertas[z], &bytes, 4);
+    }
+    return z;
+}
+
+static int alertas_avx2(const float *const niveles[NUM_CONTAMINANTES], int n, uint8_t *alertas) __attribute__((target("avx2")));
+static int alertas_avx2(const float *const niveles[NUM_CONTAMINANTES], int n, uint8_t *alertas) {
+    const __m256 cien = _mm256_set1_ps(100), setenta_cinco = _mm256_set1_ps(75), pm25 = _mm256_set1_ps(0.8f);
+    int z = 0;
+    for(; z + 8 <= n; z += 8) {
+        __m256 emergencia = _mm256_setzero_ps(), preventiva = _mm256_setzero_ps();
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            __m256 razon = _mm256_div_ps(_mm256_loadu_ps(&niveles[c][z]), _mm256_set1_ps(limites_ecuador[c]));
+            __m256 porcentaje = _mm256_mul_ps(razon, cien);
+            emergencia = _mm256_or_ps(emergencia, _mm256_cmp_ps(porcentaje, cien, _CMP_GT_OQ));
+            preventiva = _mm256_or_ps(preventiva, _mm256_cmp_ps(porcentaje, setenta_cinco, _CMP_GT_OQ));
+            if(c == PM2_5) preventiva = _mm256_or_ps(preventiva, _mm256_cmp_ps(razon, pm25, _CMP_GE_OQ));
+        }
+        __m256i nivel = _mm256_sub_epi32(_mm256_setzero_si256(),
+                                         _mm256_add_epi32(_mm256_castps_si256(preventiva), _mm256_castps_si256(emergencia)));
+        __m128i corto = _mm_packs_epi32(_mm256_castsi256_si128(nivel), _mm256_extracti128_si256(nivel, 1));
+        _mm_storel_epi64((__m128i *)&alertas[z], _mm_packus_epi16(corto, corto));
+    }
+    return z;
+}
+
+// Función para evaluar las alertas de n zonas: niveles[c][z] es el nivel del
+// contaminante c en la zona z y alertas[z] queda con el de la zona
+void evaluar_alertas_lote(const float *const niveles[NUM_CONTAMINANTES], int n, uint8_t *alertas) {
+    int hechas = 0;
+    switch(modo_alertas()) {
+        case ALERTAS_AVX2:
+            hechas = alertas_avx2(niveles, n, alertas);
+            break;
+        case ALERTAS_SSE:
+            hechas = alertas_sse(niveles, n, alertas);
+            break;
+    }
+    alertas_escalar(niveles, hechas, n, alertas);
+}
@@ -0,0 +1,744 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "bdd.h"
+
+#define BDD_NODOS_INICIALES 1024
+#define BDD_BITS_CACHE 18
+#define SIN_MEMO 0xFFFFFFFFu
+
+// ===================== Tabla única y cache =====================
+
+static uint32_t hashNodo(uint32_t var, NodoBDD bajo, NodoBDD alto) {
+    uint64_t k = ((uint64_t)var * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)bajo << 32 | alto);
+    k ^= k >> 29;
+    k *= 0xBF58476D1CE4E5B9ULL;
+    k ^= k >> 32;
+    return (uint32_t)k;
+}
+
+static int nivelDe(const Bdd *b, NodoBDD f) {
+    return (f <= BDD_VERDADERO) ? b->numVars : b->nivel[b->nodos[f].var];
+}
+
+int bddCrear(Bdd *b, int numVars, const int *orden) {
+    memset(b, 0, sizeof(*b));
+    if (numVars < 1 || numVars > BDD_MAX_VARIABLES) return 0;
+    b->numVars = numVars;
+    for (int i = 0; i < numVars; i++) {
+        b->orden[i] = orden ? orden[i] : i;
+        b->nivel[b->orden[i]] = i;
+    }
+    b->capNodos = BDD_NODOS_INICIALES;
+    b->nodos = malloc(b->capNodos * sizeof(NodoInterno));
+    b->mascaraUnica = BDD_NODOS_INICIALES - 1;
+    b->unica = calloc(BDD_NODOS_INICIALES, sizeof(uint32_t));
+    b->mascaraCache = (1u << BDD_BITS_CACHE) - 1;
+    b->cache = malloc(((size_t)b->mascaraCache + 1) * sizeof(EntradaCache));
+    if (!b->nodos || !b->unica || !b->cache) {
+        bddLiberar(b);
+        return 0;
+    }
+    // La cache vacía se marca con f = SIN_MEMO (ningún nodo tiene ese índice)
+    memset(b->cache, 0xFF, ((size_t)b->mascaraCache + 1) * sizeof(EntradaCache));
+
+    // Terminales 0 y 1
+    for (int i = 0; i < 2; i++) {
+        b->nodos[i].var = (uint32_t)numVars;
+        b->nodos[i].bajo = b->nodos[i].alto = (NodoBDD)i;
+        b->nodos[i].siguiente = 0;
+    }
+    b->numNodos = 2;
+    return 1;
+}
+
+void bddLiberar(Bdd *b) {
+    free(b->nodos);
+    free(b->unica);
+    free(b->cache);
+    b->nodos = NULL;
+    b->unica = NULL;
+    b->cache = NULL;
+    b->numNodos = 0;
+}
+
+static int crecerUnica(Bdd *b) {
+    uint32_t tam = (b->mascaraUnica + 1) * 2;
+    uint32_t *unica = calloc(tam, sizeof(uint32_t));
+    if (unica == NULL) return 0;
+    free(b->unica);
+    b->unica = unica;
+    b->mascaraUnica = tam - 1;
+    for (uint32_t i = 2; i < b->numNodos; i++) {
+        NodoInterno *x = &b->nodos[i];
+        uint32_t h = hashNodo(x->var, x->bajo, x->alto) & b->mascaraUnica;
+        x->siguiente = b->unica[h];
+        b->unica[h] = i;
+    }
+    return 1;
+}
+
+// Devuelve el nodo (var, bajo, alto) único, creándolo si no existe
+static NodoBDD mk(Bdd *b, uint32_t var, NodoBDD bajo, NodoBDD alto) {
+    if (bajo == alto) return bajo;
+    if (b->excedido) return BDD_FALSO;
+    uint32_t h = hashNodo(var, bajo, alto) & b->mascaraUnica;
+    for (uint32_t i = b->unica[h]; i != 0; i = b->nodos[i].siguiente) {
+        NodoInterno *x = &b->nodos[i];
+        if (x->var == var && x->bajo == bajo && x->alto == alto) return i;
+    }
+
+    if ((b->limite && b->numNodos >= b->limite) || b->numNodos == SIN_MEMO - 1) {
+        b->excedido = 1;
+        return BDD_FALSO;
+    }
+    if (b->numNodos == b->capNodos) {
+        NodoInterno *nodos = realloc(b->nodos, (size_t)b->capNodos * 2 * sizeof(NodoInterno));
+        if (nodos == NULL) { b->excedido = 1; return BDD_FALSO; }
+        b->nodos = nodos;
+        b->capNodos *= 2;
+    }
+    if (b->numNodos > b->mascaraUnica) {
+        if (!crecerUnica(b)) { b->excedido = 1; return BDD_FALSO; }
+        h = hashNodo(var, bajo, alto) & b->mascaraUnica;
+    }
+    NodoBDD nuevo = b->numNodos++;
+    b->nodos[nuevo].var = var;
+    b->nodos[nuevo].bajo = bajo;
+    b->nodos[nuevo].alto = alto;
+    b->nodos[nuevo].siguiente = b->unica[h];
+    b->unica[h] = nuevo;
+    return nuevo;
+}
+
+NodoBDD bddVariable(Bdd *b, int var) {
+    return mk(b, (uint32_t)var, BDD_FALSO, BDD_VERDADERO);
+}
+
+// ===================== Operaciones =====================
+
+// If-then-else: f·g + f'·h. Todas las operaciones binarias se reducen a ITE
+NodoBDD bddIte(Bdd *b, NodoBDD f, NodoBDD g, NodoBDD h) {
+    if (f == BDD_VERDADERO) return g;
+    if (f == BDD_FALSO) return h;
+    if (g == h) return g;
+    if (g == BDD_VERDADERO && h == BDD_FALSO) return f;
+    if (b->excedido) return BDD_FALSO;
+
+    uint32_t slot = hashNodo(f, g, h) & b->mascaraCache;
+    EntradaCache *e = &b->cache[slot];
+    if (e->f == f && e->g == g && e->h == h) return e->resultado;
+
+    int v = nivelDe(b, f);
+    if (nivelDe(b, g) < v) v = nivelDe(b, g);
+    if (nivelDe(b, h) < v) v = nivelDe(b, h);
+    uint32_t var = (uint32_t)b->orden[v];
+
+    #define COFACTOR(x, lado) ((nivelDe(b, x) == v) ? b->nodos[x].lado : (x))
+    NodoBDD bajo = bddIte(b, COFACTOR(f, bajo), COFACTOR(g, bajo), COFACTOR(h, bajo));
+    NodoBDD alto = bddIte(b, COFACTOR(f, alto), COFACTOR(g, alto), COFACTOR(h, alto));
+    #undef COFACTOR
+    NodoBDD r = mk(b, var, bajo, alto);
+
+    e = &b->cache[slot];
+    e->f = f;
+    e->g = g;
+    e->h = h;
+    e->resultado = r;
+    return r;
+}
+
+NodoBDD bddNot(Bdd *b, NodoBDD f) { return bddIte(b, f, BDD_FALSO, BDD_VERDADERO); }
+NodoBDD bddAnd(Bdd *b, NodoBDD f, NodoBDD g) { return bddIte(b, f, g, BDD_FALSO); }
+NodoBDD bddOr(Bdd *b, NodoBDD f, NodoBDD g) { return bddIte(b, f, BDD_VERDADERO, g); }
+NodoBDD bddXor(Bdd *b, NodoBDD f, NodoBDD g) { return bddIte(b, f, bddNot(b, g), g); }
+
+// ===================== Construcción desde tabla =====================
+
+// 1 si todas las filas [desde, desde+tam) valen 1, 0 si todas valen 0, -1 si hay de ambas
+static int rangoConstante(const TablaVerdad *t, size_t desde, size_t tam) {
+    if (tam < 64) {
+        uint64_t m = ((1ULL << tam) - 1) << (desde & 63);
+        uint64_t x = t->bits[desde >> 6] & m;
+        return (x == 0) ? 0 : (x == m) ? 1 : -1;
+    }
+    uint64_t todos1 = ~0ULL, alguno = 0;
+    for (size_t w = desde >> 6; w < (desde + tam) >> 6; w++) {
+        todos1 &= t->bits[w];
+        alguno |= t->bits[w];
+        if (alguno && todos1 != ~0ULL) return -1;
+    }
+    return alguno ? 1 : 0;
+}
+
+// Divide las filas por la variable v (la más significativa del rango)
+static NodoBDD construirRango(Bdd *b, const TablaVerdad *t, int v, size_t desde) {
+    size_t tam = (size_t)1 << (t->n - v);
+    int c = rangoConstante(t, desde, tam);
+    if (c >= 0) return c ? BDD_VERDADERO : BDD_FALSO;
+    NodoBDD bajo = construirRango(b, t, v + 1, desde);
+    NodoBDD alto = construirRango(b, t, v + 1, desde + tam / 2);
+    return bddIte(b, bddVariable(b, v), alto, bajo);
+}
+
+// Los indiferentes se toman como 0
+NodoBDD bddDesdeTabla(Bdd *b, const TablaVerdad *t) {
+    return construirRango(b, t, 0, 0);
+}
+
+// ===================== Construcción desde expresión =====================
+
+// Variables: A..Z (0..25) o x<número> (x0..x63); negación con ' ! o ~;
+// AND por yuxtaposición, * o &; XOR con ^; OR con + o |; constantes 0 y 1
+typedef struct {
+    Bdd *b;
+    const char *p;
+    const char *error;
+} Analizador;
+
+static void saltarEspacios(Analizador *a) {
+    while (isspace((unsigned char)*a->p)) a->p++;
+}
+
+static NodoBDD exprOr(Analizador *a);
+
+// Lee un nombre de variable; devuelve su índice o -1
+static int leerVariable(const char **p) {
+    if (**p >= 'A' && **p <= 'Z') return *(*p)++ - 'A';
+    if (**p == 'x' && isdigit((unsigned char)(*p)[1])) {
+        int v = 0;
+        (*p)++;
+        while (isdigit((unsigned char)**p)) {
+            v = v * 10 + (*(*p)++ - '0');
+            if (v >= BDD_MAX_VARIABLES) return -1;
+        }
+        return v;
+    }
+    return -1;
+}
+
+static NodoBDD exprFactor(Analizador *a) {
+    saltarEspacios(a);
+    NodoBDD r = BDD_FALSO;
+    char c = *a->p;
+    if (c == '!' || c == '~') {
+        a->p++;
+        return bddNot(a->b, exprFactor(a));
+    }
+    if (c == '(') {
+        a->p++;
+        r = exprOr(a);
+        saltarEspacios(a);
+        if (*a->p != ')') { a->error = "falta ')'"; return BDD_FALSO; }
+        a->p++;
+    } else if (c == '0' || c == '1') {
+        a->p++;
+        r = (c == '1') ? BDD_VERDADERO : BDD_FALSO;
+    } else {
+        int v = leerVariable(&a->p);
+        if (v < 0 || v >= a->b->numVars) { a->error = "variable inválida"; return BDD_FALSO; }
+        r = bddVariable(a->b, v);
+    }
+    saltarEspacios(a);
+    while (*a->p == '\'') {
+        a->p++;
+        r = bddNot(a->b, r);
+        saltarEspacios(a);
+    }
+    return r;
+}
+
+static int iniciaFactor(char c) {
+    return (c >= 'A' && c <= 'Z') || c == 'x' || c == '(' || c == '!' || c == '~' || c == '0' || c == '1';
+}
+
+static NodoBDD exprAnd(Analizador *a) {
+    NodoBDD r = exprFactor(a);
+    for (;;) {
+        if (a->error) return BDD_FALSO;
+        saltarEspacios(a);
+        if (*a->p == '*' || *a->p == '&') a->p++;
+        else if ((unsigned char)a->p[0] == 0xC2 && (unsigned char)a->p[1] == 0xB7) a->p += 2; // '·'
+        else if (!iniciaFactor(*a->p)) return r;
+        r = bddAnd(a->b, r, exprFactor(a));
+    }
+}
+
+static NodoBDD exprXor(Analizador *a) {
+    NodoBDD r = exprAnd(a);
+    saltarEspacios(a);
+    while (!a->error && *a->p == '^') {
+        a->p++;
+        r = bddXor(a->b, r, exprAnd(a));
+        saltarEspacios(a);
+    }
+    return r;
+}
+
+static NodoBDD exprOr(Analizador *a) {
+    NodoBDD r = exprXor(a);
+    saltarEspacios(a);
+    while (!a->error && (*a->p == '+' || *a->p == '|')) {
+        a->p++;
+        r = bddOr(a->b, r, exprXor(a));
+        saltarEspacios(a);
+    }
+    return r;
+}
+
+// Cantidad de variables que usa la expresión (índice máximo + 1)
+int bddContarVariables(const char *expresion) {
+    int max = -1;
+    const char *p = expresion;
+    while (*p) {
+        int v = leerVariable(&p);
+        if (v > max) max = v;
+        if (v < 0) {
+            if (*p == 'x' && isdigit((unsigned char)p[1])) return -1; // índice fuera de rango
+            p++;
+        }
+    }
+    return max + 1 > 0 ? max + 1 : 1;
+}
+
+int bddDesdeExpresion(Bdd *b, const char *expresion, NodoBDD *raiz, char *error, size_t tamError) {
+    Analizador a = { b, expresion, NULL };
+    *raiz = exprOr(&a);
+    saltarEspacios(&a);
+    if (!a.error && *a.p != '\0') a.error = "símbolo inesperado";
+    if (!a.error && b->excedido) a.error = "sin memoria para el BDD";
+    if (a.error) {
+        snprintf(error, tamError, "%s (posición %ld)", a.error, (long)(a.p - expresion) + 1);
+        return 0;
+    }
+    return 1;
+}
+
+// ===================== Consultas =====================
+
+static void marcarAlcanzables(const Bdd *b, NodoBDD f, unsigned char *visto, size_t *cuenta) {
+    while (f > BDD_VERDADERO && !visto[f]) {
+        visto[f] = 1;
+        (*cuenta)++;
+        marcarAlcanzables(b, b->nodos[f].bajo, visto, cuenta);
+        f = b->nodos[f].alto;
+    }
+}
+
+// Nodos internos alcanzables desde la raíz
+size_t bddContarNodos(const Bdd *b, NodoBDD raiz) {
+    unsigned char *visto = calloc(b->numNodos, 1);
+    size_t cuenta = 0;
+    if (visto == NULL) return 0;
+    marcarAlcanzables(b, raiz, visto, &cuenta);
+    free(visto);
+    return cuenta;
+}
+
+static long double potencia2(int k) {
+    long double r = 1;
+    while (k-- > 0) r *= 2;
+    return r;
+}
+
+static long double contarDesde(const Bdd *b, NodoBDD f, long double *memo) {
+    if (f == BDD_FALSO) return 0;
+    if (f == BDD_VERDADERO) return 1;
+    if (memo[f] >= 0) return memo[f];
+    int l = nivelDe(b, f);
+    NodoBDD bajo = b->nodos[f].bajo, alto = b->nodos[f].alto;
+    long double r = contarDesde(b, bajo, memo) * potencia2(nivelDe(b, bajo) - l - 1) +
+                    contarDesde(b, alto, memo) * potencia2(nivelDe(b, alto) - l - 1);
+    memo[f] = r;
+    return r;
+}
+
+// Cantidad de asignaciones que hacen 1 a la función (satcount)
+long double bddContarMinterminos(const Bdd *b, NodoBDD raiz) {
+    long double *memo = malloc(b->numNodos * sizeof(long double));
+    if (memo == NULL) return -1;
+    for (uint32_t i = 0; i < b->numNodos; i++) memo[i] = -1;
+    long double r = contarDesde(b, raiz, memo) * potencia2(nivelDe(b, raiz));
+    free(memo);
+    return r;
+}
+
+// Recorre los caminos a 1; cada camino es un cubo disjunto de los demás
+static int enumerarCaminos(const Bdd *b, NodoBDD f, CuboBDD actual, CuboBDD **cubos,
+                           size_t *cantidad, size_t *capacidad) {
+    if (f == BDD_FALSO) return 1;
+    if (f == BDD_VERDADERO) {
+        if (*cantidad >= BDD_MAX_CUBOS) return 0;
+        if (*cantidad == *capacidad) {
+            size_t cap = *capacidad ? *capacidad * 2 : 64;
+            CuboBDD *nuevos = realloc(*cubos, cap * sizeof(CuboBDD));
+            if (nuevos == NULL) return 0;
+            *cubos = nuevos;
+            *capacidad = cap;
+        }
+        (*cubos)[(*cantidad)++] = actual;
+        return 1;
+    }
+    uint64_t bit = 1ULL << b->nodos[f].var;
+    CuboBDD cero = { actual.valor, actual.cuidado | bit };
+    CuboBDD uno = { actual.valor | bit, actual.cuidado | bit };
+    return enumerarCaminos(b, b->nodos[f].bajo, cero, cubos, cantidad, capacidad) &&
+           enumerarCaminos(b, b->nodos[f].alto, uno, cubos, cantidad, capacidad);
+}
+
+// Lista de cubos que va armando el ISOP
+typedef struct {
+    CuboBDD *cubos;
+    size_t cantidad;
+    size_t capacidad;
+    int excedida;
+} ListaCubos;
+
+static void agregarCuboBDD(ListaCubos *l, CuboBDD c) {
+    if (l->cantidad >= BDD_MAX_CUBOS) { l->excedida = 1; return; }
+    if (l->cantidad == l->capacidad) {
+        size_t cap = l->capacidad ? l->capacidad * 2 : 64;
+        CuboBDD *nuevos = realloc(l->cubos, cap * sizeof(CuboBDD));
+        if (nuevos == NULL) { l->excedida = 1; return; }
+        l->cubos = nuevos;
+        l->capacidad = cap;
+    }
+    l->cubos[l->cantidad++] = c;
+}
+
+// Minato-Morreale: cobertura irredundante de cualquier función entre
+// 'menor' y 'mayor'. Devuelve el BDD de la cobertura agregada a la lista
+static NodoBDD isop(Bdd *b, NodoBDD menor, NodoBDD mayor, ListaCubos *l) {
+    if (menor == BDD_FALSO || l->excedida || b->excedido) return BDD_FALSO;
+    if (mayor == BDD_VERDADERO) {
+        CuboBDD tautologia = { 0, 0 };
+        agregarCuboBDD(l, tautologia);
+        return BDD_VERDADERO;
+    }
+
+    int v = nivelDe(b, menor) < nivelDe(b, mayor) ? nivelDe(b, menor) : nivelDe(b, mayor);
+    int var = b->orden[v];
+    NodoBDD m0 = menor, m1 = menor, M0 = mayor, M1 = mayor;
+    if (nivelDe(b, menor) == v) { m0 = b->nodos[menor].bajo; m1 = b->nodos[menor].alto; }
+    if (nivelDe(b, mayor) == v) { M0 = b->nodos[mayor].bajo; M1 = b->nodos[mayor].alto; }
+
+    // Cubos que necesitan el literal var' y los que necesitan var
+    size_t desde0 = l->cantidad;
+    NodoBDD r0 = isop(b, bddAnd(b, m0, bddNot(b, M1)), M0, l);
+    size_t desde1 = l->cantidad;
+    NodoBDD r1 = isop(b, bddAnd(b, m1, bddNot(b, M0)), M1, l);
+    size_t hasta1 = l->cantidad;
+    for (size_t i = desde0; i < hasta1; i++) {
+        l->cubos[i].cuidado |= 1ULL << var;
+        if (i >= desde1) l->cubos[i].valor |= 1ULL << var;
+    }
+
+    // Lo que falta cubrir se cubre sin depender de var
+    NodoBDD resto = bddOr(b, bddAnd(b, m0, bddNot(b, r0)), bddAnd(b, m1, bddNot(b, r1)));
+    NodoBDD rd = isop(b, resto, bddAnd(b, M0, M1), l);
+
+    NodoBDD x = bddVariable(b, var);
+    return bddOr(b, bddIte(b, x, r1, r0), rd);
+}
+
+// Devuelve los cubos de un SOP irredundante leído del BDD; 0 si hay demasiados
+int bddCubos(Bdd *b, NodoBDD raiz, CuboBDD **cubos, size_t *cantidad) {
+    ListaCubos l = { NULL, 0, 0, 0 };
+    isop(b, raiz, raiz, &l);
+    *cubos = l.cubos;
+    *cantidad = l.cantidad;
+    return !l.excedida && !b->excedido;
+}
+
+// Convierte a tabla de verdad (solo hasta MAX_VARIABLES)
+int bddATabla(const Bdd *b, NodoBDD raiz, TablaVerdad *t) {
+    int n = b->numVars;
+    if (n > MAX_VARIABLES || !crearTabla(t, n)) return 0;
+    CuboBDD *cubos = NULL;
+    size_t cantidad = 0, capacidad = 0;
+    CuboBDD vacio = { 0, 0 };
+    if (!enumerarCaminos(b, raiz, vacio, &cubos, &cantidad, &capacidad)) {
+        // Demasiados caminos: evaluar fila por fila
+        free(cubos);
+        for (size_t fila = 0; fila < numFilas(t); fila++) {
+            NodoBDD f = raiz;
+            while (f > BDD_VERDADERO) {
+                int v = (int)b->nodos[f].var;
+                f = ((fila >> (n - 1 - v)) & 1) ? b->nodos[f].alto : b->nodos[f].bajo;
+            }
+            if (f == BDD_VERDADERO) t->bits[fila >> 6] |= 1ULL << (fila & 63);
+        }
+        return 1;
+    }
+    for (size_t i = 0; i < cantidad; i++) {
+        Cubo c = { 0, 0 };
+        for (int v = 0; v < n; v++) {
+            uint64_t bit = 1ULL << v;
+            if (cubos[i].cuidado & bit) {
+                c.cuidado |= 1u << (n - 1 - v);
+                if (cubos[i].valor & bit) c.valor |= 1u << (n - 1 - v);
+            }
+        }
+        marcarCubo(n, c, t->bits);
+    }
+    free(cubos);
+    return 1;
+}
+
+// ===================== Reordenamiento por sifting =====================
+
+static NodoBDD transferirNodo(Bdd *dst, const Bdd *src, NodoBDD f, NodoBDD *memo) {
+    if (f <= BDD_VERDADERO) return f;
+    if (memo[f] != SIN_MEMO) return memo[f];
+    NodoBDD bajo = transferirNodo(dst, src, src->nodos[f].bajo, memo);
+    NodoBDD alto = transferirNodo(dst, src, src->nodos[f].alto, memo);
+    NodoBDD r = bddIte(dst, bddVariable(dst, (int)src->nodos[f].var), alto, bajo);
+    memo[f] = r;
+    return r;
+}
+
+// Copia la función a otro administrador (que puede tener otro orden)
+static NodoBDD transferir(Bdd *dst, const Bdd *src, NodoBDD raiz) {
+    NodoBDD *memo = malloc(src->numNodos * sizeof(NodoBDD));
+    if (memo == NULL) { dst->excedido = 1; return BDD_FALSO; }
+    memset(memo, 0xFF, src->numNodos * sizeof(NodoBDD));
+    NodoBDD r = transferirNodo(dst, src, raiz, memo);
+    free(memo);
+    return r;
+}
+
+// Sifting: cada variable (empezando por las que tienen más nodos) se prueba
+// en todas las posiciones manteniendo fijas las demás, y se queda en la que
+// da el BDD más chico. Cada posición se evalúa reconstruyendo el BDD con ese
+// orden en un administrador nuevo (acotado por un límite de nodos), lo que
+// además deja el resultado sin nodos muertos.
+int bddReordenarSifting(Bdd *b, NodoBDD *raiz) {
+    int n = b->numVars;
+    size_t mejorTam = bddContarNodos(b, *raiz);
+    size_t porVar[BDD_MAX_VARIABLES] = {0};
+    int vars[BDD_MAX_VARIABLES];
+    unsigned char *visto = calloc(b->numNodos, 1);
+    size_t cuenta = 0;
+    if (visto == NULL) return 0;
+    marcarAlcanzables(b, *raiz, visto, &cuenta);
+    for (uint32_t i = 2; i < b->numNodos; i++) {
+        if (visto[i]) porVar[b->nodos[i].var]++;
+    }
+    free(visto);
+
+    int numSoporte = 0;
+    for (int v = 0; v < n; v++) {
+        if (porVar[v] > 0) vars[numSoporte++] = v;
+    }
+    for (int i = 1; i < numSoporte; i++) {
+        int v = vars[i], j = i;
+        while (j > 0 && porVar[vars[j - 1]] < porVar[v]) { vars[j] = vars[j - 1]; j--; }
+        vars[j] = v;
+    }
+
+    for (int k = 0; k < numSoporte; k++) {
+        int v = vars[k];
+        int resto[BDD_MAX_VARIABLES], numResto = 0;
+        for (int l = 0; l < n; l++) {
+            if (b->orden[l] != v) resto[numResto++] = b->orden[l];
+        }
+
+        Bdd mejor;
+        NodoBDD mejorRaiz = BDD_FALSO;
+        int hayMejor = 0;
+        for (int pos = 0; pos < n; pos++) {
+            if (b->orden[pos] == v) continue;
+            int orden[BDD_MAX_VARIABLES];
+            for (int l = 0, r = 0; l < n; l++) orden[l] = (l == pos) ? v : resto[r++];
+
+            Bdd prueba;
+            if (!bddCrear(&prueba, n, orden)) continue;
+            prueba.limite = (uint32_t)(4 * mejorTam + 1024);
+            NodoBDD r = transferir(&prueba, b, *raiz);
+            size_t tam = prueba.excedido ? (size_t)-1 : bddContarNodos(&prueba, r);
+            if (tam < mejorTam) {
+                if (hayMejor) bddLiberar(&mejor);
+                mejor = prueba;
+                mejorRaiz = r;
+                mejorTam = tam;
+                hayMejor = 1;
+            } else {
+                bddLiberar(&prueba);
+            }
+        }
+        if (hayMejor) {
+            mejor.limite = 0;
+            bddLiberar(b);
+            *b = mejor;
+            *raiz = mejorRaiz;
+        }
+    }
+    return 1;
+}
+
+// ===================== Salida =====================
+
+const char *nombreVariableBDD(int v, char *buf) {
+    if (v < 26) snprintf(buf, 8, "%c", 'A' + v);
+    else snprintf(buf, 8, "x%u", (unsigned char)v);
+    return buf;
+}
+
+static void imprimirOrden(FILE *f, const Bdd *b) {
+    char nombre[8];
+    fprintf(f, "Orden de variables:");
+    for (int l = 0; l < b->numVars; l++) fprintf(f, " %s", nombreVariableBDD(b->orden[l], nombre));
+    fprintf(f, "\n");
+}
+
+// Hasta MAX_VARIABLES se pasa a tabla y se usa el minimizador de dos
+// niveles; con más variables el SOP se obtiene del BDD con ISOP
+void generarExpresionBDD(FILE *f, Bdd *b, NodoBDD raiz, ModoMinimizacion modo) {
+    fprintf(f, "\n%s=== BDD ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    fprintf(f, "Variables: %d | Nodos: %zu\n", b->numVars, bddContarNodos(b, raiz));
+    imprimirOrden(f, b);
+
+    if (b->numVars <= MAX_VARIABLES) {
+        TablaVerdad t;
+        Cobertura sop, pos;
+        iniciarCobertura(&sop, b->numVars);
+        iniciarCobertura(&pos, b->numVars);
+        if (bddATabla(b, raiz, &t) && minimizarSOP(&t, modo, &sop) && minimizarPOS(&t, modo, &pos)) {
+            generarExpresion(f, &t, &sop, &pos);
+        } else {
+            fprintf(stderr, "Error: No hay memoria para minimizar la función\n");
+        }
+        liberarCobertura(&sop);
+        liberarCobertura(&pos);
+        liberarTabla(&t);
+        return;
+    }
+
+    CuboBDD *cubos;
+    size_t cantidad;
+    char nombre[8];
+    fprintf(f, "\n%s=== EXPRESIÓN BOOLEANA GENERADA ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    if (!bddCubos(b, raiz, &cubos, &cantidad)) {
+        fprintf(f, "Forma SOP: más de %d términos; use la netlist del BDD\n", BDD_MAX_CUBOS);
+        free(cubos);
+        return;
+    }
+    fprintf(f, "Forma SOP (desde el BDD): ");
+    size_t literales = 0;
+    for (size_t i = 0; i < cantidad; i++) {
+        if (i > 0) fprintf(f, " + ");
+        if (cubos[i].cuidado == 0) { fprintf(f, "1"); continue; }
+        fprintf(f, "(");
+        for (int v = 0; v < b->numVars; v++) {
+            uint64_t bit = 1ULL << v;
+            if (!(cubos[i].cuidado & bit)) continue;
+            fprintf(f, "%s%s", nombreVariableBDD(v, nombre), (cubos[i].valor & bit) ? "" : "'");
+            literales++;
+        }
+        fprintf(f, ")");
+    }
+    if (cantidad == 0) fprintf(f, "0 (Función siempre falsa)");
+    fprintf(f, "\nCosto SOP: %zu términos, %zu literales\n", cantidad, literales);
+    free(cubos);
+}
+
+// Con pocas variables imprime la tabla completa; si no, las filas en 1
+// agrupadas por los caminos del BDD (grupos disjuntos)
+void imprimirTablaBDD(FILE *f, const Bdd *b, NodoBDD raiz) {
+    if (b->numVars <= MAX_VARIABLES) {
+        TablaVerdad t;
+        if (!bddATabla(b, raiz, &t)) {
+            fprintf(stderr, "Error: No hay memoria para la tabla de verdad\n");
+            return;
+        }
+        imprimirTabla(f, &t);
+        liberarTabla(&t);
+        return;
+    }
+
+    fprintf(f, "\n%s=== TABLA DE VERDAD (COMPRIMIDA) ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    fprintf(f, "Filas totales: 2^%d | Filas en 1: %.0Lf\n", b->numVars, bddContarMinterminos(b, raiz));
+    CuboBDD *cubos = NULL, vacio = { 0, 0 };
+    size_t cantidad = 0, capacidad = 0;
+    if (!enumerarCaminos(b, raiz, vacio, &cubos, &cantidad, &capacidad)) {
+        fprintf(f, "(más de %d grupos de filas)\n", BDD_MAX_CUBOS);
+        free(cubos);
+        return;
+    }
+    for (size_t i = 0; i < cantidad; i++) {
+        fprintf(f, " ");
+        for (int v = 0; v < b->numVars; v++) {
+            uint64_t bit = 1ULL << v;
+            char c = (cubos[i].cuidado & bit) ? ((cubos[i].valor & bit) ? '1' : '0') : '-';
+            fprintf(f, "%c", c);
+        }
+        fprintf(f, "  |  1  (2^%d filas)\n", b->numVars - __builtin_popcountll(cubos[i].cuidado));
+    }
+    free(cubos);
+}
+
+// Netlist de multiplexores: un MUX por nodo, simplificado a AND/OR/NOT
+// cuando uno de los hijos es constante
+void generarCircuitoBDD(FILE *f, const Bdd *b, NodoBDD raiz) {
+    fprintf(f, "\n%s=== IMPLEMENTACIÓN EN CIRCUITO LÓGICO (BDD) ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    if (raiz <= BDD_VERDADERO) {
+        fprintf(f, "- No se requieren compuertas (salida siempre %u)\n", raiz);
+        return;
+    }
+
+    unsigned char *visto = calloc(b->numNodos, 1);
+    size_t cuenta = 0;
+    if (visto == NULL) return;
+    marcarAlcanzables(b, raiz, visto, &cuenta);
+    int imprimir = cuenta <= BDD_MAX_NETLIST;
+    size_t numAnd = 0, numOr = 0, numMux = 0;
+    uint64_t negadas = 0;
+    char nv[8], bajo[16], alto[16];
+
+    // Los índices crecen de hojas a raíz, así cada red se define antes de usarse
+    for (uint32_t i = 2; i < b->numNodos; i++) {
+        if (!visto[i]) continue;
+        const NodoInterno *x = &b->nodos[i];
+        nombreVariableBDD((int)x->var, nv);
+        snprintf(bajo, sizeof(bajo), x->bajo <= BDD_VERDADERO ? "%u" : "b%u", x->bajo);
+        snprintf(alto, sizeof(alto), x->alto <= BDD_VERDADERO ? "%u" : "b%u", x->alto);
+        const char *salida = (i == raiz) ? "salida" : NULL;
+        char red[16];
+        if (salida == NULL) { snprintf(red, sizeof(red), "b%u", i); salida = red; }
+
+        if (x->bajo == BDD_FALSO && x->alto == BDD_VERDADERO) {
+            if (imprimir) fprintf(f, "%s = %s\n", salida, nv);
+        } else if (x->bajo == BDD_VERDADERO && x->alto == BDD_FALSO) {
+            negadas |= 1ULL << x->var;
+            if (imprimir) fprintf(f, "%s = n%s\n", salida, nv);
+        } else if (x->bajo == BDD_FALSO) {
+            numAnd++;
+            if (imprimir) fprintf(f, "%s = AND(%s, %s)\n", salida, nv, alto);
+        } else if (x->alto == BDD_FALSO) {
+            numAnd++;
+            negadas |= 1ULL << x->var;
+            if (imprimir) fprintf(f, "%s = AND(n%s, %s)\n", salida, nv, bajo);
+        } else if (x->alto == BDD_VERDADERO) {
+            numOr++;
+            if (imprimir) fprintf(f, "%s = OR(%s, %s)\n", salida, nv, bajo);
+        } else if (x->bajo == BDD_VERDADERO) {
+            numOr++;
+            negadas |= 1ULL << x->var;
+            if (imprimir) fprintf(f, "%s = OR(n%s, %s)\n", salida, nv, alto);
+        } else {
+            numMux++;
+            if (imprimir) fprintf(f, "%s = MUX(%s ? %s : %s)\n", salida, nv, alto, bajo);
+        }
+    }
+    if (!imprimir) fprintf(f, "(netlist de %zu nodos omitida)\n", cuenta);
+    free(visto);
+
+    int numNot = __builtin_popcountll(negadas);
+    fprintf(f, "\nResumen del circuito:\n");
+    fprintf(f, "- %d compuertas NOT\n", numNot);
+    fprintf(f, "- %zu compuertas AND de 2 entradas\n", numAnd);
+    fprintf(f, "- %zu compuertas OR de 2 entradas\n", numOr);
+    fprintf(f, "- %zu multiplexores 2:1\n", numMux);
+    fprintf(f, "Total: %zu compuertas\n", (size_t)numNot + numAnd + numOr + numMux);
+}
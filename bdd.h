@@ -0,0 +1,78 @@
+#ifndef BDD_H
+#define BDD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "booleanas.h"
+
+// Diagramas de decisión binaria reducidos y ordenados (ROBDD)
+#define BDD_MAX_VARIABLES 64
+#define BDD_FALSO 0u
+#define BDD_VERDADERO 1u
+#define BDD_MAX_NETLIST 500     // nodos hasta los que se imprime la netlist completa
+#define BDD_MAX_CUBOS 100000    // caminos a 1 que se enumeran como máximo
+
+typedef uint32_t NodoBDD;
+
+// Nodo interno: si la variable vale 0 se sigue 'bajo', si vale 1 'alto'
+typedef struct {
+    uint32_t var;
+    NodoBDD bajo;
+    NodoBDD alto;
+    uint32_t siguiente;     // encadenamiento en la tabla única
+} NodoInterno;
+
+// Entrada de la tabla de resultados (cache de ITE)
+typedef struct {
+    NodoBDD f, g, h;
+    NodoBDD resultado;
+} EntradaCache;
+
+typedef struct {
+    int numVars;
+    int orden[BDD_MAX_VARIABLES];   // nivel -> variable
+    int nivel[BDD_MAX_VARIABLES];   // variable -> nivel
+    NodoInterno *nodos;
+    uint32_t numNodos;
+    uint32_t capNodos;
+    uint32_t *unica;                // cabeza de cada cubeta (0 = vacía)
+    uint32_t mascaraUnica;
+    EntradaCache *cache;
+    uint32_t mascaraCache;
+    uint32_t limite;                // máximo de nodos (0 = sin límite)
+    int excedido;
+} Bdd;
+
+// Cubo de hasta 64 variables (bit v = variable v)
+typedef struct {
+    uint64_t valor;
+    uint64_t cuidado;
+} CuboBDD;
+
+// Gestión de nodos
+int bddCrear(Bdd *b, int numVars, const int *orden);
+void bddLiberar(Bdd *b);
+NodoBDD bddVariable(Bdd *b, int var);
+NodoBDD bddIte(Bdd *b, NodoBDD f, NodoBDD g, NodoBDD h);
+NodoBDD bddNot(Bdd *b, NodoBDD f);
+NodoBDD bddAnd(Bdd *b, NodoBDD f, NodoBDD g);
+NodoBDD bddOr(Bdd *b, NodoBDD f, NodoBDD g);
+NodoBDD bddXor(Bdd *b, NodoBDD f, NodoBDD g);
+
+// Construcción y consultas
+NodoBDD bddDesdeTabla(Bdd *b, const TablaVerdad *t);
+int bddContarVariables(const char *expresion);
+int bddDesdeExpresion(Bdd *b, const char *expresion, NodoBDD *raiz, char *error, size_t tamError);
+size_t bddContarNodos(const Bdd *b, NodoBDD raiz);
+long double bddContarMinterminos(const Bdd *b, NodoBDD raiz);
+int bddATabla(const Bdd *b, NodoBDD raiz, TablaVerdad *t);
+int bddCubos(Bdd *b, NodoBDD raiz, CuboBDD **cubos, size_t *cantidad);
+int bddReordenarSifting(Bdd *b, NodoBDD *raiz);
+const char *nombreVariableBDD(int v, char *buf);
+
+// Salida con la misma forma que la representación por tablas
+void generarExpresionBDD(FILE *f, Bdd *b, NodoBDD raiz, ModoMinimizacion modo);
+void imprimirTablaBDD(FILE *f, const Bdd *b, NodoBDD raiz);
+void generarCircuitoBDD(FILE *f, const Bdd *b, NodoBDD raiz);
+
+#endif // BDD_H
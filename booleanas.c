@@ -1,7 +1,137 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <time.h>
 #include "booleanas.h"
+#include "bdd.h"
+
+// Patrones de filas donde el bit p (p < 6) del índice vale 1 dentro de una palabra
+static const uint64_t patronesBajos[6] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+// Máscara de filas válidas de la última palabra (solo importa cuando n < 6)
+static uint64_t mascaraValida(int n) {
+    return (n >= 6) ? ~0ULL : ((1ULL << (1u << n)) - 1);
+}
+
+int crearTabla(TablaVerdad *t, int n) {
+    t->n = n;
+    t->palabras = (n >= 6) ? ((size_t)1 << (n - 6)) : 1;
+    t->bits = calloc(t->palabras, sizeof(uint64_t));
+    t->indiferentes = NULL;
+    return t->bits != NULL;
+}
+
+void liberarTabla(TablaVerdad *t) {
+    free(t->bits);
+    free(t->indiferentes);
+    t->bits = NULL;
+    t->indiferentes = NULL;
+    t->palabras = 0;
+}
+
+size_t numFilas(const TablaVerdad *t) {
+    return (size_t)1 << t->n;
+}
+
+int obtenerSalida(const TablaVerdad *t, size_t fila) {
+    return (t->bits[fila >> 6] >> (fila & 63)) & 1;
+}
+
+void asignarSalida(TablaVerdad *t, size_t fila, int valor) {
+    uint64_t bit = 1ULL << (fila & 63);
+    if (valor) t->bits[fila >> 6] |= bit;
+    else t->bits[fila >> 6] &= ~bit;
+    if (t->indiferentes) t->indiferentes[fila >> 6] &= ~bit;
+}
+
+int esIndiferente(const TablaVerdad *t, size_t fila) {
+    return t->indiferentes != NULL && ((t->indiferentes[fila >> 6] >> (fila & 63)) & 1);
+}
+
+// Marca la fila como "no importa" (la tabla de indiferentes se crea al usarla)
+int asignarIndiferente(TablaVerdad *t, size_t fila) {
+    if (t->indiferentes == NULL) {
+        t->indiferentes = calloc(t->palabras, sizeof(uint64_t));
+        if (t->indiferentes == NULL) return 0;
+    }
+    t->bits[fila >> 6] &= ~(1ULL << (fila & 63));
+    t->indiferentes[fila >> 6] |= 1ULL << (fila & 63);
+    return 1;
+}
+
+size_t contarMinterminos(const TablaVerdad *t) {
+    size_t total = 0;
+    for (size_t w = 0; w < t->palabras; w++) {
+        total += (size_t)__builtin_popcountll(t->bits[w]);
+    }
+    return total;
+}
+
+// Filas de la palabra indicada en las que la variable var (0 = A) vale 1
+uint64_t mascaraVariable(int n, int var, size_t palabra) {
+    int p = n - 1 - var; // posición del bit de la variable en el índice de fila
+    uint64_t m;
+    if (p < 6) m = patronesBajos[p];
+    else m = ((palabra >> (p - 6)) & 1) ? ~0ULL : 0;
+    return m & mascaraValida(n);
+}
+
+void complementarTabla(TablaVerdad *dst, const TablaVerdad *a) {
+    for (size_t w = 0; w < a->palabras; w++) {
+        dst->bits[w] = ~a->bits[w];
+    }
+    dst->bits[a->palabras - 1] &= mascaraValida(a->n);
+}
+
+void andTablas(TablaVerdad *dst, const TablaVerdad *a, const TablaVerdad *b) {
+    for (size_t w = 0; w < a->palabras; w++) {
+        dst->bits[w] = a->bits[w] & b->bits[w];
+    }
+}
+
+void orTablas(TablaVerdad *dst, const TablaVerdad *a, const TablaVerdad *b) {
+    for (size_t w = 0; w < a->palabras; w++) {
+        dst->bits[w] = a->bits[w] | b->bits[w];
+    }
+}
+
+void xorTablas(TablaVerdad *dst, const TablaVerdad *a, const TablaVerdad *b) {
+    for (size_t w = 0; w < a->palabras; w++) {
+        dst->bits[w] = a->bits[w] ^ b->bits[w];
+    }
+}
+
+// Imprime los valores de las entradas de una fila (" 0  1  1")
+static void imprimirEntradas(FILE *f, int n, size_t fila) {
+    for (int v = 0; v < n; v++) {
+        fprintf(f, v == 0 ? " %d" : "  %d", (int)((fila >> (n - 1 - v)) & 1));
+    }
+}
+
+// Imprime el encabezado de variables (" A  B  C")
+static void imprimirEncabezado(FILE *f, int n) {
+    for (int v = 0; v < n; v++) {
+        fprintf(f, v == 0 ? " %c" : "  %c", 'A' + v);
+    }
+}
+
+// Imprime un cubo como producto ("AB'C") o, si es POS, como suma ("A' + B + C'")
+static void imprimirCubo(FILE *f, int n, Cubo c, int comoSuma) {
+    int primero = 1;
+    for (int v = 0; v < n; v++) {
+        uint32_t b = 1u << (n - 1 - v);
+        if (!(c.cuidado & b)) continue;
+        int negada = !(c.valor & b);
+        if (comoSuma) negada = !negada; // De Morgan
+        if (comoSuma && !primero) fprintf(f, " + ");
+        fprintf(f, "%c%s", 'A' + v, negada ? "'" : "");
+        primero = 0;
+    }
+}
 
 void mostrarCaratula() {
     printf("=====================================\n");
@@ -15,149 +145,721 @@ void mostrarCaratula() {
 int obtenerNumVariables() {
     int n;
     do {
-        printf("Digite el número de variables booleanas (2 o 3): ");
-        scanf("%d", &n);
-        if (n != 2 && n != 3)
-            printf(RED "Error: Solo puede ingresar 2 o 3 variables.\n\n" RESET);
-    } while (n != 2 && n != 3);
+        printf("Digite el número de variables booleanas (%d a %d): ", MIN_VARIABLES, MAX_VARIABLES);
+        if (scanf("%d", &n) != 1) {
+            n = 0;
+            while (getchar() != '\n' && !feof(stdin));
+            if (feof(stdin)) exit(1);
+        }
+        if (n < MIN_VARIABLES || n > MAX_VARIABLES)
+            printf(RED "Error: Solo puede ingresar entre %d y %d variables.\n\n" RESET, MIN_VARIABLES, MAX_VARIABLES);
+    } while (n < MIN_VARIABLES || n > MAX_VARIABLES);
     return n;
 }
 
-void ingresarTabla(int n, int salida[]) {
-    int filas = (1 << n);
-    printf("\nIngrese los valores de salida (0 o 1) para cada fila:\n");
+void ingresarTabla(TablaVerdad *t) {
+    int n = t->n;
+    size_t filas = numFilas(t);
+    printf("\nIngrese los valores de salida (0, 1 o X = no importa) para cada fila:\n");
     printf("=====================================\n");
-    printf(" A  B");
-    if (n == 3) printf("  C");
+    imprimirEncabezado(stdout, n);
     printf("  |  Salida\n");
     printf("=====================================\n");
 
-    for (int i = 0; i < filas; i++) {
-        int A = (i >> (n-1)) & 1;
-        int B = (i >> (n-2)) & 1;
-        int C = (n == 3) ? (i & 1) : 0;
-
+    for (size_t i = 0; i < filas; i++) {
+        char valor[8];
+        int valido;
         do {
-            printf(" %d  %d", A, B);
-            if (n == 3) printf("  %d", C);
+            imprimirEntradas(stdout, n, i);
             printf("  |  ");
-            scanf("%d", &salida[i]);
-            if (salida[i] != 0 && salida[i] != 1)
-                printf(RED "Error: Solo puede ingresar 0 o 1.\n" RESET);
-        } while (salida[i] != 0 && salida[i] != 1);
+            if (scanf("%7s", valor) != 1) exit(1);
+            valido = strcmp(valor, "0") == 0 || strcmp(valor, "1") == 0 ||
+                     strcmp(valor, "x") == 0 || strcmp(valor, "X") == 0;
+            if (!valido)
+                printf(RED "Error: Solo puede ingresar 0, 1 o X.\n" RESET);
+        } while (!valido);
+        if (valor[0] == 'x' || valor[0] == 'X') asignarIndiferente(t, i);
+        else asignarSalida(t, i, valor[0] == '1');
     }
 }
 
-void generarExpresion(int n, int salida[]) {
-    int filas = (1 << n);
-    int primera = 1;
+void generarExpresion(FILE *f, const TablaVerdad *t, const Cobertura *sop, const Cobertura *pos) {
+    int n = t->n;
     
-    printf("\n" GREEN "=== EXPRESIÓN BOOLEANA GENERADA ===" RESET "\n");
-    printf("Forma SOP (Suma de Productos): ");
-
-    for (int i = 0; i < filas; i++) {
-        if (salida[i] == 1) {
-            if (!primera) printf(" + ");
-            primera = 0;
-
-            int A = (i >> (n-1)) & 1;
-            int B = (i >> (n-2)) & 1;
-            int C = (n == 3) ? (i & 1) : 0;
-
-            printf("(");
-            if (A == 0) printf("A'");
-            else printf("A");
-            
-            if (B == 0) printf("B'");
-            else printf("B");
-            
-            if (n == 3) {
-                if (C == 0) printf("C'");
-                else printf("C");
-            }
-            printf(")");
+    fprintf(f, "\n%s=== EXPRESIÓN BOOLEANA GENERADA ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    fprintf(f, "Forma SOP minimizada (Suma de Productos): ");
+
+    for (size_t i = 0; i < sop->cantidad; i++) {
+        if (i > 0) fprintf(f, " + ");
+        if (sop->cubos[i].cuidado == 0) {
+            fprintf(f, "1 (Función siempre verdadera)");
+            continue;
         }
+        fprintf(f, "(");
+        imprimirCubo(f, n, sop->cubos[i], 0);
+        fprintf(f, ")");
     }
-    
-    if (primera) {
-        printf("0 (Función siempre falsa)");
+    if (sop->cantidad == 0) {
+        fprintf(f, "0 (Función siempre falsa)");
     }
-    printf("\n");
-}
-
-void imprimirTabla(int n, int salida[]) {
-    int filas = (1 << n);
+    fprintf(f, "\n");
 
-    printf("\n" GREEN "=== TABLA DE VERDAD COMPLETA ===" RESET "\n");
-    printf("=====================================\n");
-    printf(" A  B");
-    if (n == 3) printf("  C");
-    printf("  |  Salida  |  Mintérmino\n");
-    printf("=====================================\n");
-
-    for (int i = 0; i < filas; i++) {
-        int A = (i >> (n-1)) & 1;
-        int B = (i >> (n-2)) & 1;
-        int C = (n == 3) ? (i & 1) : 0;
-
-        printf(" %d  %d", A, B);
-        if (n == 3) printf("  %d", C);
-        printf("  |    %d    |     ", salida[i]);
-        
-        if (salida[i] == 1) {
-            printf(GREEN "m%d" RESET, i);
-        } else {
-            printf("-");
+    fprintf(f, "Forma POS minimizada (Producto de Sumas): ");
+    for (size_t i = 0; i < pos->cantidad; i++) {
+        if (pos->cubos[i].cuidado == 0) {
+            fprintf(f, "0 (Función siempre falsa)");
+            continue;
         }
-        printf("\n");
+        fprintf(f, "(");
+        imprimirCubo(f, n, pos->cubos[i], 1);
+        fprintf(f, ")");
     }
-    printf("=====================================\n");
+    if (pos->cantidad == 0) {
+        fprintf(f, "1 (Función siempre verdadera)");
+    }
+    fprintf(f, "\n");
+    fprintf(f, "Costo SOP: %zu términos, %zu literales | Costo POS: %zu términos, %zu literales\n",
+           sop->cantidad, contarLiterales(sop), pos->cantidad, contarLiterales(pos));
 }
 
-void generarCircuito(int n, int salida[]) {
-    printf("\n" GREEN "=== IMPLEMENTACIÓN EN CIRCUITO LÓGICO ===" RESET "\n");
-    printf("Para implementar esta expresión necesitará:\n");
-    
-    int filas = (1 << n);
-    int terminos = 0;
+void generarCircuito(FILE *f, const TablaVerdad *t, const Cobertura *sop) {
+    int n = t->n;
+
+    fprintf(f, "\n%s=== IMPLEMENTACIÓN EN CIRCUITO LÓGICO ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    fprintf(f, "Para implementar esta expresión necesitará:\n");
     
-    for (int i = 0; i < filas; i++) {
-        if (salida[i] == 1) terminos++;
-    }
+    size_t terminos = sop->cantidad;
     
     if (terminos == 0) {
-        printf("- No se requieren compuertas (salida siempre 0)\n");
+        fprintf(f, "- No se requieren compuertas (salida siempre 0)\n");
+        return;
+    }
+    if (terminos == 1 && sop->cubos[0].cuidado == 0) {
+        fprintf(f, "- No se requieren compuertas (salida siempre 1)\n");
         return;
     }
     
-    printf("- %d compuertas AND de %d entradas\n", terminos, n);
-    printf("- %d compuertas NOT (según necesidad)\n", n);
+    // Compuertas AND agrupadas por número de entradas; los términos de un
+    // solo literal van directo a la OR. Cada variable negada usa un NOT.
+    size_t andsPorEntradas[MAX_VARIABLES + 1] = {0};
+    uint32_t negadas = 0;
+    size_t totalAnd = 0;
+    for (size_t i = 0; i < terminos; i++) {
+        Cubo c = sop->cubos[i];
+        int lit = literalesCubo(c);
+        if (lit >= 2) {
+            andsPorEntradas[lit]++;
+            totalAnd++;
+        }
+        negadas |= c.cuidado & ~c.valor;
+    }
+    int totalNot = __builtin_popcount(negadas);
+
+    for (int k = n; k >= 2; k--) {
+        if (andsPorEntradas[k] > 0) {
+            fprintf(f, "- %zu compuerta%s AND de %d entradas\n", andsPorEntradas[k],
+                   andsPorEntradas[k] == 1 ? "" : "s", k);
+        }
+    }
+    fprintf(f, "- %d compuertas NOT\n", totalNot);
     if (terminos > 1) {
-        printf("- 1 compuerta OR de %d entradas\n", terminos);
+        fprintf(f, "- 1 compuerta OR de %zu entradas\n", terminos);
     }
+    fprintf(f, "Total: %zu compuertas (%zu AND, %d NOT, %d OR)\n",
+           totalAnd + (size_t)totalNot + (terminos > 1), totalAnd, totalNot, terminos > 1);
     
-    printf("\nEstructura del circuito:\n");
-    printf("1. Entradas: ");
+    fprintf(f, "\nEstructura del circuito:\n");
+    fprintf(f, "1. Entradas: ");
     for (int i = 0; i < n; i++) {
-        printf("%c ", 'A' + i);
+        fprintf(f, "%c ", 'A' + i);
+    }
+    fprintf(f, "\n2. Compuertas NOT para generar complementos\n");
+    fprintf(f, "3. Compuertas AND para cada término del SOP minimizado\n");
+    fprintf(f, "4. Compuerta OR final para sumar productos\n");
+}
+
+// Término AND de la netlist y las salidas que lo usan
+typedef struct {
+    Cubo cubo;
+    int salida;
+} UsoCubo;
+
+static int compararUsos(const void *a, const void *b) {
+    const UsoCubo *x = a, *y = b;
+    int lx = literalesCubo(x->cubo), ly = literalesCubo(y->cubo);
+    if (lx != ly) return ly - lx;
+    if (x->cubo.cuidado != y->cubo.cuidado) return (x->cubo.cuidado > y->cubo.cuidado) ? -1 : 1;
+    if (x->cubo.valor != y->cubo.valor) return (x->cubo.valor > y->cubo.valor) ? -1 : 1;
+    return x->salida - y->salida;
+}
+
+static int mismoCubo(Cubo a, Cubo b) {
+    return a.valor == b.valor && a.cuidado == b.cuidado;
+}
+
+// Imprime la red de la entrada de una compuerta: "A" o "nA" (salida del NOT)
+static void imprimirLiteralRed(FILE *f, int n, Cubo c, int v) {
+    uint32_t b = 1u << (n - 1 - v);
+    fprintf(f, "%s%c", (c.valor & b) ? "" : "n", 'A' + v);
+}
+
+// Netlist única para varias salidas: un NOT por variable negada y una AND
+// por término distinto, aunque lo usen varias salidas
+void generarCircuitoMultisalida(FILE *f, int n, int m, const Cobertura *coberturas) {
+    size_t total = 0;
+    for (int k = 0; k < m; k++) total += coberturas[k].cantidad;
+    UsoCubo *usos = malloc((total ? total : 1) * sizeof(UsoCubo));
+    size_t *idGate = malloc((total ? total : 1) * sizeof(size_t));
+    if (usos == NULL || idGate == NULL) {
+        free(usos);
+        free(idGate);
+        fprintf(stderr, "Error: No hay memoria para la netlist\n");
+        return;
+    }
+
+    // Costo sin compartir: cada salida con sus propias compuertas
+    size_t sinCompartir = 0, entradasSinCompartir = 0, numUsos = 0;
+    uint32_t negadasGlobal = 0;
+    for (int k = 0; k < m; k++) {
+        uint32_t negadas = 0;
+        for (size_t i = 0; i < coberturas[k].cantidad; i++) {
+            Cubo c = coberturas[k].cubos[i];
+            int lit = literalesCubo(c);
+            negadas |= c.cuidado & ~c.valor;
+            if (lit >= 2) {
+                sinCompartir++;
+                entradasSinCompartir += (size_t)lit;
+                usos[numUsos].cubo = c;
+                usos[numUsos].salida = k;
+                numUsos++;
+            }
+        }
+        if (coberturas[k].cantidad > 1) {
+            sinCompartir++;
+            entradasSinCompartir += coberturas[k].cantidad;
+        }
+        sinCompartir += (size_t)__builtin_popcount(negadas);
+        entradasSinCompartir += (size_t)__builtin_popcount(negadas);
+        negadasGlobal |= negadas;
+    }
+    if (numUsos > 1) qsort(usos, numUsos, sizeof(UsoCubo), compararUsos);
+
+    fprintf(f, "\n%s=== CIRCUITO MULTISALIDA (NETLIST) ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    for (int v = 0; v < n; v++) {
+        if (negadasGlobal & (1u << (n - 1 - v))) fprintf(f, "n%c = NOT(%c)\n", 'A' + v, 'A' + v);
+    }
+
+    // Una AND por cubo distinto; se anotan las salidas que la comparten
+    size_t numAnd = 0, compartidas = 0, entradas = (size_t)__builtin_popcount(negadasGlobal);
+    for (size_t i = 0; i < numUsos; ) {
+        size_t j = i;
+        while (j < numUsos && mismoCubo(usos[j].cubo, usos[i].cubo)) j++;
+        numAnd++;
+        entradas += (size_t)literalesCubo(usos[i].cubo);
+        if (j - i > 1) compartidas++;
+        fprintf(f, "g%zu = AND(", numAnd);
+        int primero = 1;
+        for (int v = 0; v < n; v++) {
+            if (!(usos[i].cubo.cuidado & (1u << (n - 1 - v)))) continue;
+            if (!primero) fprintf(f, ", ");
+            imprimirLiteralRed(f, n, usos[i].cubo, v);
+            primero = 0;
+        }
+        fprintf(f, ")   [");
+        for (size_t k = i; k < j; k++) {
+            idGate[k] = numAnd;
+            fprintf(f, "%sF%d", k > i ? ", " : "", usos[k].salida + 1);
+        }
+        fprintf(f, "]\n");
+        i = j;
     }
-    printf("\n2. Compuertas NOT para generar complementos\n");
-    printf("3. Compuertas AND para cada mintérmino\n");
-    printf("4. Compuerta OR final para sumar productos\n");
+
+    // Una OR por salida con más de un término
+    size_t numOr = 0;
+    for (int k = 0; k < m; k++) {
+        const Cobertura *c = &coberturas[k];
+        fprintf(f, "F%d = ", k + 1);
+        if (c->cantidad == 0) { fprintf(f, "0\n"); continue; }
+        if (c->cantidad == 1 && c->cubos[0].cuidado == 0) { fprintf(f, "1\n"); continue; }
+        if (c->cantidad > 1) {
+            fprintf(f, "OR(");
+            numOr++;
+            entradas += c->cantidad;
+        }
+        for (size_t i = 0; i < c->cantidad; i++) {
+            Cubo cubo = c->cubos[i];
+            if (i > 0) fprintf(f, ", ");
+            if (literalesCubo(cubo) == 1) {
+                imprimirLiteralRed(f, n, cubo, n - 1 - __builtin_ctz(cubo.cuidado));
+                continue;
+            }
+            for (size_t u = 0; u < numUsos; u++) {
+                if (usos[u].salida == k && mismoCubo(usos[u].cubo, cubo)) {
+                    fprintf(f, "g%zu", idGate[u]);
+                    break;
+                }
+            }
+        }
+        fprintf(f, c->cantidad > 1 ? ")\n" : "\n");
+    }
+
+    size_t totalNot = (size_t)__builtin_popcount(negadasGlobal);
+    size_t totalGates = totalNot + numAnd + numOr;
+    fprintf(f, "\nResumen del circuito:\n");
+    fprintf(f, "- %zu compuertas NOT (compartidas por todas las salidas)\n", totalNot);
+    fprintf(f, "- %zu compuertas AND (%zu compartidas entre salidas)\n", numAnd, compartidas);
+    fprintf(f, "- %zu compuertas OR\n", numOr);
+    fprintf(f, "Total: %zu compuertas, %zu entradas de compuerta\n", totalGates, entradas);
+    fprintf(f, "Sin compartir: %zu compuertas, %zu entradas (ahorro: %zu compuertas)\n",
+            sinCompartir, entradasSinCompartir, sinCompartir - totalGates);
+
+    free(usos);
+    free(idGate);
 }
 
-int main() {
+// Sintetiza juntas las salidas de un diseño e imprime expresiones y netlist
+static int procesarDiseno(FILE *f, const TablaVerdad *salidas, int m, size_t numero,
+                          const char *origen, const OpcionesLote *op) {
+    int n = salidas[0].n;
+    fprintf(f, "\n%s##### DISEÑO %zu (%s, %d salidas, %d variables) #####%s\n", colorSalida(BLUE),
+            numero, origen, m, n, colorSalida(RESET));
+
+    Cobertura *cob = calloc((size_t)m, sizeof(Cobertura));
+    if (cob == NULL || !minimizarMultisalida(salidas, m, op->modo, cob)) {
+        fprintf(stderr, "Error: No hay memoria para sintetizar el diseño %zu\n", numero);
+        if (cob) for (int k = 0; k < m; k++) liberarCobertura(&cob[k]);
+        free(cob);
+        return 0;
+    }
+
+    fprintf(f, "\n%s=== EXPRESIONES MINIMIZADAS ===%s\n", colorSalida(GREEN), colorSalida(RESET));
+    for (int k = 0; k < m; k++) {
+        fprintf(f, "F%d = ", k + 1);
+        for (size_t i = 0; i < cob[k].cantidad; i++) {
+            if (i > 0) fprintf(f, " + ");
+            if (cob[k].cubos[i].cuidado == 0) { fprintf(f, "1"); continue; }
+            fprintf(f, "(");
+            imprimirCubo(f, n, cob[k].cubos[i], 0);
+            fprintf(f, ")");
+        }
+        if (cob[k].cantidad == 0) fprintf(f, "0");
+        fprintf(f, "\n");
+    }
+    if (op->conTabla) {
+        for (int k = 0; k < m; k++) imprimirTabla(f, &salidas[k]);
+    }
+    if (op->conCircuito) generarCircuitoMultisalida(f, n, m, cob);
+
+    for (int k = 0; k < m; k++) liberarCobertura(&cob[k]);
+    free(cob);
+    return 1;
+}
+
+// Reporte de una función representada como BDD
+static int procesarBDD(FILE *f, Bdd *b, NodoBDD raiz, const OpcionesLote *op) {
+    if (op->sifting && !bddReordenarSifting(b, &raiz)) return 0;
+    generarExpresionBDD(f, b, raiz, op->modo);
+    if (op->conTabla) imprimirTablaBDD(f, b, raiz);
+    if (op->conCircuito) generarCircuitoBDD(f, b, raiz);
+    return 1;
+}
+
+// Minimiza una función e imprime su reporte en f (usada por el modo por lotes)
+int procesarFuncion(FILE *f, const TablaVerdad *t, size_t numero, const char *origen, const OpcionesLote *op) {
+    fprintf(f, "\n%s##### FUNCIÓN %zu (%s, %d variables) #####%s\n", colorSalida(BLUE),
+            numero, origen, t->n, colorSalida(RESET));
+
+    if (op->bdd) {
+        // Las filas indiferentes se toman como 0
+        Bdd b;
+        int ok = bddCrear(&b, t->n, NULL);
+        NodoBDD raiz = ok ? bddDesdeTabla(&b, t) : BDD_FALSO;
+        ok = ok && !b.excedido && procesarBDD(f, &b, raiz, op);
+        if (!ok) fprintf(stderr, "Error: No hay memoria para el BDD de la función %zu\n", numero);
+        bddLiberar(&b);
+        return ok;
+    }
+
+    Cobertura sop, pos;
+    iniciarCobertura(&sop, t->n);
+    iniciarCobertura(&pos, t->n);
+    int ok = op->cache ? minimizarConCache(op->cache, t, op->modo, &sop, &pos)
+                       : minimizarSOP(t, op->modo, &sop) && minimizarPOS(t, op->modo, &pos);
+    if (ok) {
+        generarExpresion(f, t, &sop, &pos);
+        if (op->conTabla) imprimirTabla(f, t);
+        if (op->conCircuito) generarCircuito(f, t, &sop);
+    } else {
+        fprintf(stderr, "Error: No hay memoria para minimizar la función %zu\n", numero);
+    }
+    liberarCobertura(&sop);
+    liberarCobertura(&pos);
+    return ok;
+}
+
+// Construye el BDD de una expresión (admite más variables que una tabla)
+int procesarExpresion(FILE *f, const char *expresion, size_t numero, const OpcionesLote *op) {
+    int n = bddContarVariables(expresion);
+    if (n < 0) {
+        fprintf(stderr, "Error: Expresión %zu: variable fuera de rango (máximo x%d)\n",
+                numero, BDD_MAX_VARIABLES - 1);
+        return 0;
+    }
+    fprintf(f, "\n%s##### EXPRESIÓN %zu (%d variables) #####%s\n", colorSalida(BLUE), numero, n, colorSalida(RESET));
+    fprintf(f, "F = %s\n", expresion);
+
+    Bdd b;
+    NodoBDD raiz;
+    char error[96];
+    if (!bddCrear(&b, n, NULL)) {
+        fprintf(stderr, "Error: No hay memoria para el BDD de la expresión %zu\n", numero);
+        return 0;
+    }
+    int ok = bddDesdeExpresion(&b, expresion, &raiz, error, sizeof(error));
+    if (!ok) fprintf(stderr, "Error: Expresión %zu: %s\n", numero, error);
+    else ok = procesarBDD(f, &b, raiz, op);
+    bddLiberar(&b);
+    return ok;
+}
+
+// Minimiza cada función del lote y escribe su evaluador en un archivo C
+static int exportarLote(LectorFunciones *lector, const OpcionesLote *op, const char *rutaC) {
+    Exportacion e;
+    if (!iniciarExportacion(&e, rutaC)) {
+        fprintf(stderr, "Error: No se pudo crear %s\n", rutaC);
+        return 1;
+    }
+
+    size_t procesadas = 0, errores = 0;
+    TablaVerdad tabla;
+    int r;
+    while ((r = leerFuncion(lector, &tabla)) != 0) {
+        if (r < 0) {
+            errores++;
+            continue;
+        }
+        procesadas++;
+        Cobertura sop;
+        if (minimizarSOP(&tabla, op->modo, &sop) && exportarEvaluador(&e, &tabla, &sop, procesadas)) {
+            printf("F%zu (%s): evaluar_f%zu, %zu términos\n", procesadas, lector->origen,
+                   procesadas, sop.cantidad);
+        } else {
+            fprintf(stderr, "Error: No se pudo exportar la función %zu\n", procesadas);
+            errores++;
+        }
+        liberarCobertura(&sop);
+        liberarTabla(&tabla);
+    }
+    if (!terminarExportacion(&e)) {
+        fprintf(stderr, "Error: No se pudo escribir %s\n", rutaC);
+        errores++;
+    }
+
+    fprintf(stderr, "Funciones exportadas a %s: %zu, con errores: %zu\n", rutaC, procesadas, errores);
+    return errores > 0;
+}
+
+// Procesa todas las funciones de un archivo (o stdin) sin interacción
+static int procesarLote(const char *ruta, const OpcionesLote *op, int benchHilos, const char *rutaC) {
+    LectorFunciones lector;
+    if (!abrirLector(&lector, ruta, op->formato)) {
+        fprintf(stderr, "Error: No se pudo abrir %s\n", ruta ? ruta : "stdin");
+        return 1;
+    }
+
+    if (rutaC) {
+        int r = exportarLote(&lector, op, rutaC);
+        cerrarLector(&lector);
+        return r;
+    }
+
+    if (benchHilos > 0) {
+        int r = medirEscalabilidad(&lector, op, benchHilos);
+        cerrarLector(&lector);
+        return r;
+    }
+
+    size_t procesadas = 0, errores = 0;
+    if (op->multisalida) {
+        TablaVerdad *salidas;
+        int m, r;
+        while ((r = leerDiseno(&lector, &salidas, &m)) != 0) {
+            if (r < 0) errores++;
+            if (m == 0) continue;
+            procesadas++;
+            if (!procesarDiseno(stdout, salidas, m, procesadas, lector.origen, op)) errores++;
+            for (int k = 0; k < m; k++) liberarTabla(&salidas[k]);
+            free(salidas);
+        }
+    } else if (op->hilos > 1) {
+        if (!procesarLoteParalelo(&lector, op, &procesadas, &errores)) errores++;
+    } else {
+        TablaVerdad tabla;
+        int r;
+        while ((r = leerFuncion(&lector, &tabla)) != 0) {
+            if (r < 0) {
+                errores++;
+                continue;
+            }
+            procesadas++;
+            if (!procesarFuncion(stdout, &tabla, procesadas, lector.origen, op)) errores++;
+            liberarTabla(&tabla);
+        }
+    }
+    cerrarLector(&lector);
+
+    fprintf(stderr, "Funciones procesadas: %zu, con errores: %zu\n", procesadas, errores);
+    return errores > 0;
+}
+
+static double segundosDesde(const struct timespec *inicio) {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (double)(ahora.tv_sec - inicio->tv_sec) + (double)(ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Verdadero si la cobertura cubre exactamente las filas ON (más indiferentes)
+static int coberturaValida(const CoberturaIncremental *ci, size_t palabras) {
+    int n = ci->cobertura.n, ok = 1;
+    uint64_t *cubierto = calloc(palabras, sizeof(uint64_t));
+    if (cubierto == NULL) return 0;
+    for (size_t i = 0; ok && i < ci->cobertura.cantidad; i++) {
+        ok = cuboContenido(n, ci->cobertura.cubos[i], ci->permitido);
+        marcarCubo(n, ci->cobertura.cubos[i], cubierto);
+    }
+    for (size_t w = 0; ok && w < palabras; w++) ok = (ci->on[w] & ~cubierto[w]) == 0;
+    free(cubierto);
+    return ok;
+}
+
+// Compara la latencia de editar filas sueltas contra minimizar de nuevo
+// la SOP y la POS completas, para n = 12..20
+static int medirIncremental(void) {
+    const int ediciones = 200;
+    unsigned semilla = 12345;
+    int errores = 0;
+
+    printf("%3s | %12s | %12s | %10s | %16s | %16s\n", "n", "Completa (ms)", "Edición (us)",
+           "Aceleración", "SOP incremental", "SOP completa");
+    for (int n = 12; n <= 20; n++) {
+        // Función estructurada: unión de 3n cubos aleatorios de n/2 literales
+        TablaVerdad t;
+        if (!crearTabla(&t, n)) return 1;
+        for (int k = 0; k < 3 * n; k++) {
+            Cubo c = { 0, 0 };
+            while (literalesCubo(c) < n / 2) c.cuidado |= 1u << (rand_r(&semilla) % n);
+            c.valor = (uint32_t)rand_r(&semilla) & c.cuidado;
+            marcarCubo(n, c, t.bits);
+        }
+
+        struct timespec inicio;
+        Cobertura sop, pos;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        int ok = minimizarSOP(&t, MINIMIZAR_AUTO, &sop) && minimizarPOS(&t, MINIMIZAR_AUTO, &pos);
+        double completa = segundosDesde(&inicio);
+        liberarCobertura(&sop);
+        liberarCobertura(&pos);
+
+        FuncionIncremental fi;
+        ok = ok && iniciarIncremental(&fi, &t, MINIMIZAR_AUTO);
+        if (!ok) {
+            liberarTabla(&t);
+            fprintf(stderr, "Error: No hay memoria para n = %d\n", n);
+            return 1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        for (int e = 0; e < ediciones; e++) {
+            size_t fila = (size_t)rand_r(&semilla) & (numFilas(&t) - 1);
+            if (!cambiarFila(&fi, fila, !obtenerSalida(&fi.tabla, fila))) ok = 0;
+        }
+        double edicion = segundosDesde(&inicio) / ediciones;
+        ok = ok && coberturaValida(&fi.sop, t.palabras) && coberturaValida(&fi.pos, t.palabras);
+
+        // Referencia: minimización completa de la tabla ya editada
+        Cobertura final;
+        if (!minimizarSOP(&fi.tabla, MINIMIZAR_AUTO, &final)) ok = 0;
+        printf("%3d | %12.2f | %12.2f | %9.0fx | %6zu / %7zu | %6zu / %7zu%s\n", n, completa * 1e3,
+               edicion * 1e6, completa / edicion, fi.sop.cobertura.cantidad,
+               contarLiterales(&fi.sop.cobertura), final.cantidad, contarLiterales(&final),
+               ok ? "" : "  ERROR");
+        if (!ok) errores++;
+        liberarCobertura(&final);
+        liberarIncremental(&fi);
+        liberarTabla(&t);
+    }
+    printf("(SOP: términos / literales; %d ediciones por n)\n", ediciones);
+    return errores > 0;
+}
+
+static void mostrarUso(const char *programa) {
+    printf("Uso: %s                       (modo interactivo)\n", programa);
+    printf("     %s --lote [archivo|-] [opciones]\n\n", programa);
+    printf("Opciones del modo por lotes:\n");
+    printf("  --formato auto|hex|pla|bits|bin   formato de entrada (auto por defecto)\n");
+    printf("  --exacto | --heuristico           fuerza el modo del minimizador\n");
+    printf("  --sin-tabla                       no imprime la tabla de verdad\n");
+    printf("  --sin-circuito                    no imprime el circuito\n");
+    printf("  --multisalida                     sintetiza juntas las salidas de cada diseño\n");
+    printf("                                    (bloque PLA, o líneas hasta una línea en blanco)\n");
+    printf("  --hilos N                         minimiza en N hilos (0 = todos los núcleos)\n");
+    printf("  --bench-hilos N                   mide funciones/segundo con 1..N hilos\n");
+    printf("  --bench-incremental               mide edición de filas vs. minimización completa\n");
+    printf("  --tabla normal|csv|rangos         formato de la tabla de verdad\n");
+    printf("  --color auto|si|no                colores en la salida (auto: solo en terminal)\n");
+    printf("  --exportar-c ARCHIVO.c            genera evaluadores bitsliced (64/256 vectores)\n");
+    printf("                                    con benchmark opcional (-DEVALUADOR_BENCH)\n");
+    printf("  --cache ARCHIVO                   reutiliza minimizaciones de funciones NPN-equivalentes\n");
+    printf("  --bdd                             representa cada función con un BDD\n");
+    printf("  --sifting                         reordena las variables del BDD (sifting)\n");
+    printf("     %s --expr \"AB' + C^x30\" [--expr ...] [opciones]\n", programa);
+    printf("                                    procesa expresiones con BDD (hasta %d variables)\n",
+           BDD_MAX_VARIABLES);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        const char *ruta = NULL;
+        OpcionesLote op = { FORMATO_AUTO, MINIMIZAR_AUTO, 1, 1, 1, 0, 0, 0, NULL };
+        int lote = 0, benchHilos = 0;
+        const char *rutaC = NULL, *rutaCache = NULL;
+        FormatoTabla formatoTabla = TABLA_NORMAL;
+        int colores = -1;
+        const char **expresiones = calloc((size_t)argc, sizeof(char *));
+        size_t numExpresiones = 0;
+
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--lote") == 0) {
+                lote = 1;
+                if (i + 1 < argc && argv[i + 1][0] != '-') ruta = argv[++i];
+                else if (i + 1 < argc && strcmp(argv[i + 1], "-") == 0) ruta = argv[++i];
+            } else if (strcmp(argv[i], "--formato") == 0 && i + 1 < argc) {
+                const char *f = argv[++i];
+                if (strcmp(f, "hex") == 0) op.formato = FORMATO_HEX;
+                else if (strcmp(f, "pla") == 0) op.formato = FORMATO_PLA;
+                else if (strcmp(f, "bits") == 0) op.formato = FORMATO_BITS;
+                else if (strcmp(f, "bin") == 0) op.formato = FORMATO_BIN;
+                else if (strcmp(f, "auto") != 0) { mostrarUso(argv[0]); return 1; }
+            } else if (strcmp(argv[i], "--exacto") == 0) {
+                op.modo = MINIMIZAR_EXACTO;
+            } else if (strcmp(argv[i], "--heuristico") == 0) {
+                op.modo = MINIMIZAR_HEURISTICO;
+            } else if (strcmp(argv[i], "--sin-tabla") == 0) {
+                op.conTabla = 0;
+            } else if (strcmp(argv[i], "--sin-circuito") == 0) {
+                op.conCircuito = 0;
+            } else if (strcmp(argv[i], "--multisalida") == 0) {
+                op.multisalida = 1;
+            } else if (strcmp(argv[i], "--hilos") == 0 && i + 1 < argc) {
+                op.hilos = atoi(argv[++i]);
+                if (op.hilos <= 0) op.hilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+                if (op.hilos > MAX_HILOS) op.hilos = MAX_HILOS;
+            } else if (strcmp(argv[i], "--bench-hilos") == 0 && i + 1 < argc) {
+                benchHilos = atoi(argv[++i]);
+                if (benchHilos <= 0) benchHilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+                if (benchHilos > MAX_HILOS) benchHilos = MAX_HILOS;
+            } else if (strcmp(argv[i], "--bench-incremental") == 0) {
+                free(expresiones);
+                return medirIncremental();
+            } else if (strcmp(argv[i], "--tabla") == 0 && i + 1 < argc) {
+                const char *t = argv[++i];
+                if (strcmp(t, "csv") == 0) formatoTabla = TABLA_CSV;
+                else if (strcmp(t, "rangos") == 0) formatoTabla = TABLA_RANGOS;
+                else if (strcmp(t, "normal") != 0) { mostrarUso(argv[0]); free(expresiones); return 1; }
+            } else if (strcmp(argv[i], "--color") == 0 && i + 1 < argc) {
+                const char *c = argv[++i];
+                if (strcmp(c, "si") == 0) colores = 1;
+                else if (strcmp(c, "no") == 0) colores = 0;
+                else if (strcmp(c, "auto") != 0) { mostrarUso(argv[0]); free(expresiones); return 1; }
+            } else if (strcmp(argv[i], "--exportar-c") == 0 && i + 1 < argc) {
+                rutaC = argv[++i];
+            } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                rutaCache = argv[++i];
+            } else if (strcmp(argv[i], "--bdd") == 0) {
+                op.bdd = 1;
+            } else if (strcmp(argv[i], "--sifting") == 0) {
+                op.sifting = 1;
+            } else if (strcmp(argv[i], "--expr") == 0 && i + 1 < argc && expresiones) {
+                expresiones[numExpresiones++] = argv[++i];
+            } else {
+                mostrarUso(argv[0]);
+                free(expresiones);
+                return 1;
+            }
+        }
+        configurarTabla(formatoTabla, colores);
+        if (numExpresiones == 0 && !lote) {
+            mostrarUso(argv[0]);
+            free(expresiones);
+            return 1;
+        }
+        CacheNPN cache;
+        if (rutaCache != NULL) {
+            if (!abrirCacheNPN(&cache, rutaCache)) {
+                fprintf(stderr, "Error: No se pudo abrir el cache '%s'\n", rutaCache);
+                free(expresiones);
+                return 1;
+            }
+            op.cache = &cache;
+        }
+
+        int errores = 0;
+        for (size_t k = 0; k < numExpresiones; k++) {
+            if (!procesarExpresion(stdout, expresiones[k], k + 1, &op)) errores = 1;
+        }
+        free(expresiones);
+        if (lote && procesarLote(ruta, &op, benchHilos, rutaC)) errores = 1;
+
+        if (op.cache != NULL) {
+            fprintf(stderr, "Cache NPN: %zu aciertos, %zu fallos, %zu entradas\n",
+                    cache.aciertos, cache.fallos, entradasCacheNPN(&cache));
+            cerrarCacheNPN(&cache);
+        }
+        return errores;
+    }
+
     system("clear"); // Para limpiar pantalla
     mostrarCaratula();
 
     int numVars = obtenerNumVariables();
-    int filas = (1 << numVars);
-    int salida[filas];
+    TablaVerdad tabla;
+    if (!crearTabla(&tabla, numVars)) {
+        printf(RED "Error: No hay memoria para la tabla de verdad.\n" RESET);
+        return 1;
+    }
+
+    ingresarTabla(&tabla);
 
-    ingresarTabla(numVars, salida);
-    generarExpresion(numVars, salida);
-    imprimirTabla(numVars, salida);
-    generarCircuito(numVars, salida);
+    FuncionIncremental funcion;
+    if (!iniciarIncremental(&funcion, &tabla, MINIMIZAR_AUTO)) {
+        printf(RED "Error: No hay memoria para minimizar la función.\n" RESET);
+        return 1;
+    }
+    liberarTabla(&tabla);
+    generarExpresion(stdout, &funcion.tabla, &funcion.sop.cobertura, &funcion.pos.cobertura);
+    imprimirTabla(stdout, &funcion.tabla);
+    generarCircuito(stdout, &funcion.tabla, &funcion.sop.cobertura);
+
+    // Cambios sueltos: se reminimiza solo alrededor de la fila editada
+    for (;;) {
+        long fila;
+        char valor[8];
+        printf("\nFila a cambiar y nuevo valor (ej. 5 X), o -1 para terminar: ");
+        if (scanf("%ld", &fila) != 1 || fila < 0) break;
+        if (scanf("%7s", valor) != 1) break;
+        int v = (valor[0] == 'x' || valor[0] == 'X') ? FILA_INDIFERENTE : valor[0] == '1';
+        if ((size_t)fila >= numFilas(&funcion.tabla) || !strchr("01xX", valor[0]) || valor[1] != '\0') {
+            printf(RED "Error: Fila de 0 a %zu y valor 0, 1 o X.\n" RESET, numFilas(&funcion.tabla) - 1);
+            continue;
+        }
+        if (!cambiarFila(&funcion, (size_t)fila, v)) {
+            printf(RED "Error: No hay memoria para reminimizar la función.\n" RESET);
+            break;
+        }
+        ordenarIncremental(&funcion);
+        generarExpresion(stdout, &funcion.tabla, &funcion.sop.cobertura, &funcion.pos.cobertura);
+        generarCircuito(stdout, &funcion.tabla, &funcion.sop.cobertura);
+    }
+    liberarIncremental(&funcion);
 
     printf("\n" GREEN "Proyecto completado exitosamente." RESET "\n");
     printf("Presione Enter para salir...");
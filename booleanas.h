@@ -1,6 +1,11 @@
 #ifndef BOOLEANAS_H
 #define BOOLEANAS_H
 
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
 // Definición de colores ANSI
 #define RESET   "\033[0m"
 #define GREEN   "\033[0;32m"
@@ -8,12 +13,214 @@
 #define BLUE    "\033[0;34m"
 #define YELLOW  "\033[0;33m"
 
+// Rango de variables admitido (A..X)
+#define MIN_VARIABLES 1
+#define MAX_VARIABLES 24
+
+// Tabla de verdad empaquetada: un bit por fila, 64 filas por palabra.
+// La fila i tiene a la variable A en su bit más significativo, igual que
+// la tabla original de enteros. Los bits sobrantes de la última palabra
+// (cuando n < 6) se mantienen siempre en 0.
+typedef struct {
+    int n;                  // número de variables
+    size_t palabras;        // cantidad de palabras de 64 bits
+    uint64_t *bits;         // bit (fila % 64) de bits[fila / 64] = salida
+    uint64_t *indiferentes; // filas "no importa" (NULL si no hay ninguna)
+} TablaVerdad;
+
+// Cubo (término producto) en representación de máscaras: el bit p de
+// 'cuidado' indica que la variable de ese bit del índice de fila aparece
+// como literal, y el mismo bit de 'valor' indica si aparece sin negar.
+typedef struct {
+    uint32_t valor;
+    uint32_t cuidado;
+} Cubo;
+
+// Lista de cubos que cubre una función (SOP) o su complemento (POS)
+typedef struct {
+    int n;
+    size_t cantidad;
+    size_t capacidad;
+    Cubo *cubos;
+} Cobertura;
+
+// Modos del minimizador de dos niveles
+typedef enum {
+    MINIMIZAR_AUTO,         // exacto hasta UMBRAL_EXACTO variables
+    MINIMIZAR_EXACTO,       // Quine-McCluskey + cobertura
+    MINIMIZAR_HEURISTICO    // expandir/irredundante/reducir (tipo Espresso)
+} ModoMinimizacion;
+
+#define UMBRAL_EXACTO 12
+#define MAX_PARES_MULTISALIDA 32    // salidas hasta las que se prueban productos f_i·f_j
+
+// Formatos de entrada del modo por lotes
+typedef enum {
+    FORMATO_AUTO,   // PLA si empieza con '.', hexadecimal si lo parece, si no bits
+    FORMATO_HEX,    // [n:][0x]HEX, el bit i del número es la fila i
+    FORMATO_PLA,    // .i/.o/.type fd|fr, cubos "01-1 1", .e
+    FORMATO_BITS,   // una línea de 0/1/X por función, fila 0 primero
+    FORMATO_BIN     // registros binarios: 1 byte n + 2^n bits empaquetados
+} FormatoEntrada;
+
+#define TAM_BUFFER_LECTURA (1 << 20)
+
+// Lector de funciones con lecturas en bloque (fread) en lugar de scanf
+typedef struct {
+    FILE *archivo;
+    FormatoEntrada formato;
+    char *buffer;           // bloque leído del archivo
+    size_t inicio, fin;     // porción aún sin consumir del bloque
+    char *linea;            // línea actual (crece según haga falta)
+    size_t capLinea;
+    size_t numLinea;
+    int lineaDevuelta;      // la próxima lectura repite la línea actual
+    int finArchivo;
+    TablaVerdad *salidasPLA;    // salidas pendientes del último bloque PLA
+    int numSalidasPLA;
+    int sigSalidaPLA;
+    char origen[64];            // descripción de la última función leída
+} LectorFunciones;
+
+// Operaciones sobre la tabla empaquetada
+int crearTabla(TablaVerdad *t, int n);
+void liberarTabla(TablaVerdad *t);
+size_t numFilas(const TablaVerdad *t);
+int obtenerSalida(const TablaVerdad *t, size_t fila);
+void asignarSalida(TablaVerdad *t, size_t fila, int valor);
+int esIndiferente(const TablaVerdad *t, size_t fila);
+int asignarIndiferente(TablaVerdad *t, size_t fila);
+size_t contarMinterminos(const TablaVerdad *t);
+uint64_t mascaraVariable(int n, int var, size_t palabra);
+void complementarTabla(TablaVerdad *dst, const TablaVerdad *a);
+void andTablas(TablaVerdad *dst, const TablaVerdad *a, const TablaVerdad *b);
+void orTablas(TablaVerdad *dst, const TablaVerdad *a, const TablaVerdad *b);
+void xorTablas(TablaVerdad *dst, const TablaVerdad *a, const TablaVerdad *b);
+
+// Cubos y coberturas (minimizador.c)
+void iniciarCobertura(Cobertura *c, int n);
+int agregarCubo(Cobertura *c, Cubo cubo);
+void liberarCobertura(Cobertura *c);
+int literalesCubo(Cubo cubo);
+size_t contarLiterales(const Cobertura *c);
+int cuboContenido(int n, Cubo cubo, const uint64_t *conjunto);
+int cuboInterseca(int n, Cubo cubo, const uint64_t *conjunto);
+void marcarCubo(int n, Cubo cubo, uint64_t *conjunto);
+void ordenarCobertura(Cobertura *c);
+
+// Minimizador de dos niveles con soporte de indiferentes (minimizador.c)
+int minimizarSOP(const TablaVerdad *t, ModoMinimizacion modo, Cobertura *sop);
+int minimizarPOS(const TablaVerdad *t, ModoMinimizacion modo, Cobertura *pos);
+int minimizarMultisalida(const TablaVerdad *salidas, int m, ModoMinimizacion modo, Cobertura *coberturas);
+
+// Reminimización incremental tras cambiar filas sueltas (minimizador.c)
+#define FILA_INDIFERENTE 2      // valor de cambiarFila para una fila "no importa"
+
+typedef struct {
+    uint64_t *on;           // filas que hay que cubrir
+    uint64_t *permitido;    // filas que se pueden cubrir (ON o indiferentes)
+    uint8_t *cuenta;        // cubos que cubren cada fila ON (saturado en 255)
+    Cobertura cobertura;
+} CoberturaIncremental;
+
+typedef struct {
+    TablaVerdad tabla;
+    CoberturaIncremental sop;   // cubre los 1
+    CoberturaIncremental pos;   // cubre los 0 (De Morgan al imprimir)
+} FuncionIncremental;
+
+int iniciarIncremental(FuncionIncremental *fi, const TablaVerdad *t, ModoMinimizacion modo);
+int cambiarFila(FuncionIncremental *fi, size_t fila, int valor);
+void ordenarIncremental(FuncionIncremental *fi);
+void liberarIncremental(FuncionIncremental *fi);
+
+// Formas canónicas NPN y cache persistente de coberturas (npn.c)
+#define MAX_VARIABLES_NPN_EXACTO 6  // hasta aquí la forma canónica es exacta
+
+typedef struct {
+    TablaVerdad tabla;          // función canónica
+    int origen[MAX_VARIABLES];  // variable original de cada variable canónica
+    uint32_t negadas;           // bit j: la variable canónica j es la original negada
+    int salidaNegada;
+    uint64_t hash;
+} FormaNPN;
+
+typedef struct {
+    int fd;
+    unsigned char *mapa;        // archivo completo mapeado en memoria
+    size_t tamMapa;
+    pthread_mutex_t cerrojo;
+    size_t aciertos;
+    size_t fallos;
+} CacheNPN;
+
+int formaCanonicaNPN(const TablaVerdad *t, FormaNPN *forma);
+void liberarFormaNPN(FormaNPN *forma);
+int abrirCacheNPN(CacheNPN *c, const char *ruta);
+size_t entradasCacheNPN(CacheNPN *c);
+void cerrarCacheNPN(CacheNPN *c);
+int minimizarConCache(CacheNPN *c, const TablaVerdad *t, ModoMinimizacion modo, Cobertura *sop, Cobertura *pos);
+
+// Opciones del modo por lotes
+typedef struct {
+    FormatoEntrada formato;
+    ModoMinimizacion modo;
+    int conTabla;
+    int conCircuito;
+    int hilos;              // 1 = secuencial
+    int multisalida;        // sintetiza juntas las salidas de cada diseño
+    int bdd;                // representa cada función con un BDD (bdd.c)
+    int sifting;            // reordena las variables del BDD antes de imprimir
+    CacheNPN *cache;        // coberturas ya minimizadas por clase NPN (NULL = sin cache)
+} OpcionesLote;
+
+// Lectura por lotes (lotes.c)
+int abrirLector(LectorFunciones *l, const char *ruta, FormatoEntrada formato);
+int leerFuncion(LectorFunciones *l, TablaVerdad *t);
+int leerDiseno(LectorFunciones *l, TablaVerdad **salidas, int *m);
+void cerrarLector(LectorFunciones *l);
+
+// Procesamiento paralelo por lotes (hilos.c)
+#define MAX_HILOS 256
+int procesarLoteParalelo(LectorFunciones *l, const OpcionesLote *op, size_t *procesadas, size_t *errores);
+int medirEscalabilidad(LectorFunciones *l, const OpcionesLote *op, int maxHilos);
+
+// Impresión de tablas de verdad (salida.c)
+#define TAM_BUFFER_TABLA (1 << 20)
+
+typedef enum {
+    TABLA_NORMAL,   // una fila por línea, con mintérminos
+    TABLA_CSV,      // A,B,...,salida
+    TABLA_RANGOS    // solo los rangos de filas en 1 ("m0–m1023")
+} FormatoTabla;
+
+void configurarTabla(FormatoTabla formato, int colores);
+const char *colorSalida(const char *codigo);
+
+// Exportación de evaluadores en C (exportar.c)
+#define MAX_VARIABLES_TABLA_EXPORTADA 20    // hasta aquí se embebe la tabla para el benchmark
+
+typedef struct {
+    FILE *archivo;
+    size_t cantidad;
+    size_t capacidad;
+    int *numVars;           // variables de cada función exportada
+    int *conTabla;          // 1 si se embebió su tabla
+} Exportacion;
+
+int iniciarExportacion(Exportacion *e, const char *ruta);
+int exportarEvaluador(Exportacion *e, const TablaVerdad *t, const Cobertura *sop, size_t numero);
+int terminarExportacion(Exportacion *e);
+
 // Declaraciones de funciones
 void mostrarCaratula();
 int obtenerNumVariables();
-void ingresarTabla(int n, int salida[]);
-void generarExpresion(int n, int salida[]);
-void imprimirTabla(int n, int salida[]);
-void generarCircuito(int n, int salida[]);
+void ingresarTabla(TablaVerdad *t);
+void generarExpresion(FILE *f, const TablaVerdad *t, const Cobertura *sop, const Cobertura *pos);
+void imprimirTabla(FILE *f, const TablaVerdad *t);
+void generarCircuito(FILE *f, const TablaVerdad *t, const Cobertura *sop);
+void generarCircuitoMultisalida(FILE *f, int n, int m, const Cobertura *coberturas);
+int procesarFuncion(FILE *f, const TablaVerdad *t, size_t numero, const char *origen, const OpcionesLote *op);
+int procesarExpresion(FILE *f, const char *expresion, size_t numero, const OpcionesLote *op);
 
 #endif // BOOLEANAS_H
@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include "planificador.h"
+
+// Modelo de capacidad: filas = recursos x períodos, la fila del recurso r en
+// el período p es r * periodos + p. Los límites y la demanda acumulada de cada
+// fila viven acá; el catálogo avisa cada cambio con acumularDemanda.
+
+int definirModelo(ModeloCapacidad *m, int recursos, char (*nombresRecursos)[MAX_NOMBRE],
+                  int periodos, char (*nombresPeriodos)[MAX_NOMBRE]) {
+    memset(m, 0, sizeof(*m));
+    if(recursos <= 0 || periodos <= 0) return 0;
+    size_t filas = (size_t)recursos * (size_t)periodos;
+    if(filas > INT32_MAX) return 0;
+    m->nombresRecursos = malloc((size_t)recursos * sizeof(*m->nombresRecursos));
+    m->nombresPeriodos = malloc((size_t)periodos * sizeof(*m->nombresPeriodos));
+    m->limites = calloc(filas, sizeof(int64_t));
+    m->demandas = calloc(filas, sizeof(__int128));
+    if(m->nombresRecursos == NULL || m->nombresPeriodos == NULL || m->limites == NULL || m->demandas == NULL) {
+        liberarModelo(m);
+        return 0;
+    }
+    m->recursos = recursos;
+    m->periodos = periodos;
+    for(int r = 0; r < recursos; r++) snprintf(m->nombresRecursos[r], MAX_NOMBRE, "%s", nombresRecursos[r]);
+    for(int p = 0; p < periodos; p++) snprintf(m->nombresPeriodos[p], MAX_NOMBRE, "%s", nombresPeriodos[p]);
+    return 1;
+}
+
+void liberarModelo(ModeloCapacidad *m) {
+    free(m->nombresRecursos);
+    free(m->nombresPeriodos);
+    free(m->limites);
+    free(m->demandas);
+    memset(m, 0, sizeof(*m));
+}
+
+int filasModelo(const ModeloCapacidad *m) {
+    return m->recursos * m->periodos;
+}
+
+// Busca por número (desde 1) o por nombre sin distinguir mayúsculas; -1 si no está
+static int buscarNombre(char (*nombres)[MAX_NOMBRE], int n, const char *texto) {
+    char *fin;
+    long numero = strtol(texto, &fin, 10);
+    if(fin != texto && *fin == '\0') return (numero >= 1 && numero <= n) ? (int)numero - 1 : -1;
+    for(int i = 0; i < n; i++) {
+        if(strcasecmp(nombres[i], texto) == 0) return i;
+    }
+    return -1;
+}
+
+int buscarRecurso(const ModeloCapacidad *m, const char *texto) {
+    return buscarNombre(m->nombresRecursos, m->recursos, texto);
+}
+
+int buscarPeriodo(const ModeloCapacidad *m, const char *texto) {
+    return buscarNombre(m->nombresPeriodos, m->periodos, texto);
+}
+
+// Fila de "Recurso/Período" (o "Recurso" si hay un solo período); -1 si no está
+int buscarFila(const ModeloCapacidad *m, const char *texto) {
+    char recurso[MAX_NOMBRE];
+    const char *barra = strrchr(texto, '/');
+    int p = 0;
+    if(barra == NULL) {
+        if(m->periodos != 1) return -1;
+        snprintf(recurso, sizeof(recurso), "%s", texto);
+    } else {
+        snprintf(recurso, sizeof(recurso), "%.*s", (int)(barra - texto), texto);
+        p = buscarPeriodo(m, barra + 1);
+    }
+    int r = buscarRecurso(m, recurso);
+    return (r < 0 || p < 0) ? -1 : r * m->periodos + p;
+}
+
+// "Recurso" con un solo período, "Recurso/Período" con varios
+void nombreFila(const ModeloCapacidad *m, int fila, char *salida, size_t tam) {
+    const char *recurso = m->nombresRecursos[fila / m->periodos];
+    if(m->periodos == 1) snprintf(salida, tam, "%s", recurso);
+    else snprintf(salida, tam, "%s/%s", recurso, m->nombresPeriodos[fila % m->periodos]);
+}
+
+void fijarLimite(ModeloCapacidad *m, int fila, int64_t limite) {
+    int antes = m->demandas[fila] > m->limites[fila];
+    m->limites[fila] = limite;
+    int despues = m->demandas[fila] > m->limites[fila];
+    m->excedidas += (size_t)despues - (size_t)antes;
+}
+
+// Suma (signo 1) o resta (signo -1) a las filas la demanda de un producto:
+// 'cantidad' unidades con el consumo dado. Solo toca las filas que usa.
+void acumularDemanda(ModeloCapacidad *m, int cantidad, size_t k, const ElementoConsumo *consumo, int signo) {
+    for(size_t e = 0; e < k; e++) {
+        uint32_t f = consumo[e].fila;
+        int antes = m->demandas[f] > m->limites[f];
+        m->demandas[f] += (__int128)signo * ((int64_t)cantidad * consumo[e].valor);
+        int despues = m->demandas[f] > m->limites[f];
+        m->excedidas += (size_t)despues - (size_t)antes;
+    }
+}
+
+// Demanda de la fila, saturada a INT64_MAX si no entra (y se marca 'desborde')
+int64_t demandaFila(const ModeloCapacidad *m, int fila, int *desborde) {
+    if(m->demandas[fila] > INT64_MAX) {
+        if(desborde) *desborde = 1;
+        return INT64_MAX;
+    }
+    return (int64_t)m->demandas[fila];
+}
@@ -0,0 +1,328 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "planificador.h"
+
+#define CAPACIDAD_INICIAL 16
+
+void iniciarCatalogo(Catalogo *cat) {
+    memset(cat, 0, sizeof(*cat));
+    iniciarIndice(&cat->indice);
+}
+
+// Bytes que ocupa en la arena un nombre de largo 'largo' (más su copia)
+static size_t tamEnArena(size_t largo) {
+    return 2 * (largo + 1);
+}
+
+void liberarCatalogo(Catalogo *cat) {
+    free(cat->cantidades);
+    free(cat->ganancias);
+    free(cat->inicioNombre);
+    free(cat->inicioConsumo);
+    free(cat->largoConsumo);
+    free(cat->arena);
+    free(cat->consumos);
+    liberarIndice(&cat->indice);
+    liberarModelo(&cat->modelo);
+    iniciarCatalogo(cat);
+}
+
+// Lleva todas las columnas a 'nueva' productos. Si alguna falla las que ya
+// crecieron quedan más grandes de lo necesario, lo que no es un problema.
+static int redimensionarColumnas(Catalogo *cat, size_t nueva) {
+    int *c = realloc(cat->cantidades, nueva * sizeof(int));
+    if(c == NULL) return 0;
+    cat->cantidades = c;
+    int *g = realloc(cat->ganancias, nueva * sizeof(int));
+    if(g == NULL) return 0;
+    cat->ganancias = g;
+    uint32_t *n = realloc(cat->inicioNombre, nueva * sizeof(uint32_t));
+    if(n == NULL) return 0;
+    cat->inicioNombre = n;
+    uint32_t *ic = realloc(cat->inicioConsumo, nueva * sizeof(uint32_t));
+    if(ic == NULL) return 0;
+    cat->inicioConsumo = ic;
+    uint32_t *lc = realloc(cat->largoConsumo, nueva * sizeof(uint32_t));
+    if(lc == NULL) return 0;
+    cat->largoConsumo = lc;
+    cat->capacidad = nueva;
+    return 1;
+}
+
+static int crecerColumnas(Catalogo *cat) {
+    return redimensionarColumnas(cat, cat->capacidad ? cat->capacidad * 2 : CAPACIDAD_INICIAL);
+}
+
+// Reserva lugar para 'productos' productos más, con 'bytesNombres' bytes de
+// nombres (contando los '\0') y 'elementos' elementos de consumo, para cargas
+// masivas sin realocar a mitad de camino
+int reservarCatalogo(Catalogo *cat, size_t productos, size_t bytesNombres, size_t elementos) {
+    if(cat->cantidad + productos > cat->capacidad && !redimensionarColumnas(cat, cat->cantidad + productos)) return 0;
+    size_t arena = cat->usadoArena + 2 * bytesNombres;
+    if(arena > cat->capacidadArena) {
+        char *a = realloc(cat->arena, arena);
+        if(a == NULL) return 0;
+        cat->arena = a;
+        cat->capacidadArena = arena;
+    }
+    size_t consumos = cat->usadoConsumos + elementos;
+    if(consumos > cat->capacidadConsumos) {
+        ElementoConsumo *c = realloc(cat->consumos, consumos * sizeof(ElementoConsumo));
+        if(c == NULL) return 0;
+        cat->consumos = c;
+        cat->capacidadConsumos = consumos;
+    }
+    return 1;
+}
+
+// Reescribe la arena solo con los nombres vivos
+static int compactarArena(Catalogo *cat, size_t extra) {
+    size_t capacidad = cat->usadoArena - cat->basuraArena + extra;
+    if(capacidad < 1024) capacidad = 1024;
+    char *nueva = malloc(capacidad);
+    if(nueva == NULL) return 0;
+
+    size_t usado = 0;
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        const char *nombre = cat->arena + cat->inicioNombre[i];
+        size_t largo = tamEnArena(strlen(nombre));
+        memcpy(nueva + usado, nombre, largo);
+        cat->inicioNombre[i] = (uint32_t)usado;
+        usado += largo;
+    }
+    free(cat->arena);
+    cat->arena = nueva;
+    cat->usadoArena = usado;
+    cat->capacidadArena = capacidad;
+    cat->basuraArena = 0;
+    return 1;
+}
+
+// Copia un nombre (y su versión en minúsculas) a la arena y devuelve su
+// desplazamiento (-1 sin memoria)
+static long guardarNombre(Catalogo *cat, const char *nombre) {
+    size_t largo = strlen(nombre);
+    if(largo > MAX_NOMBRE - 1) largo = MAX_NOMBRE - 1;
+    size_t tam = tamEnArena(largo);
+    if(cat->usadoArena + tam > cat->capacidadArena) {
+        // Si más de la mitad es basura conviene compactar en vez de crecer
+        int ok;
+        if(cat->basuraArena > cat->usadoArena / 2) {
+            ok = compactarArena(cat, cat->usadoArena - cat->basuraArena + tam);
+        } else {
+            size_t nueva = cat->capacidadArena ? cat->capacidadArena * 2 : 1024;
+            while(nueva < cat->usadoArena + tam) nueva *= 2;
+            char *a = realloc(cat->arena, nueva);
+            ok = a != NULL;
+            if(ok) {
+                cat->arena = a;
+                cat->capacidadArena = nueva;
+            }
+        }
+        if(!ok) return -1;
+    }
+    if(cat->usadoArena + tam > UINT32_MAX) return -1;
+
+    size_t inicio = cat->usadoArena;
+    char *destino = cat->arena + inicio;
+    memcpy(destino, nombre, largo);
+    destino[largo] = '\0';
+    for(size_t k = 0; k <= largo; k++) {
+        destino[largo + 1 + k] = (char)tolower((unsigned char)destino[k]);
+    }
+    cat->usadoArena += tam;
+    return (long)inicio;
+}
+
+// Reescribe la matriz de consumo solo con los vectores vivos
+static int compactarConsumos(Catalogo *cat, size_t extra) {
+    size_t capacidad = cat->usadoConsumos - cat->basuraConsumos + extra;
+    if(capacidad < 256) capacidad = 256;
+    ElementoConsumo *nueva = malloc(capacidad * sizeof(ElementoConsumo));
+    if(nueva == NULL) return 0;
+
+    size_t usado = 0;
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        memcpy(nueva + usado, cat->consumos + cat->inicioConsumo[i], cat->largoConsumo[i] * sizeof(ElementoConsumo));
+        cat->inicioConsumo[i] = (uint32_t)usado;
+        usado += cat->largoConsumo[i];
+    }
+    free(cat->consumos);
+    cat->consumos = nueva;
+    cat->usadoConsumos = usado;
+    cat->capacidadConsumos = capacidad;
+    cat->basuraConsumos = 0;
+    return 1;
+}
+
+static int porFila(const void *a, const void *b) {
+    uint32_t x = ((const ElementoConsumo *)a)->fila, y = ((const ElementoConsumo *)b)->fila;
+    return (x > y) - (x < y);
+}
+
+// Copia un vector de consumo al final de la matriz, ordenado por fila, con
+// las filas repetidas sumadas y sin ceros. Devuelve su inicio (-1 si no hay
+// memoria o algún elemento es inválido) y deja en *largo cuántos quedaron.
+static long guardarConsumo(Catalogo *cat, size_t k, const ElementoConsumo *consumo, uint32_t *largo) {
+    uint32_t filas = (uint32_t)filasModelo(&cat->modelo);
+    for(size_t e = 0; e < k; e++) {
+        if(consumo[e].fila >= filas || consumo[e].valor < 0) return -1;
+    }
+    if(cat->usadoConsumos + k > cat->capacidadConsumos) {
+        int ok;
+        if(cat->basuraConsumos > cat->usadoConsumos / 2) {
+            ok = compactarConsumos(cat, cat->usadoConsumos - cat->basuraConsumos + k);
+        } else {
+            size_t nueva = cat->capacidadConsumos ? cat->capacidadConsumos * 2 : 256;
+            while(nueva < cat->usadoConsumos + k) nueva *= 2;
+            ElementoConsumo *c = realloc(cat->consumos, nueva * sizeof(ElementoConsumo));
+            ok = c != NULL;
+            if(ok) {
+                cat->consumos = c;
+                cat->capacidadConsumos = nueva;
+            }
+        }
+        if(!ok) return -1;
+    }
+    if(cat->usadoConsumos + k > UINT32_MAX) return -1;
+
+    size_t inicio = cat->usadoConsumos;
+    ElementoConsumo *destino = cat->consumos + inicio;
+    if(k > 0) {
+        memcpy(destino, consumo, k * sizeof(ElementoConsumo));
+        qsort(destino, k, sizeof(ElementoConsumo), porFila);
+    }
+    size_t n = 0;
+    for(size_t e = 0; e < k; e++) {
+        if(n > 0 && destino[n - 1].fila == destino[e].fila) {
+            int64_t suma = (int64_t)destino[n - 1].valor + destino[e].valor;
+            destino[n - 1].valor = suma > INT32_MAX ? INT32_MAX : (int)suma;
+        } else {
+            destino[n++] = destino[e];
+        }
+    }
+    size_t m = 0;
+    for(size_t e = 0; e < n; e++) {
+        if(destino[e].valor != 0) destino[m++] = destino[e];
+    }
+    cat->usadoConsumos += m;
+    *largo = (uint32_t)m;
+    return (long)inicio;
+}
+
+// Agrega un producto al final en O(1) amortizado (más su consumo); devuelve
+// su índice o -1
+long agregarProducto(Catalogo *cat, const char *nombre, int cantidad, int ganancia,
+                     size_t k, const ElementoConsumo *consumo) {
+    if(cat->cantidad == cat->capacidad && !crecerColumnas(cat)) return -1;
+    uint32_t largo;
+    long inicioConsumo = guardarConsumo(cat, k, consumo, &largo);
+    if(inicioConsumo < 0) return -1;
+    long inicio = guardarNombre(cat, nombre);
+    if(inicio < 0) {
+        cat->basuraConsumos += largo;
+        return -1;
+    }
+
+    size_t i = cat->cantidad++;
+    cat->cantidades[i] = cantidad;
+    cat->ganancias[i] = ganancia;
+    cat->inicioNombre[i] = (uint32_t)inicio;
+    cat->inicioConsumo[i] = (uint32_t)inicioConsumo;
+    cat->largoConsumo[i] = largo;
+    if(!indexarProducto(cat, i)) {
+        desindexarProducto(cat, i);
+        cat->basuraArena += tamEnArena(strlen(nombreProducto(cat, i)));
+        cat->basuraConsumos += largo;
+        cat->cantidad--;
+        return -1;
+    }
+    acumularDemanda(&cat->modelo, cantidad, largo, cat->consumos + inicioConsumo, 1);
+    return (long)i;
+}
+
+int cambiarNombre(Catalogo *cat, size_t indice, const char *nombre) {
+    desindexarProducto(cat, indice);
+    long inicio = guardarNombre(cat, nombre);
+    if(inicio >= 0) {
+        // Se lee recién ahora porque la compactación pudo mover el nombre viejo
+        uint32_t viejo = cat->inicioNombre[indice];
+        cat->inicioNombre[indice] = (uint32_t)inicio;
+        if(indexarProducto(cat, indice)) {
+            cat->basuraArena += tamEnArena(strlen(cat->arena + viejo));
+            return 1;
+        }
+        desindexarProducto(cat, indice);
+        cat->basuraArena += tamEnArena(strlen(nombreProducto(cat, indice)));
+        cat->inicioNombre[indice] = viejo;
+    }
+    // Sin memoria: se conserva el nombre anterior
+    indexarProducto(cat, indice);
+    return 0;
+}
+
+// Cambia la demanda de un producto; el modelo se actualiza solo en las filas
+// que usa
+void cambiarCantidad(Catalogo *cat, size_t indice, int cantidad) {
+    size_t k;
+    const ElementoConsumo *consumo = consumoProducto(cat, indice, &k);
+    acumularDemanda(&cat->modelo, cat->cantidades[indice], k, consumo, -1);
+    cat->cantidades[indice] = cantidad;
+    acumularDemanda(&cat->modelo, cantidad, k, consumo, 1);
+}
+
+// Reemplaza el vector de consumo de un producto (0 sin memoria o si el
+// vector es inválido, y queda el anterior)
+int cambiarConsumo(Catalogo *cat, size_t indice, size_t k, const ElementoConsumo *consumo) {
+    uint32_t largo;
+    long inicio = guardarConsumo(cat, k, consumo, &largo);
+    if(inicio < 0) return 0;
+    // Se lee recién ahora porque la compactación pudo mover el vector viejo
+    size_t viejo;
+    const ElementoConsumo *anterior = consumoProducto(cat, indice, &viejo);
+    acumularDemanda(&cat->modelo, cat->cantidades[indice], viejo, anterior, -1);
+    cat->basuraConsumos += viejo;
+    cat->inicioConsumo[indice] = (uint32_t)inicio;
+    cat->largoConsumo[indice] = largo;
+    acumularDemanda(&cat->modelo, cat->cantidades[indice], largo, cat->consumos + inicio, 1);
+    return 1;
+}
+
+const ElementoConsumo *consumoProducto(const Catalogo *cat, size_t indice, size_t *k) {
+    *k = cat->largoConsumo[indice];
+    return cat->consumos + cat->inicioConsumo[indice];
+}
+
+// Borra en O(1): el último producto ocupa el lugar del borrado
+void quitarProducto(Catalogo *cat, size_t indice) {
+    size_t ultimo = cat->cantidad - 1;
+    size_t k;
+    const ElementoConsumo *consumo = consumoProducto(cat, indice, &k);
+    acumularDemanda(&cat->modelo, cat->cantidades[indice], k, consumo, -1);
+    cat->basuraConsumos += k;
+    desindexarProducto(cat, indice);
+    if(indice != ultimo) renumerarProducto(cat, ultimo, indice);
+    cat->basuraArena += tamEnArena(strlen(nombreProducto(cat, indice)));
+    cat->cantidades[indice] = cat->cantidades[ultimo];
+    cat->ganancias[indice] = cat->ganancias[ultimo];
+    cat->inicioNombre[indice] = cat->inicioNombre[ultimo];
+    cat->inicioConsumo[indice] = cat->inicioConsumo[ultimo];
+    cat->largoConsumo[indice] = cat->largoConsumo[ultimo];
+    cat->cantidad--;
+    if(cat->cantidad == 0) {
+        cat->usadoArena = 0;
+        cat->basuraArena = 0;
+        cat->usadoConsumos = 0;
+        cat->basuraConsumos = 0;
+    }
+}
+
+const char *nombreProducto(const Catalogo *cat, size_t indice) {
+    return cat->arena + cat->inicioNombre[indice];
+}
+
+const char *nombreMinusculas(const Catalogo *cat, size_t indice) {
+    const char *nombre = cat->arena + cat->inicioNombre[indice];
+    return nombre + strlen(nombre) + 1;
+}
@@ -0,0 +1,388 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "planificador.h"
+
+// Diario de cambios del catálogo. En disco hay una instantánea (la de
+// persistencia.c) y un diario con los cambios posteriores:
+//
+//   cabecera (magia, versión, generación)
+//   registros: largo, CRC-32 y el cambio, en múltiplos de 8 bytes
+//
+// La instantánea y el diario llevan la misma generación. Compactar guarda
+// una instantánea de la generación siguiente y recién después crea el diario
+// nuevo; si el programa se cae entre los dos pasos, el diario viejo queda con
+// una generación menor y al abrir se descarta (sus cambios ya están en la
+// instantánea). Un registro cortado o con el CRC mal al final del diario es
+// una escritura que no llegó a terminar: se trunca ahí.
+
+#define MAGIA_DIARIO 0x52414944u        // "DIAR" en una máquina little endian
+#define VERSION_DIARIO 1
+#define MIN_DIARIO_COMPACTAR (1u << 20)
+
+typedef struct {
+    uint32_t magia;
+    uint32_t version;
+    uint64_t generacion;
+} CabeceraDiario;
+
+typedef struct {
+    uint32_t largo;             // bytes después de 'crc', múltiplo de 8
+    uint32_t crc;               // CRC-32 de esos bytes
+    uint32_t tipo;
+    uint32_t k;
+    uint64_t indice;
+    int64_t valor;
+    int32_t ganancia;
+    uint32_t largoNombre;       // con el '\0'; 0 si no lleva nombre
+} CabeceraRegistro;             // seguida del consumo y del nombre
+
+static uint32_t tablaCRC[256];
+static pthread_once_t tablaCRCLista = PTHREAD_ONCE_INIT;
+
+static void armarTablaCRC(void) {
+    for(uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for(int b = 0; b < 8; b++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        tablaCRC[i] = c;
+    }
+}
+
+static uint32_t crc32(const unsigned char *datos, size_t n) {
+    uint32_t c = 0xFFFFFFFFu;
+    for(size_t i = 0; i < n; i++) c = tablaCRC[(c ^ datos[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Aplica un cambio al catálogo; 0 si no se pudo (sin memoria o un índice o
+// valor inválido) y el catálogo queda como estaba
+int aplicarRegistro(Catalogo *cat, const RegistroDiario *r) {
+    if(r->tipo == REGISTRO_AGREGAR) {
+        if(r->nombre == NULL || r->valor < 0 || r->valor > INT_MAX || r->ganancia < 0) return 0;
+        return agregarProducto(cat, r->nombre, (int)r->valor, r->ganancia, r->k, r->consumo) >= 0;
+    }
+    if(r->tipo == REGISTRO_LIMITE) {
+        if(r->indice >= (size_t)filasModelo(&cat->modelo) || r->valor < 0) return 0;
+        fijarLimite(&cat->modelo, (int)r->indice, r->valor);
+        return 1;
+    }
+    if(r->indice >= cat->cantidad) return 0;
+    switch(r->tipo) {
+        case REGISTRO_NOMBRE:
+            return r->nombre != NULL && cambiarNombre(cat, r->indice, r->nombre);
+        case REGISTRO_CANTIDAD:
+            if(r->valor < 0 || r->valor > INT_MAX) return 0;
+            cambiarCantidad(cat, r->indice, (int)r->valor);
+            return 1;
+        case REGISTRO_GANANCIA:
+            if(r->valor < 0 || r->valor > INT_MAX) return 0;
+            cat->ganancias[r->indice] = (int)r->valor;
+            return 1;
+        case REGISTRO_CONSUMO:
+            return cambiarConsumo(cat, r->indice, r->k, r->consumo);
+        case REGISTRO_QUITAR:
+            quitarProducto(cat, r->indice);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// fsync del directorio que contiene 'ruta', para que un rename sobreviva
+// a una caída
+static int sincronizarDirectorio(const char *ruta) {
+    const char *barra = strrchr(ruta, '/');
+    char *dir = barra ? strndup(ruta, barra == ruta ? 1 : (size_t)(barra - ruta)) : strdup(".");
+    if(dir == NULL) return 0;
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    free(dir);
+    if(fd < 0) return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+static int escribirTodo(int fd, const void *datos, size_t n) {
+    const unsigned char *p = datos;
+    while(n > 0) {
+        ssize_t w = write(fd, p, n);
+        if(w < 0 && errno == EINTR) continue;
+        if(w <= 0) return 0;
+        p += w;
+        n -= (size_t)w;
+    }
+    return 1;
+}
+
+// Crea un diario vacío de la generación dada (en un temporal que se
+// renombra) y pasa a escribir en él
+static int crearDiario(Diario *d, uint64_t generacion) {
+    CabeceraDiario cab = { MAGIA_DIARIO, VERSION_DIARIO, generacion };
+    size_t largo = strlen(d->ruta) + 5;
+    char *temporal = malloc(largo);
+    if(temporal == NULL) return 0;
+    snprintf(temporal, largo, "%s.tmp", d->ruta);
+    int fd = open(temporal, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    int ok = fd >= 0 && escribirTodo(fd, &cab, sizeof(cab)) && fsync(fd) == 0 &&
+             rename(temporal, d->ruta) == 0 && sincronizarDirectorio(d->ruta);
+    if(!ok) {
+        if(fd >= 0) close(fd);
+        remove(temporal);
+    } else {
+        if(d->fd >= 0) close(d->fd);
+        d->fd = fd;
+        d->bytesDiario = sizeof(cab);
+    }
+    free(temporal);
+    return ok;
+}
+
+// Repite sobre el catálogo los registros del diario abierto en 'fd'. Deja
+// en *valido hasta dónde llegan los registros completos.
+static int repetirDiario(Catalogo *cat, int fd, uint64_t generacion, size_t *valido, long *aplicados) {
+    struct stat st;
+    if(fstat(fd, &st) != 0) return 0;
+    size_t tam = (size_t)st.st_size, leidos = 0;
+    unsigned char *datos = malloc(tam ? tam : 1);
+    if(datos == NULL) return 0;
+    while(leidos < tam) {
+        ssize_t r = pread(fd, datos + leidos, tam - leidos, (off_t)leidos);
+        if(r <= 0) break;
+        leidos += (size_t)r;
+    }
+
+    CabeceraDiario cab;
+    int ok = leidos == tam && tam >= sizeof(cab);
+    if(ok) {
+        memcpy(&cab, datos, sizeof(cab));
+        ok = cab.magia == MAGIA_DIARIO && cab.version == VERSION_DIARIO && cab.generacion == generacion;
+    }
+    size_t pos = sizeof(cab);
+    while(ok && tam - pos >= sizeof(CabeceraRegistro)) {
+        CabeceraRegistro c;
+        memcpy(&c, datos + pos, sizeof(c));
+        size_t cuerpo = sizeof(c) - 2 * sizeof(uint32_t);
+        if(c.largo < cuerpo || c.largo % 8 != 0 || c.largo > tam - pos - 2 * sizeof(uint32_t) ||
+           crc32(datos + pos + 2 * sizeof(uint32_t), c.largo) != c.crc) break;
+
+        // El CRC está bien: el registro se escribió entero y tiene que tener sentido
+        const unsigned char *resto = datos + pos + sizeof(c);
+        size_t libre = c.largo - cuerpo;
+        RegistroDiario r = { (TipoRegistro)c.tipo, (size_t)c.indice, NULL, c.valor, c.ganancia, c.k,
+                             (const ElementoConsumo *)resto };
+        ok = c.k <= libre / sizeof(ElementoConsumo) && c.largoNombre <= libre - c.k * sizeof(ElementoConsumo);
+        if(ok && c.largoNombre > 0) {
+            r.nombre = (const char *)resto + c.k * sizeof(ElementoConsumo);
+            ok = r.nombre[c.largoNombre - 1] == '\0';
+        }
+        ok = ok && aplicarRegistro(cat, &r);
+        if(ok) {
+            pos += 2 * sizeof(uint32_t) + c.largo;
+            (*aplicados)++;
+        }
+    }
+    free(datos);
+    *valido = pos;
+    return ok;
+}
+
+// Abre el diario de la instantánea 'rutaInstantanea': si la instantánea
+// existe la carga en el catálogo y repite los cambios anotados después
+// (*aplicados cuenta cuántos). Si no existe, el catálogo no se toca y los
+// archivos se crean con la primera compactación. Aunque falle hay que
+// llamar a cerrarDiario.
+int abrirDiario(Diario *d, Catalogo *cat, const char *rutaInstantanea, long *aplicados) {
+    struct stat st;
+    memset(d, 0, sizeof(*d));
+    d->fd = -1;
+    *aplicados = 0;
+    pthread_once(&tablaCRCLista, armarTablaCRC);
+    pthread_mutex_init(&d->mutex, NULL);
+    pthread_cond_init(&d->listo, NULL);
+    size_t largo = strlen(rutaInstantanea) + 8;
+    d->ruta = malloc(largo);
+    d->rutaInstantanea = strdup(rutaInstantanea);
+    if(d->ruta == NULL || d->rutaInstantanea == NULL) return 0;
+    snprintf(d->ruta, largo, "%s.diario", rutaInstantanea);
+    if(stat(rutaInstantanea, &st) != 0) return errno == ENOENT;
+
+    if(!cargarInstantanea(cat, rutaInstantanea)) return 0;
+    d->generacion = cat->generacion;
+    d->bytesInstantanea = (uint64_t)st.st_size;
+
+    int fd = open(d->ruta, O_RDWR | O_APPEND | O_CLOEXEC);
+    if(fd < 0) return errno == ENOENT && crearDiario(d, d->generacion);
+    CabeceraDiario cab;
+    if(pread(fd, &cab, sizeof(cab), 0) == (ssize_t)sizeof(cab) && cab.magia == MAGIA_DIARIO &&
+       cab.generacion < d->generacion) {
+        // Quedó de una compactación interrumpida: la instantánea ya lo incluye
+        close(fd);
+        return crearDiario(d, d->generacion);
+    }
+    size_t valido;
+    if(!repetirDiario(cat, fd, d->generacion, &valido, aplicados)) {
+        close(fd);
+        return 0;
+    }
+    // Lo que sigue al último registro completo no llegó a escribirse entero
+    struct stat sd;
+    if(fstat(fd, &sd) != 0 || ((size_t)sd.st_size > valido && (ftruncate(fd, (off_t)valido) != 0 || fsync(fd) != 0))) {
+        close(fd);
+        return 0;
+    }
+    d->fd = fd;
+    d->bytesDiario = valido;
+    return 1;
+}
+
+void cerrarDiario(Diario *d) {
+    if(d->fd >= 0) {
+        confirmarDiario(d, d->anotado);
+        close(d->fd);
+    }
+    free(d->ruta);
+    free(d->rutaInstantanea);
+    free(d->pendiente);
+    free(d->enVuelo);
+    pthread_mutex_destroy(&d->mutex);
+    pthread_cond_destroy(&d->listo);
+    memset(d, 0, sizeof(*d));
+    d->fd = -1;
+}
+
+// Anota un cambio ya aplicado; todavía no está en disco. Devuelve la
+// posición que hay que pasarle a confirmarDiario (0 sin memoria).
+uint64_t anotarRegistro(Diario *d, const RegistroDiario *r) {
+    size_t largoNombre = r->nombre ? strlen(r->nombre) + 1 : 0;
+    size_t tam = sizeof(CabeceraRegistro) + r->k * sizeof(ElementoConsumo) + largoNombre;
+    tam = (tam + 7) & ~(size_t)7;
+    if(tam > UINT32_MAX) return 0;
+
+    pthread_mutex_lock(&d->mutex);
+    if(d->usadoPendiente + tam > d->capacidadPendiente) {
+        size_t nueva = d->capacidadPendiente ? d->capacidadPendiente * 2 : 4096;
+        while(nueva < d->usadoPendiente + tam) nueva *= 2;
+        unsigned char *p = realloc(d->pendiente, nueva);
+        if(p == NULL) {
+            d->error = 1;
+            pthread_mutex_unlock(&d->mutex);
+            return 0;
+        }
+        d->pendiente = p;
+        d->capacidadPendiente = nueva;
+    }
+    unsigned char *destino = d->pendiente + d->usadoPendiente;
+    CabeceraRegistro c = { (uint32_t)(tam - 2 * sizeof(uint32_t)), 0, (uint32_t)r->tipo, (uint32_t)r->k,
+                           (uint64_t)r->indice, r->valor, r->ganancia, (uint32_t)largoNombre };
+    memset(destino, 0, tam);
+    memcpy(destino, &c, sizeof(c));
+    if(r->k > 0) memcpy(destino + sizeof(c), r->consumo, r->k * sizeof(ElementoConsumo));
+    if(largoNombre > 0) memcpy(destino + sizeof(c) + r->k * sizeof(ElementoConsumo), r->nombre, largoNombre);
+    c.crc = crc32(destino + 2 * sizeof(uint32_t), tam - 2 * sizeof(uint32_t));
+    memcpy(destino + sizeof(uint32_t), &c.crc, sizeof(uint32_t));
+    d->usadoPendiente += tam;
+    d->anotado += tam;
+    uint64_t posicion = d->anotado;
+    pthread_mutex_unlock(&d->mutex);
+    return posicion;
+}
+
+// Vuelve cuando todo lo anotado hasta 'hasta' está en disco (0 si falló la
+// escritura). Escritura en grupo: si nadie está escribiendo, este hilo
+// escribe todo lo pendiente, también lo que anotaron otros, con un solo
+// fdatasync; si alguien ya está escribiendo, espera y revisa.
+int confirmarDiario(Diario *d, uint64_t hasta) {
+    if(hasta == 0) return 0;
+    pthread_mutex_lock(&d->mutex);
+    while(!d->error && d->durable < hasta) {
+        if(d->sincronizando || d->fd < 0) {
+            if(d->fd < 0) d->error = 1;
+            else pthread_cond_wait(&d->listo, &d->mutex);
+            continue;
+        }
+        unsigned char *bloque = d->pendiente;
+        size_t capacidad = d->capacidadPendiente, n = d->usadoPendiente;
+        uint64_t fin = d->anotado;
+        d->pendiente = d->enVuelo;
+        d->capacidadPendiente = d->capacidadEnVuelo;
+        d->usadoPendiente = 0;
+        d->sincronizando = 1;
+        pthread_mutex_unlock(&d->mutex);
+
+        int ok = escribirTodo(d->fd, bloque, n) && fdatasync(d->fd) == 0;
+
+        pthread_mutex_lock(&d->mutex);
+        d->enVuelo = bloque;
+        d->capacidadEnVuelo = capacidad;
+        d->sincronizando = 0;
+        d->sincronizaciones++;
+        if(ok) {
+            d->durable = fin;
+            d->bytesDiario += n;
+        } else {
+            d->error = 1;
+        }
+        pthread_cond_broadcast(&d->listo);
+    }
+    int ok = !d->error;
+    pthread_mutex_unlock(&d->mutex);
+    return ok;
+}
+
+// El diario ya cuesta más repetirlo que cargar una instantánea nueva
+int diarioGrande(Diario *d) {
+    pthread_mutex_lock(&d->mutex);
+    uint64_t limite = d->bytesInstantanea > MIN_DIARIO_COMPACTAR ? d->bytesInstantanea : MIN_DIARIO_COMPACTAR;
+    int grande = d->fd >= 0 && d->bytesDiario + d->usadoPendiente > limite;
+    pthread_mutex_unlock(&d->mutex);
+    return grande;
+}
+
+// Guarda el catálogo como instantánea de la generación siguiente y empieza
+// un diario vacío. Lo anotado hasta acá queda cubierto por la instantánea.
+// Nadie puede modificar el catálogo mientras tanto.
+int compactarDiario(Diario *d, Catalogo *cat) {
+    pthread_mutex_lock(&d->mutex);
+    while(d->sincronizando) pthread_cond_wait(&d->listo, &d->mutex);
+    d->sincronizando = 1;
+    pthread_mutex_unlock(&d->mutex);
+
+    struct stat st;
+    uint64_t anterior = cat->generacion, generacion = d->generacion + 1;
+    cat->generacion = generacion;
+    int ok = guardarInstantanea(cat, d->rutaInstantanea) && sincronizarDirectorio(d->rutaInstantanea) &&
+             stat(d->rutaInstantanea, &st) == 0;
+    if(!ok) cat->generacion = anterior;
+    int diarioOk = ok && crearDiario(d, generacion);
+
+    pthread_mutex_lock(&d->mutex);
+    d->sincronizando = 0;
+    if(ok) {
+        d->generacion = generacion;
+        d->bytesInstantanea = (uint64_t)st.st_size;
+        d->usadoPendiente = 0;
+        d->durable = d->anotado;
+        // La instantánea ya es de la generación nueva: lo que se escriba en
+        // el diario viejo se descartaría al abrir
+        if(!diarioOk) d->error = 1;
+    }
+    pthread_cond_broadcast(&d->listo);
+    pthread_mutex_unlock(&d->mutex);
+    return diarioOk;
+}
+
+// Aplica un cambio y, con diario, vuelve cuando está en disco (y compacta
+// si hace falta). 1 si todo salió bien, 0 si el cambio no se pudo aplicar,
+// -1 si se aplicó pero no se pudo escribir en el diario.
+int cambiarCatalogo(Catalogo *cat, Diario *d, const RegistroDiario *r) {
+    if(!aplicarRegistro(cat, r)) return 0;
+    if(d == NULL) return 1;
+    if(!confirmarDiario(d, anotarRegistro(d, r))) return -1;
+    if(diarioGrande(d) && !compactarDiario(d, cat)) return -1;
+    return 1;
+}
@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "planificador.h"
+
+// Escenarios "¿qué pasa si?": una copia del catálogo que comparte las
+// columnas de la base por tramos de TAM_TRAMO productos y copia un tramo
+// recién cuando una edición lo modifica (copia al escribir). Crear un
+// escenario cuesta O(productos / TAM_TRAMO + filas); las demandas por fila
+// se copian y se ajustan con cada edición igual que en el catálogo.
+
+#define TAM_TRAMO (1u << BITS_TRAMO_ESCENARIO)
+#define MASCARA_TRAMO (TAM_TRAMO - 1)
+#define PROPIAS_CANTIDADES 1
+#define PROPIAS_GANANCIAS 2
+
+int crearEscenario(Escenario *e, const Catalogo *base, const char *nombre) {
+    memset(e, 0, sizeof(*e));
+    e->base = base;
+    e->cantidad = base->cantidad;
+    e->tramos = (base->cantidad + TAM_TRAMO - 1) >> BITS_TRAMO_ESCENARIO;
+    snprintf(e->nombre, sizeof(e->nombre), "%s", nombre);
+
+    size_t filas = (size_t)filasModelo(&base->modelo);
+    e->modelo = base->modelo;                   // nombres compartidos
+    e->modelo.limites = malloc((filas + 1) * sizeof(int64_t));
+    e->modelo.demandas = malloc((filas + 1) * sizeof(__int128));
+    e->cantidades = malloc((e->tramos + 1) * sizeof(int *));
+    e->ganancias = malloc((e->tramos + 1) * sizeof(int *));
+    e->propios = calloc(e->tramos + 1, 1);
+    if(e->modelo.limites == NULL || e->modelo.demandas == NULL || e->cantidades == NULL ||
+       e->ganancias == NULL || e->propios == NULL) {
+        liberarEscenario(e);
+        return 0;
+    }
+    if(filas > 0) {
+        memcpy(e->modelo.limites, base->modelo.limites, filas * sizeof(int64_t));
+        memcpy(e->modelo.demandas, base->modelo.demandas, filas * sizeof(__int128));
+    }
+    for(size_t t = 0; t < e->tramos; t++) {
+        e->cantidades[t] = base->cantidades + (t << BITS_TRAMO_ESCENARIO);
+        e->ganancias[t] = base->ganancias + (t << BITS_TRAMO_ESCENARIO);
+    }
+    return 1;
+}
+
+void liberarEscenario(Escenario *e) {
+    for(size_t t = 0; e->propios && t < e->tramos; t++) {
+        if(e->propios[t] & PROPIAS_CANTIDADES) free(e->cantidades[t]);
+        if(e->propios[t] & PROPIAS_GANANCIAS) free(e->ganancias[t]);
+    }
+    free(e->cantidades);
+    free(e->ganancias);
+    free(e->propios);
+    free(e->modelo.limites);
+    free(e->modelo.demandas);
+    memset(e, 0, sizeof(*e));
+}
+
+// Copia el tramo de la columna antes de la primera escritura
+static int *tramoPropio(Escenario *e, int **tramos, int bandera, size_t i) {
+    size_t t = i >> BITS_TRAMO_ESCENARIO;
+    if(!(e->propios[t] & bandera)) {
+        size_t desde = t << BITS_TRAMO_ESCENARIO;
+        size_t largo = e->cantidad - desde < TAM_TRAMO ? e->cantidad - desde : TAM_TRAMO;
+        int *copia = malloc(TAM_TRAMO * sizeof(int));
+        if(copia == NULL) return NULL;
+        memcpy(copia, tramos[t], largo * sizeof(int));
+        tramos[t] = copia;
+        e->propios[t] |= bandera;
+    }
+    return &tramos[t][i & MASCARA_TRAMO];
+}
+
+int cantidadEscenario(const Escenario *e, size_t i) {
+    return e->cantidades[i >> BITS_TRAMO_ESCENARIO][i & MASCARA_TRAMO];
+}
+
+int gananciaEscenario(const Escenario *e, size_t i) {
+    return e->ganancias[i >> BITS_TRAMO_ESCENARIO][i & MASCARA_TRAMO];
+}
+
+static int64_t cambiarValor(int64_t actual, TipoCambio tipo, double valor, int64_t maximo) {
+    double nuevo;
+    switch(tipo) {
+        case CAMBIO_FIJAR: nuevo = valor; break;
+        case CAMBIO_SUMAR: nuevo = (double)actual + valor; break;
+        default: nuevo = (double)actual * (1.0 + valor / 100.0); break;
+    }
+    nuevo = floor(nuevo + 0.5);
+    if(nuevo < 0) return 0;
+    if(nuevo >= (double)maximo) return maximo;
+    return (int64_t)nuevo;
+}
+
+static int editarProductoEscenario(Escenario *e, const EdicionEscenario *ed, size_t i) {
+    if(ed->campo == EDITAR_GANANCIA) {
+        int *g = tramoPropio(e, e->ganancias, PROPIAS_GANANCIAS, i);
+        if(g == NULL) return 0;
+        *g = (int)cambiarValor(*g, ed->tipo, ed->valor, INT32_MAX);
+        return 1;
+    }
+    int *c = tramoPropio(e, e->cantidades, PROPIAS_CANTIDADES, i);
+    if(c == NULL) return 0;
+    size_t k;
+    const ElementoConsumo *consumo = consumoProducto(e->base, i, &k);
+    acumularDemanda(&e->modelo, *c, k, consumo, -1);
+    *c = (int)cambiarValor(*c, ed->tipo, ed->valor, INT32_MAX);
+    acumularDemanda(&e->modelo, *c, k, consumo, 1);
+    return 1;
+}
+
+// Aplica las ediciones en orden; la base no se toca. Devuelve 0 si faltó
+// memoria (las ediciones anteriores quedan aplicadas).
+int aplicarEdiciones(Escenario *e, const EdicionEscenario *ediciones, size_t n) {
+    for(size_t j = 0; j < n; j++) {
+        const EdicionEscenario *ed = &ediciones[j];
+        if(ed->campo == EDITAR_LIMITE) {
+            int filas = filasModelo(&e->modelo);
+            int desde = ed->objetivo < 0 ? 0 : (int)ed->objetivo;
+            int hasta = ed->objetivo < 0 ? filas : desde + 1;
+            for(int f = desde; f < hasta && f < filas; f++) {
+                fijarLimite(&e->modelo, f, cambiarValor(e->modelo.limites[f], ed->tipo, ed->valor, INT64_MAX));
+            }
+            continue;
+        }
+        size_t desde = ed->objetivo < 0 ? 0 : (size_t)ed->objetivo;
+        size_t hasta = ed->objetivo < 0 ? e->cantidad : desde + 1;
+        for(size_t i = desde; i < hasta && i < e->cantidad; i++) {
+            if(!editarProductoEscenario(e, ed, i)) return 0;
+        }
+    }
+    return 1;
+}
+
+// Plan óptimo del escenario (ver mostrarPlanOptimo): max ganancia, o las
+// unidades si ningún producto tiene ganancia, sin pasar la demanda ni los
+// límites. 'plan' debe tener lugar para todos los productos.
+ResultadoEntero optimizarEscenario(const Escenario *e, double *plan, int *porGanancia) {
+    ResultadoEntero res = { PLAN_SIN_MEMORIA, 0, 0, 0 };
+    int filas = filasModelo(&e->modelo);
+    ProblemaEntero problema;
+
+    *porGanancia = 0;
+    for(size_t i = 0; i < e->cantidad && !*porGanancia; i++) {
+        if(gananciaEscenario(e, i) > 0) *porGanancia = 1;
+    }
+
+    double *limites = malloc(((size_t)filas + 1) * sizeof(double));
+    int *filasColumna = malloc(((size_t)filas + 1) * sizeof(int));
+    double *valores = malloc(((size_t)filas + 1) * sizeof(double));
+    int ok = limites != NULL && filasColumna != NULL && valores != NULL;
+    if(ok) {
+        for(int f = 0; f < filas; f++) limites[f] = (double)e->modelo.limites[f];
+        ok = iniciarProblema(&problema, filas, limites);
+    }
+    for(size_t i = 0; ok && i < e->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(e->base, i, &k);
+        for(size_t j = 0; j < k; j++) {
+            filasColumna[j] = (int)consumo[j].fila;
+            valores[j] = consumo[j].valor;
+        }
+        double valor = *porGanancia ? gananciaEscenario(e, i) : 1.0;
+        if(!agregarColumna(&problema, valor, cantidadEscenario(e, i), (int)k, filasColumna, valores)) {
+            liberarProblema(&problema);
+            ok = 0;
+        }
+    }
+    free(limites);
+    free(filasColumna);
+    free(valores);
+    if(!ok) return res;
+
+    res = resolverEntero(&problema, LIMITE_NODOS_PLAN, plan);
+    liberarProblema(&problema);
+    return res;
+}
+
+static void sumarPlanEscenario(const Escenario *e, const double *plan, ResultadoEscenario *r) {
+    r->producidas = 0;
+    r->ganancia = 0;
+    for(size_t i = 0; i < e->cantidad; i++) {
+        long long x = (long long)plan[i];
+        r->producidas += x;
+        r->ganancia += x * gananciaEscenario(e, i);
+    }
+}
+
+// Resultado de "Calcular producción" para el escenario: si la demanda entra
+// se produce toda; si no, el plan por prioridad, y como en el menú el branch
+// and bound solo cuando ése no es exacto y hay pocos productos. Si la
+// búsqueda se corta antes de mejorar el plan por prioridad queda éste.
+int evaluarEscenario(const Escenario *e, ResultadoEscenario *r) {
+    memset(r, 0, sizeof(*r));
+    r->excedidas = e->modelo.excedidas;
+    r->viable = e->modelo.excedidas == 0;
+    for(size_t i = 0; i < e->cantidad; i++) {
+        r->demanda += cantidadEscenario(e, i);
+        if(gananciaEscenario(e, i) > 0) r->porGanancia = 1;
+    }
+    if(r->viable) {
+        r->estado = PLAN_OPTIMO;
+        r->producidas = r->demanda;
+        for(size_t i = 0; i < e->cantidad; i++) {
+            r->ganancia += (long long)cantidadEscenario(e, i) * gananciaEscenario(e, i);
+        }
+        return 1;
+    }
+
+    ResultadoPrioridad prioridad;
+    double *plan = malloc((e->cantidad + 1) * sizeof(double));
+    if(plan == NULL || !planPorPrioridad(e, plan, &prioridad)) {
+        free(plan);
+        r->estado = PLAN_SIN_MEMORIA;
+        return 0;
+    }
+    r->estado = prioridad.exacto ? PLAN_OPTIMO : PLAN_VORAZ;
+    sumarPlanEscenario(e, plan, r);
+
+    if(!prioridad.exacto && e->cantidad <= MAX_PRODUCTOS_PLAN_OPTIMO) {
+        int porGanancia;
+        ResultadoEntero res = optimizarEscenario(e, plan, &porGanancia);
+        if(res.estado == PLAN_OPTIMO || (res.estado == PLAN_LIMITE_NODOS && res.valor > (double)prioridad.valor)) {
+            r->estado = res.estado;
+            r->cota = res.cota;
+            sumarPlanEscenario(e, plan, r);
+        }
+    }
+    free(plan);
+    return 1;
+}
+
+typedef struct {
+    Escenario *const *escenarios;
+    ResultadoEscenario *resultados;
+    size_t n;
+    size_t siguiente;           // próximo escenario sin tomar (atómico)
+} TrabajoEscenarios;
+
+static void *evaluarPendientes(void *arg) {
+    TrabajoEscenarios *t = arg;
+    for(;;) {
+        size_t j = __atomic_fetch_add(&t->siguiente, 1, __ATOMIC_RELAXED);
+        if(j >= t->n) return NULL;
+        evaluarEscenario(t->escenarios[j], &t->resultados[j]);
+    }
+}
+
+// Evalúa los escenarios en paralelo (hilos 0 = uno por núcleo). Cada hilo
+// toma el próximo escenario pendiente, así los que necesitan optimizar no
+// dejan a los demás esperando. Solo se lee la base.
+void evaluarEscenarios(Escenario *const *escenarios, size_t n, ResultadoEscenario *resultados, int hilos) {
+    TrabajoEscenarios trabajo = { escenarios, resultados, n, 0 };
+    pthread_t ids[MAX_HILOS_ESCENARIOS];
+    int lanzados = 0;
+    if(hilos <= 0) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if((size_t)hilos > n) hilos = n > 0 ? (int)n : 1;
+    if(hilos > MAX_HILOS_ESCENARIOS) hilos = MAX_HILOS_ESCENARIOS;
+
+    // El hilo que llama también trabaja
+    for(int h = 1; h < hilos; h++) {
+        if(pthread_create(&ids[lanzados], NULL, evaluarPendientes, &trabajo) == 0) lanzados++;
+    }
+    evaluarPendientes(&trabajo);
+    for(int h = 0; h < lanzados; h++) pthread_join(ids[h], NULL);
+}
@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "booleanas.h"
+
+// Genera un archivo C con un evaluador sin saltos por cada función: el SOP
+// se evalúa en forma bitsliced, x[v] lleva la variable v de 64 vectores de
+// entrada (o 256 con AVX2) y el resultado trae la salida de todos a la vez.
+
+int iniciarExportacion(Exportacion *e, const char *ruta) {
+    e->archivo = fopen(ruta, "w");
+    e->cantidad = 0;
+    e->capacidad = 0;
+    e->numVars = NULL;
+    e->conTabla = NULL;
+    if (e->archivo == NULL) return 0;
+
+    FILE *f = e->archivo;
+    fprintf(f, "// Evaluadores bitsliced generados por booleanas\n");
+    fprintf(f, "// Compilar el benchmark con: gcc -O2 -march=native -DEVALUADOR_BENCH archivo.c\n");
+    fprintf(f, "#if defined(EVALUADOR_BENCH) && !defined(_POSIX_C_SOURCE)\n");
+    fprintf(f, "#define _POSIX_C_SOURCE 200809L\n");
+    fprintf(f, "#endif\n");
+    fprintf(f, "#include <stdint.h>\n");
+    fprintf(f, "#ifdef __AVX2__\n#include <immintrin.h>\n#endif\n");
+    return 1;
+}
+
+// Escribe el producto como una expresión de C sobre uint64_t
+static void escribirProducto64(FILE *f, int n, Cubo c) {
+    int primero = 1;
+    if (c.cuidado == 0) {
+        fprintf(f, "~(uint64_t)0");
+        return;
+    }
+    for (int v = 0; v < n; v++) {
+        uint32_t bit = 1u << (n - 1 - v);
+        if (!(c.cuidado & bit)) continue;
+        fprintf(f, "%s%sx[%d]", primero ? "" : " & ", (c.valor & bit) ? "" : "~", v);
+        primero = 0;
+    }
+}
+
+static void escribirPalabras(FILE *f, const char *nombre, size_t numero, const uint64_t *p, size_t palabras) {
+    fprintf(f, "static const uint64_t %s_f%zu[%zu] = {", nombre, numero, palabras);
+    for (size_t w = 0; w < palabras; w++) {
+        fprintf(f, "%s0x%016llxULL%s", (w % 4 == 0) ? "\n    " : " ", (unsigned long long)p[w],
+                (w + 1 < palabras) ? "," : "");
+    }
+    fprintf(f, "\n};\n");
+}
+
+// Se embebe la tabla original, no la del SOP, junto con la máscara de las
+// filas que importan (las que no son indiferentes): así el benchmark
+// comprueba la minimización y no al evaluador contra sí mismo
+static int escribirTabla(FILE *f, const TablaVerdad *t, size_t numero) {
+    uint64_t *cuidado = malloc(t->palabras * sizeof(uint64_t));
+    if (cuidado == NULL) return 0;
+    uint64_t validas = t->n < 6 ? (1ULL << (1u << t->n)) - 1 : ~0ULL;
+    for (size_t w = 0; w < t->palabras; w++) {
+        cuidado[w] = (t->indiferentes ? ~t->indiferentes[w] : ~0ULL) & validas;
+    }
+    escribirPalabras(f, "tabla", numero, t->bits, t->palabras);
+    escribirPalabras(f, "cuidado", numero, cuidado, t->palabras);
+    free(cuidado);
+    return 1;
+}
+
+int exportarEvaluador(Exportacion *e, const TablaVerdad *t, const Cobertura *sop, size_t numero) {
+    FILE *f = e->archivo;
+    int n = t->n;
+
+    if (e->cantidad == e->capacidad) {
+        size_t cap = e->capacidad ? e->capacidad * 2 : 16;
+        int *numVars = realloc(e->numVars, cap * sizeof(int));
+        if (numVars == NULL) return 0;
+        e->numVars = numVars;
+        int *conTabla = realloc(e->conTabla, cap * sizeof(int));
+        if (conTabla == NULL) return 0;
+        e->conTabla = conTabla;
+        e->capacidad = cap;
+    }
+
+    fprintf(f, "\n// F%zu: %d variables, %zu términos, %zu literales\n",
+            numero, n, sop->cantidad, contarLiterales(sop));
+    fprintf(f, "// x[v]: el bit k es la variable v (A = 0) del vector k\n");
+    fprintf(f, "#define VARIABLES_F%zu %d\n", numero, n);
+
+    // 64 vectores por palabra
+    fprintf(f, "static inline uint64_t evaluar_f%zu(const uint64_t *x) {\n", numero);
+    fprintf(f, "    (void)x;\n");
+    if (sop->cantidad == 0) {
+        fprintf(f, "    return 0;\n");
+    } else {
+        fprintf(f, "    return");
+        for (size_t i = 0; i < sop->cantidad; i++) {
+            fprintf(f, "%s(", (i == 0) ? " " : "\n        | ");
+            escribirProducto64(f, n, sop->cubos[i]);
+            fprintf(f, ")");
+        }
+        fprintf(f, ";\n");
+    }
+    fprintf(f, "}\n");
+
+    // 256 vectores por registro: andnot(a, b) = ~a & b
+    fprintf(f, "#ifdef __AVX2__\n");
+    fprintf(f, "static inline __m256i evaluar_f%zu_avx2(const __m256i *x) {\n", numero);
+    fprintf(f, "    const __m256i unos = _mm256_set1_epi64x(-1);\n");
+    fprintf(f, "    __m256i r = _mm256_setzero_si256(), p;\n");
+    fprintf(f, "    (void)x; (void)unos; (void)p;\n");
+    for (size_t i = 0; i < sop->cantidad; i++) {
+        Cubo c = sop->cubos[i];
+        fprintf(f, "    p = unos;");
+        for (int v = 0; v < n; v++) {
+            uint32_t bit = 1u << (n - 1 - v);
+            if (!(c.cuidado & bit)) continue;
+            if (c.valor & bit) fprintf(f, " p = _mm256_and_si256(p, x[%d]);", v);
+            else fprintf(f, " p = _mm256_andnot_si256(x[%d], p);", v);
+        }
+        fprintf(f, " r = _mm256_or_si256(r, p);\n");
+    }
+    fprintf(f, "    return r;\n}\n#endif\n");
+
+    int conTabla = n <= MAX_VARIABLES_TABLA_EXPORTADA;
+    if (conTabla && !escribirTabla(f, t, numero)) return 0;
+
+    e->numVars[e->cantidad] = n;
+    e->conTabla[e->cantidad] = conTabla;
+    e->cantidad++;
+    return !ferror(f);
+}
+
+// Benchmark opcional: cada evaluador contra la consulta de tabla_f[] fila
+// por fila sobre los mismos vectores aleatorios, comprobando que coincidan
+// en las filas que no son indiferentes (cuidado_f[])
+static void escribirBenchmark(Exportacion *e) {
+    FILE *f = e->archivo;
+    fprintf(f, "\n#ifdef EVALUADOR_BENCH\n");
+    fprintf(f, "#include <stdio.h>\n#include <stdlib.h>\n#include <time.h>\n\n");
+    fprintf(f, "#define BLOQUES 4096         // bloques de 64 vectores\n");
+    fprintf(f, "#define REPETICIONES 64\n\n");
+    fprintf(f,
+        "typedef uint64_t (*Evaluador64)(const uint64_t *);\n"
+        "#ifdef __AVX2__\n"
+        "typedef __m256i (*Evaluador256)(const __m256i *);\n"
+        "#else\n"
+        "typedef void *Evaluador256;\n"
+        "#endif\n"
+        "\n"
+        "static double segundosDesde(const struct timespec *inicio) {\n"
+        "    struct timespec ahora;\n"
+        "    clock_gettime(CLOCK_MONOTONIC, &ahora);\n"
+        "    return (double)(ahora.tv_sec - inicio->tv_sec) + (double)(ahora.tv_nsec - inicio->tv_nsec) / 1e9;\n"
+        "}\n"
+        "\n"
+        "static uint64_t semilla = 0x9E3779B97F4A7C15ULL;\n"
+        "static uint64_t aleatorio(void) {\n"
+        "    semilla ^= semilla << 13;\n"
+        "    semilla ^= semilla >> 7;\n"
+        "    semilla ^= semilla << 17;\n"
+        "    return semilla;\n"
+        "}\n"
+        "\n"
+        "// filas: índice de fila de cada vector (A es el bit más significativo)\n"
+        "// x: x[v * BLOQUES + b] lleva la variable v de los 64 vectores del bloque b\n"
+        "static void medir(const char *nombre, int n, Evaluador64 ev64, Evaluador256 ev256,\n"
+        "                  const uint64_t *tabla, const uint64_t *cuidado, const uint32_t *filas, const uint64_t *x) {\n"
+        "    struct timespec inicio;\n"
+        "    uint64_t xs[64], control = 0, errores = 0;\n"
+        "    double evaluaciones = (double)BLOQUES * 64 * REPETICIONES;\n"
+        "    printf(\"%%s (%%d variables)\\n\", nombre, n);\n"
+        "\n"
+        "    if (tabla) {\n"
+        "        clock_gettime(CLOCK_MONOTONIC, &inicio);\n"
+        "        for (int r = 0; r < REPETICIONES; r++) {\n"
+        "            for (size_t k = 0; k < (size_t)BLOQUES * 64; k++) {\n"
+        "                uint32_t fila = filas[k];\n"
+        "                control += (tabla[fila >> 6] >> (fila & 63)) & 1;\n"
+        "            }\n"
+        "        }\n"
+        "        double dt = segundosDesde(&inicio);\n"
+        "        printf(\"  tabla:        %%12.0f evaluaciones/s\\n\", evaluaciones / dt);\n"
+        "    }\n"
+        "\n"
+        "    clock_gettime(CLOCK_MONOTONIC, &inicio);\n"
+        "    for (int r = 0; r < REPETICIONES; r++) {\n"
+        "        for (int b = 0; b < BLOQUES; b++) {\n"
+        "            for (int v = 0; v < n; v++) xs[v] = x[(size_t)v * BLOQUES + b];\n"
+        "            control ^= ev64(xs);\n"
+        "        }\n"
+        "    }\n"
+        "    double dt = segundosDesde(&inicio);\n"
+        "    printf(\"  bitsliced 64: %%12.0f evaluaciones/s\\n\", evaluaciones / dt);\n"
+        "\n"
+        "#ifdef __AVX2__\n"
+        "    __m256i xv[64], acum = _mm256_setzero_si256();\n"
+        "    clock_gettime(CLOCK_MONOTONIC, &inicio);\n"
+        "    for (int r = 0; r < REPETICIONES; r++) {\n"
+        "        for (int b = 0; b < BLOQUES; b += 4) {\n"
+        "            for (int v = 0; v < n; v++)\n"
+        "                xv[v] = _mm256_loadu_si256((const __m256i *)&x[(size_t)v * BLOQUES + b]);\n"
+        "            acum = _mm256_xor_si256(acum, ev256(xv));\n"
+        "        }\n"
+        "    }\n"
+        "    dt = segundosDesde(&inicio);\n"
+        "    control ^= (uint64_t)_mm256_extract_epi64(acum, 0);\n"
+        "    printf(\"  AVX2 256:     %%12.0f evaluaciones/s\\n\", evaluaciones / dt);\n"
+        "#else\n"
+        "    (void)ev256;\n"
+        "#endif\n"
+        "\n"
+        "    // Verificación contra la tabla original, sin las filas indiferentes\n"
+        "    for (int b = 0; tabla && b < BLOQUES; b++) {\n"
+        "        uint64_t esperado = 0, importa = 0;\n"
+        "        for (int k = 0; k < 64; k++) {\n"
+        "            uint32_t fila = filas[(size_t)b * 64 + k];\n"
+        "            esperado |= ((tabla[fila >> 6] >> (fila & 63)) & 1) << k;\n"
+        "            importa |= ((cuidado[fila >> 6] >> (fila & 63)) & 1) << k;\n"
+        "        }\n"
+        "        for (int v = 0; v < n; v++) xs[v] = x[(size_t)v * BLOQUES + b];\n"
+        "        errores += (uint64_t)__builtin_popcountll((ev64(xs) ^ esperado) & importa);\n"
+        "    }\n"
+        "    if (tabla) printf(\"  vectores distintos de la tabla: %%llu\\n\", (unsigned long long)errores);\n"
+        "    else printf(\"  (sin tabla embebida: no se compara)\\n\");\n"
+        "    printf(\"  control: %%llx\\n\", (unsigned long long)control);\n"
+        "}\n"
+        "\n"
+        "int main(void) {\n"
+        "    uint32_t *filas = malloc((size_t)BLOQUES * 64 * sizeof(uint32_t));\n"
+        "    uint64_t *x = malloc((size_t)64 * BLOQUES * sizeof(uint64_t));\n"
+        "    if (filas == NULL || x == NULL) return 1;\n");
+
+    for (size_t i = 0; i < e->cantidad; i++) {
+        size_t k = i + 1;
+        fprintf(f, "\n    // F%zu\n", k);
+        fprintf(f, "    for (size_t j = 0; j < (size_t)BLOQUES * 64; j++)\n");
+        fprintf(f, "        filas[j] = (uint32_t)(aleatorio() & ((1ULL << VARIABLES_F%zu) - 1));\n", k);
+        fprintf(f, "    for (int v = 0; v < VARIABLES_F%zu; v++) {\n", k);
+        fprintf(f, "        for (int b = 0; b < BLOQUES; b++) {\n");
+        fprintf(f, "            uint64_t palabra = 0;\n");
+        fprintf(f, "            for (int j = 0; j < 64; j++)\n");
+        fprintf(f, "                palabra |= (uint64_t)((filas[(size_t)b * 64 + j] >> (VARIABLES_F%zu - 1 - v)) & 1) << j;\n", k);
+        fprintf(f, "            x[(size_t)v * BLOQUES + b] = palabra;\n");
+        fprintf(f, "        }\n    }\n");
+        char tabla[64] = "NULL, NULL";
+        if (e->conTabla[i]) snprintf(tabla, sizeof(tabla), "tabla_f%zu, cuidado_f%zu", k, k);
+        fprintf(f, "#ifdef __AVX2__\n");
+        fprintf(f, "    medir(\"F%zu\", VARIABLES_F%zu, evaluar_f%zu, evaluar_f%zu_avx2, %s, filas, x);\n",
+                k, k, k, k, tabla);
+        fprintf(f, "#else\n");
+        fprintf(f, "    medir(\"F%zu\", VARIABLES_F%zu, evaluar_f%zu, NULL, %s, filas, x);\n", k, k, k, tabla);
+        fprintf(f, "#endif\n");
+    }
+    fprintf(f, "\n    free(filas);\n    free(x);\n    return 0;\n}\n#endif // EVALUADOR_BENCH\n");
+}
+
+int terminarExportacion(Exportacion *e) {
+    if (e->archivo == NULL) return 0;
+    escribirBenchmark(e);
+    int ok = !ferror(e->archivo);
+    if (fclose(e->archivo) != 0) ok = 0;
+    e->archivo = NULL;
+    free(e->numVars);
+    free(e->conTabla);
+    e->numVars = NULL;
+    e->conTabla = NULL;
+    return ok;
+}
@@ -0,0 +1,355 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "booleanas.h"
+
+#define TAREAS_POR_TANDA 4096
+#define PALABRAS_POR_TANDA ((size_t)1 << 23)   // ~64 MB de tablas por tanda
+
+// Una función a minimizar y dónde quedó su reporte
+typedef struct {
+    TablaVerdad tabla;
+    size_t numero;
+    char origen[64];
+    int trabajador;         // hilo que la procesó
+    long desplazamiento;    // inicio de su texto en el buffer de ese hilo
+    long largo;
+    int ok;
+} Tarea;
+
+// Cola doble de índices de tareas: el dueño toma por el inicio y los
+// ladrones por el final, así casi nunca compiten por el mismo extremo
+typedef struct {
+    pthread_mutex_t mutex;
+    size_t *indices;
+    size_t inicio, fin;
+} ColaTareas;
+
+struct PoolHilos;
+
+typedef struct {
+    pthread_t hilo;
+    int id;
+    ColaTareas cola;
+    FILE *salida;           // buffer privado de salida (open_memstream)
+    char *texto;
+    size_t largoTexto;
+    unsigned semilla;       // para elegir víctimas al robar
+    size_t robadas;
+    struct PoolHilos *pool;
+} Trabajador;
+
+typedef struct PoolHilos {
+    int numHilos;
+    Trabajador *trabajadores;
+    pthread_mutex_t mutex;
+    pthread_cond_t hayTanda;
+    pthread_cond_t tandaLista;
+    unsigned tanda;         // se incrementa al publicar una tanda nueva
+    int ocupados;
+    int salir;
+    Tarea *tareas;
+    size_t numTareas;
+    const OpcionesLote *opciones;
+} PoolHilos;
+
+// ===================== Colas con robo de trabajo =====================
+
+static int tomarPropia(Trabajador *w, size_t *idx) {
+    int ok = 0;
+    pthread_mutex_lock(&w->cola.mutex);
+    if (w->cola.inicio < w->cola.fin) {
+        *idx = w->cola.indices[w->cola.inicio++];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&w->cola.mutex);
+    return ok;
+}
+
+// Recorre las demás colas desde una víctima al azar y roba del final
+static int robar(Trabajador *w, size_t *idx) {
+    PoolHilos *pool = w->pool;
+    int n = pool->numHilos;
+    int desde = (int)(rand_r(&w->semilla) % (unsigned)n);
+    for (int k = 0; k < n; k++) {
+        Trabajador *v = &pool->trabajadores[(desde + k) % n];
+        if (v == w) continue;
+        pthread_mutex_lock(&v->cola.mutex);
+        if (v->cola.inicio < v->cola.fin) {
+            *idx = v->cola.indices[--v->cola.fin];
+            pthread_mutex_unlock(&v->cola.mutex);
+            w->robadas++;
+            return 1;
+        }
+        pthread_mutex_unlock(&v->cola.mutex);
+    }
+    return 0;
+}
+
+static void ejecutarTarea(Trabajador *w, Tarea *t) {
+    t->trabajador = w->id;
+    t->desplazamiento = ftell(w->salida);
+    t->ok = procesarFuncion(w->salida, &t->tabla, t->numero, t->origen, w->pool->opciones);
+    t->largo = ftell(w->salida) - t->desplazamiento;
+}
+
+static void *bucleTrabajador(void *arg) {
+    Trabajador *w = arg;
+    PoolHilos *pool = w->pool;
+    unsigned vista = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (pool->tanda == vista && !pool->salir) {
+            pthread_cond_wait(&pool->hayTanda, &pool->mutex);
+        }
+        if (pool->salir) break;
+        vista = pool->tanda;
+        pthread_mutex_unlock(&pool->mutex);
+
+        // Las tareas no generan tareas nuevas: si no queda nada propio
+        // ni para robar, la tanda terminó para este hilo
+        size_t idx;
+        while (tomarPropia(w, &idx) || robar(w, &idx)) {
+            ejecutarTarea(w, &pool->tareas[idx]);
+        }
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->ocupados == 0) pthread_cond_signal(&pool->tandaLista);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+// ===================== Pool =====================
+
+static void destruirPool(PoolHilos *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->salir = 1;
+    pthread_cond_broadcast(&pool->hayTanda);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->numHilos; i++) {
+        pthread_join(pool->trabajadores[i].hilo, NULL);
+    }
+    if (pool->trabajadores) {
+        for (int i = 0; i < pool->numHilos; i++) {
+            pthread_mutex_destroy(&pool->trabajadores[i].cola.mutex);
+            free(pool->trabajadores[i].cola.indices);
+        }
+    }
+    free(pool->trabajadores);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->hayTanda);
+    pthread_cond_destroy(&pool->tandaLista);
+}
+
+static int crearPool(PoolHilos *pool, int numHilos, const OpcionesLote *op) {
+    memset(pool, 0, sizeof(*pool));
+    pool->numHilos = numHilos;
+    pool->opciones = op;
+    pool->trabajadores = calloc((size_t)numHilos, sizeof(Trabajador));
+    if (pool->trabajadores == NULL) return 0;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->hayTanda, NULL);
+    pthread_cond_init(&pool->tandaLista, NULL);
+
+    int listos = 0;             // trabajadores con cola
+    for (; listos < numHilos; listos++) {
+        Trabajador *w = &pool->trabajadores[listos];
+        w->id = listos;
+        w->pool = pool;
+        w->semilla = 0x9E3779B9u * (unsigned)(listos + 1);
+        w->cola.indices = malloc(TAREAS_POR_TANDA * sizeof(size_t));
+        if (w->cola.indices == NULL) break;
+        pthread_mutex_init(&w->cola.mutex, NULL);
+    }
+    int lanzados = 0;
+    if (listos == numHilos) {
+        while (lanzados < numHilos &&
+               pthread_create(&pool->trabajadores[lanzados].hilo, NULL, bucleTrabajador, &pool->trabajadores[lanzados]) == 0) {
+            lanzados++;
+        }
+    }
+    if (lanzados < numHilos) {
+        // Las colas de los que no arrancaron se liberan acá; destruirPool
+        // detiene a los que sí y libera el resto
+        for (int i = lanzados; i < listos; i++) {
+            pthread_mutex_destroy(&pool->trabajadores[i].cola.mutex);
+            free(pool->trabajadores[i].cola.indices);
+        }
+        pool->numHilos = lanzados;
+        destruirPool(pool);
+        return 0;
+    }
+    return 1;
+}
+
+// Reparte la tanda en bloques contiguos y la publica (no espera)
+static int iniciarTanda(PoolHilos *pool, Tarea *tareas, size_t numTareas) {
+    int n = pool->numHilos;
+    for (int i = 0; i < n; i++) {
+        Trabajador *w = &pool->trabajadores[i];
+        w->texto = NULL;
+        w->largoTexto = 0;
+        w->salida = open_memstream(&w->texto, &w->largoTexto);
+        if (w->salida == NULL) {
+            for (int j = 0; j < i; j++) {
+                fclose(pool->trabajadores[j].salida);
+                free(pool->trabajadores[j].texto);
+                pool->trabajadores[j].texto = NULL;
+            }
+            return 0;
+        }
+        w->cola.inicio = 0;
+        w->cola.fin = 0;
+        for (size_t t = numTareas * (size_t)i / (size_t)n; t < numTareas * (size_t)(i + 1) / (size_t)n; t++) {
+            w->cola.indices[w->cola.fin++] = t;
+        }
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->tareas = tareas;
+    pool->numTareas = numTareas;
+    pool->ocupados = n;
+    pool->tanda++;
+    pthread_cond_broadcast(&pool->hayTanda);
+    pthread_mutex_unlock(&pool->mutex);
+    return 1;
+}
+
+// Espera la tanda y escribe los reportes en el orden de entrada
+static void terminarTanda(PoolHilos *pool, FILE *destino, size_t *errores) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->ocupados > 0) pthread_cond_wait(&pool->tandaLista, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->numHilos; i++) fclose(pool->trabajadores[i].salida);
+    for (size_t k = 0; k < pool->numTareas; k++) {
+        Tarea *t = &pool->tareas[k];
+        if (destino) {
+            fwrite(pool->trabajadores[t->trabajador].texto + t->desplazamiento, 1, (size_t)t->largo, destino);
+        }
+        if (!t->ok && errores) (*errores)++;
+    }
+    for (int i = 0; i < pool->numHilos; i++) {
+        free(pool->trabajadores[i].texto);
+        pool->trabajadores[i].texto = NULL;
+    }
+}
+
+// Llena una tanda desde el lector; devuelve cuántas funciones leyó
+static size_t leerTanda(LectorFunciones *l, Tarea *tareas, size_t *numero, size_t *errores) {
+    size_t cantidad = 0, palabras = 0;
+    int r;
+    while (cantidad < TAREAS_POR_TANDA && palabras < PALABRAS_POR_TANDA &&
+           (r = leerFuncion(l, &tareas[cantidad].tabla)) != 0) {
+        if (r < 0) {
+            (*errores)++;
+            continue;
+        }
+        Tarea *t = &tareas[cantidad++];
+        t->numero = ++(*numero);
+        snprintf(t->origen, sizeof(t->origen), "%s", l->origen);
+        palabras += t->tabla.palabras;
+    }
+    return cantidad;
+}
+
+static void liberarTanda(Tarea *tareas, size_t cantidad) {
+    for (size_t k = 0; k < cantidad; k++) liberarTabla(&tareas[k].tabla);
+}
+
+// ===================== Interfaz pública =====================
+
+// Lee por tandas y, mientras los hilos minimizan una, lee la siguiente
+int procesarLoteParalelo(LectorFunciones *l, const OpcionesLote *op, size_t *procesadas, size_t *errores) {
+    PoolHilos pool;
+    Tarea *tandas[2];
+    tandas[0] = calloc(TAREAS_POR_TANDA, sizeof(Tarea));
+    tandas[1] = calloc(TAREAS_POR_TANDA, sizeof(Tarea));
+    if (tandas[0] == NULL || tandas[1] == NULL || !crearPool(&pool, op->hilos, op)) {
+        free(tandas[0]);
+        free(tandas[1]);
+        return 0;
+    }
+
+    int ok = 1, actual = 0;
+    size_t cantidad = leerTanda(l, tandas[actual], procesadas, errores);
+    while (cantidad > 0) {
+        if (!iniciarTanda(&pool, tandas[actual], cantidad)) { ok = 0; break; }
+        size_t siguiente = leerTanda(l, tandas[1 - actual], procesadas, errores);
+        terminarTanda(&pool, stdout, errores);
+        liberarTanda(tandas[actual], cantidad);
+        actual = 1 - actual;
+        cantidad = siguiente;
+    }
+    liberarTanda(tandas[actual], cantidad);
+
+    destruirPool(&pool);
+    free(tandas[0]);
+    free(tandas[1]);
+    return ok;
+}
+
+static double segundosDesde(const struct timespec *inicio) {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (double)(ahora.tv_sec - inicio->tv_sec) + (double)(ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Carga todas las funciones una vez y mide funciones/segundo con 1..maxHilos
+// (el texto se genera igual, pero se descarta en lugar de escribirse)
+int medirEscalabilidad(LectorFunciones *l, const OpcionesLote *op, int maxHilos) {
+    size_t capacidad = TAREAS_POR_TANDA, total = 0, numero = 0, errores = 0;
+    Tarea *tareas = malloc(capacidad * sizeof(Tarea));
+    if (tareas == NULL) return 1;
+    for (;;) {
+        if (total + TAREAS_POR_TANDA > capacidad) {
+            Tarea *nuevas = realloc(tareas, capacidad * 2 * sizeof(Tarea));
+            if (nuevas == NULL) break;
+            tareas = nuevas;
+            capacidad *= 2;
+        }
+        size_t leidas = leerTanda(l, tareas + total, &numero, &errores);
+        if (leidas == 0) break;
+        total += leidas;
+    }
+    if (total == 0) {
+        fprintf(stderr, "No hay funciones para medir\n");
+        free(tareas);
+        return 1;
+    }
+
+    printf("Funciones: %zu\n", total);
+    printf("Hilos | Tiempo (s) | Funciones/s | Aceleración | Robos\n");
+    double base = 0;
+    for (int h = 1; h <= maxHilos; h++) {
+        OpcionesLote opHilos = *op;
+        opHilos.hilos = h;
+        PoolHilos pool;
+        if (!crearPool(&pool, h, &opHilos)) {
+            fprintf(stderr, "No se pudo crear el pool de %d hilos\n", h);
+            break;
+        }
+        struct timespec inicio;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        for (size_t desde = 0; desde < total; desde += TAREAS_POR_TANDA) {
+            size_t cantidad = total - desde < TAREAS_POR_TANDA ? total - desde : TAREAS_POR_TANDA;
+            if (!iniciarTanda(&pool, tareas + desde, cantidad)) break;
+            terminarTanda(&pool, NULL, NULL);
+        }
+        double dt = segundosDesde(&inicio);
+        size_t robos = 0;
+        for (int i = 0; i < h; i++) robos += pool.trabajadores[i].robadas;
+        destruirPool(&pool);
+
+        if (h == 1) base = dt;
+        printf("%5d | %10.3f | %11.0f | %10.2fx | %zu\n", h, dt, (double)total / dt, base / dt, robos);
+    }
+
+    liberarTanda(tareas, total);
+    free(tareas);
+    return errores > 0;
+}
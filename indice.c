@@ -0,0 +1,282 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "planificador.h"
+
+#define SIN_PRODUCTO UINT32_MAX
+#define GRAMA_OCUPADO 0x80000000u
+#define RANURAS_INICIALES 64
+#define MAX_GRAMAS (3 * MAX_NOMBRE)
+
+void iniciarIndice(IndiceNombres *ind) {
+    memset(ind, 0, sizeof(*ind));
+}
+
+void liberarIndice(IndiceNombres *ind) {
+    if(ind->gramas) {
+        for(size_t i = 0; i <= ind->mascaraGramas; i++) free(ind->gramas[i].productos);
+    }
+    free(ind->gramas);
+    free(ind->ranuras);
+    iniciarIndice(ind);
+}
+
+// FNV-1a de 32 bits
+static uint32_t hashNombre(const char *s) {
+    uint32_t h = 2166136261u;
+    for(; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static size_t posicionGrama(uint32_t grama, size_t mascara) {
+    return (size_t)(grama * 2654435761u) & mascara;
+}
+
+// Clave del n-grama de 'largo' caracteres (1 a 3) que empieza en s
+static uint32_t claveGrama(const char *s, int largo) {
+    uint32_t clave = (uint32_t)largo << 24;
+    for(int k = 0; k < largo; k++) clave |= (uint32_t)(unsigned char)s[k] << (8 * (largo - 1 - k));
+    return clave;
+}
+
+// N-gramas distintos de s (de 1 a 3 caracteres, o solo de 3 si soloTres),
+// ordenados; devuelve cuántos hay
+static size_t gramasDe(const char *s, int soloTres, uint32_t *salida) {
+    size_t n = 0;
+    for(size_t k = 0; s[k]; k++) {
+        for(int largo = soloTres ? 3 : 1; largo <= 3; largo++) {
+            if(largo >= 2 && s[k + 1] == '\0') break;
+            if(largo == 3 && s[k + 2] == '\0') break;
+            uint32_t t = claveGrama(&s[k], largo);
+            // Inserción ordenada descartando repetidos
+            size_t j = n;
+            while(j > 0 && salida[j - 1] > t) j--;
+            if(j > 0 && salida[j - 1] == t) continue;
+            memmove(&salida[j + 1], &salida[j], (n - j) * sizeof(uint32_t));
+            salida[j] = t;
+            n++;
+        }
+    }
+    return n;
+}
+
+// ===================== Tabla de nombres exactos =====================
+
+static int crecerRanuras(IndiceNombres *ind) {
+    size_t capacidad = ind->ranuras ? 2 * (ind->mascara + 1) : RANURAS_INICIALES;
+    RanuraNombre *nuevas = malloc(capacidad * sizeof(RanuraNombre));
+    if(nuevas == NULL) return 0;
+    for(size_t i = 0; i < capacidad; i++) nuevas[i].producto = SIN_PRODUCTO;
+
+    for(size_t i = 0; ind->ranuras && i <= ind->mascara; i++) {
+        if(ind->ranuras[i].producto == SIN_PRODUCTO) continue;
+        size_t p = ind->ranuras[i].hash & (capacidad - 1);
+        while(nuevas[p].producto != SIN_PRODUCTO) p = (p + 1) & (capacidad - 1);
+        nuevas[p] = ind->ranuras[i];
+    }
+    free(ind->ranuras);
+    ind->ranuras = nuevas;
+    ind->mascara = capacidad - 1;
+    return 1;
+}
+
+static int insertarExacto(IndiceNombres *ind, uint32_t hash, uint32_t producto) {
+    if(ind->ranuras == NULL || 2 * (ind->ocupadas + 1) > ind->mascara + 1) {
+        if(!crecerRanuras(ind)) return 0;
+    }
+    size_t p = hash & ind->mascara;
+    while(ind->ranuras[p].producto != SIN_PRODUCTO) p = (p + 1) & ind->mascara;
+    ind->ranuras[p].hash = hash;
+    ind->ranuras[p].producto = producto;
+    ind->ocupadas++;
+    return 1;
+}
+
+static long buscarRanura(const IndiceNombres *ind, uint32_t hash, uint32_t producto) {
+    if(ind->ranuras == NULL) return -1;
+    for(size_t p = hash & ind->mascara; ind->ranuras[p].producto != SIN_PRODUCTO; p = (p + 1) & ind->mascara) {
+        if(ind->ranuras[p].producto == producto) return (long)p;
+    }
+    return -1;
+}
+
+// Borrado con corrimiento hacia atrás: no deja lápidas en la tabla
+static void quitarExacto(IndiceNombres *ind, uint32_t hash, uint32_t producto) {
+    long encontrada = buscarRanura(ind, hash, producto);
+    if(encontrada < 0) return;
+    size_t hueco = (size_t)encontrada;
+    for(size_t p = (hueco + 1) & ind->mascara; ind->ranuras[p].producto != SIN_PRODUCTO; p = (p + 1) & ind->mascara) {
+        size_t inicio = ind->ranuras[p].hash & ind->mascara;
+        // La entrada en p puede pasar al hueco si su posición inicial no
+        // está entre el hueco (exclusive) y p (inclusive)
+        int entre = (hueco <= p) ? (inicio > hueco && inicio <= p) : (inicio > hueco || inicio <= p);
+        if(!entre) {
+            ind->ranuras[hueco] = ind->ranuras[p];
+            hueco = p;
+        }
+    }
+    ind->ranuras[hueco].producto = SIN_PRODUCTO;
+    ind->ocupadas--;
+}
+
+// ===================== Listas por n-grama =====================
+
+static int crecerGramas(IndiceNombres *ind) {
+    size_t capacidad = ind->gramas ? 2 * (ind->mascaraGramas + 1) : RANURAS_INICIALES;
+    ListaGrama *nuevas = calloc(capacidad, sizeof(ListaGrama));
+    if(nuevas == NULL) return 0;
+    for(size_t i = 0; ind->gramas && i <= ind->mascaraGramas; i++) {
+        if(ind->gramas[i].clave == 0) continue;
+        size_t p = posicionGrama(ind->gramas[i].clave & ~GRAMA_OCUPADO, capacidad - 1);
+        while(nuevas[p].clave != 0) p = (p + 1) & (capacidad - 1);
+        nuevas[p] = ind->gramas[i];
+    }
+    free(ind->gramas);
+    ind->gramas = nuevas;
+    ind->mascaraGramas = capacidad - 1;
+    return 1;
+}
+
+// Ranura del n-grama, o la primera libre de su secuencia si no está
+static size_t ranuraGrama(const IndiceNombres *ind, uint32_t grama) {
+    uint32_t clave = grama | GRAMA_OCUPADO;
+    size_t p = posicionGrama(grama, ind->mascaraGramas);
+    while(ind->gramas[p].clave != 0 && ind->gramas[p].clave != clave) p = (p + 1) & ind->mascaraGramas;
+    return p;
+}
+
+// Lista del n-grama, o NULL si no existe (y crear == 0) o no hay memoria
+static ListaGrama *listaGrama(IndiceNombres *ind, uint32_t grama, int crear) {
+    if(crear && (ind->gramas == NULL || 2 * (ind->usadosGramas + 1) > ind->mascaraGramas + 1)) {
+        if(!crecerGramas(ind)) return NULL;
+    }
+    if(ind->gramas == NULL) return NULL;
+    ListaGrama *l = &ind->gramas[ranuraGrama(ind, grama)];
+    if(l->clave == 0) {
+        if(!crear) return NULL;
+        l->clave = grama | GRAMA_OCUPADO;
+        ind->usadosGramas++;
+    }
+    return l;
+}
+
+static int agregarALista(ListaGrama *l, uint32_t producto) {
+    if(l->cantidad == l->capacidad) {
+        uint32_t capacidad = l->capacidad ? 2 * l->capacidad : 4;
+        uint32_t *p = realloc(l->productos, capacidad * sizeof(uint32_t));
+        if(p == NULL) return 0;
+        l->productos = p;
+        l->capacidad = capacidad;
+    }
+    l->productos[l->cantidad++] = producto;
+    return 1;
+}
+
+// Reemplaza 'desde' por 'hacia' en la lista (SIN_PRODUCTO = quitarlo)
+static void cambiarEnLista(ListaGrama *l, uint32_t desde, uint32_t hacia) {
+    for(uint32_t i = 0; i < l->cantidad; i++) {
+        if(l->productos[i] != desde) continue;
+        if(hacia == SIN_PRODUCTO) l->productos[i] = l->productos[--l->cantidad];
+        else l->productos[i] = hacia;
+        return;
+    }
+}
+
+// ===================== Operaciones del catálogo =====================
+
+// Si falla por memoria el producto puede quedar indexado a medias; quien
+// llama lo deshace con desindexarProducto
+int indexarProducto(Catalogo *cat, size_t producto) {
+    IndiceNombres *ind = &cat->indice;
+    const char *nombre = nombreMinusculas(cat, producto);
+    if(!insertarExacto(ind, hashNombre(nombre), (uint32_t)producto)) return 0;
+
+    uint32_t gramas[MAX_GRAMAS];
+    size_t n = gramasDe(nombre, 0, gramas);
+    for(size_t k = 0; k < n; k++) {
+        ListaGrama *l = listaGrama(ind, gramas[k], 1);
+        if(l == NULL || !agregarALista(l, (uint32_t)producto)) return 0;
+    }
+    return 1;
+}
+
+void desindexarProducto(Catalogo *cat, size_t producto) {
+    IndiceNombres *ind = &cat->indice;
+    const char *nombre = nombreMinusculas(cat, producto);
+    quitarExacto(ind, hashNombre(nombre), (uint32_t)producto);
+
+    uint32_t gramas[MAX_GRAMAS];
+    size_t n = gramasDe(nombre, 0, gramas);
+    for(size_t k = 0; k < n; k++) {
+        ListaGrama *l = listaGrama(ind, gramas[k], 0);
+        if(l) cambiarEnLista(l, (uint32_t)producto, SIN_PRODUCTO);
+    }
+}
+
+// El producto 'desde' pasa a llamarse 'hacia' (borrado con intercambio)
+void renumerarProducto(Catalogo *cat, size_t desde, size_t hacia) {
+    IndiceNombres *ind = &cat->indice;
+    const char *nombre = nombreMinusculas(cat, desde);
+    long r = buscarRanura(ind, hashNombre(nombre), (uint32_t)desde);
+    if(r >= 0) ind->ranuras[r].producto = (uint32_t)hacia;
+
+    uint32_t gramas[MAX_GRAMAS];
+    size_t n = gramasDe(nombre, 0, gramas);
+    for(size_t k = 0; k < n; k++) {
+        ListaGrama *l = listaGrama(ind, gramas[k], 0);
+        if(l) cambiarEnLista(l, (uint32_t)desde, (uint32_t)hacia);
+    }
+}
+
+// Busca sin distinguir mayúsculas: primero el nombre exacto y si no hay,
+// el primer producto (menor índice) que contenga el texto. Hasta tres
+// caracteres la lista del n-grama es exactamente la respuesta; con más solo
+// se revisan los productos de la lista más corta entre los trigramas.
+long buscarEnCatalogo(const Catalogo *cat, const char *texto) {
+    const IndiceNombres *ind = &cat->indice;
+    char busqueda[MAX_NOMBRE];
+    size_t largo = 0;
+    for(; texto[largo] && largo < MAX_NOMBRE - 1; largo++) {
+        busqueda[largo] = (char)tolower((unsigned char)texto[largo]);
+    }
+    busqueda[largo] = '\0';
+
+    uint32_t hash = hashNombre(busqueda);
+    size_t mejor = SIZE_MAX;
+    for(size_t p = ind->ranuras ? (hash & ind->mascara) : 0;
+        ind->ranuras && ind->ranuras[p].producto != SIN_PRODUCTO; p = (p + 1) & ind->mascara) {
+        uint32_t producto = ind->ranuras[p].producto;
+        if(ind->ranuras[p].hash == hash && producto < mejor &&
+           strcmp(nombreMinusculas(cat, producto), busqueda) == 0) {
+            mejor = producto;
+        }
+    }
+    if(mejor != SIZE_MAX) return (long)mejor;
+
+    if(largo == 0) return cat->cantidad > 0 ? 0 : -1;
+    if(ind->gramas == NULL) return -1;
+    if(largo <= 3) {
+        const ListaGrama *l = &ind->gramas[ranuraGrama(ind, claveGrama(busqueda, (int)largo))];
+        for(uint32_t i = 0; l->clave != 0 && i < l->cantidad; i++) {
+            if(l->productos[i] < mejor) mejor = l->productos[i];
+        }
+        return (mejor != SIZE_MAX) ? (long)mejor : -1;
+    }
+
+    uint32_t gramas[MAX_GRAMAS];
+    size_t n = gramasDe(busqueda, 1, gramas);
+    const ListaGrama *corta = NULL;
+    for(size_t k = 0; k < n; k++) {
+        const ListaGrama *l = &ind->gramas[ranuraGrama(ind, gramas[k])];
+        if(l->clave == 0 || l->cantidad == 0) return -1;
+        if(corta == NULL || l->cantidad < corta->cantidad) corta = l;
+    }
+    for(uint32_t i = 0; i < corta->cantidad; i++) {
+        uint32_t producto = corta->productos[i];
+        if(producto < mejor && strstr(nombreMinusculas(cat, producto), busqueda) != NULL) mejor = producto;
+    }
+    return (mejor != SIZE_MAX) ? (long)mejor : -1;
+}
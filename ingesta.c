@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "monitor.h"
+
+// Ingesta continua de lecturas con hora, desde un archivo o una tubería, en
+// CSV o en el formato binario de monitor.h (se reconoce por la magia). Un
+// archivo común se mapea en memoria y se recorre entero sin copiar; una
+// tubería se lee por lotes de TAM_LOTE bytes y se procesan todas las
+// líneas o registros completos del lote, que se leen en el mismo buffer.
+//
+// CSV: tiempo,zona,PM2.5,PM10,NO2,SO2[,temperatura,humedad,viento]
+// con el tiempo en segundos desde 1970 (UTC); los datos de clima pueden
+// faltar o quedar vacíos. La primera línea puede ser un encabezado y las
+// que empiezan con '#' se ignoran.
+
+#define TAM_LOTE (1 << 20)
+#define MAX_DIGITOS 18
+
+enum { FORMATO_DESCONOCIDO, FORMATO_CSV, FORMATO_BINARIO };
+
+typedef struct {
+    RegistroZonas *reg;
+    EstadisticasIngesta *est;
+    int formato;
+    int primera_linea;
+    int cabecera_leida;
+    uint32_t num_zonas;         // binario: zonas de la cabecera
+    int *zonas;                 // binario: índice en el registro de cada una (-1 = sin lugar)
+    const char *error;
+} Ingesta;
+
+static const double potencias_diez[MAX_DIGITOS + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+// Función para aplicar una lectura ya validada: entra en la serie de la zona
+// y, si es la más reciente, pasa a ser el nivel actual
+void aplicar_lectura(Zona *zona, int64_t tiempo, const float *contaminantes, const float *clima,
+                     EstadisticasIngesta *est) {
+    if(!agregar_a_serie(&zona->serie, tiempo, contaminantes)) est->atrasadas++;
+    if(tiempo >= zona->ultima_lectura) {
+        memcpy(zona->contaminantes, contaminantes, sizeof(zona->contaminantes));
+        for(int k = 0; k < NUM_CLIMA; k++) {
+            if(!isnan(clima[k])) zona->clima[k] = clima[k];
+        }
+        zona->ultima_lectura = tiempo;
+    }
+    zona->lecturas++;
+    est->lecturas++;
+    if(tiempo > est->ultima_lectura) est->ultima_lectura = tiempo;
+}
+
+static int lectura_valida(const float *contaminantes, const float *clima) {
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+        if(!(contaminantes[c] >= rangos_min[c] && contaminantes[c] <= rangos_max[c])) return 0;
+    }
+    for(int k = 0; k < NUM_CLIMA; k++) {
+        if(!isnan(clima[k]) && !(clima[k] >= clima_min[k] && clima[k] <= clima_max[k])) return 0;
+    }
+    return 1;
+}
+
+// Número decimal sin exponente ([-+]123.45); devuelve el puntero al primer
+// carácter siguiente o NULL si no hay número. Los dígitos se acumulan en un
+// entero y se dividen una sola vez por la potencia de diez.
+static const char *leer_decimal(const char *p, const char *fin, float *valor) {
+    int negativo = 0, digitos = 0, decimales = 0, hay_digitos = 0;
+    uint64_t m = 0;
+    if(p < fin && (*p == '-' || *p == '+')) negativo = *p++ == '-';
+    for(; p < fin && (unsigned)(*p - '0') < 10; p++, hay_digitos = 1) {
+        if(digitos == MAX_DIGITOS) return NULL;
+        m = m * 10 + (uint64_t)(*p - '0');
+        digitos += m > 0;
+    }
+    if(p < fin && *p == '.') {
+        for(p++; p < fin && (unsigned)(*p - '0') < 10; p++, hay_digitos = 1) {
+            if(digitos == MAX_DIGITOS || decimales == MAX_DIGITOS) continue;  // sin peso en un float
+            m = m * 10 + (uint64_t)(*p - '0');
+            digitos += m > 0;
+            decimales++;
+        }
+    }
+    if(!hay_digitos) return NULL;
+    double v = (double)m / potencias_diez[decimales];
+    *valor = (float)(negativo ? -v : v);
+    return p;
+}
+
+// Una línea CSV sin el '\n'
+static void leer_linea_csv(Ingesta *in, const char *p, const char *fin) {
+    int primera = in->primera_linea;
+    in->primera_linea = 0;
+    if(fin > p && fin[-1] == '\r') fin--;
+    if(p == fin || *p == '#') return;
+    if(primera && (unsigned)(*p - '0') >= 10) return;   // encabezado
+
+    uint64_t tiempo = 0;
+    const char *inicio = p;
+    for(; p < fin && (unsigned)(*p - '0') < 10; p++) tiempo = tiempo * 10 + (uint64_t)(*p - '0');
+    if(p == inicio || p - inicio > 12 || p == fin || *p != ',') {
+        in->est->invalidas++;
+        return;
+    }
+    const char *nombre = ++p;
+    const char *coma = memchr(p, ',', (size_t)(fin - p));
+    if(coma == NULL || coma == nombre) {
+        in->est->invalidas++;
+        return;
+    }
+    p = coma;
+
+    float contaminantes[NUM_CONTAMINANTES];
+    float clima[NUM_CLIMA] = { NAN, NAN, NAN };
+    for(int c = 0; c < NUM_CONTAMINANTES && p != NULL; c++) {
+        p = p < fin && *p == ',' ? leer_decimal(p + 1, fin, &contaminantes[c]) : NULL;
+    }
+    for(int k = 0; k < NUM_CLIMA && p != NULL && p < fin; k++) {
+        if(*p != ',') p = NULL;
+        else if(p + 1 < fin && p[1] != ',') p = leer_decimal(p + 1, fin, &clima[k]);
+        else p++;
+    }
+    if(p != fin || !lectura_valida(contaminantes, clima)) {
+        in->est->invalidas++;
+        return;
+    }
+    int z = registrar_zona(in->reg, nombre, (size_t)(coma - nombre));
+    if(z < 0) {
+        if(coma - nombre < MAX_NOMBRE_ZONA) in->est->sin_lugar++;
+        else in->est->invalidas++;
+        return;
+    }
+    aplicar_lectura(&in->reg->zonas[z], (int64_t)tiempo, contaminantes, clima, in->est);
+}
+
+static size_t procesar_csv(Ingesta *in, const char *datos, size_t largo, int final) {
+    const char *p = datos, *fin = datos + largo;
+    for(;;) {
+        const char *salto = memchr(p, '\n', (size_t)(fin - p));
+        if(salto == NULL) break;
+        leer_linea_csv(in, p, salto);
+        p = salto + 1;
+    }
+    if(final && p < fin) {
+        leer_linea_csv(in, p, fin);
+        p = fin;
+    }
+    return (size_t)(p - datos);
+}
+
+static size_t leer_cabecera(Ingesta *in, const char *datos, size_t largo) {
+    CabeceraLecturas c;
+    if(largo < sizeof(c)) return 0;
+    memcpy(&c, datos, sizeof(c));
+    if(c.version != VERSION_LECTURAS || c.tam_registro != sizeof(RegistroLectura) ||
+       c.num_zonas > (TAM_LOTE - sizeof(c)) / MAX_NOMBRE_ZONA) {
+        in->error = "cabecera binaria inválida";
+        return 0;
+    }
+    size_t total = sizeof(c) + (size_t)c.num_zonas * MAX_NOMBRE_ZONA;
+    if(largo < total) return 0;
+    in->zonas = malloc(((size_t)c.num_zonas + 1) * sizeof(int));
+    if(in->zonas == NULL) {
+        in->error = "no hay memoria";
+        return 0;
+    }
+    for(uint32_t z = 0; z < c.num_zonas; z++) {
+        const char *nombre = datos + sizeof(c) + (size_t)z * MAX_NOMBRE_ZONA;
+        in->zonas[z] = registrar_zona(in->reg, nombre, strnlen(nombre, MAX_NOMBRE_ZONA));
+    }
+    in->num_zonas = c.num_zonas;
+    in->cabecera_leida = 1;
+    return total;
+}
+
+static size_t procesar_binario(Ingesta *in, const char *datos, size_t largo, int final) {
+    size_t usado = 0;
+    if(!in->cabecera_leida) {
+        usado = leer_cabecera(in, datos, largo);
+        if(!in->cabecera_leida) {
+            if(final && in->error == NULL) in->error = "cabecera binaria incompleta";
+            return 0;
+        }
+    }
+    for(; largo - usado >= sizeof(RegistroLectura); usado += sizeof(RegistroLectura)) {
+        RegistroLectura r;
+        memcpy(&r, datos + usado, sizeof(r));
+        if(r.zona >= in->num_zonas || !lectura_valida(r.contaminantes, r.clima)) {
+            in->est->invalidas++;
+        } else if(in->zonas[r.zona] < 0) {
+            in->est->sin_lugar++;
+        } else {
+            aplicar_lectura(&in->reg->zonas[in->zonas[r.zona]], r.tiempo, r.contaminantes, r.clima, in->est);
+        }
+    }
+    if(final && usado < largo) {
+        in->est->invalidas++;   // registro cortado al final
+        usado = largo;
+    }
+    return usado;
+}
+
+// Procesa lo que haya completo en datos[0..largo) y devuelve cuántos bytes
+// consumió; con 'final' no queda nada pendiente
+static size_t procesar(Ingesta *in, const char *datos, size_t largo, int final) {
+    if(in->formato == FORMATO_DESCONOCIDO) {
+        if(largo < 4 && !final) return 0;
+        in->formato = largo >= 4 && memcmp(datos, MAGIA_LECTURAS, 4) == 0 ? FORMATO_BINARIO : FORMATO_CSV;
+    }
+    return in->formato == FORMATO_CSV ? procesar_csv(in, datos, largo, final)
+                                      : procesar_binario(in, datos, largo, final);
+}
+
+static void iniciar_ingesta(Ingesta *in, RegistroZonas *reg, EstadisticasIngesta *est) {
+    memset(in, 0, sizeof(*in));
+    in->reg = reg;
+    in->est = est;
+    in->primera_linea = 1;
+}
+
+// Función para ingerir desde un descriptor (tubería, terminal o archivo)
+// por lotes
+int ingerir_descriptor(RegistroZonas *reg, int fd, EstadisticasIngesta *est) {
+    Ingesta in;
+    size_t usado = 0;
+    char *lote = malloc(TAM_LOTE);
+    iniciar_ingesta(&in, reg, est);
+    if(lote == NULL) return 0;
+
+    for(;;) {
+        ssize_t n = read(fd, lote + usado, TAM_LOTE - usado);
+        if(n < 0 && errno == EINTR) continue;
+        if(n < 0) {
+            in.error = "error de lectura";
+            break;
+        }
+        usado += (size_t)n;
+        size_t consumido = procesar(&in, lote, usado, n == 0);
+        if(in.error != NULL || n == 0) break;
+        if(consumido == 0 && usado == TAM_LOTE) {
+            in.error = in.formato == FORMATO_CSV ? "línea demasiado larga" : "cabecera binaria inválida";
+            break;
+        }
+        memmove(lote, lote + consumido, usado - consumido);
+        usado -= consumido;
+    }
+    if(in.error != NULL) printf("❌ Error: %s\n", in.error);
+    free(in.zonas);
+    free(lote);
+    return in.error == NULL;
+}
+
+// Función para ingerir un archivo ("-" = entrada estándar); un archivo
+// común se mapea en memoria y se procesa de una vez
+int ingerir_archivo(RegistroZonas *reg, const char *ruta, EstadisticasIngesta *est) {
+    if(strcmp(ruta, "-") == 0) return ingerir_descriptor(reg, STDIN_FILENO, est);
+    int fd = open(ruta, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0) {
+        printf("❌ Error: No se pudo abrir %s\n", ruta);
+        if(fd >= 0) close(fd);
+        return 0;
+    }
+    if(!S_ISREG(st.st_mode) || st.st_size == 0) {
+        int ok = ingerir_descriptor(reg, fd, est);
+        close(fd);
+        return ok;
+    }
+
+    void *mapa = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapa == MAP_FAILED) {
+        printf("❌ Error: No se pudo mapear %s\n", ruta);
+        return 0;
+    }
+    madvise(mapa, (size_t)st.st_size, MADV_SEQUENTIAL);
+    Ingesta in;
+    iniciar_ingesta(&in, reg, est);
+    procesar(&in, mapa, (size_t)st.st_size, 1);
+    munmap(mapa, (size_t)st.st_size);
+    if(in.error != NULL) printf("❌ Error: %s: %s\n", ruta, in.error);
+    free(in.zonas);
+    return in.error == NULL;
+}
@@ -0,0 +1,465 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "booleanas.h"
+
+// ===================== Lectura en bloque =====================
+
+int abrirLector(LectorFunciones *l, const char *ruta, FormatoEntrada formato) {
+    memset(l, 0, sizeof(*l));
+    l->formato = formato;
+    if (ruta == NULL || strcmp(ruta, "-") == 0) {
+        l->archivo = stdin;
+    } else {
+        l->archivo = fopen(ruta, formato == FORMATO_BIN ? "rb" : "r");
+        if (l->archivo == NULL) return 0;
+    }
+    l->buffer = malloc(TAM_BUFFER_LECTURA);
+    l->capLinea = 256;
+    l->linea = malloc(l->capLinea);
+    return l->buffer != NULL && l->linea != NULL;
+}
+
+static void liberarSalidasPLA(LectorFunciones *l) {
+    for (int i = l->sigSalidaPLA; i < l->numSalidasPLA; i++) {
+        liberarTabla(&l->salidasPLA[i]);
+    }
+    free(l->salidasPLA);
+    l->salidasPLA = NULL;
+    l->numSalidasPLA = 0;
+    l->sigSalidaPLA = 0;
+}
+
+void cerrarLector(LectorFunciones *l) {
+    liberarSalidasPLA(l);
+    if (l->archivo && l->archivo != stdin) fclose(l->archivo);
+    free(l->buffer);
+    free(l->linea);
+    l->archivo = NULL;
+    l->buffer = NULL;
+    l->linea = NULL;
+}
+
+// Rellena el bloque cuando se consumió por completo
+static int rellenar(LectorFunciones *l) {
+    if (l->finArchivo) return 0;
+    l->inicio = 0;
+    l->fin = fread(l->buffer, 1, TAM_BUFFER_LECTURA, l->archivo);
+    if (l->fin == 0) l->finArchivo = 1;
+    return l->fin > 0;
+}
+
+// Lee la siguiente línea (sin '\n' ni '\r'); devuelve su largo o -1 al final
+static long leerLinea(LectorFunciones *l) {
+    size_t largo = 0;
+    int leyoAlgo = 0;
+    if (l->lineaDevuelta) {
+        l->lineaDevuelta = 0;
+        l->numLinea++;
+        return (long)strlen(l->linea);
+    }
+    for (;;) {
+        if (l->inicio == l->fin && !rellenar(l)) break;
+        leyoAlgo = 1;
+        char *desde = l->buffer + l->inicio;
+        size_t disponible = l->fin - l->inicio;
+        char *nl = memchr(desde, '\n', disponible);
+        size_t tomar = nl ? (size_t)(nl - desde) : disponible;
+        if (largo + tomar + 1 > l->capLinea) {
+            size_t cap = l->capLinea;
+            while (largo + tomar + 1 > cap) cap *= 2;
+            char *nueva = realloc(l->linea, cap);
+            if (nueva == NULL) return -1;
+            l->linea = nueva;
+            l->capLinea = cap;
+        }
+        memcpy(l->linea + largo, desde, tomar);
+        largo += tomar;
+        l->inicio += tomar + (nl ? 1 : 0);
+        if (nl) break;
+    }
+    if (!leyoAlgo && largo == 0) return -1;
+    if (largo > 0 && l->linea[largo - 1] == '\r') largo--;
+    l->linea[largo] = '\0';
+    l->numLinea++;
+    return (long)largo;
+}
+
+// La próxima llamada a leerLinea devolverá otra vez la línea actual
+static void devolverLinea(LectorFunciones *l) {
+    l->lineaDevuelta = 1;
+    l->numLinea--;
+}
+
+// Copia bytes crudos del flujo (formato binario)
+static int leerBytes(LectorFunciones *l, unsigned char *destino, size_t cantidad) {
+    while (cantidad > 0) {
+        if (l->inicio == l->fin && !rellenar(l)) return 0;
+        size_t tomar = l->fin - l->inicio;
+        if (tomar > cantidad) tomar = cantidad;
+        memcpy(destino, l->buffer + l->inicio, tomar);
+        l->inicio += tomar;
+        destino += tomar;
+        cantidad -= tomar;
+    }
+    return 1;
+}
+
+// n tal que 2^n == x, o -1 si x no es potencia de dos
+static int log2Exacto(size_t x) {
+    if (x == 0 || (x & (x - 1))) return -1;
+    return __builtin_ctzll((unsigned long long)x);
+}
+
+static int valorHex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// ===================== Formatos de una línea =====================
+
+static int errorLinea(LectorFunciones *l, const char *mensaje) {
+    fprintf(stderr, "Línea %zu: %s\n", l->numLinea, mensaje);
+    return -1;
+}
+
+// [n:][0x]HEX: el dígito de más a la derecha contiene las filas 0..3
+static int parsearHex(LectorFunciones *l, char *s, TablaVerdad *t) {
+    int n = -1;
+    char *dosPuntos = strchr(s, ':');
+    if (dosPuntos) {
+        *dosPuntos = '\0';
+        n = atoi(s);
+        s = dosPuntos + 1;
+    }
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) s += 2;
+    size_t largo = strlen(s);
+    if (largo == 0) return errorLinea(l, "tabla hexadecimal vacía");
+    if (n < 0) {
+        int k = log2Exacto(largo);
+        if (k < 0) return errorLinea(l, "el largo hexadecimal debe ser potencia de 2 (o use el prefijo n:)");
+        n = k + 2;
+    }
+    if (n < MIN_VARIABLES || n > MAX_VARIABLES) return errorLinea(l, "número de variables fuera de rango");
+    if (!crearTabla(t, n)) return errorLinea(l, "sin memoria");
+
+    // Con el prefijo n: los dígitos que faltan a la izquierda son ceros
+    size_t filas = numFilas(t);
+    for (size_t k = 0; k < largo; k++) {
+        int v = valorHex(s[largo - 1 - k]);
+        if (v < 0) { liberarTabla(t); return errorLinea(l, "dígito hexadecimal inválido"); }
+        size_t bit = k * 4;
+        if (bit >= filas) {
+            if (v != 0) { liberarTabla(t); return errorLinea(l, "sobran bits para ese número de variables"); }
+            continue;
+        }
+        if (filas - bit < 4 && (v >> (filas - bit))) {
+            liberarTabla(t);
+            return errorLinea(l, "sobran bits para ese número de variables");
+        }
+        t->bits[bit >> 6] |= (uint64_t)v << (bit & 63);
+    }
+    return 1;
+}
+
+// Una cadena de 0/1/X por función, fila 0 primero
+static int parsearBits(LectorFunciones *l, const char *s, size_t largo, TablaVerdad *t) {
+    int n = log2Exacto(largo);
+    if (n < MIN_VARIABLES || n > MAX_VARIABLES) return errorLinea(l, "el largo debe ser 2^n con n entre 1 y 24");
+    if (!crearTabla(t, n)) return errorLinea(l, "sin memoria");
+    for (size_t i = 0; i < largo; i++) {
+        char c = s[i];
+        if (c == '1') t->bits[i >> 6] |= 1ULL << (i & 63);
+        else if (c == 'x' || c == 'X' || c == '-') {
+            if (!asignarIndiferente(t, i)) { liberarTabla(t); return errorLinea(l, "sin memoria"); }
+        } else if (c != '0') {
+            liberarTabla(t);
+            return errorLinea(l, "solo se admiten 0, 1 o X");
+        }
+    }
+    return 1;
+}
+
+// Registro binario: un byte con n y luego 2^n bits (bit i del byte j = fila 8j+i)
+static int leerRegistroBinario(LectorFunciones *l, TablaVerdad *t) {
+    unsigned char n;
+    if (!leerBytes(l, &n, 1)) return 0;
+    l->numLinea++;
+    if (n < MIN_VARIABLES || n > MAX_VARIABLES) return errorLinea(l, "registro binario con n fuera de rango");
+    if (!crearTabla(t, n)) return errorLinea(l, "sin memoria");
+    size_t bytes = (numFilas(t) + 7) / 8;
+    unsigned char *datos = malloc(bytes);
+    if (datos == NULL || !leerBytes(l, datos, bytes)) {
+        free(datos);
+        liberarTabla(t);
+        l->finArchivo = 1;
+        l->inicio = l->fin;
+        return errorLinea(l, "registro binario incompleto");
+    }
+    for (size_t b = 0; b < bytes; b++) {
+        t->bits[b >> 3] |= (uint64_t)datos[b] << ((b & 7) * 8);
+    }
+    if (n < 3) t->bits[0] &= (1ULL << (1u << n)) - 1;
+    free(datos);
+    return 1;
+}
+
+// ===================== PLA =====================
+
+// Interpreta la parte de entradas de un cubo PLA ("01-1")
+static int cuboDesdePLA(const char *s, int n, Cubo *c) {
+    c->valor = 0;
+    c->cuidado = 0;
+    for (int j = 0; j < n; j++) {
+        uint32_t b = 1u << (n - 1 - j);
+        if (s[j] == '1') { c->cuidado |= b; c->valor |= b; }
+        else if (s[j] == '0') c->cuidado |= b;
+        else if (s[j] != '-' && s[j] != '~' && s[j] != '2') return 0;
+    }
+    return 1;
+}
+
+// Lee un bloque PLA completo (la línea actual ya es su primera directiva)
+// y deja una tabla por cada columna de salida en salidasPLA
+static int leerBloquePLA(LectorFunciones *l) {
+    int n = -1, m = 1, tipoFR = 0, ok = 1;
+    uint64_t **apagadas = NULL;
+    size_t lineaInicio = l->numLinea;
+
+    liberarSalidasPLA(l);
+    do {
+        char *s = l->linea;
+        while (isspace((unsigned char)*s)) s++;
+        if (*s == '\0' || *s == '#') continue;
+
+        if (*s == '.') {
+            if (strncmp(s, ".e", 2) == 0 && (s[2] == '\0' || strcmp(s, ".end") == 0 || isspace((unsigned char)s[2]))) break;
+            if (strncmp(s, ".i ", 3) == 0) n = atoi(s + 3);
+            else if (strncmp(s, ".o ", 3) == 0) m = atoi(s + 3);
+            else if (strncmp(s, ".type", 5) == 0) tipoFR = strstr(s + 5, "r") != NULL;
+            // .p, .ilb, .ob y demás directivas no cambian la función
+            continue;
+        }
+
+        // Línea de cubo
+        if (n < MIN_VARIABLES || n > MAX_VARIABLES || m < 1) {
+            ok = errorLinea(l, "PLA sin .i/.o válidos antes de los cubos");
+            break;
+        }
+        if (l->salidasPLA == NULL) {
+            l->salidasPLA = calloc((size_t)m, sizeof(TablaVerdad));
+            apagadas = calloc((size_t)m, sizeof(uint64_t *));
+            if (l->salidasPLA == NULL || apagadas == NULL) { ok = errorLinea(l, "sin memoria"); break; }
+            l->numSalidasPLA = m;
+            for (int k = 0; k < m; k++) {
+                if (!crearTabla(&l->salidasPLA[k], n) ||
+                    !(l->salidasPLA[k].indiferentes = calloc(l->salidasPLA[k].palabras, sizeof(uint64_t))) ||
+                    !(apagadas[k] = calloc(l->salidasPLA[k].palabras, sizeof(uint64_t)))) {
+                    ok = errorLinea(l, "sin memoria");
+                    break;
+                }
+            }
+            if (ok < 0) break;
+        }
+
+        // Quitar espacios (en la misma línea): primero n entradas y luego m salidas
+        char *compacto = s;
+        int k = 0;
+        for (char *p = s; *p; p++) {
+            if (!isspace((unsigned char)*p)) compacto[k++] = *p;
+        }
+        compacto[k] = '\0';
+        Cubo c;
+        if (k != n + m || !cuboDesdePLA(compacto, n, &c)) {
+            ok = errorLinea(l, "cubo PLA inválido");
+            break;
+        }
+        for (int o = 0; o < m; o++) {
+            TablaVerdad *t = &l->salidasPLA[o];
+            char v = compacto[n + o];
+            if (v == '1' || v == '4') marcarCubo(n, c, t->bits);
+            else if (v == '-' || v == '~' || v == '2') marcarCubo(n, c, t->indiferentes);
+            else if (v == '0' || v == '3') { if (tipoFR) marcarCubo(n, c, apagadas[o]); }
+            else { ok = errorLinea(l, "salida PLA inválida"); break; }
+        }
+        if (ok < 0) break;
+    } while (leerLinea(l) >= 0);
+
+    if (ok > 0 && l->salidasPLA == NULL) {
+        // PLA sin cubos: todas las salidas en 0
+        if (n < MIN_VARIABLES || n > MAX_VARIABLES) {
+            ok = -1;
+            fprintf(stderr, "Línea %zu: PLA sin .i válido\n", lineaInicio);
+        } else {
+            l->salidasPLA = calloc((size_t)m, sizeof(TablaVerdad));
+            l->numSalidasPLA = l->salidasPLA ? m : 0;
+            for (int k = 0; k < l->numSalidasPLA; k++) crearTabla(&l->salidasPLA[k], n);
+        }
+    }
+
+    // Tipo fd: lo indiferente prevalece. Tipo fr: lo no especificado es indiferente.
+    for (int o = 0; o < l->numSalidasPLA; o++) {
+        TablaVerdad *t = &l->salidasPLA[o];
+        if (ok > 0 && t->indiferentes) {
+            int hay = 0;
+            for (size_t w = 0; w < t->palabras; w++) {
+                if (tipoFR) {
+                    t->indiferentes[w] |= ~(t->bits[w] | apagadas[o][w]);
+                    t->indiferentes[w] &= ~t->bits[w];
+                } else {
+                    t->bits[w] &= ~t->indiferentes[w];
+                }
+                hay |= t->indiferentes[w] != 0;
+            }
+            if (n < 6) t->indiferentes[0] &= (1ULL << (1u << n)) - 1;
+            if (!hay) { free(t->indiferentes); t->indiferentes = NULL; }
+        }
+        if (apagadas) free(apagadas[o]);
+    }
+    free(apagadas);
+
+    if (ok < 0) {
+        // Descartar el resto del bloque defectuoso
+        while (leerLinea(l) >= 0) {
+            char *s = l->linea;
+            while (isspace((unsigned char)*s)) s++;
+            if (strncmp(s, ".e", 2) == 0) break;
+        }
+        liberarSalidasPLA(l);
+        return -1;
+    }
+    return 1;
+}
+
+// ===================== Interfaz pública =====================
+
+// Devuelve 1 si leyó una función en t, 0 al terminar la entrada y -1 si
+// la entrada actual era inválida (el error ya se informó y se puede seguir)
+int leerFuncion(LectorFunciones *l, TablaVerdad *t) {
+    if (l->sigSalidaPLA < l->numSalidasPLA) {
+        int o = l->sigSalidaPLA++;
+        *t = l->salidasPLA[o];
+        snprintf(l->origen, sizeof(l->origen), "PLA línea %zu, salida %d", l->numLinea, o + 1);
+        if (l->sigSalidaPLA == l->numSalidasPLA) liberarSalidasPLA(l);
+        return 1;
+    }
+
+    if (l->formato == FORMATO_BIN) {
+        int r = leerRegistroBinario(l, t);
+        snprintf(l->origen, sizeof(l->origen), "registro %zu", l->numLinea);
+        return r;
+    }
+
+    long largo;
+    while ((largo = leerLinea(l)) >= 0) {
+        char *s = l->linea;
+        while (isspace((unsigned char)*s)) s++;
+        char *finTexto = s + strlen(s);
+        while (finTexto > s && isspace((unsigned char)finTexto[-1])) *--finTexto = '\0';
+        if (*s == '\0' || *s == '#') continue;
+
+        // Primero cadena de bits (solo 0, 1, X o - y largo 2^n): así "0X10"
+        // es una tabla de 2 variables con una indiferente y no hexadecimal
+        FormatoEntrada formato = l->formato;
+        if (formato == FORMATO_AUTO) {
+            size_t largoTexto = (size_t)(finTexto - s);
+            if (*s == '.') formato = FORMATO_PLA;
+            else if (strspn(s, "01xX-") == largoTexto && log2Exacto(largoTexto) >= 0) formato = FORMATO_BITS;
+            else formato = FORMATO_HEX;
+        }
+
+        snprintf(l->origen, sizeof(l->origen), "línea %zu", l->numLinea);
+        if (formato == FORMATO_HEX) return parsearHex(l, s, t);
+        if (formato == FORMATO_BITS) return parsearBits(l, s, (size_t)(finTexto - s), t);
+
+        // PLA: el bloque puede traer varias salidas
+        if (leerBloquePLA(l) < 0) return -1;
+        if (l->numSalidasPLA == 0) continue;
+        return leerFuncion(l, t);
+    }
+    return 0;
+}
+
+static int agregarSalida(TablaVerdad **salidas, int *m, int *capacidad, TablaVerdad t) {
+    if (*m == *capacidad) {
+        int nueva = *capacidad ? *capacidad * 2 : 8;
+        TablaVerdad *v = realloc(*salidas, (size_t)nueva * sizeof(TablaVerdad));
+        if (v == NULL) return 0;
+        *salidas = v;
+        *capacidad = nueva;
+    }
+    (*salidas)[(*m)++] = t;
+    return 1;
+}
+
+// Lee un diseño multisalida: todas las salidas de un bloque PLA, o varias
+// funciones seguidas (con el mismo n) terminadas por una línea en blanco.
+// Devuelve 1 con *salidas/*m llenos, 0 al terminar y -1 si hubo errores
+// (las funciones válidas del grupo igual se devuelven si las hay).
+int leerDiseno(LectorFunciones *l, TablaVerdad **salidas, int *m) {
+    int capacidad = 0, errores = 0;
+    *salidas = NULL;
+    *m = 0;
+
+    if (l->formato == FORMATO_BIN) {
+        TablaVerdad t;
+        int r = leerFuncion(l, &t);
+        if (r <= 0) return r;
+        if (!agregarSalida(salidas, m, &capacidad, t)) { liberarTabla(&t); return -1; }
+        return 1;
+    }
+
+    long largo;
+    while ((largo = leerLinea(l)) >= 0) {
+        char *s = l->linea;
+        while (isspace((unsigned char)*s)) s++;
+        if (*s == '#') continue;
+        if (*s == '\0') {
+            if (*m > 0) break;
+            continue;
+        }
+        int esPLA = (*s == '.' && l->formato != FORMATO_HEX && l->formato != FORMATO_BITS) ||
+                    l->formato == FORMATO_PLA;
+        if (esPLA && *m > 0) {
+            devolverLinea(l);
+            break;
+        }
+
+        devolverLinea(l);
+        TablaVerdad t;
+        int r = leerFuncion(l, &t);
+        if (r == 0) break;
+        if (r < 0) {
+            errores++;
+            if (esPLA) break;
+            continue;
+        }
+        if (*m > 0 && t.n != (*salidas)[0].n) {
+            fprintf(stderr, "Línea %zu: todas las salidas de un diseño deben tener %d variables\n",
+                    l->numLinea, (*salidas)[0].n);
+            liberarTabla(&t);
+            errores++;
+            continue;
+        }
+        if (!agregarSalida(salidas, m, &capacidad, t)) { liberarTabla(&t); errores++; break; }
+
+        if (esPLA) {
+            // El resto de las columnas del mismo bloque
+            while (l->sigSalidaPLA < l->numSalidasPLA) {
+                if (leerFuncion(l, &t) <= 0) break;
+                if (!agregarSalida(salidas, m, &capacidad, t)) { liberarTabla(&t); errores++; break; }
+            }
+            break;
+        }
+    }
+    if (*m == 0) {
+        free(*salidas);
+        *salidas = NULL;
+        return errores ? -1 : 0;
+    }
+    snprintf(l->origen, sizeof(l->origen), "hasta línea %zu", l->numLinea);
+    return errores ? -1 : 1;
+}
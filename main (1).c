@@ -2,39 +2,26 @@
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
-
-#define NUM_ZONAS 5
-#define DIAS_HISTORICO 30
-#define NUM_CONTAMINANTES 4
-#define MAX_NOMBRE_ZONA 50
-#define MAX_FILENAME 100
-
-// Índices para mejor legibilidad
-#define TEMPERATURA_IDX 0
-#define HUMEDAD_IDX 1
-#define VIENTO_IDX 2
-
-// Contaminantes específicos para Ecuador
-enum Contaminantes {PM2_5, PM10, NO2, SO2};
+#include <math.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "monitor.h"
 
 // Nombres de contaminantes para reportes
 const char* nombres_contaminantes[] = {"PM2.5", "PM10", "NO2", "SO2"};
 const char* unidades[] = {"μg/m³", "μg/m³", "μg/m³", "μg/m³"};
 
-typedef struct {
-    char nombre[MAX_NOMBRE_ZONA];
-    float contaminantes[NUM_CONTAMINANTES]; 
-    float clima[3]; // temperatura, humedad, viento
-    float historico[DIAS_HISTORICO][NUM_CONTAMINANTES];
-    int alerta; // 0=normal, 1=preventiva, 2=emergencia
-} Zona;
-
 // Límites según normativa ecuatoriana (μg/m³)
 const float limites_ecuador[NUM_CONTAMINANTES] = {37.0, 75.0, 150.0, 125.0};
 
 // Rangos válidos para validación
 const float rangos_min[NUM_CONTAMINANTES] = {0.0, 0.0, 0.0, 0.0};
 const float rangos_max[NUM_CONTAMINANTES] = {500.0, 600.0, 400.0, 300.0};
+const float clima_min[NUM_CLIMA] = {-10.0, 0.0, 0.0};
+const float clima_max[NUM_CLIMA] = {40.0, 100.0, 80.0};
 
 // Función para limpiar buffer de entrada
 void limpiar_buffer() {
@@ -93,25 +80,29 @@ float factor_quemas(int mes) {
     return 1.0;
 }
 
-// Función para generar datos históricos más realistas
+// Función para generar datos históricos más realistas: una lectura al
+// mediodía de cada uno de los últimos DIAS_HISTORICO días
 void generar_historico_realista(Zona *zona) {
+    int64_t hoy = (int64_t)time(NULL) / SEGUNDOS_DIA;
     for(int d = 0; d < DIAS_HISTORICO; d++) {
+        float dia[NUM_CONTAMINANTES];
         for(int c = 0; c < NUM_CONTAMINANTES; c++) {
             // Variación más natural: ±30% del valor base
             float variacion = 0.7 + 0.6 * ((float)rand() / RAND_MAX);
-            zona->historico[d][c] = zona->contaminantes[c] * variacion;
+            dia[c] = zona->contaminantes[c] * variacion;
             
             // Asegurar que no sea negativo
-            if(zona->historico[d][c] < 0) {
-                zona->historico[d][c] = 0.1;
+            if(dia[c] < 0) {
+                dia[c] = 0.1;
             }
             
             // Añadir tendencia temporal (días más recientes similar a actual)
             if(d >= DIAS_HISTORICO - 7) {
                 float factor_reciente = 0.9 + 0.2 * ((float)rand() / RAND_MAX);
-                zona->historico[d][c] = zona->contaminantes[c] * factor_reciente;
+                dia[c] = zona->contaminantes[c] * factor_reciente;
             }
         }
+        agregar_a_serie(&zona->serie, (hoy - (DIAS_HISTORICO - 1 - d)) * SEGUNDOS_DIA + SEGUNDOS_DIA / 2, dia);
     }
 }
 
@@ -122,6 +113,7 @@ void ingresar_datos(Zona *zonas) {
     for(int i = 0; i < NUM_ZONAS; i++) {
         printf("\n📍 --- Zona %d ---\n", i+1);
         
+        iniciar_zona(&zonas[i], "", 0);
         leer_nombre_zona(zonas[i].nombre);
         
         printf("\n🏭 Ingrese niveles actuales de contaminantes:\n");
@@ -135,9 +127,12 @@ void ingresar_datos(Zona *zonas) {
         }
         
         printf("\n🌤️  Ingrese datos climáticos:\n");
-        zonas[i].clima[TEMPERATURA_IDX] = leer_valor_valido("  Temperatura (°C, -10 a 40): ", -10.0, 40.0);
-        zonas[i].clima[HUMEDAD_IDX] = leer_valor_valido("  Humedad (%, 0 a 100): ", 0.0, 100.0);
-        zonas[i].clima[VIENTO_IDX] = leer_valor_valido("  Velocidad viento (km/h, 0 a 80): ", 0.0, 80.0);
+        zonas[i].clima[TEMPERATURA_IDX] = leer_valor_valido("  Temperatura (°C, -10 a 40): ",
+                                                            clima_min[TEMPERATURA_IDX], clima_max[TEMPERATURA_IDX]);
+        zonas[i].clima[HUMEDAD_IDX] = leer_valor_valido("  Humedad (%, 0 a 100): ",
+                                                        clima_min[HUMEDAD_IDX], clima_max[HUMEDAD_IDX]);
+        zonas[i].clima[VIENTO_IDX] = leer_valor_valido("  Velocidad viento (km/h, 0 a 80): ",
+                                                       clima_min[VIENTO_IDX], clima_max[VIENTO_IDX]);
         
         // Generar datos históricos
         generar_historico_realista(&zonas[i]);
@@ -146,21 +141,15 @@ void ingresar_datos(Zona *zonas) {
     }
 }
 
-// Función para calcular promedios mejorada
+// Función para calcular promedios mejorada (sobre los promedios diarios de
+// los últimos DIAS_HISTORICO días de la serie, que ya van sumados)
 void calcular_promedios(Zona *zona) {
+    EstadisticasSerie est;
+    leer_estadisticas(&zona->serie, &est);
     for(int i = 0; i < NUM_CONTAMINANTES; i++) {
-        float suma = 0;
-        int dias_validos = 0;
-        
-        for(int d = 0; d < DIAS_HISTORICO; d++) {
-            if(zona->historico[d][i] >= 0) { // Solo datos válidos
-                suma += zona->historico[d][i];
-                dias_validos++;
-            }
-        }
-        
-        if(dias_validos > 0) {
-            zona->contaminantes[i] = suma / dias_validos;
+        // Solo días con datos válidos
+        if(est.dias_mes > 0) {
+            zona->contaminantes[i] = (float)(est.suma_mes[i] / est.dias_mes);
         }
     }
 }
@@ -168,20 +157,14 @@ void calcular_promedios(Zona *zona) {
 // Función para predecir contaminación mejorada
 void predecir_contaminacion(Zona *zona, int mes) {
     float factor = factor_quemas(mes);
+    EstadisticasSerie est;
+    leer_estadisticas(&zona->serie, &est);
     
     for(int i = 0; i < NUM_CONTAMINANTES; i++) {
-        float prediccion = 0;
-        float peso_total = 0;
-        
-        // Usar los últimos 7 días con pesos decrecientes
-        for(int d = 0; d < 7 && d < DIAS_HISTORICO; d++) {
-            float peso = 7 - d; // Más peso a días más recientes
-            prediccion += zona->historico[DIAS_HISTORICO-1-d][i] * peso;
-            peso_total += peso;
-        }
-        
-        if(peso_total > 0) {
-            zona->contaminantes[i] = (prediccion / peso_total) * factor;
+        // Últimos 7 días con pesos decrecientes, 7 el más reciente (los
+        // días sin lecturas no cuentan)
+        if(est.peso_semana > 0) {
+            zona->contaminantes[i] = (float)(est.ponderada_semana[i] / est.peso_semana) * factor;
         }
         
         // Ajuste por condiciones climáticas
@@ -196,39 +179,16 @@ void predecir_contaminacion(Zona *zona, int mes) {
 
 // Función para evaluar alertas mejorada
 void evaluar_alertas(Zona *zona) {
-    zona->alerta = 0; // Por defecto sin alerta
-    int contaminantes_elevados = 0;
-    
-    for(int i = 0; i < NUM_CONTAMINANTES; i++) {
-        float porcentaje = (zona->contaminantes[i] / limites_ecuador[i]) * 100;
-        
-        if(porcentaje > 100) {
-            zona->alerta = 2; // Emergencia
-            contaminantes_elevados++;
-        } else if(porcentaje > 75 && zona->alerta < 1) {
-            zona->alerta = 1; // Alerta preventiva
-            contaminantes_elevados++;
-        }
-    }
-    
-    // Ajuste especial para PM2.5 (más peligroso)
-    if((zona->contaminantes[PM2_5] / limites_ecuador[PM2_5]) > 0.8 && zona->alerta < 1) {
-        zona->alerta = 1;
-    }
-    
-    // Si múltiples contaminantes están elevados, aumentar alerta
-    if(contaminantes_elevados >= 2 && zona->alerta < 2) {
-        zona->alerta = 2;
-    }
+    zona->alerta = nivel_alerta(zona->contaminantes);
 }
 
 // Función para mostrar resultados de una zona
-void mostrar_resultados_zona(Zona zona) {
-    printf("\n🏙️  === %s ===\n", zona.nombre);
+void mostrar_resultados_zona(const Zona *zona) {
+    printf("\n🏙️  === %s ===\n", zona->nombre);
     
     printf("📊 Niveles actuales:\n");
     for(int i = 0; i < NUM_CONTAMINANTES; i++) {
-        float porcentaje = (zona.contaminantes[i] / limites_ecuador[i]) * 100;
+        float porcentaje = (zona->contaminantes[i] / limites_ecuador[i]) * 100;
         char estado[20];
         
         if(porcentaje <= 50) strcpy(estado, "🟢 BUENO");
@@ -237,16 +197,16 @@ void mostrar_resultados_zona(Zona zona) {
         else strcpy(estado, "🔴 PELIGROSO");
         
         printf("  %s: %.2f %s (%.1f%% del límite) %s\n", 
-               nombres_contaminantes[i], zona.contaminantes[i], 
+               nombres_contaminantes[i], zona->contaminantes[i], 
                unidades[i], porcentaje, estado);
     }
     
     printf("\n🌡️  Condiciones climáticas:\n");
     printf("  Temperatura: %.1f°C | Humedad: %.1f%% | Viento: %.1f km/h\n",
-           zona.clima[TEMPERATURA_IDX], zona.clima[HUMEDAD_IDX], zona.clima[VIENTO_IDX]);
+           zona->clima[TEMPERATURA_IDX], zona->clima[HUMEDAD_IDX], zona->clima[VIENTO_IDX]);
     
     printf("\n🚨 Nivel de alerta: ");
-    switch(zona.alerta) {
+    switch(zona->alerta) {
         case 0: printf("🟢 NORMAL\n"); break;
         case 1: printf("🟡 PREVENTIVA\n"); break;
         case 2: printf("🔴 EMERGENCIA\n"); break;
@@ -254,40 +214,40 @@ void mostrar_resultados_zona(Zona zona) {
 }
 
 // Función para generar recomendaciones específicas
-void generar_recomendaciones(Zona zona) {
-    printf("\n💡 Recomendaciones para %s:\n", zona.nombre);
+void generar_recomendaciones(const Zona *zona) {
+    printf("\n💡 Recomendaciones para %s:\n", zona->nombre);
     
-    if(zona.alerta >= 1) {
+    if(zona->alerta >= 1) {
         printf("⚠️  MEDIDAS PREVENTIVAS:\n");
         
-        if(zona.contaminantes[PM2_5] > limites_ecuador[PM2_5] * 0.75) {
+        if(zona->contaminantes[PM2_5] > limites_ecuador[PM2_5] * 0.75) {
             printf("  • Evitar actividades físicas intensas al aire libre\n");
             printf("  • Usar mascarilla de protección (N95 o KN95)\n");
             printf("  • Mantener ventanas cerradas durante el día\n");
             
             // Recomendaciones específicas por ciudad
-            if(strstr(zona.nombre, "Quito") != NULL || strstr(zona.nombre, "quito") != NULL) {
+            if(strstr(zona->nombre, "Quito") != NULL || strstr(zona->nombre, "quito") != NULL) {
                 printf("  • Evitar ejercitarse en el Parque La Carolina y El Ejido\n");
                 printf("  • Considerar la altitud (2800m) - mayor impacto respiratorio\n");
             }
-            if(strstr(zona.nombre, "Guayaquil") != NULL || strstr(zona.nombre, "guayaquil") != NULL) {
+            if(strstr(zona->nombre, "Guayaquil") != NULL || strstr(zona->nombre, "guayaquil") != NULL) {
                 printf("  • Evitar el Malecón 2000 en horas de mayor tráfico\n");
                 printf("  • Cuidado extra por el calor y humedad\n");
             }
         }
         
-        if(zona.contaminantes[NO2] > limites_ecuador[NO2] * 0.75) {
+        if(zona->contaminantes[NO2] > limites_ecuador[NO2] * 0.75) {
             printf("  • Preferir transporte público o bicicleta\n");
             printf("  • Evitar zonas de alto tráfico vehicular\n");
             printf("  • Planificar rutas por calles menos transitadas\n");
         }
         
-        if(zona.contaminantes[SO2] > limites_ecuador[SO2] * 0.75) {
+        if(zona->contaminantes[SO2] > limites_ecuador[SO2] * 0.75) {
             printf("  • Alejarse de zonas industriales\n");
             printf("  • Personas con asma: llevar inhalador\n");
         }
         
-        if(zona.alerta == 2) {
+        if(zona->alerta == 2) {
             printf("\n🚨 MEDIDAS DE EMERGENCIA:\n");
             printf("  • Permanecer en interiores tanto como sea posible\n");
             printf("  • Restricción vehicular recomendada\n");
@@ -302,10 +262,10 @@ void generar_recomendaciones(Zona zona) {
     }
     
     // Recomendaciones según clima
-    if(zona.clima[VIENTO_IDX] < 5.0) {
+    if(zona->clima[VIENTO_IDX] < 5.0) {
         printf("  • Viento bajo: contaminantes se acumulan más\n");
     }
-    if(zona.clima[HUMEDAD_IDX] > 80.0) {
+    if(zona->clima[HUMEDAD_IDX] > 80.0) {
         printf("  • Alta humedad: mayor retención de contaminantes\n");
     }
 }
@@ -319,7 +279,7 @@ void imprimir_separador() {
 }
 
 // Función para exportar reporte completo
-int exportar_reporte_completo(Zona zonas[], int num_zonas, int mes, const char* nombre_archivo) {
+int exportar_reporte_completo(const Zona zonas[], int num_zonas, int mes, const char* nombre_archivo) {
     FILE *archivo = fopen(nombre_archivo, "w");
     if(archivo == NULL) {
         printf("❌ Error: No se pudo crear el archivo %s\n", nombre_archivo);
@@ -351,6 +311,16 @@ int exportar_reporte_completo(Zona zonas[], int num_zonas, int mes, const char*
                    unidades[c], porcentaje, limites_ecuador[c]);
         }
         
+        if(zonas[i].lecturas > 0) {
+            EstadisticasSerie est;
+            leer_estadisticas(&zonas[i].serie, &est);
+            fprintf(archivo, "\nTendencia de la última hora (promedio exponencial ± desviación):\n");
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+                fprintf(archivo, "  %s: %.2f ± %.2f %s\n", nombres_contaminantes[c],
+                        est.media[c], sqrt(est.varianza[c]), unidades[c]);
+            }
+        }
+        
         fprintf(archivo, "\nCondiciones climáticas:\n");
         fprintf(archivo, "  Temperatura: %.1f°C\n", zonas[i].clima[TEMPERATURA_IDX]);
         fprintf(archivo, "  Humedad: %.1f%%\n", zonas[i].clima[HUMEDAD_IDX]);
@@ -389,12 +359,715 @@ int exportar_reporte_completo(Zona zonas[], int num_zonas, int mes, const char*
     return 1;
 }
 
+// Promedios y predicción zona por zona; las alertas de a BLOQUE_ZONAS, con
+// los niveles pasados a columnas
+static void procesar_bloque(Zona *zonas, int desde, int hasta, int hilo, void *datos) {
+    int mes = *(const int *)datos;
+    float columnas[NUM_CONTAMINANTES][BLOQUE_ZONAS];
+    const float *niveles[NUM_CONTAMINANTES];
+    uint8_t alertas[BLOQUE_ZONAS];
+    (void)hilo;
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) niveles[c] = columnas[c];
+    for(int b = desde; b < hasta; b += BLOQUE_ZONAS) {
+        int n = hasta - b < BLOQUE_ZONAS ? hasta - b : BLOQUE_ZONAS;
+        for(int k = 0; k < n; k++) {
+            calcular_promedios(&zonas[b + k]);
+            predecir_contaminacion(&zonas[b + k], mes);
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) columnas[c][k] = zonas[b + k].contaminantes[c];
+        }
+        evaluar_alertas_lote(niveles, n, alertas);
+        for(int k = 0; k < n; k++) zonas[b + k].alerta = alertas[k];
+    }
+}
+
+// Función para procesar zonas: promedios, predicción y alertas, repartidas
+// entre 'hilos' hilos (0 = uno por núcleo) cuando hay más de un bloque
+void procesar_zonas(Zona *zonas, int num_zonas, int mes, int hilos) {
+    GrupoHilos grupo;
+    int bloques = (num_zonas + BLOQUE_ZONAS - 1) / BLOQUE_ZONAS;
+    if(hilos < 1) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if(hilos > bloques) hilos = bloques;
+    if(hilos <= 1 || !iniciar_grupo(&grupo, hilos)) {
+        procesar_bloque(zonas, 0, num_zonas, 0, &mes);
+        return;
+    }
+    repartir_zonas(&grupo, zonas, num_zonas, procesar_bloque, &mes);
+    cerrar_grupo(&grupo);
+}
+
+// Función para mostrar una línea por zona (con cientos de estaciones el
+// detalle completo va al reporte)
+void mostrar_resumen_zonas(const Zona *zonas, int num_zonas) {
+    const char *alertas[] = {"🟢 NORMAL", "🟡 PREVENTIVA", "🔴 EMERGENCIA"};
+    printf("\n%-24s %9s", "Zona", "Lecturas");
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) printf(" %8s", nombres_contaminantes[c]);
+    printf("  Alerta\n");
+    for(int i = 0; i < num_zonas; i++) {
+        printf("%-24s %9ld", zonas[i].nombre, zonas[i].lecturas);
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) printf(" %8.2f", zonas[i].contaminantes[c]);
+        printf("  %s\n", alertas[zonas[i].alerta]);
+    }
+}
+
+static double segundos_desde(const struct timespec *inicio) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (double)(fin.tv_sec - inicio->tv_sec) + (double)(fin.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Función para el modo sin preguntas: ingiere las lecturas (si hay), procesa
+// cada zona y muestra el resumen. Con almacén, las zonas y sus series
+// quedan en el archivo y siguen ahí en la próxima corrida.
+int monitorear_lecturas(const char *ruta, const char *almacen, int mes, const char *nombre_archivo, int hilos) {
+    RegistroZonas reg;
+    EstadisticasIngesta est = {0};
+    struct timespec inicio;
+    if(!abrir_registro(&reg, almacen, ZONAS_INICIALES)) {
+        if(almacen != NULL) printf("❌ Error: No se pudo abrir el almacén %s\n", almacen);
+        else printf("❌ Error: No hay memoria para las zonas\n");
+        return 1;
+    }
+    if(almacen != NULL && reg.num_zonas > 0) {
+        printf("🗄️  Almacén %s: %d zonas guardadas\n", almacen, reg.num_zonas);
+    }
+    
+    int ok = 1;
+    if(ruta != NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        ok = ingerir_archivo(&reg, ruta, &est);
+        double segundos = segundos_desde(&inicio);
+        printf("📥 %ld lecturas de %d zonas en %.3f s (%.0f por segundo)\n",
+               est.lecturas, reg.num_zonas, segundos, est.lecturas / (segundos > 0 ? segundos : 1e-9));
+        if(est.invalidas || est.atrasadas || est.sin_lugar) {
+            printf("⚠️  Inválidas: %ld | De días anteriores: %ld | Zonas sin lugar: %ld\n",
+                   est.invalidas, est.atrasadas, est.sin_lugar);
+        }
+    }
+    for(int i = 0; i < reg.num_zonas; i++) {
+        if(reg.zonas[i].ultima_lectura > est.ultima_lectura) est.ultima_lectura = reg.zonas[i].ultima_lectura;
+    }
+    if(ok && reg.num_zonas == 0) {
+        printf("❌ Error: No hay lecturas válidas\n");
+        ok = 0;
+    }
+    if(ok) {
+        // Sin --mes, el de la lectura más reciente
+        if(mes == 0) {
+            time_t t = (time_t)est.ultima_lectura;
+            struct tm fecha;
+            gmtime_r(&t, &fecha);
+            mes = fecha.tm_mon + 1;
+        }
+        procesar_zonas(reg.zonas, reg.num_zonas, mes, hilos);
+        mostrar_resumen_zonas(reg.zonas, reg.num_zonas);
+        if(nombre_archivo != NULL) {
+            ok = exportar_reporte_completo(reg.zonas, reg.num_zonas, mes, nombre_archivo);
+            if(ok) printf("✅ Reporte generado exitosamente en: %s\n", nombre_archivo);
+        }
+    }
+    cerrar_registro(&reg);
+    return ok ? 0 : 1;
+}
+
+// Lecturas sintéticas: 'zonas' estaciones que reportan cada minuto, con
+// valores de dos decimales para que CSV y binario den exactamente lo mismo
+static int escribir_lecturas_prueba(const char *csv, const char *bin, long lecturas, int zonas) {
+    FILE *fc = fopen(csv, "w"), *fb = fopen(bin, "wb");
+    int ok = fc != NULL && fb != NULL;
+    CabeceraLecturas cab = {{'A', 'I', 'R', 'E'}, VERSION_LECTURAS, (uint32_t)zonas, sizeof(RegistroLectura)};
+    if(ok) {
+        fprintf(fc, "tiempo,zona,pm25,pm10,no2,so2,temperatura,humedad,viento\n");
+        ok = fwrite(&cab, sizeof(cab), 1, fb) == 1;
+    }
+    for(int z = 0; ok && z < zonas; z++) {
+        char nombre[MAX_NOMBRE_ZONA] = {0};
+        snprintf(nombre, sizeof(nombre), "Estacion-%04d", z);
+        ok = fwrite(nombre, sizeof(nombre), 1, fb) == 1;
+    }
+    srand(12345);
+    for(long i = 0; ok && i < lecturas; i++) {
+        RegistroLectura r;
+        r.tiempo = 1722470400u + (uint32_t)(i / zonas) * 60;   // desde el 1/8/2024
+        r.zona = (uint32_t)(i % zonas);
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            r.contaminantes[c] = (float)((rand() % (int)(rangos_max[c] * 40)) / 100.0);
+        }
+        r.clima[TEMPERATURA_IDX] = (float)((rand() % 3001 - 500) / 100.0);
+        r.clima[HUMEDAD_IDX] = (float)((rand() % 10001) / 100.0);
+        r.clima[VIENTO_IDX] = i % 7 == 0 ? NAN : (float)((rand() % 4001) / 100.0);
+        fprintf(fc, "%u,Estacion-%04u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,", r.tiempo, r.zona,
+                r.contaminantes[0], r.contaminantes[1], r.contaminantes[2], r.contaminantes[3],
+                r.clima[0], r.clima[1]);
+        if(isnan(r.clima[VIENTO_IDX])) fprintf(fc, "\n");
+        else fprintf(fc, "%.2f\n", r.clima[VIENTO_IDX]);
+        ok = fwrite(&r, sizeof(r), 1, fb) == 1;
+    }
+    if(fc != NULL && fclose(fc) != 0) ok = 0;
+    if(fb != NULL && fclose(fb) != 0) ok = 0;
+    return ok;
+}
+
+static int zonas_iguales(const RegistroZonas *a, const RegistroZonas *b) {
+    if(a->num_zonas != b->num_zonas) return 0;
+    for(int i = 0; i < a->num_zonas; i++) {
+        const Zona *x = &a->zonas[i], *y = &b->zonas[i];
+        if(strcmp(x->nombre, y->nombre) != 0 || x->lecturas != y->lecturas ||
+           memcmp(&x->serie, &y->serie, sizeof(x->serie)) != 0 ||
+           memcmp(x->contaminantes, y->contaminantes, sizeof(x->contaminantes)) != 0 ||
+           memcmp(x->clima, y->clima, sizeof(x->clima)) != 0) return 0;
+    }
+    return 1;
+}
+
+// Función para medir la ingesta: CSV y binario, mapeados y leídos por lotes
+int medir_ingesta(long lecturas) {
+    const char *dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    const int zonas = 500;
+    char csv[512], bin[512];
+    snprintf(csv, sizeof(csv), "%s/monitor-%d.csv", dir, (int)getpid());
+    snprintf(bin, sizeof(bin), "%s/monitor-%d.bin", dir, (int)getpid());
+    if(!escribir_lecturas_prueba(csv, bin, lecturas, zonas)) {
+        printf("❌ Error: No se pudieron escribir %s y %s\n", csv, bin);
+        remove(csv);
+        remove(bin);
+        return 1;
+    }
+    
+    const char *rutas[4] = {csv, csv, bin, bin};
+    const char *nombres[4] = {"CSV mapeado", "CSV por lotes", "Binario mapeado", "Binario por lotes"};
+    RegistroZonas reg[4];
+    int ok = 1, creados = 0;
+    printf("%ld lecturas de %d estaciones\n", lecturas, zonas);
+    for(int m = 0; ok && m < 4; m++) {
+        EstadisticasIngesta est = {0};
+        struct timespec inicio;
+        struct stat st;
+        ok = abrir_registro(&reg[m], NULL, zonas);
+        if(!ok) break;
+        creados++;
+        stat(rutas[m], &st);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        if(m % 2 == 0) {
+            ok = ingerir_archivo(&reg[m], rutas[m], &est);
+        } else {
+            int fd = open(rutas[m], O_RDONLY);
+            ok = fd >= 0 && ingerir_descriptor(&reg[m], fd, &est);
+            if(fd >= 0) close(fd);
+        }
+        double t = segundos_desde(&inicio);
+        ok = ok && est.lecturas == lecturas && est.invalidas == 0;
+        printf("%-18s %7.3f s %12.0f lecturas/s %8.1f MB/s\n", nombres[m], t, lecturas / t, st.st_size / t / 1e6);
+    }
+    for(int m = 1; ok && m < 4; m++) ok = zonas_iguales(&reg[0], &reg[m]);
+    printf("Mismo estado de las zonas en los cuatro casos: %s\n", ok ? "sí" : "no");
+    for(int m = 0; m < creados; m++) cerrar_registro(&reg[m]);
+    remove(csv);
+    remove(bin);
+    return !ok;
+}
+
+// Memoria residente del proceso en kB ("VmRSS" o el máximo, "VmHWM")
+static long memoria_residente(const char *campo) {
+    char linea[256];
+    long kb = -1;
+    size_t largo = strlen(campo);
+    FILE *f = fopen("/proc/self/status", "r");
+    while(f != NULL && fgets(linea, sizeof(linea), f) != NULL) {
+        if(strncmp(linea, campo, largo) == 0 && linea[largo] == ':') kb = atol(linea + largo + 1);
+    }
+    if(f != NULL) fclose(f);
+    return kb;
+}
+
+static uint64_t suma_series(const RegistroZonas *reg) {
+    uint64_t h = 1469598103934665603ull;
+    for(int i = 0; i < reg->num_zonas; i++) {
+        const unsigned char *p = (const unsigned char *)&reg->zonas[i].serie;
+        for(size_t b = 0; b < sizeof(SerieZona); b++) h = (h ^ p[b]) * 1099511628211ull;
+    }
+    return h;
+}
+
+// Función para medir el almacén: un año de lecturas por hora de 'zonas'
+// zonas, la memoria y el disco que ocupa, y que al reabrirlo esté igual
+int medir_almacen(int zonas) {
+    const char *dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    char ruta[512];
+    snprintf(ruta, sizeof(ruta), "%s/monitor-%d.serie", dir, (int)getpid());
+    RegistroZonas reg;
+    EstadisticasIngesta est = {0};
+    struct timespec inicio;
+    remove(ruta);
+    if(!abrir_registro(&reg, ruta, zonas)) {
+        printf("❌ Error: No se pudo crear %s\n", ruta);
+        return 1;
+    }
+    int ok = 1;
+    for(int z = 0; ok && z < zonas; z++) {
+        char nombre[MAX_NOMBRE_ZONA];
+        int largo = snprintf(nombre, sizeof(nombre), "Estacion-%04d", z);
+        ok = registrar_zona(&reg, nombre, (size_t)largo) == z;
+    }
+    
+    const long horas = 365 * 24;
+    const float sin_clima[NUM_CLIMA] = {NAN, NAN, NAN};
+    srand(12345);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(long h = 0; ok && h < horas; h++) {
+        for(int z = 0; z < zonas; z++) {
+            float valores[NUM_CONTAMINANTES];
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) valores[c] = (float)(rand() % (int)(rangos_max[c] * 40)) / 100;
+            aplicar_lectura(&reg.zonas[z], 1704067200 + h * 3600, valores, sin_clima, &est);
+        }
+    }
+    double cargar = segundos_desde(&inicio);
+    uint64_t antes = suma_series(&reg);
+    long residente = memoria_residente("VmHWM");
+    cerrar_registro(&reg);
+    
+    struct stat st;
+    stat(ruta, &st);
+    printf("%d zonas, un año de lecturas por hora (%ld lecturas)\n", zonas, est.lecturas);
+    printf("Carga: %.3f s (%.0f lecturas/s)\n", cargar, est.lecturas / cargar);
+    printf("Almacén: %.1f MB (%zu bytes por zona), en disco %.1f MB\n",
+           st.st_size / 1e6, sizeof(Zona), st.st_blocks * 512.0 / 1e6);
+    printf("Memoria residente máxima: %.1f MB\n", residente / 1e3);
+    
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = ok && abrir_registro(&reg, ruta, zonas);
+    double reabrir = segundos_desde(&inicio);
+    if(ok) {
+        int iguales = reg.num_zonas == zonas && suma_series(&reg) == antes &&
+                      buscar_zona(&reg, "Estacion-0007", 13) == 7;
+        printf("Reabrir: %.3f ms, series iguales: %s\n", reabrir * 1e3, iguales ? "sí" : "no");
+        ok = iguales;
+        cerrar_registro(&reg);
+    }
+    remove(ruta);
+    return !ok;
+}
+
+// Consultas de un tablero mientras la ingesta escribe: toma instantáneas de
+// las estadísticas y cuenta las que no cierran (una lectura a medio escribir)
+typedef struct {
+    const RegistroZonas *reg;
+    atomic_int terminar;
+    long consultas;
+    long inconsistentes;
+} Tablero;
+
+static int instantanea_coherente(const EstadisticasSerie *e) {
+    int d = e->dias_semana;
+    if(e->dias_mes < 0 || e->dias_mes > DIAS_HISTORICO || d < 0 || d > DIAS_SEMANA || d > e->dias_mes) return 0;
+    if(e->peso_semana < d * (d + 1) / 2 || e->peso_semana > d * (2 * DIAS_SEMANA + 1 - d) / 2) return 0;
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+        if(e->dias_mes > 0 && e->suma_mes[c] / e->dias_mes > rangos_max[c] + 0.01) return 0;
+        if(d > 0 && e->ponderada_semana[c] / e->peso_semana > rangos_max[c] + 0.01) return 0;
+    }
+    return 1;
+}
+
+static void *consultar_tablero(void *arg) {
+    Tablero *t = arg;
+    unsigned z = 0;
+    while(!atomic_load_explicit(&t->terminar, memory_order_relaxed)) {
+        EstadisticasSerie e;
+        z = (z + 7919) % (unsigned)t->reg->num_zonas;
+        leer_estadisticas(&t->reg->zonas[z].serie, &e);
+        if(!instantanea_coherente(&e)) t->inconsistentes++;
+        t->consultas++;
+    }
+    return NULL;
+}
+
+// Lo que calculaban antes calcular_promedios y predecir_contaminacion
+// recorriendo la serie: promedio de 30 días y ponderado de 7
+static void recalcular_ventanas(const SerieZona *s, int c, double *mes, double *semana) {
+    int64_t hoy = s->acumulado[NIVEL_DIA].actual;
+    double suma = 0, ponderada = 0, peso = 0;
+    int dias = 0;
+    for(int d = 0; d < DIAS_HISTORICO; d++) {
+        float valor = valor_serie(s, NIVEL_DIA, hoy - d, c);
+        if(valor < 0) continue;
+        suma += valor;
+        dias++;
+        if(d < DIAS_SEMANA) {
+            ponderada += (double)valor * (DIAS_SEMANA - d);
+            peso += DIAS_SEMANA - d;
+        }
+    }
+    *mes = dias > 0 ? suma / dias : -1;
+    *semana = peso > 0 ? ponderada / peso : -1;
+}
+
+// Función para medir las estadísticas móviles: 45 días de lecturas cada 10
+// minutos en 'zonas' zonas con un tablero consultando en otro hilo; después
+// compara contra recorrer la serie y mide las dos formas de consultar
+int medir_estadisticas(int zonas) {
+    RegistroZonas reg;
+    EstadisticasIngesta est = {0};
+    struct timespec inicio;
+    if(!abrir_registro(&reg, NULL, zonas)) {
+        printf("❌ Error: No hay memoria para %d zonas\n", zonas);
+        return 1;
+    }
+    for(int z = 0; z < zonas; z++) {
+        char nombre[MAX_NOMBRE_ZONA];
+        int largo = snprintf(nombre, sizeof(nombre), "Estacion-%04d", z);
+        registrar_zona(&reg, nombre, (size_t)largo);
+    }
+    
+    Tablero tablero = { .reg = &reg };
+    pthread_t hilo;
+    int con_hilo = pthread_create(&hilo, NULL, consultar_tablero, &tablero) == 0;
+    const long pasos = 45 * 24 * 6;
+    const float sin_clima[NUM_CLIMA] = {NAN, NAN, NAN};
+    srand(12345);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(long p = 0; p < pasos; p++) {
+        // Cada tanto falta un día entero de alguna zona
+        for(int z = 0; z < zonas; z++) {
+            if((p / 144 + z) % 11 == 0) continue;
+            float valores[NUM_CONTAMINANTES];
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) valores[c] = (float)(rand() % (int)(rangos_max[c] * 40)) / 100;
+            aplicar_lectura(&reg.zonas[z], 1704067200 + p * 600, valores, sin_clima, &est);
+        }
+    }
+    double cargar = segundos_desde(&inicio);
+    atomic_store(&tablero.terminar, 1);
+    if(con_hilo) pthread_join(hilo, NULL);
+    
+    double diferencia = 0;
+    for(int z = 0; z < zonas; z++) {
+        EstadisticasSerie e;
+        leer_estadisticas(&reg.zonas[z].serie, &e);
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            double mes, semana;
+            recalcular_ventanas(&reg.zonas[z].serie, c, &mes, &semana);
+            double d1 = fabs(e.suma_mes[c] / e.dias_mes - mes);
+            double d2 = fabs(e.ponderada_semana[c] / e.peso_semana - semana);
+            if(d1 > diferencia) diferencia = d1;
+            if(d2 > diferencia) diferencia = d2;
+        }
+    }
+    
+    const int vueltas = 200;
+    double control = 0;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int v = 0; v < vueltas; v++) {
+        for(int z = 0; z < zonas; z++) {
+            EstadisticasSerie e;
+            leer_estadisticas(&reg.zonas[z].serie, &e);
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+                control += e.suma_mes[c] / e.dias_mes + e.ponderada_semana[c] / e.peso_semana;
+            }
+        }
+    }
+    double incremental = segundos_desde(&inicio);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int v = 0; v < vueltas; v++) {
+        for(int z = 0; z < zonas; z++) {
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+                double mes, semana;
+                recalcular_ventanas(&reg.zonas[z].serie, c, &mes, &semana);
+                control -= mes + semana;
+            }
+        }
+    }
+    double recorriendo = segundos_desde(&inicio);
+    
+    long consultas = (long)vueltas * zonas;
+    printf("%d zonas, %ld lecturas en %.3f s (%.0f lecturas/s)\n", zonas, est.lecturas, cargar, est.lecturas / cargar);
+    if(con_hilo) {
+        printf("Tablero en paralelo: %ld consultas, %ld instantáneas inconsistentes\n",
+               tablero.consultas, tablero.inconsistentes);
+    }
+    printf("Máxima diferencia con recorrer la serie: %.2e\n", diferencia);
+    printf("Consulta incremental  %8.1f ns por zona\n", incremental * 1e9 / consultas);
+    printf("Consulta recorriendo  %8.1f ns por zona (control %.1e)\n", recorriendo * 1e9 / consultas, control);
+    cerrar_registro(&reg);
+    return !(diferencia < 1e-3 && tablero.inconsistentes == 0);
+}
+
+// Lectura sintética de una zona en un momento dado: sale de mezclar la zona
+// y el tiempo, así da lo mismo qué hilo la genere
+static void lectura_sintetica(int zona, int64_t tiempo, float *valores) {
+    uint64_t x = ((uint64_t)zona << 32 ^ (uint64_t)tiempo) * 0x9E3779B97F4A7C15ull;
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+        x ^= x >> 29;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 32;
+        valores[c] = rangos_max[c] * 0.4f * (float)(x >> 40) / (float)(1 << 24);
+    }
+}
+
+// Contadores de cada hilo en su propia línea de caché
+typedef struct {
+    _Alignas(LINEA_CACHE) long lecturas;
+    long alertas;
+} ConteoHilo;
+
+typedef struct {
+    int64_t inicio;             // tiempo de la primera lectura de la ronda
+    int minutos;                // lecturas por zona, una por minuto
+    int mes;
+    ConteoHilo conteo[MAX_HILOS_ZONAS];
+} RondaZonas;
+
+// Una ronda del monitoreo continuo para un bloque: las lecturas nuevas de
+// cada zona y después promedios, predicción y alertas
+static void avanzar_bloque(Zona *zonas, int desde, int hasta, int hilo, void *datos) {
+    RondaZonas *r = datos;
+    EstadisticasIngesta est = {0};
+    const float sin_clima[NUM_CLIMA] = {NAN, NAN, NAN};
+    long alertas = 0;
+    for(int z = desde; z < hasta; z++) {
+        for(int m = 0; m < r->minutos; m++) {
+            float valores[NUM_CONTAMINANTES];
+            int64_t t = r->inicio + m * 60;
+            lectura_sintetica(z, t, valores);
+            aplicar_lectura(&zonas[z], t, valores, sin_clima, &est);
+        }
+        calcular_promedios(&zonas[z]);
+        predecir_contaminacion(&zonas[z], r->mes);
+        evaluar_alertas(&zonas[z]);
+        alertas += zonas[z].alerta > 0;
+    }
+    r->conteo[hilo].lecturas += est.lecturas;
+    r->conteo[hilo].alertas += alertas;
+}
+
+static uint64_t suma_zonas(const RegistroZonas *reg) {
+    const uint64_t *p = (const uint64_t *)reg->zonas;
+    size_t palabras = (size_t)reg->num_zonas * sizeof(Zona) / sizeof(uint64_t);
+    uint64_t h = 1469598103934665603ull;
+    for(size_t i = 0; i < palabras; i++) h = (h ^ p[i]) * 1099511628211ull;
+    return h;
+}
+
+// Rondas de una hora de monitoreo (10 minutos de lecturas cada una) sobre
+// 'zonas' zonas nuevas con 'hilos' hilos; devuelve los segundos y las
+// lecturas por ronda
+static double medir_rondas(int zonas, int hilos, long *lecturas, uint64_t *suma) {
+    const int rondas = 6, minutos = 10;
+    RegistroZonas reg;
+    GrupoHilos grupo;
+    RondaZonas r;
+    struct timespec inicio;
+    if(!abrir_registro(&reg, NULL, zonas)) return -1;
+    if(!iniciar_grupo(&grupo, hilos)) {
+        cerrar_registro(&reg);
+        return -1;
+    }
+    for(int z = 0; z < zonas; z++) {
+        char nombre[MAX_NOMBRE_ZONA];
+        int largo = snprintf(nombre, sizeof(nombre), "Estacion-%05d", z);
+        registrar_zona(&reg, nombre, (size_t)largo);
+    }
+    memset(&r, 0, sizeof(r));
+    r.minutos = minutos;
+    r.mes = 8;
+    
+    // La primera ronda trae las páginas a memoria y no se mide
+    double total = 0;
+    for(int k = 0; k <= rondas; k++) {
+        r.inicio = 1722470400 + (int64_t)k * minutos * 60;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        repartir_zonas(&grupo, reg.zonas, reg.num_zonas, avanzar_bloque, &r);
+        if(k > 0) total += segundos_desde(&inicio);
+    }
+    *lecturas = 0;
+    for(int h = 0; h < grupo.num_hilos; h++) *lecturas += r.conteo[h].lecturas;
+    *lecturas /= rondas + 1;
+    *suma = suma_zonas(&reg);
+    cerrar_grupo(&grupo);
+    cerrar_registro(&reg);
+    return total / rondas;
+}
+
+// Función para medir cómo escala el procesamiento con los hilos: de 10 en
+// 10 veces más zonas hasta 'max_zonas', con 1, 2, 4, ... hasta 'max_hilos'
+// hilos; el estado final tiene que ser el mismo con cualquier cantidad
+int medir_zonas(int max_zonas, int max_hilos) {
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    int ok = 1;
+    printf("%ld núcleos, %zu bytes por zona\n", nucleos, sizeof(Zona));
+    printf("%8s %6s %12s %14s %8s %6s\n", "Zonas", "Hilos", "Ronda (ms)", "Lecturas/s", "Acel.", "Igual");
+    for(int zonas = 10; ; zonas *= 10) {
+        if(zonas > max_zonas) zonas = max_zonas;
+        double base = 0;
+        uint64_t suma_base = 0;
+        for(int hilos = 1; ; hilos *= 2) {
+            if(hilos > max_hilos) hilos = max_hilos;
+            long lecturas;
+            uint64_t suma;
+            double ronda = medir_rondas(zonas, hilos, &lecturas, &suma);
+            if(ronda < 0) {
+                printf("❌ Error: No hay memoria para %d zonas\n", zonas);
+                return 1;
+            }
+            if(hilos == 1) {
+                base = ronda;
+                suma_base = suma;
+            }
+            printf("%8d %6d %12.3f %14.0f %7.2fx %6s\n", zonas, hilos, ronda * 1e3,
+                   lecturas / ronda, base / ronda, suma == suma_base ? "sí" : "no");
+            ok = ok && suma == suma_base;
+            if(hilos == max_hilos) break;
+        }
+        if(zonas == max_zonas) break;
+    }
+    return !ok;
+}
+
+// Niveles de prueba para las alertas: la mayoría al azar entre 0 y 1.5
+// veces el límite y el resto justo en los bordes de las reglas (el float
+// anterior, el exacto y el siguiente al 75%, 80% y 100%), más 0, negativos,
+// infinito y NaN
+static float nivel_prueba(int c, unsigned *semilla) {
+    unsigned x = *semilla = *semilla * 1103515245u + 12345u;
+    float limite = limites_ecuador[c];
+    if((x >> 16) % 4 != 0) return limite * 1.5f * (float)(x >> 8 & 0xFFFF) / 65535.0f;
+    const float fracciones[] = {0.75f, 0.8f, 1.0f};
+    switch((x >> 20) % 13) {
+        case 9: return 0;
+        case 10: return -1;
+        case 11: return INFINITY;
+        case 12: return NAN;
+    }
+    int k = (int)((x >> 20) % 13);
+    float borde = limite * fracciones[k / 3];
+    if(k % 3 == 0) return nextafterf(borde, 0);
+    if(k % 3 == 2) return nextafterf(borde, INFINITY);
+    return borde;
+}
+
+// Función para medir el cálculo de alertas: 'zonas' zonas en columnas con
+// el núcleo escalar, SSE y AVX2, contra la regla de una zona por vez
+int medir_alertas(int zonas) {
+    float *columnas = malloc((size_t)zonas * NUM_CONTAMINANTES * sizeof(float));
+    float *filas = malloc((size_t)zonas * NUM_CONTAMINANTES * sizeof(float));
+    uint8_t *esperado = malloc((size_t)zonas), *alertas = malloc((size_t)zonas);
+    if(columnas == NULL || filas == NULL || esperado == NULL || alertas == NULL) {
+        printf("❌ Error: No hay memoria para %d zonas\n", zonas);
+        free(columnas);
+        free(filas);
+        free(esperado);
+        free(alertas);
+        return 1;
+    }
+    const float *niveles[NUM_CONTAMINANTES];
+    unsigned semilla = 12345;
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) niveles[c] = &columnas[(size_t)c * zonas];
+    for(int z = 0; z < zonas; z++) {
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            filas[(size_t)z * NUM_CONTAMINANTES + c] = columnas[(size_t)c * zonas + z] = nivel_prueba(c, &semilla);
+        }
+    }
+    
+    const int vueltas = 20;
+    struct timespec inicio;
+    long cuantas[3] = {0};
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int v = 0; v < vueltas; v++) {
+        for(int z = 0; z < zonas; z++) esperado[z] = (uint8_t)nivel_alerta(&filas[(size_t)z * NUM_CONTAMINANTES]);
+    }
+    double por_zona = segundos_desde(&inicio);
+    for(int z = 0; z < zonas; z++) cuantas[esperado[z]]++;
+    printf("%d zonas: %ld normales, %ld preventivas, %ld emergencias\n", zonas, cuantas[0], cuantas[1], cuantas[2]);
+    printf("%-22s %8.2f ns por zona\n", "Una zona por vez", por_zona * 1e9 / vueltas / zonas);
+    
+    const char *nombres[] = {"Lote escalar", "Lote SSE", "Lote AVX2"};
+    int ok = 1;
+    for(int modo = ALERTAS_ESCALAR; modo <= ALERTAS_AVX2; modo++) {
+        if(modo == ALERTAS_AVX2 && !__builtin_cpu_supports("avx2")) {
+            printf("%-22s (la CPU no tiene AVX2)\n", nombres[modo]);
+            continue;
+        }
+        configurar_alertas(modo);
+        memset(alertas, 0xFF, (size_t)zonas);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        for(int v = 0; v < vueltas; v++) evaluar_alertas_lote(niveles, zonas, alertas);
+        double lote = segundos_desde(&inicio);
+        int iguales = memcmp(alertas, esperado, (size_t)zonas) == 0;
+        printf("%-22s %8.2f ns por zona (x%.1f), iguales: %s\n", nombres[modo],
+               lote * 1e9 / vueltas / zonas, por_zona / lote, iguales ? "sí" : "no");
+        ok = ok && iguales;
+    }
+    configurar_alertas(-1);
+    free(columnas);
+    free(filas);
+    free(esperado);
+    free(alertas);
+    return !ok;
+}
+
+static void mostrar_uso(const char *programa) {
+    printf("Uso: %s                          (ingreso interactivo de %d zonas)\n", programa, NUM_ZONAS);
+    printf("     %s [--ingerir archivo|-] [--almacen archivo] [--mes N] [--reporte archivo] [--hilos N]\n", programa);
+    printf("     %s --bench-ingesta [lecturas] | --bench-almacen [zonas] | --bench-estadisticas [zonas]\n", programa);
+    printf("     %s --bench-zonas [zonas] [hilos] | --bench-alertas [zonas]\n", programa);
+}
+
 // Función principal mejorada
-int main() {
+int main(int argc, char *argv[]) {
+    const char *ingerir = NULL, *reporte = NULL, *almacen = NULL;
+    int mes_opcion = 0, hilos = 0;
+    
+    if(argc > 1 && strcmp(argv[1], "--bench-ingesta") == 0) {
+        long lecturas = argc > 2 ? atol(argv[2]) : 0;
+        return medir_ingesta(lecturas > 0 ? lecturas : 2000000);
+    }
+    if(argc > 1 && strcmp(argv[1], "--bench-almacen") == 0) {
+        int zonas = argc > 2 ? atoi(argv[2]) : 0;
+        return medir_almacen(zonas > 0 ? zonas : 1000);
+    }
+    if(argc > 1 && strcmp(argv[1], "--bench-zonas") == 0) {
+        int zonas = argc > 2 ? atoi(argv[2]) : 0;
+        int max_hilos = argc > 3 ? atoi(argv[3]) : 0;
+        if(max_hilos <= 0) {
+            long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+            max_hilos = nucleos > 0 ? (int)nucleos : 1;
+        }
+        return medir_zonas(zonas > 0 ? zonas : 10000, max_hilos < MAX_HILOS_ZONAS ? max_hilos : MAX_HILOS_ZONAS);
+    }
+    if(argc > 1 && strcmp(argv[1], "--bench-alertas") == 0) {
+        int zonas = argc > 2 ? atoi(argv[2]) : 0;
+        return medir_alertas(zonas > 0 ? zonas : 1000003);
+    }
+    if(argc > 1 && strcmp(argv[1], "--bench-estadisticas") == 0) {
+        int zonas = argc > 2 ? atoi(argv[2]) : 0;
+        return medir_estadisticas(zonas > 0 ? zonas : 200);
+    }
+    for(int a = 1; a < argc; a++) {
+        int con_valor = a + 1 < argc;
+        if(strcmp(argv[a], "--ingerir") == 0 && con_valor) ingerir = argv[++a];
+        else if(strcmp(argv[a], "--reporte") == 0 && con_valor) reporte = argv[++a];
+        else if(strcmp(argv[a], "--almacen") == 0 && con_valor) almacen = argv[++a];
+        else if(strcmp(argv[a], "--hilos") == 0 && con_valor && atoi(argv[a + 1]) >= 1) hilos = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--mes") == 0 && con_valor && atoi(argv[a + 1]) >= 1 && atoi(argv[a + 1]) <= 12) {
+            mes_opcion = atoi(argv[++a]);
+        } else {
+            mostrar_uso(argv[0]);
+            return 1;
+        }
+    }
+    // Lecturas de estaciones desde un archivo o una tubería, sin preguntas
+    if(ingerir != NULL || almacen != NULL) return monitorear_lecturas(ingerir, almacen, mes_opcion, reporte, hilos);
+    
     // Inicializar generador de números aleatorios UNA SOLA VEZ
     srand(time(NULL));
     
-    Zona zonas[NUM_ZONAS];
+    // Las zonas (con sus series) van en un almacén en memoria
+    RegistroZonas reg;
+    if(!abrir_registro(&reg, NULL, NUM_ZONAS)) {
+        printf("❌ Error: No hay memoria para las zonas\n");
+        return 1;
+    }
+    Zona *zonas = reg.zonas;
     int mes_actual;
     char nombre_archivo[MAX_FILENAME];
     
@@ -410,11 +1083,7 @@ int main() {
     
     // 2. Procesamiento
     printf("\n⚙️  Procesando datos y generando predicciones...\n");
-    for(int i = 0; i < NUM_ZONAS; i++) {
-        calcular_promedios(&zonas[i]);
-        predecir_contaminacion(&zonas[i], mes_actual);
-        evaluar_alertas(&zonas[i]);
-    }
+    procesar_zonas(zonas, NUM_ZONAS, mes_actual, 1);
     
     // 3. Salida de resultados
     printf("\n📊 ===============================\n");
@@ -422,8 +1091,8 @@ int main() {
     printf("===============================\n");
     
     for(int i = 0; i < NUM_ZONAS; i++) {
-        mostrar_resultados_zona(zonas[i]);
-        generar_recomendaciones(zonas[i]);
+        mostrar_resultados_zona(&zonas[i]);
+        generar_recomendaciones(&zonas[i]);
         printf("\n");
         imprimir_separador();
     }
@@ -439,8 +1108,10 @@ int main() {
         printf("✅ Reporte generado exitosamente en: %s\n", nombre_archivo);
     } else {
         printf("❌ Error al crear el archivo de reporte\n");
+        cerrar_registro(&reg);
         return 1;
     }
+    cerrar_registro(&reg);
     
     printf("\n🎉 ===============================\n");
     printf("   ANÁLISIS COMPLETADO EXITOSAMENTE!\n");
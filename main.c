@@ -2,22 +2,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-
-#define MAX_PRODUCTOS 5
-#define MAX_NOMBRE 50
-
-// Función para convertir a minúsculas (búsqueda insensible a mayúsculas)
-void aMinusculas(char *str) {
-    for(int i = 0; str[i]; i++) {
-        str[i] = tolower(str[i]);
-    }
-}
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include "planificador.h"
 
 // Función para limpiar el buffer de entrada
 void limpiarBuffer() {
     while(getchar() != '\n');
 }
 
+static double segundosDesde(const struct timespec *inicio) {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
 // Función para mostrar el menú principal
 void mostrarMenu() {
     printf("\n=== MENÚ PRINCIPAL ===\n");
@@ -26,130 +26,379 @@ void mostrarMenu() {
     printf("3. Editar producto\n");
     printf("4. Eliminar producto\n");
     printf("5. Mostrar todos los productos\n");
-    printf("6. Salir\n");
+    printf("6. Guardar catálogo\n");
+    printf("7. Comparar escenarios\n");
+    printf("8. Salir\n");
 }
 
-// Función para ingresar los límites de la fábrica
-void ingresarLimites(int *tiempo, int *recursos) {
-    printf("\n=== LÍMITES DE PRODUCCIÓN ===\n");
+// Función para leer un nombre de recurso o período (sin espacios, para
+// poder escribirlo después en una línea de consumo)
+void leerNombreModelo(const char *tipo, int numero, char *nombre) {
+    do {
+        printf("Nombre del %s %d: ", tipo, numero);
+        fgets(nombre, MAX_NOMBRE, stdin);
+        nombre[strcspn(nombre, "\n")] = '\0';
+        if(nombre[0] == '\0') snprintf(nombre, MAX_NOMBRE, "%c%s%d", toupper((unsigned char)tipo[0]), tipo + 1, numero);
+        if(strchr(nombre, ' ') != NULL) printf("Error: No puede tener espacios\n");
+    } while(strchr(nombre, ' ') != NULL);
+}
+
+// Función para ingresar los recursos, los períodos y los límites de la fábrica
+int ingresarModelo(Catalogo *cat) {
+    int recursos, periodos;
+    
+    printf("\n=== RECURSOS Y PERÍODOS ===\n");
     
     do {
-        printf("Tiempo disponible (horas): ");
-        scanf("%d", tiempo);
-        if(*tiempo <= 0) printf("Error: Debe ser positivo\n");
-    } while(*tiempo <= 0);
+        printf("¿Cuántos recursos? (máquinas, materiales, horas de personal...): ");
+        scanf("%d", &recursos);
+        if(recursos <= 0) printf("Error: Debe ser positivo\n");
+    } while(recursos <= 0);
+    limpiarBuffer();
+    
+    char (*nombresRecursos)[MAX_NOMBRE] = malloc((size_t)recursos * MAX_NOMBRE);
+    if(nombresRecursos == NULL) return 0;
+    for(int r = 0; r < recursos; r++) leerNombreModelo("recurso", r + 1, nombresRecursos[r]);
     
     do {
-        printf("Recursos disponibles: ");
-        scanf("%d", recursos);
-        if(*recursos <= 0) printf("Error: Debe ser positivo\n");
-    } while(*recursos <= 0);
+        printf("¿Cuántos períodos? (turnos, días...): ");
+        scanf("%d", &periodos);
+        if(periodos <= 0) printf("Error: Debe ser positivo\n");
+    } while(periodos <= 0);
+    limpiarBuffer();
+    
+    char (*nombresPeriodos)[MAX_NOMBRE] = malloc((size_t)periodos * MAX_NOMBRE);
+    if(nombresPeriodos == NULL) {
+        free(nombresRecursos);
+        return 0;
+    }
+    for(int p = 0; p < periodos; p++) leerNombreModelo("período", p + 1, nombresPeriodos[p]);
+    
+    int ok = definirModelo(&cat->modelo, recursos, nombresRecursos, periodos, nombresPeriodos);
+    free(nombresRecursos);
+    free(nombresPeriodos);
+    if(!ok) return 0;
+    
+    printf("\n=== LÍMITES DE PRODUCCIÓN ===\n");
+    for(int f = 0; f < filasModelo(&cat->modelo); f++) {
+        char fila[2 * MAX_NOMBRE];
+        long long limite;
+        nombreFila(&cat->modelo, f, fila, sizeof(fila));
+        do {
+            printf("Disponible de %s: ", fila);
+            scanf("%lld", &limite);
+            if(limite < 0) printf("Error: No puede ser negativo\n");
+        } while(limite < 0);
+        fijarLimite(&cat->modelo, f, limite);
+    }
     
     limpiarBuffer();
+    return 1;
+}
+
+// Función para leer el consumo por unidad de un producto, una línea por
+// recurso ("recurso período cantidad", o "recurso cantidad" con un solo
+// período), hasta una línea vacía. Devuelve cuántos elementos quedaron.
+size_t leerConsumo(const ModeloCapacidad *m, ElementoConsumo *consumo) {
+    char linea[3 * MAX_NOMBRE];
+    size_t k = 0;
+    
+    if(m->periodos == 1) printf("Consumo por unidad, una línea \"recurso cantidad\" (vacía para terminar):\n");
+    else printf("Consumo por unidad, una línea \"recurso período cantidad\" (vacía para terminar):\n");
+    while(fgets(linea, sizeof(linea), stdin) != NULL) {
+        char recurso[MAX_NOMBRE], periodo[MAX_NOMBRE], resto[2];
+        int valor, r, p = 0;
+        linea[strcspn(linea, "\n")] = '\0';
+        if(linea[0] == '\0') break;
+        
+        int leidos = m->periodos == 1
+            ? sscanf(linea, "%49s %d %1s", recurso, &valor, resto)
+            : sscanf(linea, "%49s %49s %d %1s", recurso, periodo, &valor, resto);
+        if(leidos != (m->periodos == 1 ? 2 : 3)) {
+            printf("Error: Formato inválido\n");
+            continue;
+        }
+        r = buscarRecurso(m, recurso);
+        if(m->periodos > 1) p = buscarPeriodo(m, periodo);
+        if(r < 0 || p < 0) {
+            printf("Error: %s desconocido\n", r < 0 ? "Recurso" : "Período");
+            continue;
+        }
+        if(valor < 0) {
+            printf("Error: No puede ser negativo\n");
+            continue;
+        }
+        
+        // Una fila repetida reemplaza el valor anterior
+        uint32_t fila = (uint32_t)(r * m->periodos + p);
+        size_t e = 0;
+        while(e < k && consumo[e].fila != fila) e++;
+        consumo[e].fila = fila;
+        consumo[e].valor = valor;
+        if(e == k) k++;
+    }
+    return k;
 }
 
-// Función para ingresar datos de productos
-void ingresarProductos(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[], int recursos[]) {
+// Función para mostrar el consumo por unidad de un producto en una línea
+void mostrarConsumo(const Catalogo *cat, size_t indice) {
+    size_t k;
+    const ElementoConsumo *consumo = consumoProducto(cat, indice, &k);
+    printf("Consumo por unidad:");
+    if(k == 0) printf(" ninguno");
+    for(size_t e = 0; e < k; e++) {
+        char fila[2 * MAX_NOMBRE];
+        nombreFila(&cat->modelo, (int)consumo[e].fila, fila, sizeof(fila));
+        printf("%s %s %d", e ? "," : "", fila, consumo[e].valor);
+    }
+    printf("\n");
+}
+
+// Función para aplicar un cambio al catálogo; con diario, vuelve cuando el
+// cambio ya está en disco
+int aplicarCambio(Catalogo *cat, Diario *diario, const RegistroDiario *r, const char *sinMemoria) {
+    int resultado = cambiarCatalogo(cat, diario, r);
+    if(resultado == 0) printf("Error: %s\n", sinMemoria);
+    if(resultado < 0) printf("Error: No se pudo escribir el diario %s\n", diario->ruta);
+    return resultado > 0;
+}
+
+// Función para ingresar datos de productos (se agregan al final del catálogo)
+void ingresarProductos(Catalogo *cat, Diario *diario) {
+    int nuevos;
+    ElementoConsumo *consumo = malloc((size_t)filasModelo(&cat->modelo) * sizeof(ElementoConsumo));
+    if(consumo == NULL) {
+        printf("Error: No hay memoria para más productos\n");
+        return;
+    }
+    
     printf("\n=== INGRESO DE PRODUCTOS ===\n");
     
-    for(int i = 0; i < MAX_PRODUCTOS; i++) {
-        printf("\nProducto %d:\n", i+1);
+    do {
+        printf("¿Cuántos productos desea ingresar?: ");
+        scanf("%d", &nuevos);
+        if(nuevos < 0) printf("Error: No puede ser negativo\n");
+    } while(nuevos < 0);
+    limpiarBuffer();
+    
+    for(int i = 0; i < nuevos; i++) {
+        char nombre[MAX_NOMBRE];
+        int cantidad, ganancia;
+        
+        printf("\nProducto %zu:\n", cat->cantidad + 1);
         
         // Nombre
         printf("Nombre: ");
-        fgets(nombres[i], MAX_NOMBRE, stdin);
-        nombres[i][strcspn(nombres[i], "\n")] = '\0';
+        fgets(nombre, MAX_NOMBRE, stdin);
+        nombre[strcspn(nombre, "\n")] = '\0';
         
         // Validación de datos numéricos
         do {
             printf("Cantidad demandada: ");
-            scanf("%d", &cantidades[i]);
-            if(cantidades[i] < 0) printf("Error: No puede ser negativo\n");
-        } while(cantidades[i] < 0);
-        
-        do {
-            printf("Tiempo por unidad (horas): ");
-            scanf("%d", &tiempos[i]);
-            if(tiempos[i] <= 0) printf("Error: Debe ser positivo\n");
-        } while(tiempos[i] <= 0);
+            scanf("%d", &cantidad);
+            if(cantidad < 0) printf("Error: No puede ser negativo\n");
+        } while(cantidad < 0);
         
         do {
-            printf("Recursos por unidad: ");
-            scanf("%d", &recursos[i]);
-            if(recursos[i] <= 0) printf("Error: Debe ser positivo\n");
-        } while(recursos[i] <= 0);
+            printf("Ganancia por unidad (0 = sin dato): ");
+            scanf("%d", &ganancia);
+            if(ganancia < 0) printf("Error: No puede ser negativo\n");
+        } while(ganancia < 0);
         
         limpiarBuffer();
+        
+        size_t k = leerConsumo(&cat->modelo, consumo);
+        RegistroDiario r = { REGISTRO_AGREGAR, 0, nombre, cantidad, ganancia, k, consumo };
+        if(!aplicarCambio(cat, diario, &r, "No hay memoria para más productos")) break;
     }
+    free(consumo);
 }
 
-// Función para buscar producto (retorna índice o -1 si no encuentra)
-int buscarProducto(char nombres[][MAX_NOMBRE], const char *nombreBuscado) {
-    char nombreTemp[MAX_NOMBRE];
-    
-    for(int i = 0; i < MAX_PRODUCTOS; i++) {
-        strcpy(nombreTemp, nombres[i]);
-        aMinusculas(nombreTemp);
-        
-        char busquedaTemp[MAX_NOMBRE];
-        strcpy(busquedaTemp, nombreBuscado);
-        aMinusculas(busquedaTemp);
-        
-        if(strstr(nombreTemp, busquedaTemp) != NULL) {
-            return i; // Retorna el índice si encuentra coincidencia
+// Función para buscar producto (retorna índice o -1 si no encuentra).
+// Sin distinguir mayúsculas: gana el nombre exacto y si no, el primero que
+// contenga el texto; las búsquedas van por el índice del catálogo.
+long buscarProducto(const Catalogo *cat, const char *nombreBuscado) {
+    return buscarEnCatalogo(cat, nombreBuscado);
+}
+
+// Función para mostrar lo que usa un plan de cada fila y los productos que
+// no reciben su demanda completa
+void mostrarDetallePlan(const Catalogo *cat, const double *plan, size_t completos) {
+    const ModeloCapacidad *m = &cat->modelo;
+    int filas = filasModelo(m);
+    size_t parciales = 0;
+    long long *usados = calloc((size_t)filas + 1, sizeof(long long));
+    if(usados != NULL) {
+        for(size_t i = 0; i < cat->cantidad; i++) {
+            size_t k;
+            const ElementoConsumo *consumo = consumoProducto(cat, i, &k);
+            for(size_t e = 0; e < k; e++) usados[consumo[e].fila] += (long long)plan[i] * consumo[e].valor;
+        }
+        for(int f = 0; f < filas; f++) {
+            char fila[2 * MAX_NOMBRE];
+            if(usados[f] == 0) continue;
+            nombreFila(m, f, fila, sizeof(fila));
+            printf("%s usado: %lld/%lld\n", fila, usados[f], (long long)m->limites[f]);
+        }
+        free(usados);
+    }
+    printf("Productos con la demanda completa: %zu\n", completos);
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        long long x = (long long)plan[i];
+        if(x == cat->cantidades[i]) continue;
+        if(parciales++ == 50) {
+            printf("- ... y %zu productos más con demanda parcial\n", cat->cantidad - completos - 50);
+            break;
         }
+        printf("- %s: producir %lld de %d\n", nombreProducto(cat, i), x, cat->cantidades[i]);
     }
-    return -1; // No encontrado
 }
 
-// Función para calcular y mostrar los resultados
-void calcularProduccion(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[], int recursos[], int tiempoDisp, int recursosDisp) {
-    int total_tiempo = 0;
-    int total_recursos = 0;
-    int productos_registrados = 0;
+// Función para repartir la capacidad por prioridad: primero los productos
+// con más ganancia por unidad del recurso que los limita. Con un solo
+// recurso excedido el reparto es exacto (mochila). Devuelve 1 si es exacto y
+// deja en 'valor' la ganancia del plan (o las unidades sin ganancias).
+int mostrarPlanPrioridad(const Catalogo *cat, long long *valor) {
+    ResultadoPrioridad r;
+    Escenario actual;
+    long long demanda = 0;
+    double *plan = malloc((cat->cantidad + 1) * sizeof(double));
+    int ok = plan != NULL && crearEscenario(&actual, cat, "Actual");
+    if(ok) {
+        ok = planPorPrioridad(&actual, plan, &r);
+        liberarEscenario(&actual);
+    }
+    if(!ok) {
+        printf("Error: No hay memoria para el plan por prioridad\n");
+        free(plan);
+        return 0;
+    }
+    for(size_t i = 0; i < cat->cantidad; i++) demanda += cat->cantidades[i];
     
-    printf("\n=== RESUMEN DE PRODUCCIÓN ===\n");
+    char fila[2 * MAX_NOMBRE];
+    nombreFila(&cat->modelo, r.fila, fila, sizeof(fila));
+    printf("\n=== PLAN POR PRIORIDAD%s ===\n", r.exacto ? " (ÓPTIMO)" : "");
+    printf("Prioridad: más %s por unidad del recurso que limita a cada producto\n",
+           r.porGanancia ? "ganancia" : "unidades");
+    printf("Recurso más excedido: %s\n", fila);
+    printf("Unidades a producir: %lld de %lld demandadas\n", r.producidas, demanda);
+    if(r.porGanancia) printf("Ganancia: %lld\n", r.valor);
+    mostrarDetallePlan(cat, plan, r.completos);
+    free(plan);
+    *valor = r.valor;
+    return r.exacto;
+}
+
+// Función para buscar el mejor plan cuando la demanda no entra: cuántas
+// unidades de cada producto fabricar (enteras, sin pasar la demanda) para
+// maximizar la ganancia, o las unidades si no hay ganancias cargadas. Si la
+// búsqueda se corta sin superar 'valorPrioridad' (el del plan por prioridad
+// ya mostrado) solo se avisa, como en los escenarios.
+void mostrarPlanOptimo(const Catalogo *cat, long long valorPrioridad) {
+    int porGanancia = 0;
+    Escenario actual;
     
-    // Calcular totales y contar productos válidos
-    for(int i = 0; i < MAX_PRODUCTOS; i++) {
-        if(strlen(nombres[i]) > 0) { // Si el nombre no está vacío
-            total_tiempo += cantidades[i] * tiempos[i];
-            total_recursos += cantidades[i] * recursos[i];
-            productos_registrados++;
-        }
+    // El catálogo tal como está es un escenario sin ediciones
+    double *plan = malloc((cat->cantidad + 1) * sizeof(double));
+    if(plan == NULL || !crearEscenario(&actual, cat, "Actual")) {
+        printf("Error: No hay memoria para optimizar\n");
+        free(plan);
+        return;
+    }
+    ResultadoEntero res = optimizarEscenario(&actual, plan, &porGanancia);
+    liberarEscenario(&actual);
+    if(res.estado == PLAN_SIN_MEMORIA) {
+        printf("Error: No hay memoria para optimizar\n");
+        free(plan);
+        return;
+    }
+    if(res.estado != PLAN_OPTIMO && res.estado != PLAN_LIMITE_NODOS) {
+        printf("\nNo se pudo calcular un plan de producción\n");
+        free(plan);
+        return;
+    }
+    
+    long long unidades = 0, demanda = 0, ganancia = 0;
+    size_t completos = 0;
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        long long x = (long long)plan[i];
+        unidades += x;
+        demanda += cat->cantidades[i];
+        ganancia += x * cat->ganancias[i];
+        if(x == cat->cantidades[i]) completos++;
+    }
+    if(res.estado == PLAN_LIMITE_NODOS && (porGanancia ? ganancia : unidades) <= valorPrioridad) {
+        printf("\nBúsqueda cortada en %ld nodos sin mejorar el plan por prioridad; el óptimo no supera %.0f\n",
+               res.nodos, res.cota);
+        free(plan);
+        return;
+    }
+    
+    printf("\n=== PLAN DE PRODUCCIÓN %s ===\n", res.estado == PLAN_OPTIMO ? "ÓPTIMO" : "(MEJOR ENCONTRADO)");
+    printf("Objetivo: maximizar %s\n", porGanancia ? "la ganancia" : "las unidades producidas");
+    printf("Unidades a producir: %lld de %lld demandadas\n", unidades, demanda);
+    if(porGanancia) printf("Ganancia: %lld\n", ganancia);
+    if(res.estado == PLAN_LIMITE_NODOS) {
+        printf("Búsqueda cortada en %ld nodos; el óptimo no supera %.0f\n", res.nodos, res.cota);
     }
+    mostrarDetallePlan(cat, plan, completos);
+    free(plan);
+}
+
+// Función para calcular y mostrar los resultados. La demanda de cada recurso
+// en cada período ya está sumada en el modelo (se actualiza con cada alta,
+// edición o baja), así que no se recorre el catálogo.
+void calcularProduccion(const Catalogo *cat) {
+    const ModeloCapacidad *m = &cat->modelo;
+    size_t productos_registrados = cat->cantidad;
+    int desborde = 0;
+    
+    printf("\n=== RESUMEN DE PRODUCCIÓN ===\n");
     
     // Mostrar resultados
-    printf("Productos registrados: %d\n", productos_registrados);
-    printf("Tiempo requerido: %d/%d horas\n", total_tiempo, tiempoDisp);
-    printf("Recursos necesarios: %d/%d\n", total_recursos, recursosDisp);
+    printf("Productos registrados: %zu\n", productos_registrados);
+    for(int f = 0; f < filasModelo(m); f++) {
+        char fila[2 * MAX_NOMBRE];
+        nombreFila(m, f, fila, sizeof(fila));
+        printf("%s requerido: %lld/%lld\n", fila, (long long)demandaFila(m, f, &desborde), (long long)m->limites[f]);
+    }
+    if(desborde) printf("Aviso: la demanda supera %lld y se muestra saturada\n", (long long)INT64_MAX);
     
     // Determinar viabilidad
     if(productos_registrados == 0) {
         printf("\nNo hay productos registrados!\n");
-    } else if(total_tiempo <= tiempoDisp && total_recursos <= recursosDisp) {
+    } else if(m->excedidas == 0) {
         printf("\n✅ PRODUCCIÓN VIABLE\n");
-        printf("Recursos sobrantes: %d\n", recursosDisp - total_recursos);
-        printf("Tiempo disponible: %d horas\n", tiempoDisp - total_tiempo);
+        for(int f = 0; f < filasModelo(m); f++) {
+            char fila[2 * MAX_NOMBRE];
+            nombreFila(m, f, fila, sizeof(fila));
+            printf("%s sobrante: %lld\n", fila, (long long)(m->limites[f] - demandaFila(m, f, NULL)));
+        }
     } else {
         printf("\n❌ NO SE PUEDE CUMPLIR LA DEMANDA\n");
-        if(total_tiempo > tiempoDisp) {
-            printf("- Faltan %d horas de producción\n", total_tiempo - tiempoDisp);
+        for(int f = 0; f < filasModelo(m); f++) {
+            char fila[2 * MAX_NOMBRE];
+            int64_t requerido = demandaFila(m, f, NULL);
+            if(requerido <= m->limites[f]) continue;
+            nombreFila(m, f, fila, sizeof(fila));
+            printf("- Faltan %lld de %s\n", (long long)(requerido - m->limites[f]), fila);
         }
-        if(total_recursos > recursosDisp) {
-            printf("- Faltan %d unidades de recursos\n", total_recursos - recursosDisp);
+        // Branch and bound solo en catálogos chicos (igual que los escenarios)
+        long long valorPrioridad = -1;
+        if(!mostrarPlanPrioridad(cat, &valorPrioridad) && cat->cantidad <= MAX_PRODUCTOS_PLAN_OPTIMO) {
+            mostrarPlanOptimo(cat, valorPrioridad);
         }
     }
 }
 
 // Función para editar un producto existente
-void editarProducto(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[], int recursos[]) {
+void editarProducto(Catalogo *cat, Diario *diario) {
     char nombreBusqueda[MAX_NOMBRE];
-    int indice;
+    long indice;
     
     printf("\n=== EDITAR PRODUCTO ===\n");
     
-    if(strlen(nombres[0]) == 0) {
+    if(cat->cantidad == 0) {
         printf("No hay productos registrados!\n");
         return;
     }
@@ -158,45 +407,55 @@ void editarProducto(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[],
     fgets(nombreBusqueda, MAX_NOMBRE, stdin);
     nombreBusqueda[strcspn(nombreBusqueda, "\n")] = '\0';
     
-    indice = buscarProducto(nombres, nombreBusqueda);
+    indice = buscarProducto(cat, nombreBusqueda);
     
     if(indice == -1) {
         printf("Producto no encontrado!\n");
     } else {
-        printf("\nEditando producto: %s\n", nombres[indice]);
+        printf("\nEditando producto: %s\n", nombreProducto(cat, indice));
         
         // Editar nombre
-        printf("Nuevo nombre [%s]: ", nombres[indice]);
+        printf("Nuevo nombre [%s]: ", nombreProducto(cat, indice));
         char nuevoNombre[MAX_NOMBRE];
         fgets(nuevoNombre, MAX_NOMBRE, stdin);
         if(strlen(nuevoNombre) > 1) { // Si el usuario ingresó algo
             nuevoNombre[strcspn(nuevoNombre, "\n")] = '\0';
-            strcpy(nombres[indice], nuevoNombre);
+            RegistroDiario r = { REGISTRO_NOMBRE, (size_t)indice, nuevoNombre, 0, 0, 0, NULL };
+            aplicarCambio(cat, diario, &r, "No hay memoria para el nuevo nombre");
         }
         
-        // Editar cantidad
-        printf("Nueva cantidad [%d]: ", cantidades[indice]);
+        // Editar cantidad (el modelo se actualiza solo en las filas que usa)
+        printf("Nueva cantidad [%d]: ", cat->cantidades[indice]);
         char input[20];
         fgets(input, 20, stdin);
         if(strlen(input) > 1) {
             int nuevaCantidad = atoi(input);
-            if(nuevaCantidad >= 0) cantidades[indice] = nuevaCantidad;
+            RegistroDiario r = { REGISTRO_CANTIDAD, (size_t)indice, NULL, nuevaCantidad, 0, 0, NULL };
+            if(nuevaCantidad >= 0) aplicarCambio(cat, diario, &r, "Cantidad inválida");
         }
         
-        // Editar tiempo
-        printf("Nuevo tiempo por unidad [%d]: ", tiempos[indice]);
+        // Editar consumo
+        mostrarConsumo(cat, indice);
+        printf("¿Cambiar el consumo? (s/N): ");
         fgets(input, 20, stdin);
-        if(strlen(input) > 1) {
-            int nuevoTiempo = atoi(input);
-            if(nuevoTiempo > 0) tiempos[indice] = nuevoTiempo;
+        if(input[0] == 's' || input[0] == 'S') {
+            ElementoConsumo *consumo = malloc((size_t)filasModelo(&cat->modelo) * sizeof(ElementoConsumo));
+            if(consumo == NULL) {
+                printf("Error: No hay memoria para el nuevo consumo\n");
+            } else {
+                RegistroDiario r = { REGISTRO_CONSUMO, (size_t)indice, NULL, 0, 0, leerConsumo(&cat->modelo, consumo), consumo };
+                aplicarCambio(cat, diario, &r, "No hay memoria para el nuevo consumo");
+            }
+            free(consumo);
         }
         
-        // Editar recursos
-        printf("Nuevos recursos por unidad [%d]: ", recursos[indice]);
+        // Editar ganancia
+        printf("Nueva ganancia por unidad [%d]: ", cat->ganancias[indice]);
         fgets(input, 20, stdin);
         if(strlen(input) > 1) {
-            int nuevosRecursos = atoi(input);
-            if(nuevosRecursos > 0) recursos[indice] = nuevosRecursos;
+            int nuevaGanancia = atoi(input);
+            RegistroDiario r = { REGISTRO_GANANCIA, (size_t)indice, NULL, nuevaGanancia, 0, 0, NULL };
+            if(nuevaGanancia >= 0) aplicarCambio(cat, diario, &r, "Ganancia inválida");
         }
         
         printf("Producto actualizado con éxito!\n");
@@ -204,13 +463,13 @@ void editarProducto(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[],
 }
 
 // Función para eliminar un producto
-void eliminarProducto(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[], int recursos[]) {
+void eliminarProducto(Catalogo *cat, Diario *diario) {
     char nombreBusqueda[MAX_NOMBRE];
-    int indice;
+    long indice;
     
     printf("\n=== ELIMINAR PRODUCTO ===\n");
     
-    if(strlen(nombres[0]) == 0) {
+    if(cat->cantidad == 0) {
         printf("No hay productos registrados!\n");
         return;
     }
@@ -219,63 +478,988 @@ void eliminarProducto(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[
     fgets(nombreBusqueda, MAX_NOMBRE, stdin);
     nombreBusqueda[strcspn(nombreBusqueda, "\n")] = '\0';
     
-    indice = buscarProducto(nombres, nombreBusqueda);
+    indice = buscarProducto(cat, nombreBusqueda);
     
     if(indice == -1) {
         printf("Producto no encontrado!\n");
     } else {
-        printf("\nEliminando producto: %s\n", nombres[indice]);
-        strcpy(nombres[indice], ""); // Cadena vacía para nombre
-        cantidades[indice] = 0;
-        tiempos[indice] = 0;
-        recursos[indice] = 0;
-        printf("Producto eliminado con éxito!\n");
+        printf("\nEliminando producto: %s\n", nombreProducto(cat, indice));
+        // El último producto pasa a ocupar su lugar
+        RegistroDiario r = { REGISTRO_QUITAR, (size_t)indice, NULL, 0, 0, 0, NULL };
+        if(aplicarCambio(cat, diario, &r, "No se pudo eliminar")) printf("Producto eliminado con éxito!\n");
+    }
+}
+
+// Función para interpretar una edición de escenario, "campo cambio objetivo":
+// campo es cantidad, ganancia o limite; cambio es 500 (fijar), +5 o -5
+// (sumar) o +20% / -20% (porcentaje); objetivo es un producto, un
+// "Recurso/Período" para los límites, o * para todos
+const char *leerEdicion(const Catalogo *cat, const char *linea, EdicionEscenario *ed) {
+    char campo[16], cambio[32], objetivo[2 * MAX_NOMBRE];
+    int usados = 0;
+    if(sscanf(linea, "%15s %31s %n", campo, cambio, &usados) != 2 || linea[usados] == '\0') {
+        return "Formato inválido (campo cambio objetivo)";
+    }
+    snprintf(objetivo, sizeof(objetivo), "%s", linea + usados);
+    for(size_t k = strlen(objetivo); k > 0 && isspace((unsigned char)objetivo[k - 1]); k--) objetivo[k - 1] = '\0';
+    
+    if(strcasecmp(campo, "cantidad") == 0) ed->campo = EDITAR_CANTIDAD;
+    else if(strcasecmp(campo, "ganancia") == 0) ed->campo = EDITAR_GANANCIA;
+    else if(strcasecmp(campo, "limite") == 0 || strcasecmp(campo, "límite") == 0) ed->campo = EDITAR_LIMITE;
+    else return "Campo desconocido (cantidad, ganancia o limite)";
+    
+    char *fin;
+    ed->valor = strtod(cambio, &fin);
+    if(fin == cambio || (*fin != '\0' && strcmp(fin, "%") != 0)) return "Cambio inválido";
+    if(*fin == '%') ed->tipo = CAMBIO_PORCENTAJE;
+    else if(cambio[0] == '+' || cambio[0] == '-') ed->tipo = CAMBIO_SUMAR;
+    else ed->tipo = CAMBIO_FIJAR;
+    
+    if(strcmp(objetivo, "*") == 0) ed->objetivo = -1;
+    else if(ed->campo == EDITAR_LIMITE) ed->objetivo = buscarFila(&cat->modelo, objetivo);
+    else ed->objetivo = buscarProducto(cat, objetivo);
+    if(ed->objetivo < 0 && strcmp(objetivo, "*") != 0) {
+        return ed->campo == EDITAR_LIMITE ? "Recurso/período no encontrado" : "Producto no encontrado";
+    }
+    return NULL;
+}
+
+// Función para leer escenarios: "= nombre" abre un escenario y las líneas
+// siguientes son sus ediciones ('#' comenta). En modo interactivo termina con
+// una línea vacía. El primero de la lista es el catálogo sin ediciones.
+size_t leerEscenarios(const Catalogo *cat, FILE *entrada, int interactivo, Escenario **lista) {
+    char linea[256];
+    size_t n = 0, capacidad = 4;
+    long numero = 0;
+    Escenario *escenarios = malloc(capacidad * sizeof(Escenario));
+    if(escenarios == NULL || !crearEscenario(&escenarios[0], cat, "Actual")) {
+        free(escenarios);
+        return 0;
+    }
+    n = 1;
+    
+    if(interactivo) {
+        printf("\"= nombre\" empieza un escenario; después, una edición por línea:\n");
+        printf("  cantidad +20%% Eje | cantidad 500 Eje | ganancia +2 * | limite -10%% Torno/Lunes\n");
+        printf("Línea vacía para terminar.\n> ");
+    }
+    while(fgets(linea, sizeof(linea), entrada) != NULL) {
+        numero++;
+        linea[strcspn(linea, "\r\n")] = '\0';
+        const char *texto = linea;
+        while(isspace((unsigned char)*texto)) texto++;
+        if(*texto == '\0' && interactivo) break;
+        
+        if(*texto == '=') {
+            texto++;
+            while(isspace((unsigned char)*texto)) texto++;
+            if(n == capacidad) {
+                Escenario *nuevos = realloc(escenarios, 2 * capacidad * sizeof(Escenario));
+                if(nuevos == NULL) break;
+                escenarios = nuevos;
+                capacidad *= 2;
+            }
+            char nombre[MAX_NOMBRE];
+            if(*texto) snprintf(nombre, sizeof(nombre), "%s", texto);
+            else snprintf(nombre, sizeof(nombre), "Escenario %zu", n);
+            if(!crearEscenario(&escenarios[n], cat, nombre)) {
+                printf("Error: No hay memoria para más escenarios\n");
+                break;
+            }
+            n++;
+        } else if(*texto != '\0' && *texto != '#') {
+            EdicionEscenario ed;
+            const char *error = n == 1 ? "Falta \"= nombre\" antes de las ediciones" : leerEdicion(cat, texto, &ed);
+            if(error == NULL && !aplicarEdiciones(&escenarios[n - 1], &ed, 1)) error = "No hay memoria para el escenario";
+            if(error != NULL && interactivo) printf("Error: %s\n", error);
+            else if(error != NULL) printf("Error: línea %ld: %s\n", numero, error);
+        }
+        if(interactivo) printf("> ");
+    }
+    *lista = escenarios;
+    return n;
+}
+
+// Función para escribir una celda de 'ancho' columnas (los acentos ocupan
+// más de un byte y printf cuenta bytes)
+void imprimirCelda(const char *texto, int ancho, int aIzquierda) {
+    int columnas = 0;
+    for(const char *c = texto; *c; c++) {
+        if(((unsigned char)*c & 0xC0) != 0x80) columnas++;
+    }
+    int relleno = ancho > columnas ? ancho - columnas : 0;
+    if(aIzquierda) printf("%s%*s", texto, relleno, "");
+    else printf(" %*s%s", relleno, "", texto);
+}
+
+// Función para mostrar los escenarios lado a lado, de a cinco columnas
+void mostrarComparacion(Escenario *const *esc, const ResultadoEscenario *res, size_t n) {
+    enum { POR_BLOQUE = 5, ANCHO = 14, ETIQUETA = 22 };
+    const ModeloCapacidad *base = &esc[0]->modelo;
+    char celda[64];
+    int recortada = 0, voraz = 0;
+    
+    printf("\n=== COMPARACIÓN DE ESCENARIOS ===\n");
+    for(size_t desde = 0; desde < n; desde += POR_BLOQUE) {
+        size_t hasta = desde + POR_BLOQUE < n ? desde + POR_BLOQUE : n;
+        
+        printf("\n");
+        imprimirCelda("", ETIQUETA, 1);
+        for(size_t j = desde; j < hasta; j++) {
+            snprintf(celda, sizeof(celda), "%.14s", esc[j]->nombre);
+            imprimirCelda(celda, ANCHO, 0);
+        }
+        
+        const char *etiquetas[] = { "Viable", "Filas excedidas", "Demanda (u)", "Producción (u)", "Ganancia",
+                                    "Ganancia vs actual" };
+        for(int fila = 0; fila < 6; fila++) {
+            printf("\n");
+            imprimirCelda(etiquetas[fila], ETIQUETA, 1);
+            for(size_t j = desde; j < hasta; j++) {
+                const ResultadoEscenario *r = &res[j];
+                int conPlan = r->estado == PLAN_OPTIMO || r->estado == PLAN_LIMITE_NODOS || r->estado == PLAN_VORAZ;
+                switch(fila) {
+                    case 0: snprintf(celda, sizeof(celda), "%s", r->viable ? "sí" : "no"); break;
+                    case 1: snprintf(celda, sizeof(celda), "%zu", r->excedidas); break;
+                    case 2: snprintf(celda, sizeof(celda), "%lld", r->demanda); break;
+                    case 3: snprintf(celda, sizeof(celda), conPlan ? "%lld" : "error", r->producidas); break;
+                    case 4:
+                        snprintf(celda, sizeof(celda), conPlan ? "%lld%s" : "error", r->ganancia,
+                                 r->estado == PLAN_LIMITE_NODOS ? "*" : r->estado == PLAN_VORAZ ? "~" : "");
+                        if(r->estado == PLAN_LIMITE_NODOS) recortada = 1;
+                        if(r->estado == PLAN_VORAZ) voraz = 1;
+                        break;
+                    default:
+                        if(j == 0) snprintf(celda, sizeof(celda), "-");
+                        else snprintf(celda, sizeof(celda), "%+lld", r->ganancia - res[0].ganancia);
+                }
+                imprimirCelda(celda, ANCHO, 0);
+            }
+        }
+        
+        // Filas de capacidad: las que cambian respecto del catálogo actual o
+        // quedan excedidas en algún escenario (demanda/límite)
+        for(int f = 0; f < filasModelo(base); f++) {
+            int mostrar = 0;
+            for(size_t j = 0; j < n && !mostrar; j++) {
+                const ModeloCapacidad *m = &esc[j]->modelo;
+                mostrar = m->demandas[f] > m->limites[f] || m->limites[f] != base->limites[f] ||
+                          m->demandas[f] != base->demandas[f];
+            }
+            if(!mostrar) continue;
+            nombreFila(base, f, celda, sizeof(celda));
+            printf("\n");
+            imprimirCelda(celda, ETIQUETA, 1);
+            for(size_t j = desde; j < hasta; j++) {
+                const ModeloCapacidad *m = &esc[j]->modelo;
+                snprintf(celda, sizeof(celda), "%lld/%lld", (long long)demandaFila(m, f, NULL), (long long)m->limites[f]);
+                imprimirCelda(celda, ANCHO, 0);
+            }
+        }
+        printf("\n");
+    }
+    if(recortada) printf("\n* búsqueda cortada por el límite de nodos: mejor plan encontrado\n");
+    if(voraz) printf("%s~ plan por prioridad: puede no ser el óptimo\n", recortada ? "" : "\n");
+}
+
+// Función para comparar escenarios leídos de 'entrada' sin tocar el catálogo
+void compararEscenarios(const Catalogo *cat, FILE *entrada, int interactivo) {
+    Escenario *escenarios;
+    
+    printf("\n=== ESCENARIOS ===\n");
+    size_t n = leerEscenarios(cat, entrada, interactivo, &escenarios);
+    if(n == 0) {
+        printf("Error: No hay memoria para los escenarios\n");
+        return;
+    }
+    
+    Escenario **punteros = malloc(n * sizeof(Escenario *));
+    ResultadoEscenario *resultados = malloc(n * sizeof(ResultadoEscenario));
+    if(punteros != NULL && resultados != NULL) {
+        struct timespec inicio;
+        for(size_t j = 0; j < n; j++) punteros[j] = &escenarios[j];
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        evaluarEscenarios(punteros, n, resultados, 0);
+        double segundos = segundosDesde(&inicio);
+        mostrarComparacion(punteros, resultados, n);
+        printf("\n%zu escenarios evaluados en %.3f s\n", n, segundos);
+    } else {
+        printf("Error: No hay memoria para los escenarios\n");
+    }
+    for(size_t j = 0; j < n; j++) liberarEscenario(&escenarios[j]);
+    free(escenarios);
+    free(punteros);
+    free(resultados);
+}
+
+// Función para guardar el catálogo: en CSV si el archivo termina en .csv, si
+// no como instantánea binaria
+void guardarCatalogo(const Catalogo *cat) {
+    char ruta[256];
+    
+    printf("\n=== GUARDAR CATÁLOGO ===\n");
+    printf("Archivo (.csv para CSV, otro para instantánea): ");
+    fgets(ruta, sizeof(ruta), stdin);
+    ruta[strcspn(ruta, "\n")] = '\0';
+    if(ruta[0] == '\0') return;
+    
+    size_t largo = strlen(ruta);
+    int csv = largo >= 4 && strcmp(ruta + largo - 4, ".csv") == 0;
+    if(csv ? exportarCSV(cat, ruta) : guardarInstantanea(cat, ruta)) {
+        printf("Catálogo guardado en %s\n", ruta);
+    } else {
+        printf("Error: No se pudo guardar %s\n", ruta);
     }
 }
 
 // Función para mostrar todos los productos
-void mostrarProductos(char nombres[][MAX_NOMBRE], int cantidades[], int tiempos[], int recursos[]) {
+void mostrarProductos(const Catalogo *cat) {
     printf("\n=== LISTA DE PRODUCTOS ===\n");
     
-    int productosMostrados = 0;
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        printf("\nProducto %zu:\n", i+1);
+        printf("Nombre: %s\n", nombreProducto(cat, i));
+        printf("Cantidad: %d\n", cat->cantidades[i]);
+        mostrarConsumo(cat, i);
+        printf("Ganancia por unidad: %d\n", cat->ganancias[i]);
+    }
     
-    for(int i = 0; i < MAX_PRODUCTOS; i++) {
-        if(strlen(nombres[i]) > 0) {
-            printf("\nProducto %d:\n", i+1);
-            printf("Nombre: %s\n", nombres[i]);
-            printf("Cantidad: %d\n", cantidades[i]);
-            printf("Tiempo por unidad: %d horas\n", tiempos[i]);
-            printf("Recursos por unidad: %d\n", recursos[i]);
-            productosMostrados++;
+    if(cat->cantidad == 0) {
+        printf("No hay productos registrados!\n");
+    } else {
+        printf("\nTotal productos registrados: %zu\n", cat->cantidad);
+    }
+}
+
+// Búsqueda de referencia: la de antes (copia y pasa a minúsculas en cada
+// producto), con la misma preferencia por el nombre exacto
+static long busquedaLineal(const Catalogo *cat, const char *texto) {
+    char busqueda[MAX_NOMBRE], nombre[MAX_NOMBRE];
+    long primero = -1;
+    snprintf(busqueda, sizeof(busqueda), "%s", texto);
+    for(int k = 0; busqueda[k]; k++) busqueda[k] = tolower((unsigned char)busqueda[k]);
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        snprintf(nombre, sizeof(nombre), "%s", nombreProducto(cat, i));
+        for(int k = 0; nombre[k]; k++) nombre[k] = tolower((unsigned char)nombre[k]);
+        if(strcmp(nombre, busqueda) == 0) return (long)i;
+        if(primero < 0 && strstr(nombre, busqueda) != NULL) primero = (long)i;
+    }
+    return primero;
+}
+
+// Compara el índice con el recorrido lineal sobre un catálogo sintético
+static int medirBusqueda(size_t productos) {
+    static const char *familias[] = { "Resistor", "Capacitor", "Diodo", "Transistor", "Inductor",
+                                      "Conector", "Fusible", "Relé", "Cristal", "Regulador" };
+    static const char *encapsulados[] = { "0402", "0603", "0805", "SOT-23", "TO-220", "DIP-8", "QFN-32" };
+    Catalogo cat;
+    char nombre[MAX_NOMBRE];
+    struct timespec inicio;
+    iniciarCatalogo(&cat);
+    
+    srand(12345);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(size_t i = 0; i < productos; i++) {
+        snprintf(nombre, sizeof(nombre), "%s %s R%zu-%04d", familias[rand() % 10], encapsulados[rand() % 7],
+                 i, rand() % 10000);
+        if(agregarProducto(&cat, nombre, 1, 0, 0, NULL) < 0) {
+            printf("Error: No hay memoria para el catálogo\n");
+            liberarCatalogo(&cat);
+            return 1;
         }
     }
+    printf("Catálogo de %zu productos armado en %.3f s\n", productos, segundosDesde(&inicio));
     
-    if(productosMostrados == 0) {
-        printf("No hay productos registrados!\n");
+    // Consultas: nombres exactos, fragmentos largos y cortos, y ausentes
+    enum { CONSULTAS = 2000 };
+    char (*consultas)[MAX_NOMBRE] = malloc(CONSULTAS * sizeof(*consultas));
+    if(consultas == NULL) {
+        liberarCatalogo(&cat);
+        return 1;
+    }
+    for(int q = 0; q < CONSULTAS; q++) {
+        const char *base = nombreProducto(&cat, (size_t)rand() % productos);
+        switch(q % 4) {
+            case 0: snprintf(consultas[q], MAX_NOMBRE, "%s", base); break;
+            case 1: snprintf(consultas[q], MAX_NOMBRE, "r%d-", rand() % (int)productos); break;
+            case 2: snprintf(consultas[q], MAX_NOMBRE, "%c", "aeiou"[rand() % 5]); break;
+            default: snprintf(consultas[q], MAX_NOMBRE, "zz%d", rand()); break;
+        }
+    }
+    
+    long resultados[CONSULTAS];
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int q = 0; q < CONSULTAS; q++) resultados[q] = buscarProducto(&cat, consultas[q]);
+    double indexado = segundosDesde(&inicio);
+    
+    int linealesMedidas = CONSULTAS / 20, distintos = 0;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int q = 0; q < linealesMedidas; q++) {
+        if(busquedaLineal(&cat, consultas[q]) != resultados[q]) distintos++;
+    }
+    double lineal = segundosDesde(&inicio);
+    
+    printf("Con índice: %.2f µs por búsqueda (%d búsquedas)\n", indexado / CONSULTAS * 1e6, CONSULTAS);
+    printf("Lineal:     %.2f µs por búsqueda (%d búsquedas)\n", lineal / linealesMedidas * 1e6, linealesMedidas);
+    printf("Resultados distintos: %d\n", distintos);
+    
+    free(consultas);
+    liberarCatalogo(&cat);
+    return distintos != 0;
+}
+
+// Mide la demanda por fila que "Calcular producción" lee del modelo contra
+// recorrer todo el catálogo como antes: un catálogo sintético de recursos por
+// períodos con consumos grandes (los totales no entran en 32 bits), ediciones
+// sueltas de cantidades, y al final la demanda de cada fila se compara con la
+// recalculada desde cero en 128 bits
+static int medirDemanda(size_t productos) {
+    enum { RECURSOS = 4, PERIODOS = 7, EDICIONES = 100000, REPETICIONES = 5 };
+    char nombresRecursos[RECURSOS][MAX_NOMBRE] = { "Torno", "Fresa", "Cobre", "Horas" };
+    char nombresPeriodos[PERIODOS][MAX_NOMBRE] = { "Lunes", "Martes", "Miércoles", "Jueves", "Viernes",
+                                                   "Sábado", "Domingo" };
+    const int filas = RECURSOS * PERIODOS;
+    Catalogo cat;
+    struct timespec inicio;
+    iniciarCatalogo(&cat);
+    int ok = definirModelo(&cat.modelo, RECURSOS, nombresRecursos, PERIODOS, nombresPeriodos) &&
+             reservarCatalogo(&cat, productos, productos * 16, productos * 3);
+    
+    srand(12345);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(size_t i = 0; ok && i < productos; i++) {
+        char nombre[MAX_NOMBRE];
+        ElementoConsumo consumo[3];
+        int periodo = rand() % PERIODOS;
+        for(int e = 0; e < 3; e++) {
+            consumo[e].fila = (uint32_t)(((rand() % RECURSOS) * PERIODOS + periodo + e) % filas);
+            consumo[e].valor = 1 + rand() % 10000;
+        }
+        snprintf(nombre, sizeof(nombre), "Pieza %zu", i);
+        ok = agregarProducto(&cat, nombre, rand() % 1000000, 0, 3, consumo) >= 0;
+    }
+    double armar = segundosDesde(&inicio);
+    if(!ok) {
+        printf("Error: No hay memoria para el catálogo\n");
+        liberarCatalogo(&cat);
+        return 1;
+    }
+    for(int f = 0; f < filas; f++) fijarLimite(&cat.modelo, f, demandaFila(&cat.modelo, f, NULL) / 10 * (5 + f % 10));
+    
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int j = 0; j < EDICIONES; j++) cambiarCantidad(&cat, (size_t)rand() % productos, rand() % 1000000);
+    double editar = segundosDesde(&inicio);
+    
+    // Lo que lee el resumen: la demanda y el estado de cada fila
+    volatile long long sumidero = 0;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int r = 0; r < REPETICIONES; r++) {
+        int desborde = 0;
+        for(int f = 0; f < filas; f++) sumidero += demandaFila(&cat.modelo, f, &desborde) > cat.modelo.limites[f];
+        sumidero += (long long)cat.modelo.excedidas + desborde;
+    }
+    double resumen = segundosDesde(&inicio) / REPETICIONES;
+    
+    // Recorriendo el catálogo, con la suma exacta en 128 bits
+    __int128 *recalculada = calloc((size_t)filas, sizeof(__int128));
+    if(recalculada == NULL) {
+        liberarCatalogo(&cat);
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int r = 0; r < REPETICIONES; r++) {
+        memset(recalculada, 0, (size_t)filas * sizeof(__int128));
+        for(size_t i = 0; i < cat.cantidad; i++) {
+            size_t k;
+            const ElementoConsumo *consumo = consumoProducto(&cat, i, &k);
+            for(size_t e = 0; e < k; e++) recalculada[consumo[e].fila] += (int64_t)cat.cantidades[i] * consumo[e].valor;
+        }
+        sumidero += (long long)recalculada[0];
+    }
+    double recorrer = segundosDesde(&inicio) / REPETICIONES;
+    
+    int distintas = 0;
+    size_t excedidas = 0;
+    for(int f = 0; f < filas; f++) {
+        if(recalculada[f] != cat.modelo.demandas[f]) distintas++;
+        if(recalculada[f] > cat.modelo.limites[f]) excedidas++;
+    }
+    if(excedidas != cat.modelo.excedidas) distintas++;
+    
+    // Desborde: con todo al máximo la demanda de la fila no entra en 64 bits
+    // y se muestra saturada
+    ElementoConsumo maximo = { 0, INT32_MAX };
+    int desborde = 0;
+    for(int j = 0; j < 3; j++) agregarProducto(&cat, "Máximo", INT32_MAX, 0, 1, &maximo);
+    int saturada = demandaFila(&cat.modelo, 0, &desborde) == INT64_MAX && desborde;
+    
+    printf("%zu productos, %d filas (%d recursos x %d períodos)\n", productos, filas, RECURSOS, PERIODOS);
+    printf("Armar el catálogo: %.3f s (%.0f ns por producto)\n", armar, armar * 1e9 / (double)productos);
+    printf("Editar cantidades: %.1f ns por edición\n", editar * 1e9 / EDICIONES);
+    printf("Resumen desde el modelo: %10.3f µs\n", resumen * 1e6);
+    printf("Recorriendo el catálogo: %10.3f µs (x%.0f)\n", recorrer * 1e6, recorrer / resumen);
+    printf("Filas distintas de la suma recorriendo: %d, desborde saturado: %s\n", distintas, saturada ? "sí" : "no");
+    
+    free(recalculada);
+    liberarCatalogo(&cat);
+    return distintas != 0 || !saturada;
+}
+
+static int catalogosIguales(const Catalogo *a, const Catalogo *b) {
+    const ModeloCapacidad *ma = &a->modelo, *mb = &b->modelo;
+    if(a->cantidad != b->cantidad || ma->recursos != mb->recursos || ma->periodos != mb->periodos) return 0;
+    for(int r = 0; r < ma->recursos; r++) {
+        if(strcmp(ma->nombresRecursos[r], mb->nombresRecursos[r]) != 0) return 0;
+    }
+    for(int p = 0; p < ma->periodos; p++) {
+        if(strcmp(ma->nombresPeriodos[p], mb->nombresPeriodos[p]) != 0) return 0;
+    }
+    for(int f = 0; f < filasModelo(ma); f++) {
+        if(ma->limites[f] != mb->limites[f] || ma->demandas[f] != mb->demandas[f]) return 0;
+    }
+    for(size_t i = 0; i < a->cantidad; i++) {
+        size_t ka, kb;
+        const ElementoConsumo *ca = consumoProducto(a, i, &ka), *cb = consumoProducto(b, i, &kb);
+        if(strcmp(nombreProducto(a, i), nombreProducto(b, i)) != 0 || a->cantidades[i] != b->cantidades[i] ||
+           a->ganancias[i] != b->ganancias[i] || ka != kb) return 0;
+        for(size_t e = 0; e < ka; e++) {
+            if(ca[e].fila != cb[e].fila || ca[e].valor != cb[e].valor) return 0;
+        }
+    }
+    return 1;
+}
+
+static long tamArchivo(const char *ruta) {
+    FILE *f = fopen(ruta, "rb");
+    if(f == NULL) return -1;
+    fseek(f, 0, SEEK_END);
+    long tam = ftell(f);
+    fclose(f);
+    return tam;
+}
+
+// Exporta e importa un catálogo sintético en CSV y en instantánea, y
+// verifica que los dos vuelvan iguales
+static int medirArchivos(size_t productos) {
+    char nombresRecursos[4][MAX_NOMBRE] = { "Torno", "Fresadora", "Cobre", "Personal" };
+    char nombresPeriodos[7][MAX_NOMBRE] = { "Lunes", "Martes", "Miércoles", "Jueves", "Viernes", "Sábado", "Domingo" };
+    const char *dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    char csv[512], instantanea[512];
+    snprintf(csv, sizeof(csv), "%s/planificador-%d.csv", dir, (int)getpid());
+    snprintf(instantanea, sizeof(instantanea), "%s/planificador-%d.plan", dir, (int)getpid());
+    
+    Catalogo original, desdeCSV, desdeInstantanea;
+    iniciarCatalogo(&original);
+    iniciarCatalogo(&desdeCSV);
+    iniciarCatalogo(&desdeInstantanea);
+    int ok = definirModelo(&original.modelo, 4, nombresRecursos, 7, nombresPeriodos);
+    srand(12345);
+    for(int f = 0; ok && f < filasModelo(&original.modelo); f++) fijarLimite(&original.modelo, f, rand() % 1000000);
+    for(size_t i = 0; ok && i < productos; i++) {
+        char nombre[MAX_NOMBRE];
+        ElementoConsumo consumo[4];
+        size_t k = 1 + (size_t)rand() % 4;
+        for(size_t e = 0; e < k; e++) {
+            consumo[e].fila = (uint32_t)(rand() % filasModelo(&original.modelo));
+            consumo[e].valor = 1 + rand() % 50;
+        }
+        // Algunos nombres con comas y comillas para ejercitar el entrecomillado
+        snprintf(nombre, sizeof(nombre), i % 97 == 0 ? "Kit \"%zu\", surtido" : "Pieza R%zu-%04d", i, rand() % 10000);
+        ok = agregarProducto(&original, nombre, rand() % 1000, rand() % 100, k, consumo) >= 0;
+    }
+    if(!ok) {
+        printf("Error: No hay memoria para el catálogo\n");
+        liberarCatalogo(&original);
+        return 1;
+    }
+    printf("%zu productos, %d filas de capacidad\n", productos, filasModelo(&original.modelo));
+    
+    struct timespec inicio;
+    long linea;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = exportarCSV(&original, csv);
+    double exportar = segundosDesde(&inicio);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = ok && importarCSV(&desdeCSV, csv, &linea);
+    double importar = segundosDesde(&inicio);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = ok && guardarInstantanea(&original, instantanea);
+    double guardar = segundosDesde(&inicio);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = ok && cargarInstantanea(&desdeInstantanea, instantanea);
+    double cargar = segundosDesde(&inicio);
+    
+    if(ok) {
+        printf("CSV (%.1f MB):         exportar %.3f s, importar %.3f s\n", tamArchivo(csv) / 1e6, exportar, importar);
+        printf("Instantánea (%.1f MB): guardar %.3f s, cargar %.3f s\n", tamArchivo(instantanea) / 1e6, guardar, cargar);
+        printf("CSV igual al original: %s\n", catalogosIguales(&original, &desdeCSV) ? "sí" : "no");
+        printf("Instantánea igual al original: %s\n", catalogosIguales(&original, &desdeInstantanea) ? "sí" : "no");
+        ok = catalogosIguales(&original, &desdeCSV) && catalogosIguales(&original, &desdeInstantanea);
     } else {
-        printf("\nTotal productos registrados: %d\n", productosMostrados);
+        printf("Error: Falló la exportación o la importación\n");
     }
+    remove(csv);
+    remove(instantanea);
+    liberarCatalogo(&original);
+    liberarCatalogo(&desdeCSV);
+    liberarCatalogo(&desdeInstantanea);
+    return !ok;
 }
 
-int main() {
-    char nombres[MAX_PRODUCTOS][MAX_NOMBRE];
-    int cantidades[MAX_PRODUCTOS] = {0};
-    int tiempos[MAX_PRODUCTOS] = {0};
-    int recursos[MAX_PRODUCTOS] = {0};
-    int tiempo_disponible = 0;
-    int recursos_disponibles = 0;
+// Evalúa escenarios sobre un catálogo sintético que no entra en la capacidad,
+// en un hilo y en paralelo, y verifica que den lo mismo sin tocar la base
+static int medirEscenarios(size_t productos) {
+    char nombresRecursos[2][MAX_NOMBRE] = { "Torno", "Cobre" };
+    char nombresPeriodos[2][MAX_NOMBRE] = { "Mañana", "Tarde" };
+    enum { ESCENARIOS = 16 };
+    Catalogo cat;
+    iniciarCatalogo(&cat);
+    int ok = definirModelo(&cat.modelo, 2, nombresRecursos, 2, nombresPeriodos);
+    srand(12345);
+    for(size_t i = 0; ok && i < productos; i++) {
+        char nombre[MAX_NOMBRE];
+        ElementoConsumo consumo[2];
+        int turno = rand() % 2;
+        for(int e = 0; e < 2; e++) {
+            consumo[e].fila = (uint32_t)(e * 2 + turno);
+            consumo[e].valor = 1 + rand() % 20;
+        }
+        snprintf(nombre, sizeof(nombre), "Pieza %zu", i);
+        ok = agregarProducto(&cat, nombre, 1 + rand() % 100, rand() % 50, 2, consumo) >= 0;
+    }
+    // Límites al 70% de la demanda: el plan óptimo tiene trabajo
+    for(int f = 0; ok && f < filasModelo(&cat.modelo); f++) {
+        fijarLimite(&cat.modelo, f, demandaFila(&cat.modelo, f, NULL) * 7 / 10);
+    }
+    
+    Escenario escenarios[ESCENARIOS];
+    Escenario *punteros[ESCENARIOS];
+    ResultadoEscenario secuencial[ESCENARIOS], paralelo[ESCENARIOS];
+    __int128 *antes = malloc((size_t)filasModelo(&cat.modelo) * sizeof(__int128));
+    int creados = 0;
+    struct timespec inicio;
+    ok = ok && antes != NULL;
+    if(ok) memcpy(antes, cat.modelo.demandas, (size_t)filasModelo(&cat.modelo) * sizeof(__int128));
+    
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int j = 0; ok && j < ESCENARIOS; j++) {
+        char nombre[MAX_NOMBRE];
+        snprintf(nombre, sizeof(nombre), "Escenario %d", j);
+        ok = crearEscenario(&escenarios[j], &cat, nombre);
+        if(!ok) break;
+        punteros[j] = &escenarios[j];
+        creados++;
+        // Un cambio global cada cuatro escenarios; los demás, ediciones sueltas
+        EdicionEscenario ediciones[8];
+        size_t n = 0;
+        if(j % 4 == 1) ediciones[n++] = (EdicionEscenario){ EDITAR_CANTIDAD, -1, CAMBIO_PORCENTAJE, 10.0 * (j % 3) - 10 };
+        if(j % 4 == 2) ediciones[n++] = (EdicionEscenario){ EDITAR_LIMITE, rand() % 4, CAMBIO_PORCENTAJE, 20 };
+        while(n < 8) {
+            ediciones[n++] = (EdicionEscenario){ rand() % 2 ? EDITAR_CANTIDAD : EDITAR_GANANCIA,
+                                                 (long)((size_t)rand() % productos), CAMBIO_SUMAR, rand() % 41 - 20 };
+        }
+        ok = aplicarEdiciones(&escenarios[j], ediciones, n);
+    }
+    double crear = segundosDesde(&inicio);
+    if(!ok) {
+        printf("Error: No hay memoria para los escenarios\n");
+    } else {
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        evaluarEscenarios(punteros, ESCENARIOS, secuencial, 1);
+        double uno = segundosDesde(&inicio);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        evaluarEscenarios(punteros, ESCENARIOS, paralelo, 0);
+        double varios = segundosDesde(&inicio);
+        
+        int distintos = 0;
+        for(int j = 0; j < ESCENARIOS; j++) {
+            if(secuencial[j].producidas != paralelo[j].producidas || secuencial[j].ganancia != paralelo[j].ganancia ||
+               secuencial[j].estado != paralelo[j].estado) distintos++;
+        }
+        int baseIntacta = memcmp(antes, cat.modelo.demandas, (size_t)filasModelo(&cat.modelo) * sizeof(__int128)) == 0;
+        printf("%zu productos, %d escenarios\n", productos, ESCENARIOS);
+        printf("Crear y editar: %.3f ms en total\n", crear * 1e3);
+        printf("Evaluar en 1 hilo: %.3f s\n", uno);
+        printf("Evaluar en paralelo (%ld núcleos): %.3f s (x%.2f)\n", sysconf(_SC_NPROCESSORS_ONLN), varios, uno / varios);
+        printf("Resultados distintos: %d, base intacta: %s\n", distintos, baseIntacta ? "sí" : "no");
+        ok = distintos == 0 && baseIntacta;
+    }
+    for(int j = 0; j < creados; j++) liberarEscenario(&escenarios[j]);
+    free(antes);
+    liberarCatalogo(&cat);
+    return !ok;
+}
+
+typedef struct {
+    Catalogo *cat;
+    Diario *diario;
+    pthread_mutex_t *candado;
+    int cambios;
+    unsigned semilla;
+    int ok;
+} HiloDiario;
+
+// Como el servidor: cambia y anota con el catálogo tomado, y espera el disco
+// sin él, así los hilos comparten las escrituras
+static void *cambiarConDiario(void *arg) {
+    HiloDiario *h = arg;
+    h->ok = 1;
+    for(int i = 0; h->ok && i < h->cambios; i++) {
+        pthread_mutex_lock(h->candado);
+        RegistroDiario r = { REGISTRO_CANTIDAD, (size_t)rand_r(&h->semilla) % h->cat->cantidad, NULL,
+                             rand_r(&h->semilla) % 1000, 0, 0, NULL };
+        uint64_t posicion = aplicarRegistro(h->cat, &r) ? anotarRegistro(h->diario, &r) : 0;
+        pthread_mutex_unlock(h->candado);
+        h->ok = confirmarDiario(h->diario, posicion);
+    }
+    return NULL;
+}
+
+// Cambios con diario en un hilo (un fdatasync por cambio) y en varios
+// (escritura en grupo), y reinicio desde la instantánea y el diario
+static int medirDiario(size_t productos) {
+    char nombresRecursos[2][MAX_NOMBRE] = { "Torno", "Cobre" };
+    char nombresPeriodos[2][MAX_NOMBRE] = { "Mañana", "Tarde" };
+    enum { CAMBIOS = 2000, HILOS = 16 };
+    const char *dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    char ruta[512], rutaDiario[520];
+    snprintf(ruta, sizeof(ruta), "%s/planificador-%d.plan", dir, (int)getpid());
+    snprintf(rutaDiario, sizeof(rutaDiario), "%s.diario", ruta);
+    
+    Catalogo cat, reinicio;
+    Diario diario, otro;
+    long aplicados = 0, antes;
+    struct timespec inicio;
+    iniciarCatalogo(&cat);
+    iniciarCatalogo(&reinicio);
+    int ok = definirModelo(&cat.modelo, 2, nombresRecursos, 2, nombresPeriodos);
+    srand(12345);
+    for(size_t i = 0; ok && i < productos; i++) {
+        char nombre[MAX_NOMBRE];
+        ElementoConsumo consumo[2] = { { (uint32_t)(rand() % 2), 1 + rand() % 20 }, { (uint32_t)(2 + rand() % 2), 1 + rand() % 20 } };
+        snprintf(nombre, sizeof(nombre), "Pieza %zu", i);
+        ok = agregarProducto(&cat, nombre, rand() % 100, rand() % 50, 2, consumo) >= 0;
+    }
+    ok = ok && productos > 0 && abrirDiario(&diario, &reinicio, ruta, &aplicados) && compactarDiario(&diario, &cat);
+    if(!ok) {
+        printf("Error: No se pudo crear el catálogo o el diario en %s\n", dir);
+        cerrarDiario(&diario);
+        liberarCatalogo(&cat);
+        liberarCatalogo(&reinicio);
+        return 1;
+    }
+    printf("%zu productos, instantánea de %.1f MB\n", productos, diario.bytesInstantanea / 1e6);
+    
+    // Un hilo: cada cambio espera su propio fdatasync
+    antes = diario.sincronizaciones;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int i = 0; ok && i < CAMBIOS; i++) {
+        RegistroDiario r = { i % 10 == 0 ? REGISTRO_GANANCIA : REGISTRO_CANTIDAD, (size_t)rand() % cat.cantidad,
+                             NULL, rand() % 1000, 0, 0, NULL };
+        ok = cambiarCatalogo(&cat, &diario, &r) > 0;
+    }
+    double uno = segundosDesde(&inicio);
+    printf("1 hilo:   %d cambios en %.3f s (%.0f por segundo, %ld fdatasync)\n", CAMBIOS, uno, CAMBIOS / uno,
+           diario.sincronizaciones - antes);
+    
+    // Varios hilos: los que llegan mientras otro escribe salen en la próxima escritura
+    pthread_mutex_t candado = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t ids[HILOS];
+    HiloDiario hilos[HILOS];
+    int lanzados = 0;
+    antes = diario.sincronizaciones;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int h = 0; ok && h < HILOS; h++) {
+        hilos[h] = (HiloDiario){ &cat, &diario, &candado, CAMBIOS / HILOS, (unsigned)h + 1, 0 };
+        if(pthread_create(&ids[h], NULL, cambiarConDiario, &hilos[h]) == 0) lanzados++;
+    }
+    for(int h = 0; h < lanzados; h++) {
+        pthread_join(ids[h], NULL);
+        ok = ok && hilos[h].ok;
+    }
+    double varios = segundosDesde(&inicio);
+    printf("%d hilos: %d cambios en %.3f s (%.0f por segundo, %ld fdatasync)\n", HILOS, lanzados * (CAMBIOS / HILOS),
+           varios, lanzados * (CAMBIOS / HILOS) / varios, diario.sincronizaciones - antes);
+    
+    // Reinicio: instantánea más el diario, sin cerrar el actual (como tras una caída)
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = ok && abrirDiario(&otro, &reinicio, ruta, &aplicados);
+    double reiniciar = segundosDesde(&inicio);
+    if(ok) {
+        printf("Reinicio: %.3f s (instantánea y %ld cambios del diario)\n", reiniciar, aplicados);
+        printf("Catálogo igual al original: %s\n", catalogosIguales(&cat, &reinicio) ? "sí" : "no");
+        ok = catalogosIguales(&cat, &reinicio);
+    } else {
+        printf("Error: Falló el diario\n");
+    }
+    cerrarDiario(&otro);
+    
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ok = compactarDiario(&diario, &cat) && ok;
+    printf("Compactar: %.3f s\n", segundosDesde(&inicio));
+    cerrarDiario(&diario);
+    remove(ruta);
+    remove(rutaDiario);
+    liberarCatalogo(&cat);
+    liberarCatalogo(&reinicio);
+    return !ok;
+}
+
+// Catálogo sintético con 'recursos' recursos en dos turnos; cada producto usa
+// todos los recursos en un turno y los límites quedan en 'porciento' de la
+// demanda
+static int catalogoPrioridad(Catalogo *cat, size_t productos, int recursos, int maxCantidad, int porciento) {
+    char nombresRecursos[2][MAX_NOMBRE] = { "Torno", "Cobre" };
+    char nombresPeriodos[2][MAX_NOMBRE] = { "Mañana", "Tarde" };
+    iniciarCatalogo(cat);
+    int ok = definirModelo(&cat->modelo, recursos, nombresRecursos, recursos == 1 ? 1 : 2, nombresPeriodos);
+    int periodos = cat->modelo.periodos;
+    for(size_t i = 0; ok && i < productos; i++) {
+        char nombre[MAX_NOMBRE];
+        ElementoConsumo consumo[2];
+        int turno = rand() % periodos;
+        for(int e = 0; e < recursos; e++) {
+            consumo[e].fila = (uint32_t)(e * periodos + turno);
+            consumo[e].valor = 1 + rand() % 20;
+        }
+        snprintf(nombre, sizeof(nombre), "Pieza %zu", i);
+        ok = agregarProducto(cat, nombre, 1 + rand() % maxCantidad, 1 + rand() % 50, (size_t)recursos, consumo) >= 0;
+    }
+    for(int f = 0; ok && f < filasModelo(&cat->modelo); f++) {
+        fijarLimite(&cat->modelo, f, demandaFila(&cat->modelo, f, NULL) * porciento / 100);
+    }
+    return ok;
+}
+
+// Un plan es válido si no pasa la demanda de nadie ni el límite de ninguna fila
+static int planValido(const Catalogo *cat, const double *plan) {
+    int filas = filasModelo(&cat->modelo);
+    long long *usados = calloc((size_t)filas + 1, sizeof(long long));
+    int ok = usados != NULL;
+    for(size_t i = 0; ok && i < cat->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(cat, i, &k);
+        if(plan[i] < 0 || plan[i] > cat->cantidades[i]) ok = 0;
+        for(size_t e = 0; e < k; e++) usados[consumo[e].fila] += (long long)plan[i] * consumo[e].valor;
+    }
+    for(int f = 0; ok && f < filas; f++) {
+        if(usados[f] > cat->modelo.limites[f]) ok = 0;
+    }
+    free(usados);
+    return ok;
+}
+
+// Mide el plan voraz sobre un catálogo grande con varios recursos excedidos,
+// y lo compara con la mochila exacta (y con branch and bound en el más chico)
+// en catálogos de un solo recurso
+static int medirPrioridad(size_t productos) {
+    Catalogo cat;
+    Escenario actual;
+    ResultadoPrioridad voraz, exacto;
+    struct timespec inicio;
+    double *plan = malloc((productos + 1) * sizeof(double));
+    srand(12345);
+    int ok = plan != NULL && catalogoPrioridad(&cat, productos, 2, 100, 70);
+    ok = ok && crearEscenario(&actual, &cat, "Actual");
+    if(ok) {
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        ok = planVoraz(&actual, plan, &voraz);
+        double t = segundosDesde(&inicio);
+        ok = ok && planValido(&cat, plan);
+        printf("%zu productos, %zu filas excedidas\n", productos, cat.modelo.excedidas);
+        printf("Voraz: %.3f s, ganancia %lld, %zu completos, plan válido: %s\n",
+               t, voraz.valor, voraz.completos, ok ? "sí" : "no");
+        liberarEscenario(&actual);
+    }
+    if(plan != NULL) liberarCatalogo(&cat);
+    
+    printf("\nUn recurso: voraz contra mochila exacta\n");
+    printf("%10s %12s %12s %10s %10s %8s\n", "productos", "voraz", "exacto", "t voraz", "t exacto", "brecha");
+    for(size_t n = 250; ok && n <= 2000 && n <= productos; n *= 2) {
+        ok = catalogoPrioridad(&cat, n, 1, 10, 40);
+        if(!ok || !crearEscenario(&actual, &cat, "Actual")) {
+            liberarCatalogo(&cat);
+            ok = 0;
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        ok = planVoraz(&actual, plan, &voraz) && planValido(&cat, plan);
+        double tVoraz = segundosDesde(&inicio);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        ok = ok && planMochila(&actual, plan, &exacto, (size_t)1 << 31) == 1 && planValido(&cat, plan);
+        double tExacto = segundosDesde(&inicio);
+        ok = ok && exacto.valor >= voraz.valor;
+        if(ok) {
+            printf("%10zu %12lld %12lld %9.3fs %9.3fs %7.3f%%\n", n, voraz.valor, exacto.valor, tVoraz, tExacto,
+                   100.0 * (double)(exacto.valor - voraz.valor) / (double)exacto.valor);
+        }
+        // La mochila tiene que coincidir con el branch and bound cuando éste
+        // termina
+        int porGanancia;
+        if(ok && n == 250) {
+            ResultadoEntero res = optimizarEscenario(&actual, plan, &porGanancia);
+            if(res.estado == PLAN_OPTIMO) {
+                printf("%10s branch and bound: %.0f\n", "", res.valor);
+                ok = (long long)(res.valor + 0.5) == exacto.valor;
+            }
+        }
+        liberarEscenario(&actual);
+        liberarCatalogo(&cat);
+    }
+    if(!ok) printf("Error: Falló el plan por prioridad\n");
+    free(plan);
+    return !ok;
+}
+
+static void mostrarUso(const char *programa) {
+    printf("Uso: %s [--cargar instantánea | --diario instantánea] [--importar archivo.csv]\n", programa);
+    printf("       [--calcular] [--escenarios archivo] [--servidor socket|-] [--guardar instantánea]\n");
+    printf("       [--exportar archivo.csv]\n");
+    printf("     %s --bench-busqueda [productos] | --bench-demanda [productos] | --bench-archivos [productos]\n", programa);
+    printf("       | --bench-escenarios [productos] | --bench-diario [productos] | --bench-prioridad [productos]\n");
+    printf("     %s --carga socket [clientes] [peticiones por cliente] [%% ediciones]\n", programa);
+}
+
+// Carga la instantánea y después agrega los productos del CSV, si se pidieron
+static int cargarArchivos(Catalogo *cat, const char *instantanea, const char *csv) {
+    if(instantanea && !cargarInstantanea(cat, instantanea)) {
+        printf("Error: No se pudo cargar la instantánea %s\n", instantanea);
+        return 0;
+    }
+    if(csv) {
+        size_t antes = cat->cantidad;
+        long linea;
+        if(!importarCSV(cat, csv, &linea)) {
+            if(linea > 0) printf("Error: %s, línea %ld: formato inválido\n", csv, linea);
+            else printf("Error: No se pudo leer %s\n", csv);
+            return 0;
+        }
+        printf("Importados %zu productos de %s\n", cat->cantidad - antes, csv);
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *cargar = NULL, *importar = NULL, *guardar = NULL, *exportar = NULL, *escenarios = NULL;
+    const char *servidor = NULL, *rutaDiario = NULL;
+    int calcular = 0;
+    
+    if(argc > 1) {
+        size_t productos = argc > 2 ? (size_t)atol(argv[2]) : 0;
+        if(strcmp(argv[1], "--bench-busqueda") == 0) return medirBusqueda(productos ? productos : 100000);
+        if(strcmp(argv[1], "--bench-demanda") == 0) return medirDemanda(productos ? productos : 1000000);
+        if(strcmp(argv[1], "--bench-archivos") == 0) return medirArchivos(productos ? productos : 1000000);
+        if(strcmp(argv[1], "--bench-escenarios") == 0) return medirEscenarios(productos ? productos : 1000);
+        if(strcmp(argv[1], "--bench-diario") == 0) return medirDiario(productos ? productos : 100000);
+        if(strcmp(argv[1], "--bench-prioridad") == 0) return medirPrioridad(productos ? productos : 100000);
+        if(strcmp(argv[1], "--carga") == 0 && argc > 2) {
+            int clientes = argc > 3 ? atoi(argv[3]) : 0;
+            long peticiones = argc > 4 ? atol(argv[4]) : 0;
+            int ediciones = argc > 5 ? atoi(argv[5]) : 10;
+            if(ediciones < 0 || ediciones > 100) ediciones = 10;
+            return generarCarga(argv[2], clientes > 0 ? clientes : 16, peticiones > 0 ? peticiones : 10000, ediciones);
+        }
+    }
+    for(int a = 1; a < argc; a++) {
+        int conArchivo = a + 1 < argc;
+        if(strcmp(argv[a], "--cargar") == 0 && conArchivo) cargar = argv[++a];
+        else if(strcmp(argv[a], "--importar") == 0 && conArchivo) importar = argv[++a];
+        else if(strcmp(argv[a], "--guardar") == 0 && conArchivo) guardar = argv[++a];
+        else if(strcmp(argv[a], "--exportar") == 0 && conArchivo) exportar = argv[++a];
+        else if(strcmp(argv[a], "--escenarios") == 0 && conArchivo) escenarios = argv[++a];
+        else if(strcmp(argv[a], "--servidor") == 0 && conArchivo) servidor = argv[++a];
+        else if(strcmp(argv[a], "--diario") == 0 && conArchivo) rutaDiario = argv[++a];
+        else if(strcmp(argv[a], "--calcular") == 0) calcular = 1;
+        else {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+    }
+    if(rutaDiario && cargar) {
+        printf("Error: --diario ya carga su instantánea; no use --cargar\n");
+        return 1;
+    }
+    
+    Catalogo catalogo;
+    Diario diario;
+    Diario *conDiario = rutaDiario ? &diario : NULL;
     int opcion;
     
+    iniciarCatalogo(&catalogo);
+    if(conDiario) {
+        long aplicados;
+        if(!abrirDiario(&diario, &catalogo, rutaDiario, &aplicados)) {
+            printf("Error: No se pudo abrir el diario de %s\n", rutaDiario);
+            cerrarDiario(&diario);
+            liberarCatalogo(&catalogo);
+            return 1;
+        }
+        if(diario.fd >= 0) printf("Diario: %s con %ld cambios posteriores\n", rutaDiario, aplicados);
+    }
+    if(!cargarArchivos(&catalogo, cargar, importar)) {
+        if(conDiario) cerrarDiario(&diario);
+        liberarCatalogo(&catalogo);
+        return 1;
+    }
+    // Lo importado no pasa por el diario: queda en una instantánea nueva. Sin
+    // instantánea previa se crea apenas haya un modelo.
+    if(conDiario && filasModelo(&catalogo.modelo) > 0 && (importar || diario.fd < 0) &&
+       !compactarDiario(&diario, &catalogo)) {
+        printf("Error: No se pudo guardar %s\n", rutaDiario);
+        cerrarDiario(&diario);
+        liberarCatalogo(&catalogo);
+        return 1;
+    }
+    
+    // Sin menú, para correr el planificador desde scripts
+    if(calcular || escenarios || servidor || guardar || exportar) {
+        int ok = filasModelo(&catalogo.modelo) > 0;
+        if(!ok) printf("Error: Falta el modelo de capacidad (use --cargar, --importar o --diario)\n");
+        if(ok && calcular) calcularProduccion(&catalogo);
+        if(ok && escenarios) {
+            FILE *f = fopen(escenarios, "r");
+            if(f == NULL) {
+                printf("Error: No se pudo leer %s\n", escenarios);
+                ok = 0;
+            } else {
+                compararEscenarios(&catalogo, f, 0);
+                fclose(f);
+            }
+        }
+        // El servidor atiende hasta fin de la entrada (o SIGINT/SIGTERM con
+        // socket); lo que se guarde o exporte después incluye sus cambios
+        if(ok && servidor) {
+            ok = strcmp(servidor, "-") == 0 ? servirEntrada(&catalogo, conDiario, stdin, stdout)
+                                            : servirSocket(&catalogo, conDiario, servidor, 0);
+            if(!ok) printf("Error: No se pudo atender en %s\n", servidor);
+        }
+        if(ok && guardar && !guardarInstantanea(&catalogo, guardar)) {
+            printf("Error: No se pudo guardar %s\n", guardar);
+            ok = 0;
+        }
+        if(ok && exportar && !exportarCSV(&catalogo, exportar)) {
+            printf("Error: No se pudo exportar %s\n", exportar);
+            ok = 0;
+        }
+        if(conDiario) cerrarDiario(&diario);
+        liberarCatalogo(&catalogo);
+        return ok ? 0 : 1;
+    }
+    
     printf("=== SISTEMA DE OPTIMIZACIÓN DE PRODUCCIÓN ===\n");
     printf("=== FÁBRICA DE COMPONENTES ELECTRÓNICOS ===\n\n");
     
-    // Inicializar nombres como cadenas vacías
-    for(int i = 0; i < MAX_PRODUCTOS; i++) {
-        strcpy(nombres[i], "");
+    // Ingresar recursos, períodos y límites de la fábrica (si no vinieron
+    // de un archivo)
+    if(filasModelo(&catalogo.modelo) == 0 && !ingresarModelo(&catalogo)) {
+        printf("Error: No hay memoria para el modelo de capacidad\n");
+        return 1;
+    }
+    if(conDiario && diario.fd < 0 && !compactarDiario(&diario, &catalogo)) {
+        printf("Error: No se pudo guardar %s; los cambios no se anotarán\n", rutaDiario);
+        cerrarDiario(&diario);
+        conDiario = NULL;
     }
-    
-    // Ingresar límites de la fábrica
-    ingresarLimites(&tiempo_disponible, &recursos_disponibles);
     
     do {
         mostrarMenu();
@@ -285,33 +1469,40 @@ int main() {
         
         switch(opcion) {
             case 1:
-                ingresarProductos(nombres, cantidades, tiempos, recursos);
+                ingresarProductos(&catalogo, conDiario);
                 break;
             case 2:
-                calcularProduccion(nombres, cantidades, tiempos, recursos, 
-                                 tiempo_disponible, recursos_disponibles);
+                calcularProduccion(&catalogo);
                 break;
             case 3:
-                editarProducto(nombres, cantidades, tiempos, recursos);
+                editarProducto(&catalogo, conDiario);
                 break;
             case 4:
-                eliminarProducto(nombres, cantidades, tiempos, recursos);
+                eliminarProducto(&catalogo, conDiario);
                 break;
             case 5:
-                mostrarProductos(nombres, cantidades, tiempos, recursos);
+                mostrarProductos(&catalogo);
                 break;
             case 6:
+                guardarCatalogo(&catalogo);
+                break;
+            case 7:
+                compararEscenarios(&catalogo, stdin, 1);
+                break;
+            case 8:
                 printf("\nSaliendo del sistema...\n");
                 break;
             default:
                 printf("\nOpción no válida. Intente nuevamente.\n");
         }
         
-        if(opcion != 6) {
+        if(opcion != 8) {
             printf("\nPresione Enter para continuar...");
             limpiarBuffer();
         }
-    } while(opcion != 6);
+    } while(opcion != 8);
     
+    if(conDiario) cerrarDiario(&diario);
+    liberarCatalogo(&catalogo);
     return 0;
 }
\ No newline at end of file
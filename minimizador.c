@@ -0,0 +1,1072 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "booleanas.h"
+
+#define MAX_ITERACIONES_HEURISTICO 4
+#define SIN_INDICE ((size_t)-1)
+
+// ===================== Cubos y coberturas =====================
+
+void iniciarCobertura(Cobertura *c, int n) {
+    c->n = n;
+    c->cantidad = 0;
+    c->capacidad = 0;
+    c->cubos = NULL;
+}
+
+int agregarCubo(Cobertura *c, Cubo cubo) {
+    if (c->cantidad == c->capacidad) {
+        size_t nueva = c->capacidad ? c->capacidad * 2 : 16;
+        Cubo *cubos = realloc(c->cubos, nueva * sizeof(Cubo));
+        if (cubos == NULL) return 0;
+        c->cubos = cubos;
+        c->capacidad = nueva;
+    }
+    c->cubos[c->cantidad++] = cubo;
+    return 1;
+}
+
+void liberarCobertura(Cobertura *c) {
+    free(c->cubos);
+    c->cubos = NULL;
+    c->cantidad = 0;
+    c->capacidad = 0;
+}
+
+int literalesCubo(Cubo cubo) {
+    return __builtin_popcount(cubo.cuidado);
+}
+
+size_t contarLiterales(const Cobertura *c) {
+    size_t total = 0;
+    for (size_t i = 0; i < c->cantidad; i++) {
+        total += (size_t)literalesCubo(c->cubos[i]);
+    }
+    return total;
+}
+
+// Filas de una palabra que cumplen los literales de los 6 bits bajos del cubo
+static uint64_t mascaraCuboBaja(int n, Cubo cubo) {
+    uint64_t m = (n >= 6) ? ~0ULL : ((1ULL << (1u << n)) - 1);
+    int bajos = (n < 6) ? n : 6;
+    for (int p = 0; p < bajos; p++) {
+        if ((cubo.cuidado >> p) & 1) {
+            uint64_t patron = mascaraVariable(n, n - 1 - p, 0);
+            m &= ((cubo.valor >> p) & 1) ? patron : ~patron;
+        }
+    }
+    return m;
+}
+
+// Recorre las palabras de la tabla que contienen filas del cubo
+// (los bits altos libres se enumeran como subconjuntos)
+typedef struct {
+    size_t base;
+    size_t libre;
+    size_t sub;
+    int fin;
+} IterPalabras;
+
+static void iniciarIterPalabras(IterPalabras *it, int n, Cubo cubo) {
+    size_t palabras = (n >= 6) ? ((size_t)1 << (n - 6)) : 1;
+    it->base = (size_t)(cubo.valor >> 6);
+    it->libre = ~(size_t)(cubo.cuidado >> 6) & (palabras - 1);
+    it->sub = 0;
+    it->fin = 0;
+}
+
+static int siguientePalabra(IterPalabras *it, size_t *w) {
+    if (it->fin) return 0;
+    *w = it->base | it->sub;
+    it->sub = (it->sub - it->libre) & it->libre;
+    if (it->sub == 0) it->fin = 1;
+    return 1;
+}
+
+int cuboContenido(int n, Cubo cubo, const uint64_t *conjunto) {
+    uint64_t m = mascaraCuboBaja(n, cubo);
+    IterPalabras it;
+    size_t w;
+    iniciarIterPalabras(&it, n, cubo);
+    while (siguientePalabra(&it, &w)) {
+        if (m & ~conjunto[w]) return 0;
+    }
+    return 1;
+}
+
+int cuboInterseca(int n, Cubo cubo, const uint64_t *conjunto) {
+    uint64_t m = mascaraCuboBaja(n, cubo);
+    IterPalabras it;
+    size_t w;
+    iniciarIterPalabras(&it, n, cubo);
+    while (siguientePalabra(&it, &w)) {
+        if (m & conjunto[w]) return 1;
+    }
+    return 0;
+}
+
+void marcarCubo(int n, Cubo cubo, uint64_t *conjunto) {
+    uint64_t m = mascaraCuboBaja(n, cubo);
+    IterPalabras it;
+    size_t w;
+    iniciarIterPalabras(&it, n, cubo);
+    while (siguientePalabra(&it, &w)) {
+        conjunto[w] |= m;
+    }
+}
+
+// Ajusta el contador de cada fila del cubo que pertenece al conjunto.
+// Los contadores se saturan en 255; al restar desde la saturación se
+// subestima, lo que solo vuelve más conservadora la eliminación de cubos.
+static void sumarCubo(int n, Cubo cubo, const uint64_t *conjunto, uint8_t *cuenta, int delta) {
+    uint64_t m = mascaraCuboBaja(n, cubo);
+    IterPalabras it;
+    size_t w;
+    iniciarIterPalabras(&it, n, cubo);
+    while (siguientePalabra(&it, &w)) {
+        uint64_t x = m & conjunto[w];
+        while (x) {
+            size_t fila = (w << 6) + (size_t)__builtin_ctzll(x);
+            x &= x - 1;
+            if (delta > 0 && cuenta[fila] < 255) cuenta[fila]++;
+            else if (delta < 0 && cuenta[fila] > 0) cuenta[fila]--;
+        }
+    }
+}
+
+// Verdadero si todas las filas del cubo dentro del conjunto tienen cuenta >= 2
+static int cuboRedundante(int n, Cubo cubo, const uint64_t *conjunto, const uint8_t *cuenta) {
+    uint64_t m = mascaraCuboBaja(n, cubo);
+    IterPalabras it;
+    size_t w;
+    iniciarIterPalabras(&it, n, cubo);
+    while (siguientePalabra(&it, &w)) {
+        uint64_t x = m & conjunto[w];
+        while (x) {
+            size_t fila = (w << 6) + (size_t)__builtin_ctzll(x);
+            x &= x - 1;
+            if (cuenta[fila] < 2) return 0;
+        }
+    }
+    return 1;
+}
+
+// ===================== Etapa común: irredundante =====================
+
+static int compararMasLiterales(const void *a, const void *b) {
+    int la = literalesCubo(*(const Cubo *)a);
+    int lb = literalesCubo(*(const Cubo *)b);
+    return lb - la;
+}
+
+// Quita cubos cuyas filas ON ya están cubiertas por los demás,
+// empezando por los más pequeños (más literales)
+static int irredundante(Cobertura *cob, const uint64_t *on, uint8_t *cuenta, size_t filas) {
+    int n = cob->n;
+    memset(cuenta, 0, filas);
+    if (cob->cantidad > 1) qsort(cob->cubos, cob->cantidad, sizeof(Cubo), compararMasLiterales);
+    for (size_t i = 0; i < cob->cantidad; i++) {
+        sumarCubo(n, cob->cubos[i], on, cuenta, +1);
+    }
+
+    size_t quedan = 0;
+    for (size_t i = 0; i < cob->cantidad; i++) {
+        Cubo c = cob->cubos[i];
+        if (cuboRedundante(n, c, on, cuenta)) {
+            sumarCubo(n, c, on, cuenta, -1);
+        } else {
+            cob->cubos[quedan++] = c;
+        }
+    }
+    cob->cantidad = quedan;
+    return 1;
+}
+
+// ===================== Quine-McCluskey exacto =====================
+
+// Conjunto de cubos con búsqueda por hash (direccionamiento abierto)
+typedef struct {
+    Cubo *cubos;
+    size_t cantidad;
+    size_t capacidad;
+    size_t *tabla;      // índice + 1 (0 = vacío)
+    size_t mascara;
+} ConjuntoCubos;
+
+static uint64_t claveCubo(Cubo c) {
+    uint64_t k = ((uint64_t)c.cuidado << 32) | c.valor;
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static int iniciarConjunto(ConjuntoCubos *s, size_t esperado) {
+    size_t tam = 64;
+    while (tam < esperado * 2) tam <<= 1;
+    s->cubos = malloc(esperado ? esperado * sizeof(Cubo) : sizeof(Cubo));
+    s->tabla = calloc(tam, sizeof(size_t));
+    s->cantidad = 0;
+    s->capacidad = esperado ? esperado : 1;
+    s->mascara = tam - 1;
+    return s->cubos != NULL && s->tabla != NULL;
+}
+
+static void liberarConjunto(ConjuntoCubos *s) {
+    free(s->cubos);
+    free(s->tabla);
+}
+
+static size_t buscarEnConjunto(const ConjuntoCubos *s, Cubo c) {
+    size_t h = (size_t)claveCubo(c) & s->mascara;
+    while (s->tabla[h]) {
+        Cubo x = s->cubos[s->tabla[h] - 1];
+        if (x.valor == c.valor && x.cuidado == c.cuidado) return s->tabla[h] - 1;
+        h = (h + 1) & s->mascara;
+    }
+    return SIN_INDICE;
+}
+
+static int agregarAConjunto(ConjuntoCubos *s, Cubo c) {
+    if (buscarEnConjunto(s, c) != SIN_INDICE) return 1;
+    if (s->cantidad == s->capacidad) {
+        Cubo *cubos = realloc(s->cubos, s->capacidad * 2 * sizeof(Cubo));
+        if (cubos == NULL) return 0;
+        s->cubos = cubos;
+        s->capacidad *= 2;
+    }
+    if ((s->cantidad + 1) * 2 > s->mascara + 1) {
+        size_t tam = (s->mascara + 1) * 2;
+        size_t *tabla = calloc(tam, sizeof(size_t));
+        if (tabla == NULL) return 0;
+        free(s->tabla);
+        s->tabla = tabla;
+        s->mascara = tam - 1;
+        for (size_t i = 0; i < s->cantidad; i++) {
+            size_t h = (size_t)claveCubo(s->cubos[i]) & s->mascara;
+            while (s->tabla[h]) h = (h + 1) & s->mascara;
+            s->tabla[h] = i + 1;
+        }
+    }
+    size_t h = (size_t)claveCubo(c) & s->mascara;
+    while (s->tabla[h]) h = (h + 1) & s->mascara;
+    s->cubos[s->cantidad] = c;
+    s->tabla[h] = ++s->cantidad;
+    return 1;
+}
+
+// Genera todos los implicantes primos combinando cubos que difieren en un
+// solo literal. Cada nivel se agrupa en cubetas por cantidad de unos en
+// 'valor': la pareja de un cubo de la cubeta k solo puede estar en la k+1.
+static int implicantesPrimos(int n, const uint64_t *on, const uint64_t *permitido,
+                             size_t palabras, Cobertura *primos) {
+    uint32_t completo = (n >= 32) ? 0xFFFFFFFFu : ((1u << n) - 1);
+    ConjuntoCubos nivel;
+    size_t inicial = 0;
+    for (size_t w = 0; w < palabras; w++) inicial += (size_t)__builtin_popcountll(permitido[w]);
+    if (!iniciarConjunto(&nivel, inicial)) return 0;
+
+    for (size_t w = 0; w < palabras; w++) {
+        uint64_t x = permitido[w];
+        while (x) {
+            uint32_t fila = (uint32_t)((w << 6) + (size_t)__builtin_ctzll(x));
+            x &= x - 1;
+            Cubo c = { fila, completo };
+            if (!agregarAConjunto(&nivel, c)) { liberarConjunto(&nivel); return 0; }
+        }
+    }
+
+    int ok = 1;
+    while (ok && nivel.cantidad > 0) {
+        size_t *inicio = calloc((size_t)n + 2, sizeof(size_t));
+        size_t *orden = malloc(nivel.cantidad * sizeof(size_t));
+        unsigned char *combinado = calloc(nivel.cantidad, 1);
+        ConjuntoCubos siguiente;
+        if (!inicio || !orden || !combinado || !iniciarConjunto(&siguiente, nivel.cantidad)) {
+            free(inicio); free(orden); free(combinado);
+            liberarConjunto(&nivel);
+            return 0;
+        }
+
+        // Cubetas por cantidad de unos (ordenamiento por conteo)
+        for (size_t i = 0; i < nivel.cantidad; i++) {
+            inicio[__builtin_popcount(nivel.cubos[i].valor) + 1]++;
+        }
+        for (int k = 1; k <= n + 1; k++) inicio[k] += inicio[k - 1];
+        size_t *pos = malloc(((size_t)n + 1) * sizeof(size_t));
+        if (pos == NULL) ok = 0;
+        else {
+            memcpy(pos, inicio, ((size_t)n + 1) * sizeof(size_t));
+            for (size_t i = 0; i < nivel.cantidad; i++) {
+                orden[pos[__builtin_popcount(nivel.cubos[i].valor)]++] = i;
+            }
+            free(pos);
+        }
+
+        for (int k = 0; ok && k < n; k++) {
+            for (size_t o = inicio[k]; ok && o < inicio[k + 1]; o++) {
+                size_t i = orden[o];
+                Cubo c = nivel.cubos[i];
+                uint32_t libres = c.cuidado & ~c.valor;
+                while (libres) {
+                    uint32_t b = libres & (~libres + 1);
+                    libres &= libres - 1;
+                    Cubo pareja = { c.valor | b, c.cuidado };
+                    size_t j = buscarEnConjunto(&nivel, pareja);
+                    if (j == SIN_INDICE) continue;
+                    combinado[i] = combinado[j] = 1;
+                    Cubo unido = { c.valor, c.cuidado & ~b };
+                    if (!agregarAConjunto(&siguiente, unido)) { ok = 0; break; }
+                }
+            }
+        }
+
+        // Los que no se combinaron son primos; solo interesan si cubren algún 1
+        for (size_t i = 0; ok && i < nivel.cantidad; i++) {
+            if (!combinado[i] && cuboInterseca(n, nivel.cubos[i], on)) {
+                if (!agregarCubo(primos, nivel.cubos[i])) ok = 0;
+            }
+        }
+
+        free(inicio);
+        free(orden);
+        free(combinado);
+        liberarConjunto(&nivel);
+        nivel = siguiente;
+    }
+    liberarConjunto(&nivel);
+    return ok;
+}
+
+// Estado de la selección de cobertura (filas cubiertas y ganancias)
+typedef struct {
+    const uint32_t *grado;          // inicio de la lista de primos de cada fila
+    const uint32_t *primosDeFila;
+    size_t *ganancia;               // filas aún sin cubrir de cada primo
+    unsigned char *elegido;
+    unsigned char *cubierta;
+    size_t *pendientes;
+} Seleccion;
+
+// Elige un primo: marca sus filas y descuenta la ganancia de los demás
+static void elegirPrimo(int n, const uint64_t *on, const Cobertura *primos, size_t p, Seleccion *s) {
+    Cubo c = primos->cubos[p];
+    uint64_t m = mascaraCuboBaja(n, c);
+    IterPalabras it;
+    size_t w;
+    s->elegido[p] = 1;
+    iniciarIterPalabras(&it, n, c);
+    while (siguientePalabra(&it, &w)) {
+        uint64_t x = m & on[w];
+        while (x) {
+            size_t f = (w << 6) + (size_t)__builtin_ctzll(x);
+            x &= x - 1;
+            if (s->cubierta[f]) continue;
+            s->cubierta[f] = 1;
+            (*s->pendientes)--;
+            for (uint32_t k = s->grado[f]; k < s->grado[f + 1]; k++) {
+                s->ganancia[s->primosDeFila[k]]--;
+            }
+        }
+    }
+}
+
+// Selecciona primos esenciales y completa la cobertura con una elección
+// voraz (más filas sin cubrir, desempate por menos literales)
+static int seleccionarCobertura(int n, const uint64_t *on, size_t filas,
+                                const Cobertura *primos, Cobertura *sop) {
+    size_t np = primos->cantidad;
+    uint32_t *grado = calloc(filas + 1, sizeof(uint32_t));
+    size_t *ganancia = calloc(np ? np : 1, sizeof(size_t));
+    unsigned char *elegido = calloc(np ? np : 1, 1);
+    unsigned char *cubierta = calloc(filas, 1);
+    uint32_t *primosDeFila = NULL;
+    if (!grado || !ganancia || !elegido || !cubierta) goto error;
+
+    // Primera pasada: cuántos primos cubren cada fila ON
+    for (size_t p = 0; p < np; p++) {
+        Cubo c = primos->cubos[p];
+        uint64_t m = mascaraCuboBaja(n, c);
+        IterPalabras it;
+        size_t w;
+        iniciarIterPalabras(&it, n, c);
+        while (siguientePalabra(&it, &w)) {
+            uint64_t x = m & on[w];
+            ganancia[p] += (size_t)__builtin_popcountll(x);
+            while (x) {
+                grado[(w << 6) + (size_t)__builtin_ctzll(x) + 1]++;
+                x &= x - 1;
+            }
+        }
+    }
+    for (size_t f = 0; f < filas; f++) grado[f + 1] += grado[f];
+    primosDeFila = malloc((grado[filas] ? grado[filas] : 1) * sizeof(uint32_t));
+    if (primosDeFila == NULL) goto error;
+
+    // Segunda pasada: lista de primos por fila (formato comprimido)
+    {
+        uint32_t *pos = malloc(filas * sizeof(uint32_t));
+        if (pos == NULL) goto error;
+        memcpy(pos, grado, filas * sizeof(uint32_t));
+        for (size_t p = 0; p < np; p++) {
+            Cubo c = primos->cubos[p];
+            uint64_t m = mascaraCuboBaja(n, c);
+            IterPalabras it;
+            size_t w;
+            iniciarIterPalabras(&it, n, c);
+            while (siguientePalabra(&it, &w)) {
+                uint64_t x = m & on[w];
+                while (x) {
+                    size_t f = (w << 6) + (size_t)__builtin_ctzll(x);
+                    x &= x - 1;
+                    primosDeFila[pos[f]++] = (uint32_t)p;
+                }
+            }
+        }
+        free(pos);
+    }
+
+    size_t pendientes = 0;
+    for (size_t w = 0; w < (filas + 63) / 64; w++) pendientes += (size_t)__builtin_popcountll(on[w]);
+    Seleccion sel = { grado, primosDeFila, ganancia, elegido, cubierta, &pendientes };
+
+
+    // Primos esenciales: única opción para alguna fila
+    for (size_t f = 0; f < filas; f++) {
+        if (grado[f + 1] - grado[f] == 1 && !cubierta[f]) {
+            size_t p = primosDeFila[grado[f]];
+            if (!elegido[p]) elegirPrimo(n, on, primos, p, &sel);
+        }
+    }
+
+    while (pendientes > 0) {
+        size_t mejor = SIN_INDICE;
+        for (size_t p = 0; p < np; p++) {
+            if (elegido[p] || ganancia[p] == 0) continue;
+            if (mejor == SIN_INDICE || ganancia[p] > ganancia[mejor] ||
+                (ganancia[p] == ganancia[mejor] &&
+                 literalesCubo(primos->cubos[p]) < literalesCubo(primos->cubos[mejor]))) {
+                mejor = p;
+            }
+        }
+        if (mejor == SIN_INDICE) break;
+        elegirPrimo(n, on, primos, mejor, &sel);
+    }
+
+    for (size_t p = 0; p < np; p++) {
+        if (elegido[p] && !agregarCubo(sop, primos->cubos[p])) goto error;
+    }
+
+    free(grado); free(ganancia); free(elegido); free(cubierta); free(primosDeFila);
+    return 1;
+
+error:
+    free(grado); free(ganancia); free(elegido); free(cubierta); free(primosDeFila);
+    return 0;
+}
+
+// ===================== Heurístico tipo Espresso =====================
+
+// Expande un cubo quitando literales mientras no toque el conjunto OFF.
+// Un literal que no se pudo quitar tampoco se podrá quitar después,
+// así que una sola pasada deja un implicante primo.
+static Cubo expandirCubo(int n, Cubo c, const uint64_t *permitido, const int *orden) {
+    for (int k = 0; k < n; k++) {
+        uint32_t b = 1u << orden[k];
+        if (!(c.cuidado & b)) continue;
+        Cubo mitad = { c.valor ^ b, c.cuidado };
+        if (cuboContenido(n, mitad, permitido)) {
+            c.cuidado &= ~b;
+            c.valor &= ~b;
+        }
+    }
+    return c;
+}
+
+// Reduce cada cubo al menor cubo que contiene sus filas ON que ningún
+// otro cubo cubre; los cubos sin filas propias desaparecen
+static void reducirCobertura(Cobertura *cob, const uint64_t *on, uint8_t *cuenta, size_t filas) {
+    int n = cob->n;
+    uint32_t completo = (1u << n) - 1;
+    memset(cuenta, 0, filas);
+    for (size_t i = 0; i < cob->cantidad; i++) sumarCubo(n, cob->cubos[i], on, cuenta, +1);
+
+    size_t quedan = 0;
+    for (size_t i = 0; i < cob->cantidad; i++) {
+        Cubo c = cob->cubos[i];
+        uint32_t unos = completo, ceros = completo;
+        int propias = 0;
+        uint64_t m = mascaraCuboBaja(n, c);
+        IterPalabras it;
+        size_t w;
+        iniciarIterPalabras(&it, n, c);
+        while (siguientePalabra(&it, &w)) {
+            uint64_t x = m & on[w];
+            while (x) {
+                uint32_t f = (uint32_t)((w << 6) + (size_t)__builtin_ctzll(x));
+                x &= x - 1;
+                if (cuenta[f] == 1) {
+                    unos &= f;
+                    ceros &= ~f;
+                    propias = 1;
+                }
+            }
+        }
+        sumarCubo(n, c, on, cuenta, -1);
+        if (!propias) continue;
+        Cubo r = { unos & (unos | ceros), (unos | ceros) & completo };
+        sumarCubo(n, r, on, cuenta, +1);
+        cob->cubos[quedan++] = r;
+    }
+    cob->cantidad = quedan;
+}
+
+// Compara costos: primero cantidad de cubos, luego literales
+static int mejorCosto(const Cobertura *a, const Cobertura *b) {
+    if (a->cantidad != b->cantidad) return a->cantidad < b->cantidad;
+    return contarLiterales(a) < contarLiterales(b);
+}
+
+static int minimizarHeuristico(int n, const uint64_t *on, const uint64_t *permitido,
+                               size_t palabras, Cobertura *sop) {
+    size_t filas = (size_t)1 << n;
+    uint64_t *cubierto = calloc(palabras, sizeof(uint64_t));
+    uint8_t *cuenta = malloc(filas);
+    int orden[32];
+    if (!cubierto || !cuenta) { free(cubierto); free(cuenta); return 0; }
+
+    // Expandir: cada fila ON aún no cubierta genera un primo
+    for (int k = 0; k < n; k++) orden[k] = n - 1 - k;
+    for (size_t w = 0; w < palabras; w++) {
+        uint64_t x;
+        while ((x = on[w] & ~cubierto[w]) != 0) {
+            Cubo c = { (uint32_t)((w << 6) + (size_t)__builtin_ctzll(x)), (1u << n) - 1 };
+            c = expandirCubo(n, c, permitido, orden);
+            if (!agregarCubo(sop, c)) { free(cubierto); free(cuenta); return 0; }
+            marcarCubo(n, c, cubierto);
+        }
+    }
+    free(cubierto);
+    irredundante(sop, on, cuenta, filas);
+
+    // Reducir / expandir / irredundante mientras el costo mejore
+    for (int iter = 1; iter <= MAX_ITERACIONES_HEURISTICO; iter++) {
+        Cobertura previa;
+        iniciarCobertura(&previa, n);
+        for (size_t i = 0; i < sop->cantidad; i++) {
+            if (!agregarCubo(&previa, sop->cubos[i])) { liberarCobertura(&previa); free(cuenta); return 0; }
+        }
+
+        for (int k = 0; k < n; k++) {
+            int p = (iter % 2) ? k : n - 1 - k;   // alterna dirección
+            orden[k] = (p + iter) % n;           // y rota el inicio
+        }
+        reducirCobertura(sop, on, cuenta, filas);
+        for (size_t i = 0; i < sop->cantidad; i++) {
+            sop->cubos[i] = expandirCubo(n, sop->cubos[i], permitido, orden);
+        }
+        irredundante(sop, on, cuenta, filas);
+
+        if (!mejorCosto(sop, &previa)) {
+            if (mejorCosto(&previa, sop)) {
+                Cobertura tmp = *sop;
+                *sop = previa;
+                previa = tmp;
+            }
+            liberarCobertura(&previa);
+            break;
+        }
+        liberarCobertura(&previa);
+    }
+    free(cuenta);
+    return 1;
+}
+
+// ===================== Interfaz pública =====================
+
+// Orden de presentación: menos literales primero y luego por variables (A antes que B)
+static int compararPresentacion(const void *a, const void *b) {
+    Cubo x = *(const Cubo *)a, y = *(const Cubo *)b;
+    int lx = literalesCubo(x), ly = literalesCubo(y);
+    if (lx != ly) return lx - ly;
+    if (x.cuidado != y.cuidado) return (x.cuidado > y.cuidado) ? -1 : 1;
+    if (x.valor != y.valor) return (x.valor > y.valor) ? -1 : 1;
+    return 0;
+}
+
+void ordenarCobertura(Cobertura *c) {
+    if (c->cantidad > 1) qsort(c->cubos, c->cantidad, sizeof(Cubo), compararPresentacion);
+}
+
+// Minimiza la función cuyas filas ON están en 'on' y cuyas filas
+// permitidas (ON o indiferentes) están en 'permitido'
+static int minimizarConjuntos(int n, const uint64_t *on, const uint64_t *permitido,
+                              size_t palabras, ModoMinimizacion modo, Cobertura *sop) {
+    iniciarCobertura(sop, n);
+    if (modo == MINIMIZAR_AUTO) {
+        modo = (n <= UMBRAL_EXACTO) ? MINIMIZAR_EXACTO : MINIMIZAR_HEURISTICO;
+    }
+
+    int ok;
+    if (modo == MINIMIZAR_HEURISTICO) {
+        ok = minimizarHeuristico(n, on, permitido, palabras, sop);
+    } else {
+        Cobertura primos;
+        iniciarCobertura(&primos, n);
+        ok = implicantesPrimos(n, on, permitido, palabras, &primos) &&
+             seleccionarCobertura(n, on, (size_t)1 << n, &primos, sop);
+        liberarCobertura(&primos);
+        if (ok) {
+            uint8_t *cuenta = malloc((size_t)1 << n);
+            if (cuenta == NULL) return 0;
+            irredundante(sop, on, cuenta, (size_t)1 << n);
+            free(cuenta);
+        }
+    }
+    if (ok) ordenarCobertura(sop);
+    return ok;
+}
+
+int minimizarSOP(const TablaVerdad *t, ModoMinimizacion modo, Cobertura *sop) {
+    iniciarCobertura(sop, t->n);
+    uint64_t *permitido = malloc(t->palabras * sizeof(uint64_t));
+    if (permitido == NULL) return 0;
+    for (size_t w = 0; w < t->palabras; w++) {
+        permitido[w] = t->bits[w] | (t->indiferentes ? t->indiferentes[w] : 0);
+    }
+    int ok = minimizarConjuntos(t->n, t->bits, permitido, t->palabras, modo, sop);
+    free(permitido);
+    return ok;
+}
+
+// La POS se obtiene minimizando el complemento (las filas en 0) y
+// aplicando De Morgan al imprimir cada cubo como una suma
+int minimizarPOS(const TablaVerdad *t, ModoMinimizacion modo, Cobertura *pos) {
+    TablaVerdad ceros;
+    iniciarCobertura(pos, t->n);
+    if (!crearTabla(&ceros, t->n)) return 0;
+    complementarTabla(&ceros, t);
+    ceros.indiferentes = t->indiferentes;
+    if (t->indiferentes) {
+        for (size_t w = 0; w < t->palabras; w++) ceros.bits[w] &= ~t->indiferentes[w];
+    }
+    int ok = minimizarSOP(&ceros, modo, pos);
+    ceros.indiferentes = NULL;
+    liberarTabla(&ceros);
+    return ok;
+}
+
+// ===================== Síntesis multisalida =====================
+
+// Filas del cubo que están en 'conjunto' y todavía no en 'cubierto'
+static size_t filasNuevas(int n, Cubo cubo, const uint64_t *conjunto, const uint64_t *cubierto) {
+    uint64_t m = mascaraCuboBaja(n, cubo);
+    IterPalabras it;
+    size_t w, total = 0;
+    iniciarIterPalabras(&it, n, cubo);
+    while (siguientePalabra(&it, &w)) {
+        total += (size_t)__builtin_popcountll(m & conjunto[w] & ~cubierto[w]);
+    }
+    return total;
+}
+
+// Costo de usar un cubo en una salida: una entrada de la OR, más la AND
+// y sus entradas si ninguna otra salida la construyó ya
+static double costoCubo(Cubo c, int compartido) {
+    int lit = literalesCubo(c);
+    if (lit < 2 || compartido) return 1.0;
+    return 2.0 + lit;
+}
+
+// Elige la cobertura de una salida entre los candidatos válidos para ella,
+// prefiriendo los cubos que ya usan las demás salidas
+static int coberturaCompartida(int n, const uint64_t *on, size_t palabras, const ConjuntoCubos *cand,
+                               const size_t *validos, size_t numValidos,
+                               const ConjuntoCubos *compartidos, Cobertura *cob) {
+    size_t filas = (size_t)1 << n;
+    uint64_t *cubierto = calloc(palabras, sizeof(uint64_t));
+    uint8_t *cuenta = malloc(filas);
+    unsigned char *elegido = calloc(numValidos ? numValidos : 1, 1);
+    if (!cubierto || !cuenta || !elegido) { free(cubierto); free(cuenta); free(elegido); return 0; }
+
+    iniciarCobertura(cob, n);
+    for (;;) {
+        size_t mejor = SIN_INDICE;
+        double mejorPuntaje = 0;
+        for (size_t k = 0; k < numValidos; k++) {
+            if (elegido[k]) continue;
+            Cubo c = cand->cubos[validos[k]];
+            size_t ganancia = filasNuevas(n, c, on, cubierto);
+            if (ganancia == 0) continue;
+            double puntaje = (double)ganancia / costoCubo(c, buscarEnConjunto(compartidos, c) != SIN_INDICE);
+            if (mejor == SIN_INDICE || puntaje > mejorPuntaje ||
+                (puntaje == mejorPuntaje && literalesCubo(c) < literalesCubo(cand->cubos[validos[mejor]]))) {
+                mejor = k;
+                mejorPuntaje = puntaje;
+            }
+        }
+        if (mejor == SIN_INDICE) break;
+        elegido[mejor] = 1;
+        Cubo c = cand->cubos[validos[mejor]];
+        if (!agregarCubo(cob, c)) { free(cubierto); free(cuenta); free(elegido); return 0; }
+        marcarCubo(n, c, cubierto);
+    }
+
+    // Irredundante: se descartan primero los cubos propios (no compartidos)
+    // y, entre ellos, los de más literales
+    memset(cuenta, 0, filas);
+    for (size_t i = 0; i < cob->cantidad; i++) sumarCubo(n, cob->cubos[i], on, cuenta, +1);
+    for (int pasada = 0; pasada < 2; pasada++) {
+        size_t quedan = 0;
+        for (size_t i = 0; i < cob->cantidad; i++) {
+            Cubo c = cob->cubos[i];
+            int compartido = buscarEnConjunto(compartidos, c) != SIN_INDICE;
+            if (compartido == pasada && cuboRedundante(n, c, on, cuenta)) {
+                sumarCubo(n, c, on, cuenta, -1);
+            } else {
+                cob->cubos[quedan++] = c;
+            }
+        }
+        cob->cantidad = quedan;
+    }
+    if (cob->cantidad > 1) qsort(cob->cubos, cob->cantidad, sizeof(Cubo), compararPresentacion);
+
+    free(cubierto);
+    free(cuenta);
+    free(elegido);
+    return 1;
+}
+
+// Minimiza varias salidas sobre las mismas entradas buscando términos
+// producto compartidos. Los candidatos son los primos de cada salida y
+// los de cada producto f_i·f_j (implicantes útiles para ambas salidas);
+// luego cada salida elige su cobertura con un costo que premia reutilizar
+// las AND que ya construyen las demás. Se hacen dos pasadas para que las
+// primeras salidas también vean lo que eligieron las últimas.
+int minimizarMultisalida(const TablaVerdad *salidas, int m, ModoMinimizacion modo, Cobertura *coberturas) {
+    int n = salidas[0].n;
+    size_t palabras = salidas[0].palabras;
+    int ok = 1;
+    uint64_t **permitido = calloc((size_t)m, sizeof(uint64_t *));
+    size_t **validos = calloc((size_t)m, sizeof(size_t *));
+    size_t *numValidos = calloc((size_t)m, sizeof(size_t));
+    uint64_t *onPar = malloc(palabras * sizeof(uint64_t));
+    uint64_t *permPar = malloc(palabras * sizeof(uint64_t));
+    ConjuntoCubos cand;
+    int candIniciado = 0;
+
+    for (int k = 0; k < m; k++) iniciarCobertura(&coberturas[k], n);
+    if (!permitido || !validos || !numValidos || !onPar || !permPar || !iniciarConjunto(&cand, 64)) {
+        ok = 0;
+        goto fin;
+    }
+    candIniciado = 1;
+
+    // Cobertura individual de cada salida
+    for (int k = 0; ok && k < m; k++) {
+        permitido[k] = malloc(palabras * sizeof(uint64_t));
+        if (permitido[k] == NULL) { ok = 0; break; }
+        for (size_t w = 0; w < palabras; w++) {
+            permitido[k][w] = salidas[k].bits[w] | (salidas[k].indiferentes ? salidas[k].indiferentes[w] : 0);
+        }
+        ok = minimizarConjuntos(n, salidas[k].bits, permitido[k], palabras, modo, &coberturas[k]);
+        for (size_t i = 0; ok && i < coberturas[k].cantidad; i++) {
+            ok = agregarAConjunto(&cand, coberturas[k].cubos[i]);
+        }
+    }
+    if (!ok || m == 1) goto fin;
+
+    // Implicantes de los productos de pares de salidas
+    if (m <= MAX_PARES_MULTISALIDA) {
+        for (int i = 0; ok && i < m; i++) {
+            for (int j = i + 1; ok && j < m; j++) {
+                int hay = 0;
+                for (size_t w = 0; w < palabras; w++) {
+                    onPar[w] = salidas[i].bits[w] & salidas[j].bits[w];
+                    permPar[w] = permitido[i][w] & permitido[j][w];
+                    hay |= onPar[w] != 0;
+                }
+                if (!hay) continue;
+                Cobertura par;
+                ok = minimizarConjuntos(n, onPar, permPar, palabras, modo, &par);
+                for (size_t c = 0; ok && c < par.cantidad; c++) ok = agregarAConjunto(&cand, par.cubos[c]);
+                liberarCobertura(&par);
+            }
+        }
+    }
+
+    // Candidatos válidos para cada salida (no tocan su conjunto OFF)
+    for (int k = 0; ok && k < m; k++) {
+        validos[k] = malloc((cand.cantidad ? cand.cantidad : 1) * sizeof(size_t));
+        if (validos[k] == NULL) { ok = 0; break; }
+        for (size_t c = 0; c < cand.cantidad; c++) {
+            if (cuboContenido(n, cand.cubos[c], permitido[k])) validos[k][numValidos[k]++] = c;
+        }
+    }
+
+    for (int pasada = 0; ok && pasada < 2; pasada++) {
+        for (int k = 0; ok && k < m; k++) {
+            // Cubos que usan las otras salidas en este momento
+            ConjuntoCubos compartidos;
+            if (!iniciarConjunto(&compartidos, 64)) { ok = 0; break; }
+            for (int o = 0; ok && o < m; o++) {
+                if (o == k) continue;
+                for (size_t i = 0; ok && i < coberturas[o].cantidad; i++) {
+                    ok = agregarAConjunto(&compartidos, coberturas[o].cubos[i]);
+                }
+            }
+            Cobertura nueva;
+            if (ok && coberturaCompartida(n, salidas[k].bits, palabras, &cand, validos[k], numValidos[k],
+                                          &compartidos, &nueva)) {
+                liberarCobertura(&coberturas[k]);
+                coberturas[k] = nueva;
+            } else {
+                ok = 0;
+            }
+            liberarConjunto(&compartidos);
+        }
+    }
+
+fin:
+    for (int k = 0; k < m; k++) {
+        if (permitido) free(permitido[k]);
+        if (validos) free(validos[k]);
+    }
+    free(permitido);
+    free(validos);
+    free(numValidos);
+    free(onPar);
+    free(permPar);
+    if (candIniciado) liberarConjunto(&cand);
+    return ok;
+}
+
+// ===================== Reminimización incremental =====================
+
+// Estado de una fila vista desde una cobertura (para la POS se invierte)
+enum { FILA_OFF, FILA_ON, FILA_DC };
+
+static void fijarBit(uint64_t *conjunto, size_t fila, int valor) {
+    if (valor) conjunto[fila >> 6] |= 1ULL << (fila & 63);
+    else conjunto[fila >> 6] &= ~(1ULL << (fila & 63));
+}
+
+static int cuboCubreFila(Cubo c, size_t fila) {
+    return (((uint32_t)fila ^ c.valor) & c.cuidado) == 0;
+}
+
+static int cubosSeTocan(Cubo a, Cubo b) {
+    return ((a.valor ^ b.valor) & a.cuidado & b.cuidado) == 0;
+}
+
+static void quitarCuboIncremental(CoberturaIncremental *ci, size_t i) {
+    Cobertura *cob = &ci->cobertura;
+    sumarCubo(cob->n, cob->cubos[i], ci->on, ci->cuenta, -1);
+    cob->cubos[i] = cob->cubos[--cob->cantidad];
+}
+
+// Agrega el primo que resulta de expandir la fila contra el conjunto OFF
+static int agregarPrimoDeFila(CoberturaIncremental *ci, size_t fila, Cubo *primo) {
+    int n = ci->cobertura.n, orden[32];
+    for (int k = 0; k < n; k++) orden[k] = n - 1 - k;
+    Cubo c = { (uint32_t)fila, (1u << n) - 1 };
+    c = expandirCubo(n, c, ci->permitido, orden);
+    if (!agregarCubo(&ci->cobertura, c)) return 0;
+    sumarCubo(n, c, ci->on, ci->cuenta, +1);
+    if (primo) *primo = c;
+    return 1;
+}
+
+// Irredundante restringido a los cubos que tocan la zona (los de más
+// literales se intentan quitar primero)
+static void limpiarZona(CoberturaIncremental *ci, Cubo zona) {
+    Cobertura *cob = &ci->cobertura;
+    for (int lit = cob->n; lit >= 0; lit--) {
+        for (size_t i = 0; i < cob->cantidad; i++) {
+            Cubo c = cob->cubos[i];
+            if (literalesCubo(c) != lit || !cubosSeTocan(c, zona)) continue;
+            if (cuboRedundante(cob->n, c, ci->on, ci->cuenta)) quitarCuboIncremental(ci, i--);
+        }
+    }
+}
+
+// Vuelve a cubrir las filas ON del cubo quitado que quedaron sin cubo
+static int cubrirFaltantes(CoberturaIncremental *ci, Cubo quitado) {
+    int n = ci->cobertura.n;
+    uint64_t m = mascaraCuboBaja(n, quitado);
+    IterPalabras it;
+    size_t w;
+    iniciarIterPalabras(&it, n, quitado);
+    while (siguientePalabra(&it, &w)) {
+        uint64_t x = m & ci->on[w];
+        while (x) {
+            size_t fila = (w << 6) + (size_t)__builtin_ctzll(x);
+            x &= x - 1;
+            if (ci->cuenta[fila] == 0 && !agregarPrimoDeFila(ci, fila, NULL)) return 0;
+        }
+    }
+    return 1;
+}
+
+// Aplica el cambio de una fila a una cobertura tocando solo los cubos vecinos
+static int actualizarCobertura(CoberturaIncremental *ci, size_t fila, int antes, int despues) {
+    Cobertura *cob = &ci->cobertura;
+    int n = cob->n;
+    Cubo minterm = { (uint32_t)fila, (1u << n) - 1 };
+    if (antes == despues) return 1;
+    fijarBit(ci->on, fila, despues == FILA_ON);
+    fijarBit(ci->permitido, fila, despues != FILA_OFF);
+
+    if (despues == FILA_ON) {
+        // Si era indiferente puede que ya esté cubierta
+        size_t cubren = 0;
+        for (size_t i = 0; i < cob->cantidad; i++) cubren += cuboCubreFila(cob->cubos[i], fila);
+        ci->cuenta[fila] = (uint8_t)(cubren < 255 ? cubren : 255);
+        if (cubren > 0) return 1;
+        Cubo primo;
+        if (!agregarPrimoDeFila(ci, fila, &primo)) return 0;
+        limpiarZona(ci, primo);
+        return 1;
+    }
+
+    ci->cuenta[fila] = 0;
+    if (despues == FILA_DC && antes == FILA_ON) {
+        // Algún cubo que la cubría pudo quedar sobrando
+        limpiarZona(ci, minterm);
+        return 1;
+    }
+    if (despues == FILA_DC) {
+        // Pasó de OFF a indiferente: los cubos vecinos quizá ahora se expanden
+        int orden[32];
+        for (int k = 0; k < n; k++) orden[k] = n - 1 - k;
+        for (size_t i = 0; i < cob->cantidad; i++) {
+            Cubo c = cob->cubos[i];
+            uint32_t dif = ((uint32_t)fila ^ c.valor) & c.cuidado;
+            if (dif == 0 || (dif & (dif - 1)) != 0) continue;
+            Cubo e = expandirCubo(n, c, ci->permitido, orden);
+            if (e.cuidado == c.cuidado) continue;
+            sumarCubo(n, c, ci->on, ci->cuenta, -1);
+            sumarCubo(n, e, ci->on, ci->cuenta, +1);
+            cob->cubos[i] = e;
+            limpiarZona(ci, e);
+            i = (size_t)-1;     // la limpieza pudo reordenar la cobertura
+        }
+        return 1;
+    }
+
+    // La fila pasa a OFF: los cubos que la cubren dejan de ser válidos
+    size_t cantidad = 0;
+    for (size_t i = 0; i < cob->cantidad; i++) cantidad += cuboCubreFila(cob->cubos[i], fila);
+    if (cantidad == 0) return 1;
+    Cubo *quitados = malloc(cantidad * sizeof(Cubo));
+    if (quitados == NULL) return 0;
+    cantidad = 0;
+    for (size_t i = 0; i < cob->cantidad; i++) {
+        if (!cuboCubreFila(cob->cubos[i], fila)) continue;
+        quitados[cantidad++] = cob->cubos[i];
+        quitarCuboIncremental(ci, i--);
+    }
+    int ok = 1;
+    for (size_t k = 0; ok && k < cantidad; k++) ok = cubrirFaltantes(ci, quitados[k]);
+    for (size_t k = 0; ok && k < cantidad; k++) limpiarZona(ci, quitados[k]);
+    free(quitados);
+    return ok;
+}
+
+static int iniciarCoberturaIncremental(CoberturaIncremental *ci, int n, size_t palabras,
+                                       const uint64_t *on, const uint64_t *permitido,
+                                       ModoMinimizacion modo) {
+    size_t filas = (size_t)1 << n;
+    iniciarCobertura(&ci->cobertura, n);
+    ci->on = malloc(palabras * sizeof(uint64_t));
+    ci->permitido = malloc(palabras * sizeof(uint64_t));
+    ci->cuenta = calloc(filas, 1);
+    if (!ci->on || !ci->permitido || !ci->cuenta) return 0;
+    memcpy(ci->on, on, palabras * sizeof(uint64_t));
+    memcpy(ci->permitido, permitido, palabras * sizeof(uint64_t));
+    if (!minimizarConjuntos(n, ci->on, ci->permitido, palabras, modo, &ci->cobertura)) return 0;
+    for (size_t i = 0; i < ci->cobertura.cantidad; i++) {
+        sumarCubo(n, ci->cobertura.cubos[i], ci->on, ci->cuenta, +1);
+    }
+    return 1;
+}
+
+static void liberarCoberturaIncremental(CoberturaIncremental *ci) {
+    free(ci->on);
+    free(ci->permitido);
+    free(ci->cuenta);
+    ci->on = ci->permitido = NULL;
+    ci->cuenta = NULL;
+    liberarCobertura(&ci->cobertura);
+}
+
+// Minimiza la función completa una vez; después cada cambiarFila ajusta
+// la SOP y la POS localmente
+int iniciarIncremental(FuncionIncremental *fi, const TablaVerdad *t, ModoMinimizacion modo) {
+    int n = t->n;
+    size_t palabras = t->palabras;
+    uint64_t valida = (n >= 6) ? ~0ULL : ((1ULL << (1u << n)) - 1);
+    memset(fi, 0, sizeof(*fi));
+    iniciarCobertura(&fi->sop.cobertura, n);
+    iniciarCobertura(&fi->pos.cobertura, n);
+    if (!crearTabla(&fi->tabla, n)) return 0;
+
+    uint64_t *onPos = malloc(palabras * sizeof(uint64_t));
+    uint64_t *permPos = malloc(palabras * sizeof(uint64_t));
+    uint64_t *permSop = malloc(palabras * sizeof(uint64_t));
+    int ok = onPos && permPos && permSop;
+    if (ok && t->indiferentes) {
+        fi->tabla.indiferentes = malloc(palabras * sizeof(uint64_t));
+        ok = fi->tabla.indiferentes != NULL;
+    }
+    for (size_t w = 0; ok && w < palabras; w++) {
+        uint64_t dc = t->indiferentes ? t->indiferentes[w] : 0;
+        fi->tabla.bits[w] = t->bits[w];
+        if (t->indiferentes) fi->tabla.indiferentes[w] = dc;
+        permSop[w] = t->bits[w] | dc;
+        permPos[w] = ~t->bits[w] & valida;
+        onPos[w] = permPos[w] & ~dc;
+    }
+    ok = ok && iniciarCoberturaIncremental(&fi->sop, n, palabras, t->bits, permSop, modo) &&
+         iniciarCoberturaIncremental(&fi->pos, n, palabras, onPos, permPos, modo);
+    free(onPos);
+    free(permPos);
+    free(permSop);
+    if (!ok) liberarIncremental(fi);
+    return ok;
+}
+
+// valor: 0, 1 o FILA_INDIFERENTE
+int cambiarFila(FuncionIncremental *fi, size_t fila, int valor) {
+    TablaVerdad *t = &fi->tabla;
+    if (fila >= numFilas(t)) return 0;
+    int antes = esIndiferente(t, fila) ? FILA_DC : obtenerSalida(t, fila) ? FILA_ON : FILA_OFF;
+    int despues = (valor == FILA_INDIFERENTE) ? FILA_DC : valor ? FILA_ON : FILA_OFF;
+    if (antes == despues) return 1;
+
+    if (despues == FILA_DC) {
+        if (!asignarIndiferente(t, fila)) return 0;
+    } else {
+        asignarSalida(t, fila, despues == FILA_ON);
+    }
+
+    // En la POS los papeles de ON y OFF se invierten
+    int antesPos = (antes == FILA_DC) ? FILA_DC : (antes == FILA_ON) ? FILA_OFF : FILA_ON;
+    int despuesPos = (despues == FILA_DC) ? FILA_DC : (despues == FILA_ON) ? FILA_OFF : FILA_ON;
+    return actualizarCobertura(&fi->sop, fila, antes, despues) &&
+           actualizarCobertura(&fi->pos, fila, antesPos, despuesPos);
+}
+
+// Deja las coberturas en el orden de presentación de minimizarSOP
+void ordenarIncremental(FuncionIncremental *fi) {
+    ordenarCobertura(&fi->sop.cobertura);
+    ordenarCobertura(&fi->pos.cobertura);
+}
+
+void liberarIncremental(FuncionIncremental *fi) {
+    liberarCoberturaIncremental(&fi->sop);
+    liberarCoberturaIncremental(&fi->pos);
+    liberarTabla(&fi->tabla);
+}
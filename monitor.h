@@ -0,0 +1,222 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define NUM_ZONAS 5
+#define ZONAS_INICIALES 256      // capacidad inicial del registro; crece al doble
+#define DIAS_HISTORICO 30
+#define NUM_CONTAMINANTES 4
+#define MAX_NOMBRE_ZONA 50
+#define MAX_FILENAME 100
+
+// Índices para mejor legibilidad
+#define TEMPERATURA_IDX 0
+#define HUMEDAD_IDX 1
+#define VIENTO_IDX 2
+#define NUM_CLIMA 3
+
+#define SEGUNDOS_DIA 86400
+
+// Contaminantes específicos para Ecuador
+enum Contaminantes {PM2_5, PM10, NO2, SO2};
+
+// Serie de tiempo de una zona en tres niveles (minuto, hora y día), cada
+// uno un anillo por contaminante (en columnas) que guarda el promedio de
+// las lecturas de cada intervalo; -1 = sin datos. Los tres niveles se
+// actualizan con cada lectura, así que el tamaño no depende de cuánto
+// tiempo se lleve midiendo.
+#define NIVELES_SERIE 3
+#define MINUTOS_SERIE 1440          // último día, minuto a minuto
+#define HORAS_SERIE (24 * 31)       // último mes, hora a hora
+#define DIAS_SERIE 366              // último año, día a día
+
+enum NivelSerie {NIVEL_MINUTO, NIVEL_HORA, NIVEL_DIA};
+
+typedef struct {
+    int64_t actual;             // intervalo de la última ranura escrita (desde 1970); -1 = ninguno
+    int64_t lecturas;           // lecturas del intervalo actual
+    double suma[NUM_CONTAMINANTES];
+} AcumuladorSerie;
+
+// Estadísticas móviles de la serie, al día con cada lectura en O(1): sobre
+// los promedios diarios, la suma de la ventana de DIAS_HISTORICO días y la
+// de la semana con su suma ponderada (pesos 7 al día más nuevo a 1 al más
+// viejo); sobre las lecturas, un promedio exponencial con su varianza y
+// constante de tiempo TAU_EWMA.
+#define DIAS_SEMANA 7
+#define TAU_EWMA 3600.0             // segundos
+
+typedef struct {
+    int64_t dia;                // día más nuevo de las ventanas; -1 = ninguno
+    int32_t dias_mes;           // días con lecturas en cada ventana
+    int32_t dias_semana;
+    int32_t peso_semana;        // suma de los pesos de esos días
+    int32_t reservado;
+    int64_t ultima;             // tiempo de la última lectura del promedio exponencial
+    double suma_mes[NUM_CONTAMINANTES];
+    double suma_semana[NUM_CONTAMINANTES];
+    double ponderada_semana[NUM_CONTAMINANTES];
+    double media[NUM_CONTAMINANTES];
+    double varianza[NUM_CONTAMINANTES];
+} EstadisticasSerie;
+
+// Un solo escritor por zona; las estadísticas se leen sin bloquear con
+// leer_estadisticas (secuencia impar = escritura en curso)
+typedef struct {
+    _Atomic uint32_t secuencia;
+    EstadisticasSerie estadisticas;
+    AcumuladorSerie acumulado[NIVELES_SERIE];
+    float minutos[NUM_CONTAMINANTES][MINUTOS_SERIE];
+    float horas[NUM_CONTAMINANTES][HORAS_SERIE];
+    float dias[NUM_CONTAMINANTES][DIAS_SERIE];
+} SerieZona;
+
+// Sin punteros: las zonas viven en el almacén mapeado y sobreviven a un
+// reinicio tal cual. Cada zona empieza en su propia línea de caché, así dos
+// hilos que procesan zonas vecinas no se pisan la misma línea.
+#define LINEA_CACHE 64
+
+typedef struct {
+    _Alignas(LINEA_CACHE) char nombre[MAX_NOMBRE_ZONA];
+    float contaminantes[NUM_CONTAMINANTES];
+    float clima[NUM_CLIMA]; // temperatura, humedad, viento
+    int alerta; // 0=normal, 1=preventiva, 2=emergencia
+    int64_t ultima_lectura;     // segundos desde 1970
+    int64_t lecturas;
+    SerieZona serie;
+} Zona;
+
+extern const char* nombres_contaminantes[];
+extern const char* unidades[];
+extern const float limites_ecuador[NUM_CONTAMINANTES];
+extern const float rangos_min[NUM_CONTAMINANTES];
+extern const float rangos_max[NUM_CONTAMINANTES];
+extern const float clima_min[NUM_CLIMA];
+extern const float clima_max[NUM_CLIMA];
+
+// Almacén de zonas: una cabecera de 64 bytes y un arreglo de Zona, mapeado
+// desde un archivo (MAP_SHARED, persiste) o en memoria anónima. Cuando se
+// llena, el archivo y el mapa crecen al doble dentro de direcciones
+// reservadas al abrir, así el arreglo nunca se mueve y otros hilos pueden
+// seguir leyendo zonas mientras se registran nuevas. El registro agrega una
+// tabla hash de nombres, que se rearma al abrir y al crecer; buscar y
+// registrar son del hilo que escribe.
+#define MAGIA_ALMACEN "SERI"
+#define VERSION_ALMACEN 3
+
+typedef struct {
+    char magia[4];
+    uint32_t version;
+    uint32_t tam_zona;          // sizeof(Zona) al crearlo
+    uint32_t capacidad;
+    uint32_t num_zonas;
+    uint32_t reservado[11];
+} CabeceraAlmacen;
+
+typedef struct {
+    CabeceraAlmacen *almacen;
+    size_t tam_mapa;
+    size_t tam_reserva;         // direcciones reservadas desde 'almacen'
+    int fd;                     // archivo del almacén; -1 = en memoria
+    Zona *zonas;
+    int num_zonas;
+    int capacidad;
+    int *tabla;                 // índice de zona + 1; 0 = ranura libre
+    size_t mascara;
+} RegistroZonas;
+
+// Zonas (zonas.c)
+void iniciar_zona(Zona *zona, const char *nombre, size_t largo);
+int abrir_registro(RegistroZonas *reg, const char *ruta, int capacidad);
+void cerrar_registro(RegistroZonas *reg);
+int buscar_zona(const RegistroZonas *reg, const char *nombre, size_t largo);
+int registrar_zona(RegistroZonas *reg, const char *nombre, size_t largo);
+
+// Procesamiento en paralelo (paralelo.c): un grupo de hilos que se reparte
+// las zonas en bloques consecutivos de BLOQUE_ZONAS; cada bloque lo procesa
+// un solo hilo por ronda, así cada zona tiene un solo escritor.
+#define MAX_HILOS_ZONAS 64
+#define BLOQUE_ZONAS 16
+
+typedef void (*TareaZonas)(Zona *zonas, int desde, int hasta, int hilo, void *datos);
+
+typedef struct GrupoHilos GrupoHilos;
+
+typedef struct {
+    GrupoHilos *grupo;
+    int indice;
+} HiloGrupo;
+
+struct GrupoHilos {
+    pthread_t ids[MAX_HILOS_ZONAS];
+    HiloGrupo hilos[MAX_HILOS_ZONAS];
+    int num_hilos;              // contando al que reparte, que también trabaja
+    pthread_mutex_t mutex;
+    pthread_cond_t hay_ronda;
+    pthread_cond_t fin_ronda;
+    unsigned ronda;
+    int trabajando;             // hilos que no terminaron la ronda
+    int salir;
+    TareaZonas tarea;
+    void *datos;
+    Zona *zonas;
+    int num_zonas;
+    _Alignas(LINEA_CACHE) _Atomic int siguiente;    // próximo bloque sin tomar
+};
+
+int iniciar_grupo(GrupoHilos *g, int hilos);
+void repartir_zonas(GrupoHilos *g, Zona *zonas, int num_zonas, TareaZonas tarea, void *datos);
+void cerrar_grupo(GrupoHilos *g);
+
+// Alertas por lotes (alertas.c): los niveles van en columnas, uno por
+// contaminante, y sale un byte por zona
+enum ModoAlertas {ALERTAS_ESCALAR, ALERTAS_SSE, ALERTAS_AVX2};
+
+int nivel_alerta(const float *contaminantes);
+void evaluar_alertas_lote(const float *const niveles[NUM_CONTAMINANTES], int n, uint8_t *alertas);
+void configurar_alertas(int simd);
+
+// Series (series.c)
+void iniciar_serie(SerieZona *s);
+int agregar_a_serie(SerieZona *s, int64_t tiempo, const float *valores);
+float valor_serie(const SerieZona *s, int nivel, int64_t intervalo, int contaminante);
+void leer_estadisticas(const SerieZona *s, EstadisticasSerie *copia);
+
+// Formato binario de lecturas: una cabecera, la tabla de nombres de zona
+// (MAX_NOMBRE_ZONA bytes cada uno) y registros de tamaño fijo que nombran la
+// zona por su posición en esa tabla. Un valor de clima NaN = sin dato.
+#define MAGIA_LECTURAS "AIRE"
+#define VERSION_LECTURAS 1
+
+typedef struct {
+    char magia[4];
+    uint32_t version;
+    uint32_t num_zonas;
+    uint32_t tam_registro;
+} CabeceraLecturas;
+
+typedef struct {
+    uint32_t tiempo;            // segundos desde 1970 (UTC)
+    uint32_t zona;
+    float contaminantes[NUM_CONTAMINANTES];
+    float clima[NUM_CLIMA];
+} RegistroLectura;
+
+typedef struct {
+    long lecturas;              // aplicadas a alguna zona
+    long invalidas;             // mal formadas o fuera de rango
+    long atrasadas;             // de un día anterior al de la zona (no van a la serie)
+    long sin_lugar;             // zonas nuevas que no entraron en el registro
+    int64_t ultima_lectura;     // la más reciente de todas
+} EstadisticasIngesta;
+
+// Ingesta (ingesta.c)
+void aplicar_lectura(Zona *zona, int64_t tiempo, const float *contaminantes, const float *clima,
+                     EstadisticasIngesta *est);
+int ingerir_archivo(RegistroZonas *reg, const char *ruta, EstadisticasIngesta *est);
+int ingerir_descriptor(RegistroZonas *reg, int fd, EstadisticasIngesta *est);
+
+#endif
@@ -0,0 +1,508 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "booleanas.h"
+
+// Dos funciones son NPN-equivalentes si una se obtiene de la otra negando
+// entradas, permutándolas y/o negando la salida. Cada tabla se lleva a una
+// forma canónica y el cache guarda las coberturas de esa forma; al
+// encontrarla se traducen de vuelta con la transformación de la función.
+
+static const uint64_t patronesBajos[6] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+// ===================== Forma canónica =====================
+
+// Filas válidas de una tabla de una sola palabra
+static uint64_t mascaraFilas(int n) {
+    return (n >= 6) ? ~0ULL : ((1ULL << (1u << n)) - 1);
+}
+
+// Niega la variable cuyo bit en el índice de fila es p
+static uint64_t negarBit(uint64_t t, int p) {
+    int s = 1 << p;
+    return ((t & patronesBajos[p]) >> s) | ((t & ~patronesBajos[p]) << s);
+}
+
+// Intercambia las variables de los bits p < q del índice de fila
+static uint64_t intercambiarBits(uint64_t t, int p, int q) {
+    int s = (1 << q) - (1 << p);
+    uint64_t m = patronesBajos[p] & ~patronesBajos[q];
+    return (t & ~(m | (m << s))) | ((t & m) << s) | ((t >> s) & m);
+}
+
+typedef struct {
+    uint64_t on, dc;
+    int origen[6];
+    uint32_t negadas;
+    int salidaNegada;
+} EstadoNPN;
+
+static void considerar(EstadoNPN *mejor, int *hayMejor, const EstadoNPN *e, uint64_t valida) {
+    EstadoNPN c = *e;
+    for (int neg = 0; neg < 2; neg++) {
+        if (neg) {
+            c.on = ~e->on & ~e->dc & valida;
+            c.salidaNegada = !e->salidaNegada;
+        }
+        if (!*hayMejor || c.on < mejor->on || (c.on == mejor->on && c.dc < mejor->dc)) {
+            *mejor = c;
+            *hayMejor = 1;
+        }
+    }
+}
+
+// Búsqueda exhaustiva (n! permutaciones x 2^n negaciones x 2 salidas).
+// Las permutaciones se recorren con el algoritmo de Heap (un intercambio
+// por paso) y las negaciones en código Gray (una negación por paso).
+static void canonicaExacta(const TablaVerdad *t, FormaNPN *forma) {
+    int n = t->n;
+    uint64_t valida = mascaraFilas(n);
+    EstadoNPN e, mejor;
+    int hayMejor = 0, c[6] = {0};
+    e.on = t->bits[0];
+    e.dc = t->indiferentes ? t->indiferentes[0] : 0;
+    for (int j = 0; j < n; j++) e.origen[j] = j;
+    e.negadas = 0;
+    e.salidaNegada = 0;
+
+    for (int i = 0; ; ) {
+        // Todas las negaciones de entradas para esta permutación
+        considerar(&mejor, &hayMejor, &e, valida);
+        for (uint32_t g = 1; g < (1u << n); g++) {
+            int p = __builtin_ctz(g);   // bit del índice de fila
+            e.on = negarBit(e.on, p);
+            e.dc = negarBit(e.dc, p);
+            e.negadas ^= 1u << (n - 1 - p);
+            considerar(&mejor, &hayMejor, &e, valida);
+        }
+
+        // Siguiente permutación (Heap, iterativo)
+        while (i < n && c[i] >= i) c[i++] = 0;
+        if (i >= n) break;
+        int a = (i % 2 == 0) ? 0 : c[i], b = i;
+        int pa = n - 1 - a, pb = n - 1 - b;  // variables a, b -> bits del índice
+        int p = pa < pb ? pa : pb, q = pa < pb ? pb : pa;
+        e.on = intercambiarBits(e.on, p, q);
+        e.dc = intercambiarBits(e.dc, p, q);
+        int o = e.origen[a]; e.origen[a] = e.origen[b]; e.origen[b] = o;
+        uint32_t ba = (e.negadas >> a) & 1, bb = (e.negadas >> b) & 1;
+        if (ba != bb) e.negadas ^= (1u << a) | (1u << b);
+        c[i]++;
+        i = 0;
+    }
+
+    forma->tabla.bits[0] = mejor.on;
+    if (forma->tabla.indiferentes) forma->tabla.indiferentes[0] = mejor.dc;
+    for (int j = 0; j < n; j++) forma->origen[j] = mejor.origen[j];
+    forma->negadas = mejor.negadas;
+    forma->salidaNegada = mejor.salidaNegada;
+}
+
+// Filas del conjunto en las que la variable var vale 1
+static size_t contarCofactor(const TablaVerdad *t, const uint64_t *conjunto, int var) {
+    size_t total = 0;
+    for (size_t w = 0; w < t->palabras; w++) {
+        total += (size_t)__builtin_popcountll(conjunto[w] & mascaraVariable(t->n, var, w));
+    }
+    return total;
+}
+
+// Fila canónica de cada fila original: r' = P(r) xor constante, resuelta
+// con dos tablas de 12 bits
+static void aplicarTransformacion(const TablaVerdad *t, FormaNPN *forma) {
+    int n = t->n;
+    uint32_t bajo[4096], alto[4096], constante = 0;
+    int posCanonica[MAX_VARIABLES];     // bit de fila canónico de cada bit original
+    for (int j = 0; j < n; j++) {
+        posCanonica[n - 1 - forma->origen[j]] = n - 1 - j;
+        if ((forma->negadas >> j) & 1) constante |= 1u << (n - 1 - j);
+    }
+    for (uint32_t x = 0; x < 4096; x++) {
+        uint32_t b = 0, a = 0;
+        for (int p = 0; p < 12 && p < n; p++) {
+            if ((x >> p) & 1) b |= 1u << posCanonica[p];
+            if (p + 12 < n && ((x >> p) & 1)) a |= 1u << posCanonica[p + 12];
+        }
+        bajo[x] = b;
+        alto[x] = a;
+    }
+
+    uint64_t valida = mascaraFilas(n);
+    for (size_t w = 0; w < t->palabras; w++) {
+        uint64_t dc = t->indiferentes ? t->indiferentes[w] : 0;
+        uint64_t x = forma->salidaNegada ? (~t->bits[w] & ~dc) : t->bits[w];
+        if (w == t->palabras - 1) x &= valida;
+        for (int k = 0; k < 2; k++) {
+            uint64_t *destino = k ? forma->tabla.indiferentes : forma->tabla.bits;
+            uint64_t y = k ? dc : x;
+            while (y) {
+                uint32_t r = (uint32_t)((w << 6) + (size_t)__builtin_ctzll(y));
+                y &= y - 1;
+                uint32_t r2 = bajo[r & 4095] ^ alto[r >> 12] ^ constante;
+                destino[r2 >> 6] |= 1ULL << (r2 & 63);
+            }
+        }
+    }
+}
+
+// Semicanónica para n > 6: salida con menos unos que ceros, cada entrada
+// con más unos en su cofactor negativo, y entradas ordenadas por la
+// cantidad de unos de su cofactor positivo. Si dos funciones dan la misma
+// forma son equivalentes; algunas equivalentes pueden dar formas distintas.
+static void canonicaHeuristica(const TablaVerdad *t, FormaNPN *forma) {
+    int n = t->n;
+    size_t filas = numFilas(t), indiferentes = 0, unos = contarMinterminos(t);
+    if (t->indiferentes) {
+        for (size_t w = 0; w < t->palabras; w++) indiferentes += (size_t)__builtin_popcountll(t->indiferentes[w]);
+    }
+    forma->salidaNegada = unos > filas - unos - indiferentes;
+
+    uint64_t *on = malloc(t->palabras * sizeof(uint64_t));
+    size_t positivo[MAX_VARIABLES];
+    if (on == NULL) {
+        // Sin memoria: la identidad también es una forma válida
+        for (int j = 0; j < n; j++) forma->origen[j] = j;
+        forma->negadas = 0;
+        forma->salidaNegada = 0;
+        aplicarTransformacion(t, forma);
+        return;
+    }
+    for (size_t w = 0; w < t->palabras; w++) {
+        uint64_t dc = t->indiferentes ? t->indiferentes[w] : 0;
+        on[w] = forma->salidaNegada ? (~t->bits[w] & ~dc) : t->bits[w];
+    }
+    on[t->palabras - 1] &= mascaraFilas(n);
+    size_t total = forma->salidaNegada ? filas - unos - indiferentes : unos;
+
+    uint32_t negadasOriginal = 0;
+    for (int v = 0; v < n; v++) {
+        positivo[v] = contarCofactor(t, on, v);
+        if (positivo[v] > total - positivo[v]) {
+            negadasOriginal |= 1u << v;
+            positivo[v] = total - positivo[v];
+        }
+        forma->origen[v] = v;
+    }
+    free(on);
+
+    // Orden estable por cofactor positivo (menos unos primero)
+    for (int i = 1; i < n; i++) {
+        int v = forma->origen[i], j = i;
+        while (j > 0 && positivo[forma->origen[j - 1]] > positivo[v]) {
+            forma->origen[j] = forma->origen[j - 1];
+            j--;
+        }
+        forma->origen[j] = v;
+    }
+    forma->negadas = 0;
+    for (int j = 0; j < n; j++) {
+        if ((negadasOriginal >> forma->origen[j]) & 1) forma->negadas |= 1u << j;
+    }
+    aplicarTransformacion(t, forma);
+}
+
+static uint64_t hashTabla(const TablaVerdad *t) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ (uint64_t)t->n;
+    for (size_t w = 0; w < t->palabras; w++) {
+        h = (h ^ t->bits[w]) * 0x100000001b3ULL;
+        h ^= h >> 29;
+        if (t->indiferentes) h = (h ^ t->indiferentes[w]) * 0x100000001b3ULL;
+    }
+    return h ^ (h >> 32);
+}
+
+int formaCanonicaNPN(const TablaVerdad *t, FormaNPN *forma) {
+    if (!crearTabla(&forma->tabla, t->n)) return 0;
+    if (t->indiferentes) {
+        forma->tabla.indiferentes = calloc(t->palabras, sizeof(uint64_t));
+        if (forma->tabla.indiferentes == NULL) {
+            liberarTabla(&forma->tabla);
+            return 0;
+        }
+    }
+    if (t->n <= MAX_VARIABLES_NPN_EXACTO) canonicaExacta(t, forma);
+    else canonicaHeuristica(t, forma);
+    forma->hash = hashTabla(&forma->tabla);
+    return 1;
+}
+
+void liberarFormaNPN(FormaNPN *forma) {
+    liberarTabla(&forma->tabla);
+}
+
+// Traduce un cubo de la forma canónica a las variables originales
+static Cubo cuboOriginal(const FormaNPN *forma, Cubo c) {
+    int n = forma->tabla.n;
+    Cubo r = { 0, 0 };
+    for (int j = 0; j < n; j++) {
+        uint32_t b = 1u << (n - 1 - j);
+        if (!(c.cuidado & b)) continue;
+        uint32_t q = 1u << (n - 1 - forma->origen[j]);
+        r.cuidado |= q;
+        if (((c.valor & b) != 0) != (((forma->negadas >> j) & 1) != 0)) r.valor |= q;
+    }
+    return r;
+}
+
+// ===================== Cache persistente =====================
+
+#define MAGIA_CACHE "NPNCACH1"
+#define CUBETAS_CACHE (1u << 18)
+#define TAM_INICIAL_CACHE ((size_t)16 << 20)
+
+typedef struct {
+    char magia[8];
+    uint64_t usado;         // fin de los datos
+    uint64_t entradas;
+    uint32_t cubetas;
+    uint32_t reservado;
+} EncabezadoCache;
+
+// Registro: encabezado, on[palabras], dc[palabras] (si hay), cubos SOP y POS
+typedef struct {
+    uint64_t hash;
+    uint64_t siguiente;     // desplazamiento del siguiente en la cubeta (0 = fin)
+    uint32_t n;
+    uint32_t conIndiferentes;
+    uint32_t numSop;
+    uint32_t numPos;
+} RegistroCache;
+
+static uint64_t *cubetasCache(CacheNPN *c) {
+    return (uint64_t *)(c->mapa + sizeof(EncabezadoCache));
+}
+
+static int mapearCache(CacheNPN *c, size_t tam) {
+    if (c->mapa) munmap(c->mapa, c->tamMapa);
+    c->mapa = mmap(NULL, tam, PROT_READ | PROT_WRITE, MAP_SHARED, c->fd, 0);
+    if (c->mapa == MAP_FAILED) {
+        c->mapa = NULL;
+        return 0;
+    }
+    c->tamMapa = tam;
+    return 1;
+}
+
+int abrirCacheNPN(CacheNPN *c, const char *ruta) {
+    memset(c, 0, sizeof(*c));
+    c->fd = open(ruta, O_RDWR | O_CREAT, 0644);
+    if (c->fd < 0) return 0;
+    // Un solo proceso escribe el cache a la vez
+    if (flock(c->fd, LOCK_EX | LOCK_NB) != 0) {
+        close(c->fd);
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(c->fd, &st) != 0) { close(c->fd); return 0; }
+    size_t minimo = sizeof(EncabezadoCache) + CUBETAS_CACHE * sizeof(uint64_t);
+    int nuevo = (size_t)st.st_size < minimo;
+    size_t tam = nuevo ? TAM_INICIAL_CACHE : (size_t)st.st_size;
+    if ((nuevo && ftruncate(c->fd, (off_t)tam) != 0) || !mapearCache(c, tam)) {
+        close(c->fd);
+        return 0;
+    }
+
+    EncabezadoCache *e = (EncabezadoCache *)c->mapa;
+    if (nuevo) {
+        memset(c->mapa, 0, minimo);
+        memcpy(e->magia, MAGIA_CACHE, 8);
+        e->cubetas = CUBETAS_CACHE;
+        e->usado = minimo;
+    } else if (memcmp(e->magia, MAGIA_CACHE, 8) != 0 || e->cubetas != CUBETAS_CACHE || e->usado > tam) {
+        fprintf(stderr, "Error: %s no es un cache NPN válido\n", ruta);
+        munmap(c->mapa, c->tamMapa);
+        close(c->fd);
+        return 0;
+    }
+    pthread_mutex_init(&c->cerrojo, NULL);
+    return 1;
+}
+
+void cerrarCacheNPN(CacheNPN *c) {
+    if (c->mapa == NULL) return;
+    msync(c->mapa, c->tamMapa, MS_ASYNC);
+    munmap(c->mapa, c->tamMapa);
+    close(c->fd);
+    pthread_mutex_destroy(&c->cerrojo);
+    c->mapa = NULL;
+}
+
+size_t entradasCacheNPN(CacheNPN *c) {
+    return c->mapa ? (size_t)((EncabezadoCache *)c->mapa)->entradas : 0;
+}
+
+// Busca la forma canónica y copia sus coberturas (en variables canónicas)
+static int buscarEnCache(CacheNPN *c, const FormaNPN *forma, Cobertura *sop, Cobertura *pos) {
+    const TablaVerdad *t = &forma->tabla;
+    uint64_t desp = cubetasCache(c)[forma->hash & (CUBETAS_CACHE - 1)];
+    size_t bytesTabla = t->palabras * sizeof(uint64_t);
+    while (desp != 0) {
+        if (desp + sizeof(RegistroCache) > c->tamMapa) return 0;
+        const RegistroCache *r = (const RegistroCache *)(c->mapa + desp);
+        const unsigned char *datos = (const unsigned char *)(r + 1);
+        if (r->hash == forma->hash && r->n == (uint32_t)t->n &&
+            r->conIndiferentes == (t->indiferentes != NULL) &&
+            memcmp(datos, t->bits, bytesTabla) == 0 &&
+            (!t->indiferentes || memcmp(datos + bytesTabla, t->indiferentes, bytesTabla) == 0)) {
+            const Cubo *cubos = (const Cubo *)(datos + bytesTabla * (t->indiferentes ? 2 : 1));
+            for (uint32_t i = 0; i < r->numSop; i++) {
+                if (!agregarCubo(sop, cubos[i])) return 0;
+            }
+            for (uint32_t i = 0; i < r->numPos; i++) {
+                if (!agregarCubo(pos, cubos[r->numSop + i])) return 0;
+            }
+            return 1;
+        }
+        desp = r->siguiente;
+    }
+    return 0;
+}
+
+static int guardarEnCache(CacheNPN *c, const FormaNPN *forma, const Cobertura *sop, const Cobertura *pos) {
+    const TablaVerdad *t = &forma->tabla;
+    size_t bytesTabla = t->palabras * sizeof(uint64_t);
+    size_t tam = sizeof(RegistroCache) + bytesTabla * (t->indiferentes ? 2 : 1) +
+                 (sop->cantidad + pos->cantidad) * sizeof(Cubo);
+    tam = (tam + 7) & ~(size_t)7;
+
+    EncabezadoCache *e = (EncabezadoCache *)c->mapa;
+    if (e->usado + tam > c->tamMapa) {
+        size_t nuevo = c->tamMapa * 2;
+        while (nuevo < e->usado + tam) nuevo *= 2;
+        if (ftruncate(c->fd, (off_t)nuevo) != 0 || !mapearCache(c, nuevo)) return 0;
+        e = (EncabezadoCache *)c->mapa;
+    }
+
+    uint64_t desp = e->usado;
+    RegistroCache *r = (RegistroCache *)(c->mapa + desp);
+    unsigned char *datos = (unsigned char *)(r + 1);
+    uint64_t *cubeta = &cubetasCache(c)[forma->hash & (CUBETAS_CACHE - 1)];
+    r->hash = forma->hash;
+    r->siguiente = *cubeta;
+    r->n = (uint32_t)t->n;
+    r->conIndiferentes = t->indiferentes != NULL;
+    r->numSop = (uint32_t)sop->cantidad;
+    r->numPos = (uint32_t)pos->cantidad;
+    memcpy(datos, t->bits, bytesTabla);
+    if (t->indiferentes) memcpy(datos + bytesTabla, t->indiferentes, bytesTabla);
+    Cubo *cubos = (Cubo *)(datos + bytesTabla * (t->indiferentes ? 2 : 1));
+    if (sop->cantidad) memcpy(cubos, sop->cubos, sop->cantidad * sizeof(Cubo));
+    if (pos->cantidad) memcpy(cubos + sop->cantidad, pos->cubos, pos->cantidad * sizeof(Cubo));
+
+    // El registro queda completo antes de enlazarlo en la cubeta
+    e->usado += tam;
+    e->entradas++;
+    *cubeta = desp;
+    return 1;
+}
+
+// Verdadero si la cobertura cubre 'on' sin salirse de 'permitido'
+static int coberturaExacta(int n, const Cobertura *cob, const uint64_t *on, const uint64_t *permitido,
+                           size_t palabras) {
+    uint64_t *cubierto = calloc(palabras, sizeof(uint64_t));
+    int ok = cubierto != NULL;
+    for (size_t i = 0; ok && i < cob->cantidad; i++) {
+        ok = cuboContenido(n, cob->cubos[i], permitido);
+        marcarCubo(n, cob->cubos[i], cubierto);
+    }
+    for (size_t w = 0; ok && w < palabras; w++) ok = (on[w] & ~cubierto[w]) == 0;
+    free(cubierto);
+    return ok;
+}
+
+// Pasa las coberturas canónicas a la función original y las verifica
+// contra su tabla (protege de un cache dañado)
+static int traducirCoberturas(const TablaVerdad *t, const FormaNPN *forma, const Cobertura *sopC,
+                              const Cobertura *posC, Cobertura *sop, Cobertura *pos) {
+    // Con la salida negada, los unos de la canónica son los ceros de la original
+    const Cobertura *paraSop = forma->salidaNegada ? posC : sopC;
+    const Cobertura *paraPos = forma->salidaNegada ? sopC : posC;
+    for (size_t i = 0; i < paraSop->cantidad; i++) {
+        if (!agregarCubo(sop, cuboOriginal(forma, paraSop->cubos[i]))) return 0;
+    }
+    for (size_t i = 0; i < paraPos->cantidad; i++) {
+        if (!agregarCubo(pos, cuboOriginal(forma, paraPos->cubos[i]))) return 0;
+    }
+
+    uint64_t *permSop = malloc(t->palabras * sizeof(uint64_t));
+    uint64_t *onPos = malloc(t->palabras * sizeof(uint64_t));
+    uint64_t *permPos = malloc(t->palabras * sizeof(uint64_t));
+    int ok = permSop && onPos && permPos;
+    for (size_t w = 0; ok && w < t->palabras; w++) {
+        uint64_t dc = t->indiferentes ? t->indiferentes[w] : 0;
+        uint64_t valida = (w == t->palabras - 1) ? mascaraFilas(t->n) : ~0ULL;
+        permSop[w] = t->bits[w] | dc;
+        permPos[w] = ~t->bits[w] & valida;
+        onPos[w] = permPos[w] & ~dc;
+    }
+    ok = ok && coberturaExacta(t->n, sop, t->bits, permSop, t->palabras) &&
+         coberturaExacta(t->n, pos, onPos, permPos, t->palabras);
+    free(permSop);
+    free(onPos);
+    free(permPos);
+    return ok;
+}
+
+// Minimiza usando el cache: un acierto cuesta la forma canónica y una
+// búsqueda por hash; un fallo minimiza la forma canónica y la guarda
+int minimizarConCache(CacheNPN *c, const TablaVerdad *t, ModoMinimizacion modo, Cobertura *sop, Cobertura *pos) {
+    FormaNPN forma;
+    Cobertura sopC, posC;
+    iniciarCobertura(sop, t->n);
+    iniciarCobertura(pos, t->n);
+    iniciarCobertura(&sopC, t->n);
+    iniciarCobertura(&posC, t->n);
+    if (!formaCanonicaNPN(t, &forma)) return 0;
+
+    pthread_mutex_lock(&c->cerrojo);
+    int acierto = buscarEnCache(c, &forma, &sopC, &posC);
+    pthread_mutex_unlock(&c->cerrojo);
+
+    int ok = 0;
+    if (acierto) {
+        ok = traducirCoberturas(t, &forma, &sopC, &posC, sop, pos);
+        if (!ok) {
+            liberarCobertura(sop);
+            liberarCobertura(pos);
+            iniciarCobertura(sop, t->n);
+            iniciarCobertura(pos, t->n);
+        }
+    }
+    if (!ok) {
+        liberarCobertura(&sopC);
+        liberarCobertura(&posC);
+        ok = minimizarSOP(&forma.tabla, modo, &sopC) && minimizarPOS(&forma.tabla, modo, &posC) &&
+             traducirCoberturas(t, &forma, &sopC, &posC, sop, pos);
+        if (ok) {
+            pthread_mutex_lock(&c->cerrojo);
+            if (!acierto && !guardarEnCache(c, &forma, &sopC, &posC)) {
+                fprintf(stderr, "Aviso: No se pudo ampliar el cache NPN\n");
+            }
+            c->fallos++;
+            pthread_mutex_unlock(&c->cerrojo);
+        }
+    } else {
+        pthread_mutex_lock(&c->cerrojo);
+        c->aciertos++;
+        pthread_mutex_unlock(&c->cerrojo);
+    }
+
+    if (ok) {
+        ordenarCobertura(sop);
+        ordenarCobertura(pos);
+    }
+    liberarCobertura(&sopC);
+    liberarCobertura(&posC);
+    liberarFormaNPN(&forma);
+    return ok;
+}
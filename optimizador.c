@@ -0,0 +1,650 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "planificador.h"
+
+// Programación lineal entera para el plan de producción:
+//   max c·x   sujeto a   A x <= b,  0 <= x <= u,  x entero
+// A se guarda por columnas (CSC): con miles de productos y pocas filas casi
+// todo el trabajo es recorrer columnas. El simplex es revisado con cotas (las
+// variables no básicas están en su cota inferior o superior) y mantiene la
+// inversa de la base densa de m x m. Las ramas del branch and bound cambian
+// cotas y reoptimizan con simplex dual desde la base del nodo anterior.
+
+#define EPS_PIVOTE 1e-9
+#define EPS_FACTIBLE 1e-7
+#define EPS_COSTO 1e-9
+#define EPS_ENTERO 1e-6
+#define REFACTORIZAR_CADA 100
+#define MAX_ITERACIONES_LP 50000
+#define MAX_DEGENERADOS 50      // pasos sin avance antes de pasar a la regla de Bland
+
+// ===================== Armado del problema =====================
+
+int iniciarProblema(ProblemaEntero *p, int filas, const double *limites) {
+    memset(p, 0, sizeof(*p));
+    p->filas = filas;
+    p->limites = malloc((size_t)filas * sizeof(double));
+    p->inicioColumna = malloc(sizeof(size_t));
+    if(p->limites == NULL || p->inicioColumna == NULL) {
+        liberarProblema(p);
+        return 0;
+    }
+    memcpy(p->limites, limites, (size_t)filas * sizeof(double));
+    p->inicioColumna[0] = 0;
+    return 1;
+}
+
+void liberarProblema(ProblemaEntero *p) {
+    free(p->limites);
+    free(p->inicioColumna);
+    free(p->filaElemento);
+    free(p->valorElemento);
+    free(p->costos);
+    free(p->cotas);
+    memset(p, 0, sizeof(*p));
+}
+
+// Agrega la variable x_j con sus k coeficientes no nulos
+int agregarColumna(ProblemaEntero *p, double costo, double cota, int k, const int *filas, const double *valores) {
+    if(p->columnas == p->capacidadColumnas) {
+        size_t nueva = p->capacidadColumnas ? 2 * p->capacidadColumnas : 64;
+        size_t *inicio = realloc(p->inicioColumna, (nueva + 1) * sizeof(size_t));
+        if(inicio == NULL) return 0;
+        p->inicioColumna = inicio;
+        double *c = realloc(p->costos, nueva * sizeof(double));
+        if(c == NULL) return 0;
+        p->costos = c;
+        double *u = realloc(p->cotas, nueva * sizeof(double));
+        if(u == NULL) return 0;
+        p->cotas = u;
+        p->capacidadColumnas = nueva;
+    }
+    if(p->elementos + (size_t)k > p->capacidadElementos) {
+        size_t nueva = p->capacidadElementos ? 2 * p->capacidadElementos : 256;
+        while(nueva < p->elementos + (size_t)k) nueva *= 2;
+        int *f = realloc(p->filaElemento, nueva * sizeof(int));
+        if(f == NULL) return 0;
+        p->filaElemento = f;
+        double *v = realloc(p->valorElemento, nueva * sizeof(double));
+        if(v == NULL) return 0;
+        p->valorElemento = v;
+        p->capacidadElementos = nueva;
+    }
+    for(int e = 0; e < k; e++) {
+        p->filaElemento[p->elementos] = filas[e];
+        p->valorElemento[p->elementos] = valores[e];
+        p->elementos++;
+    }
+    p->costos[p->columnas] = costo;
+    p->cotas[p->columnas] = cota;
+    p->columnas++;
+    p->inicioColumna[p->columnas] = p->elementos;
+    return 1;
+}
+
+// ===================== Simplex con cotas =====================
+
+enum { BASICA, EN_INFERIOR, EN_SUPERIOR };
+
+// Variables 0..n-1 son las columnas del problema y n..n+m-1 las holguras
+typedef struct {
+    const ProblemaEntero *p;
+    int m;
+    size_t n, total;
+    double *inferior;
+    double *superior;
+    double *x;
+    unsigned char *estado;
+    size_t *base;           // variable básica de cada fila
+    double *binv;           // inversa de la base, por filas (m x m)
+    double *y;              // precios duales
+    double *alfa;           // columna entrante expresada en la base
+    int pivotes;            // desde la última refactorización
+} Simplex;
+
+static double costoVariable(const Simplex *s, size_t j) {
+    return (j < s->n) ? s->p->costos[j] : 0.0;
+}
+
+// v · A_j
+static double productoColumna(const Simplex *s, size_t j, const double *v) {
+    if(j >= s->n) return v[j - s->n];
+    const ProblemaEntero *p = s->p;
+    double suma = 0.0;
+    for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+        suma += v[p->filaElemento[e]] * p->valorElemento[e];
+    }
+    return suma;
+}
+
+// salida = B^-1 A_j
+static void columnaEnBase(const Simplex *s, size_t j, double *salida) {
+    int m = s->m;
+    if(j >= s->n) {
+        size_t k = j - s->n;
+        for(int i = 0; i < m; i++) salida[i] = s->binv[(size_t)i * m + k];
+        return;
+    }
+    const ProblemaEntero *p = s->p;
+    for(int i = 0; i < m; i++) salida[i] = 0.0;
+    for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+        size_t k = (size_t)p->filaElemento[e];
+        double v = p->valorElemento[e];
+        for(int i = 0; i < m; i++) salida[i] += s->binv[(size_t)i * m + k] * v;
+    }
+}
+
+// Recalcula B^-1 desde cero (Gauss-Jordan con pivoteo parcial)
+static int refactorizar(Simplex *s) {
+    int m = s->m;
+    size_t mm = (size_t)m * m;
+    double *b = calloc(mm, sizeof(double));
+    if(b == NULL) return 0;
+    for(int i = 0; i < m; i++) {
+        size_t j = s->base[i];
+        if(j >= s->n) {
+            b[(j - s->n) * m + i] = 1.0;
+        } else {
+            const ProblemaEntero *p = s->p;
+            for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+                b[(size_t)p->filaElemento[e] * m + i] = p->valorElemento[e];
+            }
+        }
+    }
+    double *inv = s->binv;
+    memset(inv, 0, mm * sizeof(double));
+    for(int i = 0; i < m; i++) inv[(size_t)i * m + i] = 1.0;
+
+    int ok = 1;
+    for(int c = 0; c < m && ok; c++) {
+        int piv = c;
+        for(int r = c + 1; r < m; r++) {
+            if(fabs(b[(size_t)r * m + c]) > fabs(b[(size_t)piv * m + c])) piv = r;
+        }
+        if(fabs(b[(size_t)piv * m + c]) < EPS_PIVOTE) {
+            ok = 0;
+            break;
+        }
+        if(piv != c) {
+            for(int k = 0; k < m; k++) {
+                double t = b[(size_t)c * m + k]; b[(size_t)c * m + k] = b[(size_t)piv * m + k]; b[(size_t)piv * m + k] = t;
+                t = inv[(size_t)c * m + k]; inv[(size_t)c * m + k] = inv[(size_t)piv * m + k]; inv[(size_t)piv * m + k] = t;
+            }
+        }
+        double d = b[(size_t)c * m + c];
+        for(int k = 0; k < m; k++) {
+            b[(size_t)c * m + k] /= d;
+            inv[(size_t)c * m + k] /= d;
+        }
+        for(int r = 0; r < m; r++) {
+            double f = b[(size_t)r * m + c];
+            if(r == c || f == 0.0) continue;
+            for(int k = 0; k < m; k++) {
+                b[(size_t)r * m + k] -= f * b[(size_t)c * m + k];
+                inv[(size_t)r * m + k] -= f * inv[(size_t)c * m + k];
+            }
+        }
+    }
+    free(b);
+    s->pivotes = 0;
+    return ok;
+}
+
+// x_B = B^-1 (b - N x_N), con cada no básica en la cota que indica su estado
+static void recalcularBasicas(Simplex *s) {
+    int m = s->m;
+    double *r = s->y;       // se usa como temporal
+    memcpy(r, s->p->limites, (size_t)m * sizeof(double));
+    for(size_t j = 0; j < s->total; j++) {
+        if(s->estado[j] == BASICA) continue;
+        s->x[j] = (s->estado[j] == EN_INFERIOR) ? s->inferior[j] : s->superior[j];
+        if(s->x[j] == 0.0) continue;
+        if(j >= s->n) {
+            r[j - s->n] -= s->x[j];
+        } else {
+            const ProblemaEntero *p = s->p;
+            for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+                r[p->filaElemento[e]] -= p->valorElemento[e] * s->x[j];
+            }
+        }
+    }
+    for(int i = 0; i < m; i++) {
+        double v = 0.0;
+        for(int k = 0; k < m; k++) v += s->binv[(size_t)i * m + k] * r[k];
+        s->x[s->base[i]] = v;
+    }
+}
+
+static void calcularDuales(Simplex *s) {
+    int m = s->m;
+    for(int k = 0; k < m; k++) s->y[k] = 0.0;
+    for(int i = 0; i < m; i++) {
+        double c = costoVariable(s, s->base[i]);
+        if(c == 0.0) continue;
+        for(int k = 0; k < m; k++) s->y[k] += c * s->binv[(size_t)i * m + k];
+    }
+}
+
+// La variable q entra a la base en la fila r (s->alfa = B^-1 A_q)
+static int pivotear(Simplex *s, int r, size_t q) {
+    int m = s->m;
+    double *filaR = &s->binv[(size_t)r * m];
+    double piv = s->alfa[r];
+    for(int k = 0; k < m; k++) filaR[k] /= piv;
+    for(int i = 0; i < m; i++) {
+        double f = s->alfa[i];
+        if(i == r || f == 0.0) continue;
+        double *fila = &s->binv[(size_t)i * m];
+        for(int k = 0; k < m; k++) fila[k] -= f * filaR[k];
+    }
+    s->base[r] = q;
+    s->estado[q] = BASICA;
+    if(++s->pivotes >= REFACTORIZAR_CADA) {
+        if(!refactorizar(s)) return 0;
+        recalcularBasicas(s);
+    }
+    return 1;
+}
+
+// Prueba del cociente para la entrante q (s->alfa = B^-1 A_q) moviéndose en
+// la dirección dir. Devuelve el paso; *fila = -1 si lo que limita es la otra
+// cota de la propia entrante.
+static double cocientePrimal(const Simplex *s, size_t q, double dir, int *fila, int *haciaSuperior) {
+    double t = s->superior[q] - s->inferior[q];
+    *fila = -1;
+    *haciaSuperior = 0;
+    for(int i = 0; i < s->m; i++) {
+        double a = dir * s->alfa[i];
+        size_t b = s->base[i];
+        double limite;
+        if(a > EPS_PIVOTE) {
+            limite = (s->x[b] - s->inferior[b]) / a;
+        } else if(a < -EPS_PIVOTE && s->superior[b] < HUGE_VAL) {
+            limite = (s->superior[b] - s->x[b]) / -a;
+        } else {
+            continue;
+        }
+        if(limite < 0.0) limite = 0.0;
+        if(limite < t || (*fila >= 0 && limite == t && fabs(a) > fabs(dir * s->alfa[*fila]))) {
+            t = limite;
+            *fila = i;
+            *haciaSuperior = a < 0.0;
+        }
+    }
+    return t;
+}
+
+static void avanzar(Simplex *s, size_t q, double dir, double t) {
+    s->x[q] += dir * t;
+    for(int i = 0; i < s->m; i++) s->x[s->base[i]] -= dir * t * s->alfa[i];
+}
+
+static void cambiarDeCota(Simplex *s, size_t q) {
+    s->estado[q] = (s->estado[q] == EN_INFERIOR) ? EN_SUPERIOR : EN_INFERIOR;
+    s->x[q] = (s->estado[q] == EN_INFERIOR) ? s->inferior[q] : s->superior[q];
+}
+
+// Simplex primal desde una base factible. Devuelve 1 al llegar al óptimo,
+// 0 si el problema no está acotado y -1 ante un error numérico o el límite
+// de iteraciones.
+static int simplexPrimal(Simplex *s) {
+    int degenerados = 0;
+    for(int iter = 0; iter < MAX_ITERACIONES_LP; iter++) {
+        calcularDuales(s);
+        int bland = degenerados > MAX_DEGENERADOS;
+        size_t q = s->total;
+        double mejor = 0.0;
+        for(size_t j = 0; j < s->total; j++) {
+            if(s->estado[j] == BASICA || s->inferior[j] == s->superior[j]) continue;
+            double d = costoVariable(s, j) - productoColumna(s, j, s->y);
+            if(!((s->estado[j] == EN_INFERIOR && d > EPS_COSTO) || (s->estado[j] == EN_SUPERIOR && d < -EPS_COSTO))) {
+                continue;
+            }
+            // Si la entrante solo pasa a su otra cota la base no cambia y los
+            // precios duales siguen valiendo: se aplica sin cortar el recorrido
+            // (con miles de productos acotados por su demanda es el caso común)
+            int fila, haciaSuperior;
+            double dir = (s->estado[j] == EN_INFERIOR) ? 1.0 : -1.0;
+            columnaEnBase(s, j, s->alfa);
+            double t = cocientePrimal(s, j, dir, &fila, &haciaSuperior);
+            if(fila < 0 && t < HUGE_VAL) {
+                avanzar(s, j, dir, t);
+                cambiarDeCota(s, j);
+                continue;
+            }
+            if(bland) { q = j; break; }
+            if(fabs(d) > mejor) { mejor = fabs(d); q = j; }
+        }
+        if(q == s->total) return 1;
+
+        int r, haciaSuperior;
+        double dir = (s->estado[q] == EN_INFERIOR) ? 1.0 : -1.0;
+        columnaEnBase(s, q, s->alfa);
+        double t = cocientePrimal(s, q, dir, &r, &haciaSuperior);
+        if(t >= HUGE_VAL) return 0;
+        degenerados = (t < EPS_FACTIBLE) ? degenerados + 1 : 0;
+
+        avanzar(s, q, dir, t);
+        if(r < 0) {
+            cambiarDeCota(s, q);
+            continue;
+        }
+        size_t sale = s->base[r];
+        s->estado[sale] = haciaSuperior ? EN_SUPERIOR : EN_INFERIOR;
+        s->x[sale] = haciaSuperior ? s->superior[sale] : s->inferior[sale];
+        if(!pivotear(s, r, q)) return -1;
+    }
+    return -1;
+}
+
+// Simplex dual desde una base dual factible (la del nodo anterior después
+// de cambiar cotas). Devuelve 1 si recupera la factibilidad primal, 0 si el
+// nodo es infactible y -1 ante un error.
+static int simplexDual(Simplex *s) {
+    int m = s->m;
+    for(int iter = 0; iter < MAX_ITERACIONES_LP; iter++) {
+        // Fila que sale: la básica más fuera de sus cotas
+        int r = -1;
+        double peor = EPS_FACTIBLE;
+        for(int i = 0; i < m; i++) {
+            size_t b = s->base[i];
+            double v = s->inferior[b] - s->x[b];
+            if(s->x[b] - s->superior[b] > v) v = s->x[b] - s->superior[b];
+            if(v > peor) { peor = v; r = i; }
+        }
+        if(r < 0) return 1;
+
+        size_t sale = s->base[r];
+        int subir = s->x[sale] < s->inferior[sale];
+        double objetivo = subir ? s->inferior[sale] : s->superior[sale];
+        const double *filaR = &s->binv[(size_t)r * m];
+        calcularDuales(s);
+
+        // x_sale cambia en -a_j * dx_j: se busca la no básica que la mueve
+        // en la dirección correcta con el menor cociente |d_j / a_j|
+        size_t q = s->total;
+        double mejorCociente = HUGE_VAL, mejorA = 0.0;
+        for(size_t j = 0; j < s->total; j++) {
+            if(s->estado[j] == BASICA || s->inferior[j] == s->superior[j]) continue;
+            double a = productoColumna(s, j, filaR);
+            int sirve = (s->estado[j] == EN_INFERIOR) ? (subir ? a < -EPS_PIVOTE : a > EPS_PIVOTE)
+                                                      : (subir ? a > EPS_PIVOTE : a < -EPS_PIVOTE);
+            if(!sirve) continue;
+            double d = costoVariable(s, j) - productoColumna(s, j, s->y);
+            double cociente = fabs(d) / fabs(a);
+            if(cociente < mejorCociente || (cociente == mejorCociente && fabs(a) > fabs(mejorA))) {
+                mejorCociente = cociente;
+                mejorA = a;
+                q = j;
+            }
+        }
+        if(q == s->total) return 0;
+
+        columnaEnBase(s, q, s->alfa);
+        double dx = (s->x[sale] - objetivo) / s->alfa[r];
+        s->x[q] += dx;
+        for(int i = 0; i < m; i++) s->x[s->base[i]] -= dx * s->alfa[i];
+        s->estado[sale] = subir ? EN_INFERIOR : EN_SUPERIOR;
+        s->x[sale] = objetivo;
+        if(!pivotear(s, r, q)) return -1;
+    }
+    return -1;
+}
+
+static void liberarSimplex(Simplex *s) {
+    free(s->inferior);
+    free(s->superior);
+    free(s->x);
+    free(s->estado);
+    free(s->base);
+    free(s->binv);
+    free(s->y);
+    free(s->alfa);
+}
+
+// Base inicial de holguras con todas las variables en 0
+static int iniciarSimplex(Simplex *s, const ProblemaEntero *p) {
+    memset(s, 0, sizeof(*s));
+    s->p = p;
+    s->m = p->filas;
+    s->n = p->columnas;
+    s->total = s->n + (size_t)s->m;
+    s->inferior = malloc(s->total * sizeof(double));
+    s->superior = malloc(s->total * sizeof(double));
+    s->x = malloc(s->total * sizeof(double));
+    s->estado = malloc(s->total);
+    s->base = malloc((size_t)s->m * sizeof(size_t));
+    s->binv = malloc((size_t)s->m * s->m * sizeof(double) + 1);
+    s->y = malloc((size_t)s->m * sizeof(double) + 1);
+    s->alfa = malloc((size_t)s->m * sizeof(double) + 1);
+    if(!s->inferior || !s->superior || !s->x || !s->estado || !s->base || !s->binv || !s->y || !s->alfa) {
+        liberarSimplex(s);
+        return 0;
+    }
+    for(size_t j = 0; j < s->total; j++) {
+        s->inferior[j] = 0.0;
+        s->superior[j] = (j < s->n) ? p->cotas[j] : HUGE_VAL;
+        s->estado[j] = EN_INFERIOR;
+    }
+    for(int i = 0; i < s->m; i++) {
+        s->base[i] = s->n + (size_t)i;
+        s->estado[s->n + (size_t)i] = BASICA;
+    }
+    refactorizar(s);
+    recalcularBasicas(s);
+    return 1;
+}
+
+// ===================== Branch and bound =====================
+
+typedef struct {
+    Simplex s;
+    double *mejorX;
+    double mejorValor;
+    double *redondeo;       // temporales de la heurística
+    double *holgura;
+    size_t *ordenGreedy;    // columnas por densidad de valor decreciente
+    long nodos;
+    long limiteNodos;
+    int agotado;
+    int error;
+    int objetivoEntero;     // costos enteros: la cota de un nodo se redondea hacia abajo
+} Busqueda;
+
+static double valorObjetivo(const ProblemaEntero *p, const double *x) {
+    double v = 0.0;
+    for(size_t j = 0; j < p->columnas; j++) v += p->costos[j] * x[j];
+    return v;
+}
+
+// Heurística: redondea hacia abajo la solución del nodo y completa con
+// unidades enteras en orden de densidad de valor mientras haya holgura
+static void redondearYCompletar(Busqueda *b) {
+    const ProblemaEntero *p = b->s.p;
+    memcpy(b->holgura, p->limites, (size_t)p->filas * sizeof(double));
+    for(size_t j = 0; j < p->columnas; j++) {
+        b->redondeo[j] = floor(b->s.x[j] + EPS_ENTERO);
+        if(b->redondeo[j] < 0.0) b->redondeo[j] = 0.0;
+        for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+            b->holgura[p->filaElemento[e]] -= p->valorElemento[e] * b->redondeo[j];
+        }
+    }
+    for(int i = 0; i < p->filas; i++) {
+        if(b->holgura[i] < -EPS_FACTIBLE) return;
+    }
+    for(size_t k = 0; k < p->columnas; k++) {
+        size_t j = b->ordenGreedy[k];
+        double t = p->cotas[j] - b->redondeo[j];
+        for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1] && t > 0.0; e++) {
+            double a = p->valorElemento[e];
+            if(a > 0.0) {
+                double cabe = floor((b->holgura[p->filaElemento[e]] + EPS_FACTIBLE) / a);
+                if(cabe < t) t = cabe;
+            }
+        }
+        if(t <= 0.0) continue;
+        b->redondeo[j] += t;
+        for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+            b->holgura[p->filaElemento[e]] -= p->valorElemento[e] * t;
+        }
+    }
+    double v = valorObjetivo(p, b->redondeo);
+    if(v > b->mejorValor + EPS_ENTERO) {
+        b->mejorValor = v;
+        memcpy(b->mejorX, b->redondeo, p->columnas * sizeof(double));
+    }
+}
+
+// Búsqueda en profundidad; al volver de cada hijo la base queda como la dejó
+// él y el hermano arranca desde ahí (arranque en caliente)
+static void ramificar(Busqueda *b, double *cotaRaiz) {
+    Simplex *s = &b->s;
+    if(b->error) return;
+    if(b->nodos >= b->limiteNodos) {
+        b->agotado = 1;
+        return;
+    }
+    b->nodos++;
+
+    recalcularBasicas(s);
+    int r = simplexDual(s);
+    if(r == 1) r = simplexPrimal(s);
+    if(r == 0) return;              // infactible
+    if(r < 0) {
+        b->error = 1;
+        return;
+    }
+
+    double z = valorObjetivo(s->p, s->x);
+    double cota = b->objetivoEntero ? floor(z + EPS_ENTERO) : z;
+    if(cotaRaiz) *cotaRaiz = cota;
+    if(cota <= b->mejorValor + EPS_ENTERO) return;
+
+    // Variable más fraccionaria
+    size_t j = s->n;
+    double masFraccion = EPS_ENTERO;
+    for(size_t k = 0; k < s->n; k++) {
+        double f = s->x[k] - floor(s->x[k]);
+        double distancia = f < 0.5 ? f : 1.0 - f;
+        if(distancia > masFraccion) {
+            masFraccion = distancia;
+            j = k;
+        }
+    }
+    if(j == s->n) {
+        b->mejorValor = z;
+        for(size_t k = 0; k < s->n; k++) b->mejorX[k] = floor(s->x[k] + 0.5);
+        return;
+    }
+    redondearYCompletar(b);
+    if(cota <= b->mejorValor + EPS_ENTERO) return;
+
+    double v = s->x[j], inferior = s->inferior[j], superior = s->superior[j];
+    int primeroArriba = v - floor(v) > 0.5;
+    for(int hijo = 0; hijo < 2; hijo++) {
+        if((hijo == 0) == primeroArriba) s->inferior[j] = ceil(v);
+        else s->superior[j] = floor(v);
+        ramificar(b, NULL);
+        s->inferior[j] = inferior;
+        s->superior[j] = superior;
+    }
+}
+
+// Base inicial: siguen siendo básicas las holguras, pero cada columna que
+// entra entera (en orden de densidad) arranca en su cota superior. Así el
+// simplex parte cerca del óptimo y solo ajusta las columnas de la frontera
+// en lugar de hacer un pivote por cada producto.
+static void arrancarConGreedy(Busqueda *b) {
+    Simplex *s = &b->s;
+    const ProblemaEntero *p = s->p;
+    memcpy(b->holgura, p->limites, (size_t)p->filas * sizeof(double));
+    for(size_t k = 0; k < p->columnas; k++) {
+        size_t j = b->ordenGreedy[k];
+        double u = p->cotas[j];
+        int entra = p->costos[j] > 0.0 && u > 0.0;
+        for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1] && entra; e++) {
+            if(b->holgura[p->filaElemento[e]] - p->valorElemento[e] * u < 0.0) entra = 0;
+        }
+        if(!entra) continue;
+        for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+            b->holgura[p->filaElemento[e]] -= p->valorElemento[e] * u;
+        }
+        s->estado[j] = EN_SUPERIOR;
+    }
+    recalcularBasicas(s);
+}
+
+typedef struct {
+    double densidad;
+    size_t columna;
+} DensidadColumna;
+
+static int compararDensidad(const void *a, const void *b) {
+    double da = ((const DensidadColumna *)a)->densidad, db = ((const DensidadColumna *)b)->densidad;
+    return (da < db) - (da > db);
+}
+
+// Columnas por valor por unidad de capacidad consumida (suma de a_ij / b_i)
+static int ordenarPorDensidad(const ProblemaEntero *p, size_t *orden) {
+    DensidadColumna *d = malloc((p->columnas + 1) * sizeof(DensidadColumna));
+    if(d == NULL) return 0;
+    for(size_t j = 0; j < p->columnas; j++) {
+        double uso = 0.0;
+        for(size_t e = p->inicioColumna[j]; e < p->inicioColumna[j + 1]; e++) {
+            double limite = p->limites[p->filaElemento[e]];
+            if(p->valorElemento[e] > 0.0) uso += p->valorElemento[e] / (limite > 0.0 ? limite : EPS_FACTIBLE);
+        }
+        d[j].densidad = p->costos[j] / (uso > 0.0 ? uso : EPS_FACTIBLE);
+        d[j].columna = j;
+    }
+    qsort(d, p->columnas, sizeof(DensidadColumna), compararDensidad);
+    for(size_t j = 0; j < p->columnas; j++) orden[j] = d[j].columna;
+    free(d);
+    return 1;
+}
+
+// Resuelve el problema entero. Requiere b >= 0 (x = 0 es factible). En x
+// queda la mejor solución encontrada; si se agotan los nodos el estado es
+// PLAN_LIMITE_NODOS y 'cota' acota el óptimo desde arriba.
+ResultadoEntero resolverEntero(const ProblemaEntero *p, long limiteNodos, double *x) {
+    ResultadoEntero res = { PLAN_SIN_MEMORIA, 0.0, 0.0, 0 };
+    for(int i = 0; i < p->filas; i++) {
+        if(p->limites[i] < 0.0) {
+            res.estado = PLAN_INFACTIBLE;
+            return res;
+        }
+    }
+
+    Busqueda b;
+    memset(&b, 0, sizeof(b));
+    if(!iniciarSimplex(&b.s, p)) return res;
+    size_t n = p->columnas;
+    b.mejorX = calloc(n + 1, sizeof(double));
+    b.redondeo = malloc((n + 1) * sizeof(double));
+    b.holgura = malloc((size_t)p->filas * sizeof(double) + 1);
+    b.ordenGreedy = malloc((n + 1) * sizeof(size_t));
+    if(b.mejorX && b.redondeo && b.holgura && b.ordenGreedy && ordenarPorDensidad(p, b.ordenGreedy)) {
+        arrancarConGreedy(&b);
+        b.objetivoEntero = 1;
+        for(size_t j = 0; j < n; j++) {
+            if(p->costos[j] != floor(p->costos[j])) b.objetivoEntero = 0;
+        }
+        b.mejorValor = 0.0;         // x = 0
+        b.limiteNodos = limiteNodos > 0 ? limiteNodos : 1;
+        double cotaRaiz = 0.0;
+        ramificar(&b, &cotaRaiz);
+
+        memcpy(x, b.mejorX, n * sizeof(double));
+        res.valor = b.mejorValor;
+        res.cota = b.agotado ? (cotaRaiz > b.mejorValor ? cotaRaiz : b.mejorValor) : b.mejorValor;
+        res.nodos = b.nodos;
+        res.estado = b.error ? PLAN_ERROR_NUMERICO : (b.agotado ? PLAN_LIMITE_NODOS : PLAN_OPTIMO);
+    }
+    free(b.mejorX);
+    free(b.redondeo);
+    free(b.holgura);
+    free(b.ordenGreedy);
+    liberarSimplex(&b.s);
+    return res;
+}
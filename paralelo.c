@@ -0,0 +1,96 @@
+#include <string.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include "monitor.h"
+
+// Grupo de hilos que queda esperando entre rondas: en el monitoreo continuo
+// se reparte una ronda por cada tanda de lecturas y crear hilos cada vez
+// costaría más que procesar las zonas. En cada ronda los hilos toman bloques
+// de BLOQUE_ZONAS zonas consecutivas con un contador atómico (el que termina
+// antes toma más) y el que reparte trabaja como uno más.
+
+static void tomar_bloques(GrupoHilos *g, int hilo) {
+    for(;;) {
+        int desde = atomic_fetch_add_explicit(&g->siguiente, 1, memory_order_relaxed) * BLOQUE_ZONAS;
+        if(desde >= g->num_zonas) return;
+        int hasta = desde + BLOQUE_ZONAS < g->num_zonas ? desde + BLOQUE_ZONAS : g->num_zonas;
+        g->tarea(g->zonas, desde, hasta, hilo, g->datos);
+    }
+}
+
+static void *esperar_rondas(void *arg) {
+    HiloGrupo *h = arg;
+    GrupoHilos *g = h->grupo;
+    unsigned vista = 0;
+    pthread_mutex_lock(&g->mutex);
+    for(;;) {
+        while(!g->salir && g->ronda == vista) pthread_cond_wait(&g->hay_ronda, &g->mutex);
+        if(g->salir) break;
+        vista = g->ronda;
+        pthread_mutex_unlock(&g->mutex);
+        tomar_bloques(g, h->indice);
+        pthread_mutex_lock(&g->mutex);
+        if(--g->trabajando == 0) pthread_cond_signal(&g->fin_ronda);
+    }
+    pthread_mutex_unlock(&g->mutex);
+    return NULL;
+}
+
+// Función para lanzar el grupo (hilos 0 = uno por núcleo); con uno solo no
+// lanza nada y las rondas corren en el que llama
+int iniciar_grupo(GrupoHilos *g, int hilos) {
+    memset(g, 0, sizeof(*g));
+    if(hilos <= 0) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if(hilos > MAX_HILOS_ZONAS) hilos = MAX_HILOS_ZONAS;
+    if(pthread_mutex_init(&g->mutex, NULL) != 0) return 0;
+    if(pthread_cond_init(&g->hay_ronda, NULL) != 0 || pthread_cond_init(&g->fin_ronda, NULL) != 0) {
+        pthread_mutex_destroy(&g->mutex);
+        return 0;
+    }
+    g->num_hilos = 1;
+    for(int h = 1; h < hilos; h++) {
+        g->hilos[g->num_hilos] = (HiloGrupo){ g, g->num_hilos };
+        if(pthread_create(&g->ids[g->num_hilos], NULL, esperar_rondas, &g->hilos[g->num_hilos]) != 0) break;
+        g->num_hilos++;
+    }
+    return 1;
+}
+
+// Función para procesar todas las zonas con la tarea; vuelve cuando todos
+// los bloques están hechos
+void repartir_zonas(GrupoHilos *g, Zona *zonas, int num_zonas, TareaZonas tarea, void *datos) {
+    if(g->num_hilos == 1 || num_zonas <= BLOQUE_ZONAS) {
+        if(num_zonas > 0) tarea(zonas, 0, num_zonas, 0, datos);
+        return;
+    }
+    pthread_mutex_lock(&g->mutex);
+    g->tarea = tarea;
+    g->datos = datos;
+    g->zonas = zonas;
+    g->num_zonas = num_zonas;
+    atomic_store_explicit(&g->siguiente, 0, memory_order_relaxed);
+    g->trabajando = g->num_hilos - 1;
+    g->ronda++;
+    pthread_cond_broadcast(&g->hay_ronda);
+    pthread_mutex_unlock(&g->mutex);
+
+    tomar_bloques(g, 0);
+
+    pthread_mutex_lock(&g->mutex);
+    while(g->trabajando > 0) pthread_cond_wait(&g->fin_ronda, &g->mutex);
+    pthread_mutex_unlock(&g->mutex);
+}
+
+void cerrar_grupo(GrupoHilos *g) {
+    pthread_mutex_lock(&g->mutex);
+    g->salir = 1;
+    pthread_cond_broadcast(&g->hay_ronda);
+    pthread_mutex_unlock(&g->mutex);
+    for(int h = 1; h < g->num_hilos; h++) pthread_join(g->ids[h], NULL);
+    pthread_cond_destroy(&g->hay_ronda);
+    pthread_cond_destroy(&g->fin_ronda);
+    pthread_mutex_destroy(&g->mutex);
+}
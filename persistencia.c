@@ -0,0 +1,537 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "planificador.h"
+
+// Importación y exportación del catálogo con su modelo de capacidad.
+//
+// CSV: la primera línea es el encabezado "nombre,cantidad,ganancia" seguido de
+// una columna por par recurso-período ("Torno/Lunes", o "Torno" con un solo
+// período). Una línea que empieza con #disponible trae los límites de cada
+// columna; las demás son productos, con el consumo por unidad en cada columna
+// (vacío = 0). Los campos pueden ir entre comillas dobles como en RFC 4180.
+//
+// Instantánea binaria: una cabecera y las columnas del catálogo una tras
+// otra, en el orden de la máquina que la escribió; se lee con un solo read.
+
+#define MAX_CAMPO 256
+#define DISPONIBLE "#disponible"
+#define PERIODO_UNICO "Total"       // período de las columnas sin "/"
+
+// ===================== Lectura de CSV =====================
+
+typedef struct {
+    const char *p;
+    const char *fin;
+    long linea;
+} LectorCSV;
+
+typedef struct {
+    const char *texto;
+    size_t largo;
+    int entrecomillado;
+} Campo;
+
+enum { CAMPO_ERROR = -1, CAMPO_FIN = 0, CAMPO_SIGUE = 1 };
+
+// Lee el campo que empieza en l->p. Sin comillas apunta directo al archivo;
+// entre comillas se copia sin los escapes a 'copia'. Devuelve CAMPO_SIGUE si
+// termina en coma, CAMPO_FIN si termina la línea (o el archivo) y CAMPO_ERROR
+// si está mal formado.
+static int leerCampo(LectorCSV *l, Campo *c, char *copia) {
+    const char *p = l->p, *fin = l->fin;
+    c->entrecomillado = 0;
+    if(p < fin && *p == '"') {
+        size_t n = 0;
+        for(p++; ; p++) {
+            if(p == fin) return CAMPO_ERROR;        // comillas sin cerrar
+            if(*p == '"') {
+                if(p + 1 < fin && p[1] == '"') p++;
+                else break;
+            }
+            if(*p == '\n') l->linea++;
+            if(n < MAX_CAMPO - 1) copia[n++] = *p;
+        }
+        p++;
+        copia[n] = '\0';
+        c->texto = copia;
+        c->largo = n;
+        c->entrecomillado = 1;
+    } else {
+        const char *inicio = p;
+        while(p < fin && *p != ',' && *p != '\n') p++;
+        c->texto = inicio;
+        c->largo = (size_t)(p - inicio);
+        if(c->largo > 0 && inicio[c->largo - 1] == '\r') c->largo--;
+    }
+    if(p < fin && *p == '\r' && p + 1 < fin && p[1] == '\n') p++;
+    if(p == fin) {
+        l->p = p;
+        return CAMPO_FIN;
+    }
+    if(*p == ',') {
+        l->p = p + 1;
+        return CAMPO_SIGUE;
+    }
+    if(*p == '\n') {
+        l->p = p + 1;
+        l->linea++;
+        return CAMPO_FIN;
+    }
+    return CAMPO_ERROR;                             // texto después de las comillas
+}
+
+// Entero no negativo hasta 'maximo' (un campo vacío vale 0); 0 si no es válido
+static int campoEntero(const Campo *c, int64_t maximo, int64_t *valor) {
+    const char *s = c->texto, *fin = c->texto + c->largo;
+    while(s < fin && *s == ' ') s++;
+    while(fin > s && fin[-1] == ' ') fin--;
+    int64_t v = 0;
+    for(; s < fin; s++) {
+        if(*s < '0' || *s > '9') return 0;
+        v = v * 10 + (*s - '0');
+        if(v > maximo) return 0;
+    }
+    *valor = v;
+    return 1;
+}
+
+static void copiarCampo(const Campo *c, char *salida, size_t tam) {
+    snprintf(salida, tam, "%.*s", (int)c->largo, c->texto);
+}
+
+// Posición de 'nombre' en la lista (agregándolo si no está); -1 sin memoria
+static int posicionNombre(char (**nombres)[MAX_NOMBRE], int *n, const char *nombre) {
+    for(int i = 0; i < *n; i++) {
+        if(strcmp((*nombres)[i], nombre) == 0) return i;
+    }
+    char (*nuevos)[MAX_NOMBRE] = realloc(*nombres, (size_t)(*n + 1) * MAX_NOMBRE);
+    if(nuevos == NULL) return -1;
+    *nombres = nuevos;
+    snprintf(nuevos[*n], MAX_NOMBRE, "%s", nombre);
+    return (*n)++;
+}
+
+// Separa "Recurso/Período" (o "Recurso", del período único)
+static void separarColumna(const char *columna, char *recurso, char *periodo) {
+    const char *barra = strrchr(columna, '/');
+    if(barra == NULL) {
+        snprintf(recurso, MAX_NOMBRE, "%s", columna);
+        snprintf(periodo, MAX_NOMBRE, "%s", PERIODO_UNICO);
+    } else {
+        snprintf(recurso, MAX_NOMBRE, "%.*s", (int)(barra - columna), columna);
+        snprintf(periodo, MAX_NOMBRE, "%s", barra + 1);
+    }
+}
+
+// Arma el modelo con los recursos y períodos de las columnas, en el orden en
+// que aparecen (los límites quedan en 0 hasta la línea #disponible)
+static int modeloDesdeColumnas(ModeloCapacidad *m, char (*columnas)[MAX_NOMBRE], size_t n) {
+    char (*recursos)[MAX_NOMBRE] = NULL, (*periodos)[MAX_NOMBRE] = NULL;
+    int nRecursos = 0, nPeriodos = 0, ok = n > 0;
+    for(size_t c = 0; ok && c < n; c++) {
+        char recurso[MAX_NOMBRE], periodo[MAX_NOMBRE];
+        separarColumna(columnas[c], recurso, periodo);
+        ok = posicionNombre(&recursos, &nRecursos, recurso) >= 0 &&
+             posicionNombre(&periodos, &nPeriodos, periodo) >= 0;
+    }
+    if(ok) ok = definirModelo(m, nRecursos, recursos, nPeriodos, periodos);
+    free(recursos);
+    free(periodos);
+    return ok;
+}
+
+// Lee el encabezado y deja en filaColumna la fila del modelo de cada columna
+// de consumo. Si el catálogo todavía no tiene modelo, se arma con ellas.
+static int leerEncabezado(Catalogo *cat, LectorCSV *l, int **filaColumna, size_t *columnas) {
+    char (*nombres)[MAX_NOMBRE] = NULL;
+    char copia[MAX_CAMPO];
+    size_t n = 0, campos = 0;
+    int r = CAMPO_SIGUE, ok = 1;
+    while(ok && r == CAMPO_SIGUE) {
+        Campo c;
+        r = leerCampo(l, &c, copia);
+        if(r == CAMPO_ERROR) ok = 0;
+        else if(campos++ >= 3) {
+            char (*nuevos)[MAX_NOMBRE] = realloc(nombres, (n + 1) * MAX_NOMBRE);
+            if(nuevos == NULL) ok = 0;
+            else {
+                nombres = nuevos;
+                copiarCampo(&c, nombres[n++], MAX_NOMBRE);
+            }
+        }
+    }
+    if(ok && campos < 3) ok = 0;
+    if(ok && filasModelo(&cat->modelo) == 0) ok = modeloDesdeColumnas(&cat->modelo, nombres, n);
+
+    *filaColumna = ok ? malloc((n + 1) * sizeof(int)) : NULL;
+    if(*filaColumna == NULL) ok = 0;
+    const ModeloCapacidad *m = &cat->modelo;
+    for(size_t c = 0; ok && c < n; c++) {
+        char recurso[MAX_NOMBRE], periodo[MAX_NOMBRE];
+        separarColumna(nombres[c], recurso, periodo);
+        int rec = buscarRecurso(m, recurso);
+        int per = strrchr(nombres[c], '/') == NULL && m->periodos == 1 ? 0 : buscarPeriodo(m, periodo);
+        if(rec < 0 || per < 0) ok = 0;
+        else (*filaColumna)[c] = rec * m->periodos + per;
+    }
+    free(nombres);
+    if(!ok) {
+        free(*filaColumna);
+        *filaColumna = NULL;
+        return 0;
+    }
+    *columnas = n;
+    return 1;
+}
+
+static int lineaVacia(LectorCSV *l) {
+    const char *p = l->p;
+    if(p < l->fin && *p == '\r') p++;
+    if(p < l->fin && *p != '\n') return 0;
+    l->p = p < l->fin ? p + 1 : p;
+    l->linea++;
+    return 1;
+}
+
+// Agrega al catálogo los productos del CSV ya mapeado en memoria
+static int leerCSV(Catalogo *cat, LectorCSV *l, long *lineaError) {
+    int *filaColumna;
+    size_t columnas;
+    if(!leerEncabezado(cat, l, &filaColumna, &columnas)) {
+        *lineaError = 1;
+        return 0;
+    }
+    ElementoConsumo *consumo = malloc((columnas + 1) * sizeof(ElementoConsumo));
+    if(consumo == NULL) {
+        free(filaColumna);
+        return 0;
+    }
+
+    // Una línea por producto como mucho: se reservan las columnas de una vez
+    size_t lineas = 0;
+    for(const char *p = l->p; (p = memchr(p, '\n', (size_t)(l->fin - p))) != NULL; p++) lineas++;
+    reservarCatalogo(cat, lineas + 1, 0, 0);
+
+    int ok = 1;
+    char copia[MAX_CAMPO];
+    while(ok && l->p < l->fin) {
+        if(lineaVacia(l)) continue;
+        long linea = l->linea;
+        Campo c;
+        int r = leerCampo(l, &c, copia);
+        int disponible = !c.entrecomillado && c.largo == strlen(DISPONIBLE) && memcmp(c.texto, DISPONIBLE, c.largo) == 0;
+        char nombre[MAX_NOMBRE];
+        int64_t cantidad = 0, ganancia = 0, valor;
+        size_t k = 0;
+        copiarCampo(&c, nombre, sizeof(nombre));
+        if(r == CAMPO_ERROR || (!disponible && nombre[0] == '\0')) ok = 0;
+
+        for(size_t col = 1; ok && r == CAMPO_SIGUE; col++) {
+            r = leerCampo(l, &c, copia);
+            if(r == CAMPO_ERROR || col >= columnas + 3) {
+                ok = 0;
+            } else if(col < 3) {
+                if(!disponible) ok = campoEntero(&c, INT32_MAX, col == 1 ? &cantidad : &ganancia);
+            } else if(disponible) {
+                ok = campoEntero(&c, INT64_MAX, &valor);
+                if(ok && c.largo > 0) fijarLimite(&cat->modelo, filaColumna[col - 3], valor);
+            } else {
+                ok = campoEntero(&c, INT32_MAX, &valor);
+                if(ok && valor > 0) {
+                    consumo[k].fila = (uint32_t)filaColumna[col - 3];
+                    consumo[k].valor = (int)valor;
+                    k++;
+                }
+            }
+        }
+        if(ok && !disponible) ok = agregarProducto(cat, nombre, (int)cantidad, (int)ganancia, k, consumo) >= 0;
+        if(!ok) *lineaError = linea;
+    }
+    free(consumo);
+    free(filaColumna);
+    return ok;
+}
+
+// Agrega los productos de un CSV (y toma sus límites). Si falla, lineaError
+// queda en la línea con el problema (0 si no se pudo leer el archivo o no
+// hubo memoria); los productos de las líneas anteriores quedan agregados.
+int importarCSV(Catalogo *cat, const char *ruta, long *lineaError) {
+    *lineaError = 0;
+    int fd = open(ruta, O_RDONLY);
+    if(fd < 0) return 0;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    if(st.st_size == 0) {
+        close(fd);
+        *lineaError = 1;
+        return 0;
+    }
+    char *datos = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(datos == MAP_FAILED) return 0;
+    madvise(datos, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    LectorCSV l = { datos, datos + st.st_size, 1 };
+    int ok = leerCSV(cat, &l, lineaError);
+    munmap(datos, (size_t)st.st_size);
+    return ok;
+}
+
+// ===================== Escritura de CSV =====================
+
+static void escribirCampo(FILE *f, const char *texto) {
+    if(strpbrk(texto, ",\"\r\n") == NULL && texto[0] != '#') {
+        fputs(texto, f);
+        return;
+    }
+    putc('"', f);
+    for(; *texto; texto++) {
+        if(*texto == '"') putc('"', f);
+        putc(*texto, f);
+    }
+    putc('"', f);
+}
+
+// Sin printf: en catálogos grandes el formateo es casi todo el costo
+static void escribirEntero(FILE *f, int64_t v) {
+    char buf[24];
+    int n = 0;
+    uint64_t u = v < 0 ? -(uint64_t)v : (uint64_t)v;
+    do {
+        buf[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while(u);
+    if(v < 0) putc('-', f);
+    while(n > 0) putc(buf[--n], f);
+}
+
+int exportarCSV(const Catalogo *cat, const char *ruta) {
+    const ModeloCapacidad *m = &cat->modelo;
+    int filas = filasModelo(m);
+    int *fila = calloc((size_t)filas + 1, sizeof(int));
+    FILE *f = fopen(ruta, "w");
+    if(fila == NULL || f == NULL) {
+        free(fila);
+        if(f) fclose(f);
+        return 0;
+    }
+    setvbuf(f, NULL, _IOFBF, 1 << 16);
+
+    fputs("nombre,cantidad,ganancia", f);
+    for(int c = 0; c < filas; c++) {
+        char nombre[2 * MAX_NOMBRE];
+        nombreFila(m, c, nombre, sizeof(nombre));
+        if(m->periodos == 1 && strchr(nombre, '/') == NULL) {
+            // Con un solo período se escribe como "Recurso/Período" para que
+            // el modelo se pueda rearmar con el mismo nombre de período
+            snprintf(nombre, sizeof(nombre), "%s/%s", m->nombresRecursos[c], m->nombresPeriodos[0]);
+        }
+        putc(',', f);
+        escribirCampo(f, nombre);
+    }
+    fputs("\n" DISPONIBLE ",,", f);
+    for(int c = 0; c < filas; c++) {
+        putc(',', f);
+        escribirEntero(f, m->limites[c]);
+    }
+    putc('\n', f);
+
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(cat, i, &k);
+        for(size_t e = 0; e < k; e++) fila[consumo[e].fila] = consumo[e].valor;
+        escribirCampo(f, nombreProducto(cat, i));
+        putc(',', f);
+        escribirEntero(f, cat->cantidades[i]);
+        putc(',', f);
+        escribirEntero(f, cat->ganancias[i]);
+        for(int c = 0; c < filas; c++) {
+            putc(',', f);
+            if(fila[c]) escribirEntero(f, fila[c]);
+        }
+        putc('\n', f);
+        for(size_t e = 0; e < k; e++) fila[consumo[e].fila] = 0;
+    }
+    free(fila);
+    int ok = !ferror(f);
+    return fclose(f) == 0 && ok;
+}
+
+// ===================== Instantánea binaria =====================
+
+#define MAGIA_INSTANTANEA 0x4E414C50u   // "PLAN" en una máquina little endian
+#define VERSION_INSTANTANEA 2         // la 1 no tenía la generación
+
+// Detrás de la cabecera, en este orden: límites (int64 por fila), cantidades,
+// ganancias y largos de consumo (32 bits por producto), los elementos de
+// consumo, los nombres de recursos y de períodos (MAX_NOMBRE bytes cada uno)
+// y los nombres de los productos terminados en '\0'. Todo lo que necesita
+// alineación va primero.
+typedef struct {
+    uint32_t magia;
+    uint32_t version;
+    uint32_t recursos;
+    uint32_t periodos;
+    uint64_t productos;
+    uint64_t elementos;
+    uint64_t bytesNombres;
+    uint64_t generacion;        // para el diario (ver diario.c)
+} CabeceraInstantanea;
+
+#define CABECERA_VERSION_1 offsetof(CabeceraInstantanea, generacion)
+
+// Escribe en un archivo temporal y lo renombra: una instantánea a medio
+// escribir nunca reemplaza a la anterior
+int guardarInstantanea(const Catalogo *cat, const char *ruta) {
+    const ModeloCapacidad *m = &cat->modelo;
+    size_t filas = (size_t)filasModelo(m);
+    CabeceraInstantanea cab = { MAGIA_INSTANTANEA, VERSION_INSTANTANEA, (uint32_t)m->recursos,
+                                (uint32_t)m->periodos, cat->cantidad, 0, 0, cat->generacion };
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        cab.elementos += cat->largoConsumo[i];
+        cab.bytesNombres += strlen(nombreProducto(cat, i)) + 1;
+    }
+
+    size_t largoRuta = strlen(ruta) + 5;
+    char *temporal = malloc(largoRuta);
+    if(temporal == NULL) return 0;
+    snprintf(temporal, largoRuta, "%s.tmp", ruta);
+    FILE *f = fopen(temporal, "wb");
+    if(f == NULL) {
+        free(temporal);
+        return 0;
+    }
+    setvbuf(f, NULL, _IOFBF, 1 << 16);
+
+    fwrite(&cab, sizeof(cab), 1, f);
+    if(filas > 0) fwrite(m->limites, sizeof(int64_t), filas, f);
+    if(cat->cantidad > 0) {
+        fwrite(cat->cantidades, sizeof(int), cat->cantidad, f);
+        fwrite(cat->ganancias, sizeof(int), cat->cantidad, f);
+        fwrite(cat->largoConsumo, sizeof(uint32_t), cat->cantidad, f);
+    }
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(cat, i, &k);
+        if(k > 0) fwrite(consumo, sizeof(ElementoConsumo), k, f);
+    }
+    if(m->recursos > 0) fwrite(m->nombresRecursos, MAX_NOMBRE, (size_t)m->recursos, f);
+    if(m->periodos > 0) fwrite(m->nombresPeriodos, MAX_NOMBRE, (size_t)m->periodos, f);
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        const char *nombre = nombreProducto(cat, i);
+        fwrite(nombre, 1, strlen(nombre) + 1, f);
+    }
+
+    // En disco antes del rename: si no, una caída podría dejar la
+    // instantánea nueva vacía en lugar de la anterior
+    int ok = fflush(f) == 0 && fsync(fileno(f)) == 0 && !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    if(ok) ok = rename(temporal, ruta) == 0;
+    if(!ok) remove(temporal);
+    free(temporal);
+    return ok;
+}
+
+// Arma el catálogo desde la instantánea ya leída en 'datos'
+static int armarDesdeInstantanea(Catalogo *cat, char *datos, size_t tam) {
+    CabeceraInstantanea cab;
+    size_t largoCabecera = sizeof(cab);
+    if(tam < CABECERA_VERSION_1) return 0;
+    memcpy(&cab, datos, CABECERA_VERSION_1);
+    if(cab.magia != MAGIA_INSTANTANEA) return 0;
+    if(cab.version == 1) {
+        largoCabecera = CABECERA_VERSION_1;
+        cab.generacion = 0;
+    } else if(cab.version != VERSION_INSTANTANEA || tam < sizeof(cab)) {
+        return 0;
+    } else {
+        memcpy(&cab, datos, sizeof(cab));
+    }
+    // Cotas antes de multiplicar, para que las cuentas de tamaño no desborden
+    if(cab.recursos > tam || cab.periodos > tam || cab.productos > tam || cab.elementos > tam ||
+       cab.bytesNombres > tam || (uint64_t)cab.recursos * cab.periodos > INT32_MAX) return 0;
+    size_t filas = (size_t)cab.recursos * cab.periodos, n = cab.productos;
+    size_t esperado = largoCabecera + filas * sizeof(int64_t) + n * 3 * sizeof(int32_t) +
+                      cab.elementos * sizeof(ElementoConsumo) +
+                      ((size_t)cab.recursos + cab.periodos) * MAX_NOMBRE + cab.bytesNombres;
+    if(esperado != tam) return 0;
+
+    const char *p = datos + largoCabecera;
+    const int64_t *limites = (const int64_t *)p;
+    p += filas * sizeof(int64_t);
+    const int32_t *cantidades = (const int32_t *)p;
+    const int32_t *ganancias = cantidades + n;
+    const uint32_t *largos = (const uint32_t *)(ganancias + n);
+    p += n * 3 * sizeof(int32_t);
+    const ElementoConsumo *consumos = (const ElementoConsumo *)p;
+    p += cab.elementos * sizeof(ElementoConsumo);
+    char (*recursos)[MAX_NOMBRE] = (char (*)[MAX_NOMBRE])(datos + (p - datos));
+    char (*periodos)[MAX_NOMBRE] = recursos + cab.recursos;
+    for(uint32_t r = 0; r < cab.recursos; r++) recursos[r][MAX_NOMBRE - 1] = '\0';
+    for(uint32_t q = 0; q < cab.periodos; q++) periodos[q][MAX_NOMBRE - 1] = '\0';
+    const char *nombre = (const char *)(periodos + cab.periodos);
+    const char *finNombres = nombre + cab.bytesNombres;
+
+    if(filas > 0 && !definirModelo(&cat->modelo, (int)cab.recursos, recursos, (int)cab.periodos, periodos)) return 0;
+    for(size_t f = 0; f < filas; f++) {
+        if(limites[f] < 0) return 0;
+        fijarLimite(&cat->modelo, (int)f, limites[f]);
+    }
+    if(!reservarCatalogo(cat, n, cab.bytesNombres, cab.elementos)) return 0;
+
+    size_t usados = 0;
+    for(size_t i = 0; i < n; i++) {
+        const char *finNombre = memchr(nombre, '\0', (size_t)(finNombres - nombre));
+        if(finNombre == NULL || cantidades[i] < 0 || ganancias[i] < 0 || largos[i] > cab.elementos - usados) return 0;
+        if(agregarProducto(cat, nombre, cantidades[i], ganancias[i], largos[i], consumos + usados) < 0) return 0;
+        usados += largos[i];
+        nombre = finNombre + 1;
+    }
+    cat->generacion = cab.generacion;
+    return usados == cab.elementos && nombre == finNombres;
+}
+
+// Reemplaza el catálogo (y su modelo) por el de la instantánea. Si falla, el
+// catálogo queda como estaba.
+int cargarInstantanea(Catalogo *cat, const char *ruta) {
+    int fd = open(ruta, O_RDONLY);
+    if(fd < 0) return 0;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    size_t tam = (size_t)st.st_size, leidos = 0;
+    char *datos = malloc(tam ? tam : 1);
+    if(datos == NULL) {
+        close(fd);
+        return 0;
+    }
+    // Un solo read alcanza salvo lecturas cortas (señales, sistemas remotos)
+    while(leidos < tam) {
+        ssize_t r = read(fd, datos + leidos, tam - leidos);
+        if(r <= 0) break;
+        leidos += (size_t)r;
+    }
+    close(fd);
+
+    Catalogo nuevo;
+    iniciarCatalogo(&nuevo);
+    int ok = leidos == tam && armarDesdeInstantanea(&nuevo, datos, tam);
+    free(datos);
+    if(!ok) {
+        liberarCatalogo(&nuevo);
+        return 0;
+    }
+    liberarCatalogo(cat);
+    *cat = nuevo;
+    return 1;
+}
@@ -0,0 +1,304 @@
+#ifndef PLANIFICADOR_H
+#define PLANIFICADOR_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#define MAX_NOMBRE 50
+
+// Índice de nombres: una tabla hash de nombres completos (en minúsculas)
+// para la coincidencia exacta y listas de productos por n-grama (de 1 a 3
+// caracteres) para la búsqueda por subcadena. Ambas guardan números de
+// producto, que se renumeran cuando un borrado mueve el último producto.
+typedef struct {
+    uint32_t hash;
+    uint32_t producto;          // SIN_PRODUCTO = ranura libre
+} RanuraNombre;
+
+typedef struct {
+    uint32_t clave;             // n-grama | GRAMA_OCUPADO, 0 = libre
+    uint32_t cantidad;
+    uint32_t capacidad;
+    uint32_t *productos;
+} ListaGrama;
+
+typedef struct {
+    RanuraNombre *ranuras;
+    size_t mascara;
+    size_t ocupadas;
+    ListaGrama *gramas;
+    size_t mascaraGramas;
+    size_t usadosGramas;
+} IndiceNombres;
+
+// Consumo por unidad de un producto en una fila del modelo de capacidad
+typedef struct {
+    uint32_t fila;              // recurso * periodos + período
+    int valor;
+} ElementoConsumo;
+
+// Modelo de capacidad: recursos con nombre (horas de máquina, materiales,
+// mano de obra...) disponibles en cada período (turnos, días). Cada par
+// recurso-período es una fila con su límite. La demanda de cada fila se
+// actualiza con cada cambio del catálogo (O(filas que usa el producto)), así
+// saber si todo entra no obliga a recorrer los productos.
+typedef struct {
+    int recursos;
+    int periodos;
+    char (*nombresRecursos)[MAX_NOMBRE];
+    char (*nombresPeriodos)[MAX_NOMBRE];
+    int64_t *limites;           // por fila
+    __int128 *demandas;         // por fila: suma de cantidad * consumo
+    size_t excedidas;           // filas con demanda mayor que su límite
+} ModeloCapacidad;
+
+// Catálogo de productos en columnas (estructura de arreglos): cada recorrido
+// toca solo las columnas que usa. Los nombres viven en una arena, seguidos de
+// su copia en minúsculas, y cada producto guarda su desplazamiento, así la
+// arena puede crecer o compactarse sin invalidar nada. Borrar mueve el último
+// producto al hueco (sin lápidas), por lo que los índices no son estables
+// entre borrados.
+typedef struct {
+    int *cantidades;
+    int *ganancias;             // ganancia por unidad (0 = sin dato)
+    uint32_t *inicioNombre;     // desplazamiento del nombre en la arena
+    uint32_t *inicioConsumo;    // primer elemento de su consumo en 'consumos'
+    uint32_t *largoConsumo;
+    size_t cantidad;
+    size_t capacidad;
+
+    char *arena;                // nombres terminados en '\0', uno tras otro
+    size_t usadoArena;
+    size_t capacidadArena;
+    size_t basuraArena;         // bytes de nombres borrados o reemplazados
+
+    // Matriz de consumo dispersa, por producto y ordenada por fila; como la
+    // arena, los vectores reemplazados quedan como basura hasta compactar
+    ElementoConsumo *consumos;
+    size_t usadoConsumos;
+    size_t capacidadConsumos;
+    size_t basuraConsumos;
+
+    IndiceNombres indice;
+    ModeloCapacidad modelo;
+    uint64_t generacion;        // de la instantánea, para el diario
+} Catalogo;
+
+// Catálogo (catalogo.c)
+void iniciarCatalogo(Catalogo *cat);
+void liberarCatalogo(Catalogo *cat);
+int reservarCatalogo(Catalogo *cat, size_t productos, size_t bytesNombres, size_t elementos);
+long agregarProducto(Catalogo *cat, const char *nombre, int cantidad, int ganancia,
+                     size_t k, const ElementoConsumo *consumo);
+int cambiarNombre(Catalogo *cat, size_t indice, const char *nombre);
+void cambiarCantidad(Catalogo *cat, size_t indice, int cantidad);
+int cambiarConsumo(Catalogo *cat, size_t indice, size_t k, const ElementoConsumo *consumo);
+const ElementoConsumo *consumoProducto(const Catalogo *cat, size_t indice, size_t *k);
+void quitarProducto(Catalogo *cat, size_t indice);
+const char *nombreProducto(const Catalogo *cat, size_t indice);
+const char *nombreMinusculas(const Catalogo *cat, size_t indice);
+
+// Índice de nombres (indice.c)
+void iniciarIndice(IndiceNombres *ind);
+void liberarIndice(IndiceNombres *ind);
+int indexarProducto(Catalogo *cat, size_t producto);
+void desindexarProducto(Catalogo *cat, size_t producto);
+void renumerarProducto(Catalogo *cat, size_t desde, size_t hacia);
+long buscarEnCatalogo(const Catalogo *cat, const char *texto);
+
+// Modelo de capacidad (capacidad.c)
+int definirModelo(ModeloCapacidad *m, int recursos, char (*nombresRecursos)[MAX_NOMBRE],
+                  int periodos, char (*nombresPeriodos)[MAX_NOMBRE]);
+void liberarModelo(ModeloCapacidad *m);
+int filasModelo(const ModeloCapacidad *m);
+int buscarRecurso(const ModeloCapacidad *m, const char *texto);
+int buscarPeriodo(const ModeloCapacidad *m, const char *texto);
+int buscarFila(const ModeloCapacidad *m, const char *texto);
+void nombreFila(const ModeloCapacidad *m, int fila, char *salida, size_t tam);
+void fijarLimite(ModeloCapacidad *m, int fila, int64_t limite);
+void acumularDemanda(ModeloCapacidad *m, int cantidad, size_t k, const ElementoConsumo *consumo, int signo);
+int64_t demandaFila(const ModeloCapacidad *m, int fila, int *desborde);
+
+// Importar y exportar (persistencia.c)
+int importarCSV(Catalogo *cat, const char *ruta, long *lineaError);
+int exportarCSV(const Catalogo *cat, const char *ruta);
+int guardarInstantanea(const Catalogo *cat, const char *ruta);
+int cargarInstantanea(Catalogo *cat, const char *ruta);
+
+// Problema entero: max c·x  sujeto a  A x <= b,  0 <= x <= u,  x entero,
+// con A guardada por columnas (CSC)
+typedef struct {
+    int filas;
+    double *limites;            // b
+    size_t columnas;
+    size_t capacidadColumnas;
+    size_t *inicioColumna;      // elementos de la columna j: [inicio[j], inicio[j+1])
+    int *filaElemento;
+    double *valorElemento;
+    size_t elementos;
+    size_t capacidadElementos;
+    double *costos;             // c
+    double *cotas;              // u
+} ProblemaEntero;
+
+typedef enum {
+    PLAN_OPTIMO,
+    PLAN_LIMITE_NODOS,          // mejor solución encontrada antes del límite
+    PLAN_INFACTIBLE,
+    PLAN_SIN_MEMORIA,
+    PLAN_ERROR_NUMERICO,
+    PLAN_VORAZ                  // solo el plan por prioridad (ver evaluarEscenario)
+} EstadoPlan;
+
+typedef struct {
+    EstadoPlan estado;
+    double valor;               // c·x de la solución devuelta
+    double cota;                // cota superior del óptimo
+    long nodos;
+} ResultadoEntero;
+
+#define LIMITE_NODOS_PLAN 20000
+
+// Branch and bound solo hasta esta cantidad de productos: en catálogos más
+// grandes puede tardar mucho y el plan por prioridad ya da uno bueno
+#define MAX_PRODUCTOS_PLAN_OPTIMO 1000
+
+// Optimizador (optimizador.c)
+int iniciarProblema(ProblemaEntero *p, int filas, const double *limites);
+void liberarProblema(ProblemaEntero *p);
+int agregarColumna(ProblemaEntero *p, double costo, double cota, int k, const int *filas, const double *valores);
+ResultadoEntero resolverEntero(const ProblemaEntero *p, long limiteNodos, double *x);
+
+// Plan por prioridad: los productos de más valor por unidad del recurso que
+// los limita se fabrican primero. La mochila exacta (un solo recurso
+// excedido) usa una tabla de lotes x (límite + 1) bits.
+#define LIMITE_CELDAS_MOCHILA ((size_t)1 << 28)
+
+typedef struct {
+    int exacto;                 // mochila exacta; si no, voraz
+    int porGanancia;
+    int fila;                   // fila más excedida (demanda / límite)
+    long long producidas;
+    long long valor;            // ganancia del plan, o unidades sin ganancias
+    size_t completos;           // productos con la demanda completa
+} ResultadoPrioridad;
+
+// Escenario "¿qué pasa si?": vista del catálogo con ediciones propias que
+// comparte con la base los tramos de columnas que no cambió (copia al
+// escribir). La base no debe modificarse mientras el escenario exista.
+#define BITS_TRAMO_ESCENARIO 10
+#define MAX_HILOS_ESCENARIOS 64
+
+typedef struct {
+    char nombre[MAX_NOMBRE];
+    const Catalogo *base;
+    size_t cantidad;
+    size_t tramos;
+    int **cantidades;           // por tramo: el de la base o una copia propia
+    int **ganancias;
+    uint8_t *propios;           // qué tramos ya se copiaron
+    ModeloCapacidad modelo;     // nombres de la base; límites y demandas propios
+} Escenario;
+
+typedef enum { EDITAR_CANTIDAD, EDITAR_GANANCIA, EDITAR_LIMITE } CampoEdicion;
+typedef enum { CAMBIO_FIJAR, CAMBIO_SUMAR, CAMBIO_PORCENTAJE } TipoCambio;
+
+typedef struct {
+    CampoEdicion campo;
+    long objetivo;              // producto, o fila para los límites (-1 = todos)
+    TipoCambio tipo;
+    double valor;               // valor, diferencia o porcentaje
+} EdicionEscenario;
+
+typedef struct {
+    int viable;
+    size_t excedidas;           // filas con demanda mayor que su límite
+    long long demanda;          // unidades demandadas
+    long long producidas;       // unidades del plan
+    long long ganancia;         // ganancia del plan
+    int porGanancia;
+    EstadoPlan estado;
+    double cota;                // cota del óptimo si la búsqueda se cortó
+} ResultadoEscenario;
+
+// Escenarios (escenarios.c)
+int crearEscenario(Escenario *e, const Catalogo *base, const char *nombre);
+void liberarEscenario(Escenario *e);
+int cantidadEscenario(const Escenario *e, size_t i);
+int gananciaEscenario(const Escenario *e, size_t i);
+int aplicarEdiciones(Escenario *e, const EdicionEscenario *ediciones, size_t n);
+ResultadoEntero optimizarEscenario(const Escenario *e, double *plan, int *porGanancia);
+int evaluarEscenario(const Escenario *e, ResultadoEscenario *r);
+void evaluarEscenarios(Escenario *const *escenarios, size_t n, ResultadoEscenario *resultados, int hilos);
+
+// Prioridad (prioridad.c)
+int planVoraz(const Escenario *esc, double *plan, ResultadoPrioridad *r);
+int planMochila(const Escenario *esc, double *plan, ResultadoPrioridad *r, size_t limiteCeldas);
+int planPorPrioridad(const Escenario *esc, double *plan, ResultadoPrioridad *r);
+
+// Cambio del catálogo tal como se anota en el diario. Los productos van
+// por índice: al repetir los cambios en orden desde la misma instantánea
+// cada índice vuelve a nombrar al mismo producto.
+typedef enum {
+    REGISTRO_AGREGAR,
+    REGISTRO_NOMBRE,
+    REGISTRO_CANTIDAD,
+    REGISTRO_GANANCIA,
+    REGISTRO_CONSUMO,
+    REGISTRO_QUITAR,
+    REGISTRO_LIMITE
+} TipoRegistro;
+
+typedef struct {
+    TipoRegistro tipo;
+    size_t indice;              // producto, o fila para REGISTRO_LIMITE
+    const char *nombre;         // REGISTRO_AGREGAR y REGISTRO_NOMBRE
+    int64_t valor;              // cantidad, ganancia o límite
+    int ganancia;               // ganancia de REGISTRO_AGREGAR
+    size_t k;                   // consumo de REGISTRO_AGREGAR y REGISTRO_CONSUMO
+    const ElementoConsumo *consumo;
+} RegistroDiario;
+
+// Diario de cambios: la instantánea más los cambios posteriores, que se
+// anotan en memoria y se escriben en grupo (un fdatasync para todos los
+// que esperan). Cuando el diario crece más que la instantánea se compacta
+// en una nueva.
+typedef struct {
+    int fd;                     // -1 hasta que exista la primera instantánea
+    char *ruta;                 // instantánea + ".diario"
+    char *rutaInstantanea;
+    uint64_t generacion;        // la de la instantánea que continúa
+    pthread_mutex_t mutex;
+    pthread_cond_t listo;
+    unsigned char *pendiente;   // registros anotados y sin escribir
+    size_t usadoPendiente;
+    size_t capacidadPendiente;
+    unsigned char *enVuelo;     // los que está escribiendo un hilo
+    size_t capacidadEnVuelo;
+    uint64_t anotado;           // bytes anotados desde que se abrió
+    uint64_t durable;           // de esos, los que ya están en disco
+    int sincronizando;
+    int error;
+    uint64_t bytesDiario;
+    uint64_t bytesInstantanea;
+    long sincronizaciones;
+} Diario;
+
+// Diario (diario.c)
+int aplicarRegistro(Catalogo *cat, const RegistroDiario *r);
+int abrirDiario(Diario *d, Catalogo *cat, const char *rutaInstantanea, long *aplicados);
+void cerrarDiario(Diario *d);
+uint64_t anotarRegistro(Diario *d, const RegistroDiario *r);
+int confirmarDiario(Diario *d, uint64_t hasta);
+int diarioGrande(Diario *d);
+int compactarDiario(Diario *d, Catalogo *cat);
+int cambiarCatalogo(Catalogo *cat, Diario *d, const RegistroDiario *r);
+
+// Servidor de consultas (servidor.c)
+int servirEntrada(Catalogo *cat, Diario *diario, FILE *entrada, FILE *salida);
+int servirSocket(Catalogo *cat, Diario *diario, const char *ruta, int hilos);
+int generarCarga(const char *ruta, int clientes, long peticiones, int escrituras);
+
+#endif // PLANIFICADOR_H
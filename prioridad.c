@@ -0,0 +1,287 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "planificador.h"
+
+// Plan por prioridad para cuando la demanda no entra: cada producto vale su
+// ganancia (o 1 por unidad si no hay ganancias) dividida por lo que usa del
+// recurso que lo limita, medido como fracción de lo disponible de esa fila.
+// Un montículo entrega los productos de mayor a menor densidad y cada uno se
+// lleva todas las unidades que todavía entran. Con un solo recurso excedido
+// hay además una mochila acotada exacta por programación dinámica. Todo se
+// lee de un escenario: el catálogo sin ediciones es uno más.
+
+// La clave va junto al producto: comparar no salta a otro arreglo
+typedef struct {
+    double clave;               // densidad
+    size_t producto;
+} EntradaMonticulo;
+
+typedef struct {
+    EntradaMonticulo *entradas; // montículo de máximos
+    size_t n;
+} Monticulo;
+
+// Mayor densidad primero; a igual densidad, el de menor índice
+static int antes(const Monticulo *h, size_t a, size_t b) {
+    const EntradaMonticulo *x = &h->entradas[a], *y = &h->entradas[b];
+    if(x->clave != y->clave) return x->clave > y->clave;
+    return x->producto < y->producto;
+}
+
+static void hundir(Monticulo *h, size_t i) {
+    for(;;) {
+        size_t mayor = i, izq = 2 * i + 1, der = izq + 1;
+        if(izq < h->n && antes(h, izq, mayor)) mayor = izq;
+        if(der < h->n && antes(h, der, mayor)) mayor = der;
+        if(mayor == i) return;
+        EntradaMonticulo t = h->entradas[i];
+        h->entradas[i] = h->entradas[mayor];
+        h->entradas[mayor] = t;
+        i = mayor;
+    }
+}
+
+// Saca la raíz bajando el hueco por el hijo mayor hasta una hoja y subiendo
+// ahí el último: una comparación por nivel en vez de dos, y el último casi
+// siempre termina cerca del fondo
+static EntradaMonticulo sacarPrimero(Monticulo *h) {
+    EntradaMonticulo *e = h->entradas;
+    EntradaMonticulo primero = e[0], ultimo = e[--h->n];
+    size_t hueco = 0, hijo;
+    while((hijo = 2 * hueco + 1) < h->n) {
+        if(hijo + 1 < h->n && antes(h, hijo + 1, hijo)) hijo++;
+        e[hueco] = e[hijo];
+        hueco = hijo;
+    }
+    while(hueco > 0) {
+        size_t padre = (hueco - 1) / 2;
+        if(e[padre].clave > ultimo.clave || (e[padre].clave == ultimo.clave && e[padre].producto < ultimo.producto)) break;
+        e[hueco] = e[padre];
+        hueco = padre;
+    }
+    e[hueco] = ultimo;
+    return primero;
+}
+
+static int conGanancias(const Escenario *esc) {
+    for(size_t i = 0; i < esc->cantidad; i++) {
+        if(gananciaEscenario(esc, i) > 0) return 1;
+    }
+    return 0;
+}
+
+// Fila excedida con mayor demanda en proporción a su límite
+static int filaMasExcedida(const ModeloCapacidad *m) {
+    int fila = -1;
+    double peor = 0;
+    for(int f = 0; f < filasModelo(m); f++) {
+        int64_t demanda = demandaFila(m, f, NULL);
+        if(demanda <= m->limites[f]) continue;
+        double razon = m->limites[f] > 0 ? (double)demanda / (double)m->limites[f] : INFINITY;
+        if(fila < 0 || razon > peor) {
+            fila = f;
+            peor = razon;
+        }
+    }
+    return fila;
+}
+
+static void iniciarResultado(const Escenario *esc, ResultadoPrioridad *r) {
+    memset(r, 0, sizeof(*r));
+    r->porGanancia = conGanancias(esc);
+    r->fila = filaMasExcedida(&esc->modelo);
+}
+
+static void sumarPlan(const Escenario *esc, const double *plan, ResultadoPrioridad *r) {
+    for(size_t i = 0; i < esc->cantidad; i++) {
+        long long x = (long long)plan[i];
+        r->producidas += x;
+        r->valor += r->porGanancia ? x * gananciaEscenario(esc, i) : x;
+        if(x == cantidadEscenario(esc, i)) r->completos++;
+    }
+}
+
+int planVoraz(const Escenario *esc, double *plan, ResultadoPrioridad *r) {
+    const ModeloCapacidad *m = &esc->modelo;
+    int filas = filasModelo(m);
+    Monticulo h = { malloc((esc->cantidad + 1) * sizeof(EntradaMonticulo)), 0 };
+    int64_t *restante = malloc(((size_t)filas + 1) * sizeof(int64_t));
+    int *minimo = malloc(((size_t)filas + 1) * sizeof(int));   // menor consumo de la fila
+    uint8_t *excedida = malloc((size_t)filas + 1);
+    if(h.entradas == NULL || restante == NULL || minimo == NULL || excedida == NULL) {
+        free(h.entradas);
+        free(restante);
+        free(minimo);
+        free(excedida);
+        return 0;
+    }
+    iniciarResultado(esc, r);
+
+    // Solo las filas excedidas limitan: en las demás entra la demanda completa
+    for(int f = 0; f < filas; f++) {
+        restante[f] = m->limites[f] > 0 ? m->limites[f] : 0;
+        minimo[f] = INT32_MAX;
+        excedida[f] = demandaFila(m, f, NULL) > m->limites[f];
+    }
+    for(size_t i = 0; i < esc->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(esc->base, i, &k);
+        double valor = r->porGanancia ? gananciaEscenario(esc, i) : 1.0;
+        double uso = 0;
+        plan[i] = 0;
+        if(cantidadEscenario(esc, i) <= 0) continue;
+        for(size_t e = 0; e < k; e++) {
+            uint32_t f = consumo[e].fila;
+            if(!excedida[f] || consumo[e].valor <= 0) continue;
+            double fraccion = restante[f] > 0 ? (double)consumo[e].valor / (double)restante[f] : INFINITY;
+            if(fraccion > uso) uso = fraccion;
+            if(consumo[e].valor < minimo[f]) minimo[f] = consumo[e].valor;
+        }
+        h.entradas[h.n++] = (EntradaMonticulo){ uso > 0 ? valor / uso : INFINITY, i };
+    }
+    for(size_t i = h.n / 2; i-- > 0; ) hundir(&h, i);
+
+    // Una fila queda agotada cuando no le entra ni una unidad del producto que
+    // menos usa de ella; con todas agotadas, lo que queda en el montículo
+    // (todo usa alguna) no recibe nada
+    size_t abiertas = 0;
+    for(int f = 0; f < filas; f++) {
+        if(excedida[f] && restante[f] >= minimo[f]) abiertas++;
+    }
+    while(h.n > 0) {
+        EntradaMonticulo primero = sacarPrimero(&h);
+        size_t i = primero.producto;
+        if(abiertas == 0 && !isinf(primero.clave)) break;
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(esc->base, i, &k);
+        int64_t x = cantidadEscenario(esc, i);
+        for(size_t e = 0; e < k && x > 0; e++) {
+            uint32_t f = consumo[e].fila;
+            if(excedida[f] && consumo[e].valor > 0 && restante[f] / consumo[e].valor < x) {
+                x = restante[f] / consumo[e].valor;
+            }
+        }
+        for(size_t e = 0; e < k && x > 0; e++) {
+            uint32_t f = consumo[e].fila;
+            if(!excedida[f]) continue;
+            int abierta = restante[f] >= minimo[f];
+            restante[f] -= x * consumo[e].valor;
+            if(abierta && restante[f] < minimo[f]) abiertas--;
+        }
+        plan[i] = (double)x;
+    }
+    sumarPlan(esc, plan, r);
+
+    free(h.entradas);
+    free(restante);
+    free(minimo);
+    free(excedida);
+    return 1;
+}
+
+// Devuelve 1, 0 sin memoria o -1 si no aplica (más de un recurso excedido,
+// tabla de más de 'limiteCeldas' o valor total que no entra en 64 bits)
+int planMochila(const Escenario *esc, double *plan, ResultadoPrioridad *r, size_t limiteCeldas) {
+    const ModeloCapacidad *m = &esc->modelo;
+    if(m->excedidas != 1) return -1;
+    iniciarResultado(esc, r);
+    int fila = r->fila;
+    int64_t capacidad = m->limites[fila] > 0 ? m->limites[fila] : 0;
+    if((uint64_t)capacidad >= limiteCeldas) return -1;
+    size_t ancho = (size_t)capacidad + 1;
+
+    // Cada producto que usa la fila se parte en lotes de 1, 2, 4, ... unidades
+    // (mochila 0/1 equivalente); los que no la usan entran completos
+    size_t lotes = 0;
+    __int128 valorTotal = 0;
+    for(size_t i = 0; i < esc->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(esc->base, i, &k);
+        int64_t peso = 0, q = cantidadEscenario(esc, i);
+        if(q < 0) q = 0;
+        for(size_t e = 0; e < k; e++) {
+            if(consumo[e].fila == (uint32_t)fila) peso = consumo[e].valor;
+        }
+        plan[i] = peso > 0 ? 0 : (double)q;
+        if(peso == 0 || peso > capacidad) continue;
+        if(q > capacidad / peso) q = capacidad / peso;
+        for(int64_t t = 1; q > 0; t *= 2) {
+            q -= t < q ? t : q;
+            lotes++;
+        }
+        valorTotal += (__int128)cantidadEscenario(esc, i) * (r->porGanancia ? gananciaEscenario(esc, i) : 1);
+    }
+    if(valorTotal > INT64_MAX || (lotes > 0 && ancho > limiteCeldas / lotes)) return -1;
+
+    int64_t *mejor = calloc(ancho, sizeof(int64_t));
+    uint64_t *tomado = calloc((lotes * ancho + 63) / 64 + 1, sizeof(uint64_t));
+    size_t *productoLote = malloc((lotes + 1) * sizeof(size_t));
+    int64_t *unidadesLote = malloc((lotes + 1) * sizeof(int64_t));
+    int64_t *pesoLote = malloc((lotes + 1) * sizeof(int64_t));
+    if(mejor == NULL || tomado == NULL || productoLote == NULL || unidadesLote == NULL || pesoLote == NULL) {
+        free(mejor);
+        free(tomado);
+        free(productoLote);
+        free(unidadesLote);
+        free(pesoLote);
+        return 0;
+    }
+
+    // mejor[c]: mayor valor con a lo sumo c de la fila usando los lotes vistos
+    size_t j = 0;
+    for(size_t i = 0; i < esc->cantidad; i++) {
+        size_t k;
+        const ElementoConsumo *consumo = consumoProducto(esc->base, i, &k);
+        int64_t peso = 0, q = cantidadEscenario(esc, i);
+        if(q < 0) q = 0;
+        int64_t valor = r->porGanancia ? gananciaEscenario(esc, i) : 1;
+        for(size_t e = 0; e < k; e++) {
+            if(consumo[e].fila == (uint32_t)fila) peso = consumo[e].valor;
+        }
+        if(peso == 0 || peso > capacidad) continue;
+        if(q > capacidad / peso) q = capacidad / peso;
+        for(int64_t t = 1; q > 0; t *= 2, j++) {
+            int64_t u = t < q ? t : q;
+            int64_t w = u * peso, v = u * valor;
+            q -= u;
+            productoLote[j] = i;
+            unidadesLote[j] = u;
+            pesoLote[j] = w;
+            size_t base = j * ancho;
+            for(int64_t c = capacidad; c >= w; c--) {
+                if(mejor[c - w] + v > mejor[c]) {
+                    mejor[c] = mejor[c - w] + v;
+                    size_t b = base + (size_t)c;
+                    tomado[b >> 6] |= 1ull << (b & 63);
+                }
+            }
+        }
+    }
+
+    // Reconstrucción de atrás hacia adelante
+    int64_t c = capacidad;
+    for(size_t l = lotes; l-- > 0; ) {
+        size_t b = l * ancho + (size_t)c;
+        if(tomado[b >> 6] >> (b & 63) & 1) {
+            plan[productoLote[l]] += (double)unidadesLote[l];
+            c -= pesoLote[l];
+        }
+    }
+    r->exacto = 1;
+    sumarPlan(esc, plan, r);
+
+    free(mejor);
+    free(tomado);
+    free(productoLote);
+    free(unidadesLote);
+    free(pesoLote);
+    return 1;
+}
+
+// Exacto si hay un solo recurso excedido y la tabla entra en el límite; si
+// no, el voraz
+int planPorPrioridad(const Escenario *esc, double *plan, ResultadoPrioridad *r) {
+    int exacto = planMochila(esc, plan, r, LIMITE_CELDAS_MOCHILA);
+    return exacto >= 0 ? exacto : planVoraz(esc, plan, r);
+}
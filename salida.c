@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "booleanas.h"
+
+// Impresión de tablas de verdad grandes: las filas se arman a mano en un
+// buffer y se escriben con un fwrite por bloque en lugar de varios printf
+// por fila.
+
+static FormatoTabla formatoTabla = TABLA_NORMAL;
+static int coloresTabla = -1;   // -1 = solo si stdout es una terminal
+
+void configurarTabla(FormatoTabla formato, int colores) {
+    formatoTabla = formato;
+    coloresTabla = colores;
+}
+
+static int usarColores(void) {
+    return (coloresTabla >= 0) ? coloresTabla : isatty(STDOUT_FILENO);
+}
+
+// Devuelve el código de color, o "" si los colores están apagados (para los
+// encabezados de los reportes)
+const char *colorSalida(const char *codigo) {
+    return usarColores() ? codigo : "";
+}
+
+typedef struct {
+    FILE *archivo;
+    char *datos;
+    size_t usado;
+    size_t capacidad;
+    char local[4096];       // respaldo si no hay memoria para el bloque grande
+} BufferSalida;
+
+static void iniciarBuffer(BufferSalida *b, FILE *f, size_t estimado) {
+    b->archivo = f;
+    b->usado = 0;
+    b->capacidad = (estimado < TAM_BUFFER_TABLA) ? estimado : TAM_BUFFER_TABLA;
+    b->datos = (b->capacidad > sizeof(b->local)) ? malloc(b->capacidad) : NULL;
+    if (b->datos == NULL) {
+        b->datos = b->local;
+        b->capacidad = sizeof(b->local);
+    }
+}
+
+static void vaciarBuffer(BufferSalida *b) {
+    if (b->usado > 0) fwrite(b->datos, 1, b->usado, b->archivo);
+    b->usado = 0;
+}
+
+static void cerrarBuffer(BufferSalida *b) {
+    vaciarBuffer(b);
+    if (b->datos != b->local) free(b->datos);
+}
+
+// Garantiza espacio para k bytes (k debe ser menor que la capacidad)
+static inline char *reservar(BufferSalida *b, size_t k) {
+    if (b->usado + k > b->capacidad) vaciarBuffer(b);
+    return b->datos + b->usado;
+}
+
+static inline void agregarTexto(BufferSalida *b, const char *s) {
+    size_t k = strlen(s);
+    memcpy(reservar(b, k), s, k);
+    b->usado += k;
+}
+
+// Escribe v en decimal y devuelve la cantidad de dígitos
+static inline size_t escribirDecimal(char *dst, size_t v) {
+    char tmp[24];
+    size_t k = 0;
+    do {
+        tmp[k++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    for (size_t i = 0; i < k; i++) dst[i] = tmp[k - 1 - i];
+    return k;
+}
+
+static inline int filaIndiferente(const TablaVerdad *t, size_t fila) {
+    return t->indiferentes != NULL && ((t->indiferentes[fila >> 6] >> (fila & 63)) & 1);
+}
+
+// Cuenta en binario sobre la plantilla de entradas (paso = distancia entre dígitos)
+static inline void incrementarEntradas(char *entradas, int n, int paso) {
+    for (int v = n - 1; v >= 0; v--) {
+        char *c = &entradas[v * paso];
+        if (*c == '0') { *c = '1'; return; }
+        *c = '0';
+    }
+}
+
+static void imprimirTablaNormal(FILE *f, const TablaVerdad *t) {
+    int n = t->n, colores = usarColores();
+    size_t filas = numFilas(t);
+    const char *verde = colores ? GREEN : "", *amarillo = colores ? YELLOW : "", *fin = colores ? RESET : "";
+    BufferSalida b;
+    iniciarBuffer(&b, f, filas * (3 * (size_t)n + 40) + 512);
+
+    char linea[3 * MAX_VARIABLES + 8];
+    agregarTexto(&b, "\n");
+    agregarTexto(&b, verde);
+    agregarTexto(&b, "=== TABLA DE VERDAD COMPLETA ===");
+    agregarTexto(&b, fin);
+    agregarTexto(&b, "\n=====================================\n");
+    for (int v = 0; v < n; v++) {
+        linea[3 * v] = ' ';
+        linea[3 * v + 1] = (char)('A' + v);
+        linea[3 * v + 2] = ' ';
+    }
+    linea[3 * n - 1] = '\0';
+    agregarTexto(&b, linea);
+    agregarTexto(&b, "  |  Salida  |  Mintérmino\n=====================================\n");
+
+    // Plantilla " 0  0  0": el dígito de la variable v está en 3v + 1
+    char *entradas = linea;
+    for (int v = 0; v < n; v++) linea[3 * v + 1] = '0';
+    size_t anchoEntradas = 3 * (size_t)n - 1;
+    size_t largoVerde = strlen(verde), largoAmarillo = strlen(amarillo), largoFin = strlen(fin);
+
+    for (size_t i = 0; i < filas; i++) {
+        char *p = reservar(&b, anchoEntradas + 64);
+        memcpy(p, entradas, anchoEntradas);
+        p += anchoEntradas;
+        if (filaIndiferente(t, i)) {
+            memcpy(p, "  |    X    |     ", 18);
+            p += 18;
+            memcpy(p, amarillo, largoAmarillo);
+            p += largoAmarillo;
+            *p++ = 'd';
+            p += escribirDecimal(p, i);
+            memcpy(p, fin, largoFin);
+            p += largoFin;
+        } else if ((t->bits[i >> 6] >> (i & 63)) & 1) {
+            memcpy(p, "  |    1    |     ", 18);
+            p += 18;
+            memcpy(p, verde, largoVerde);
+            p += largoVerde;
+            *p++ = 'm';
+            p += escribirDecimal(p, i);
+            memcpy(p, fin, largoFin);
+            p += largoFin;
+        } else {
+            memcpy(p, "  |    0    |     -", 19);
+            p += 19;
+        }
+        *p++ = '\n';
+        b.usado = (size_t)(p - b.datos);
+        incrementarEntradas(entradas + 1, n, 3);
+    }
+    agregarTexto(&b, "=====================================\n");
+    cerrarBuffer(&b);
+}
+
+static void imprimirTablaCSV(FILE *f, const TablaVerdad *t) {
+    int n = t->n;
+    size_t filas = numFilas(t);
+    BufferSalida b;
+    iniciarBuffer(&b, f, filas * (2 * (size_t)n + 2) + 128);
+
+    // Encabezado "A,B,C,salida" y plantilla "0,0,0,": el dígito de v está en 2v
+    char linea[2 * MAX_VARIABLES + 8];
+    for (int v = 0; v < n; v++) {
+        linea[2 * v] = (char)('A' + v);
+        linea[2 * v + 1] = ',';
+    }
+    memcpy(&linea[2 * n], "salida\n", 8);
+    agregarTexto(&b, linea);
+    for (int v = 0; v < n; v++) linea[2 * v] = '0';
+    size_t ancho = 2 * (size_t)n;
+
+    for (size_t i = 0; i < filas; i++) {
+        char *p = reservar(&b, ancho + 2);
+        memcpy(p, linea, ancho);
+        p[ancho] = filaIndiferente(t, i) ? 'X' : (char)('0' + ((t->bits[i >> 6] >> (i & 63)) & 1));
+        p[ancho + 1] = '\n';
+        b.usado += ancho + 2;
+        incrementarEntradas(linea, n, 2);
+    }
+    cerrarBuffer(&b);
+}
+
+// Primera fila >= desde cuyo bit en 'palabras' (o en su complemento) vale 1
+static size_t siguienteFila(const uint64_t *palabras, int complemento, size_t desde, size_t filas) {
+    if (desde >= filas) return filas;
+    size_t w = desde >> 6;
+    uint64_t x = (complemento ? ~palabras[w] : palabras[w]) & (~0ULL << (desde & 63));
+    size_t cantidad = (filas + 63) >> 6;
+    while (x == 0) {
+        if (++w >= cantidad) return filas;
+        x = complemento ? ~palabras[w] : palabras[w];
+    }
+    size_t fila = (w << 6) + (size_t)__builtin_ctzll(x);
+    return fila < filas ? fila : filas;
+}
+
+// Lista los rangos de filas en 1 de 'palabras' como "m0–m1023, m2048"
+static size_t imprimirRangos(BufferSalida *b, const uint64_t *palabras, size_t filas, char prefijo) {
+    size_t rangos = 0;
+    for (size_t i = siguienteFila(palabras, 0, 0, filas); i < filas; ) {
+        size_t fin = siguienteFila(palabras, 1, i, filas);
+        char *p = reservar(b, 64);
+        if (rangos > 0) {
+            memcpy(p, (rangos % 8 == 0) ? ",\n  " : ", ", (rangos % 8 == 0) ? 4 : 2);
+            p += (rangos % 8 == 0) ? 4 : 2;
+        } else {
+            *p++ = ' ';
+        }
+        *p++ = prefijo;
+        p += escribirDecimal(p, i);
+        if (fin - 1 > i) {
+            memcpy(p, "–", strlen("–"));
+            p += strlen("–");
+            *p++ = prefijo;
+            p += escribirDecimal(p, fin - 1);
+        }
+        b->usado = (size_t)(p - b->datos);
+        rangos++;
+        i = siguienteFila(palabras, 0, fin, filas);
+    }
+    if (rangos == 0) agregarTexto(b, " ninguna");
+    agregarTexto(b, "\n");
+    return rangos;
+}
+
+static void imprimirTablaRangos(FILE *f, const TablaVerdad *t) {
+    int colores = usarColores();
+    size_t filas = numFilas(t), indiferentes = 0;
+    char numero[24];
+    BufferSalida b;
+    iniciarBuffer(&b, f, TAM_BUFFER_TABLA);
+
+    if (t->indiferentes) {
+        for (size_t w = 0; w < t->palabras; w++) indiferentes += (size_t)__builtin_popcountll(t->indiferentes[w]);
+    }
+    agregarTexto(&b, "\n");
+    agregarTexto(&b, colores ? GREEN : "");
+    agregarTexto(&b, "=== TABLA DE VERDAD (RANGOS) ===");
+    agregarTexto(&b, colores ? RESET : "");
+    agregarTexto(&b, "\nFilas: ");
+    numero[escribirDecimal(numero, filas)] = '\0';
+    agregarTexto(&b, numero);
+    agregarTexto(&b, " | En 1: ");
+    numero[escribirDecimal(numero, contarMinterminos(t))] = '\0';
+    agregarTexto(&b, numero);
+    agregarTexto(&b, " | Indiferentes: ");
+    numero[escribirDecimal(numero, indiferentes)] = '\0';
+    agregarTexto(&b, numero);
+    agregarTexto(&b, "\nSalida 1:");
+    imprimirRangos(&b, t->bits, filas, 'm');
+    if (t->indiferentes) {
+        agregarTexto(&b, "Indiferentes:");
+        imprimirRangos(&b, t->indiferentes, filas, 'd');
+    }
+    cerrarBuffer(&b);
+}
+
+void imprimirTabla(FILE *f, const TablaVerdad *t) {
+    switch (formatoTabla) {
+    case TABLA_CSV:
+        imprimirTablaCSV(f, t);
+        break;
+    case TABLA_RANGOS:
+        imprimirTablaRangos(f, t);
+        break;
+    default:
+        imprimirTablaNormal(f, t);
+        break;
+    }
+}
@@ -0,0 +1,175 @@
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "monitor.h"
+
+// Anillos de la serie: el intervalo i (minuto, hora o día desde 1970) va en
+// la ranura i % largo. Al pasar a un intervalo nuevo se marcan sin datos
+// las ranuras de los intervalos que quedaron sin lecturas.
+
+static const int64_t duracion_nivel[NIVELES_SERIE] = {60, 3600, SEGUNDOS_DIA};
+static const int64_t largo_nivel[NIVELES_SERIE] = {MINUTOS_SERIE, HORAS_SERIE, DIAS_SERIE};
+
+static float *anillo(SerieZona *s, int nivel, int c) {
+    switch(nivel) {
+        case NIVEL_MINUTO: return s->minutos[c];
+        case NIVEL_HORA: return s->horas[c];
+        default: return s->dias[c];
+    }
+}
+
+void iniciar_serie(SerieZona *s) {
+    atomic_store_explicit(&s->secuencia, 0, memory_order_relaxed);
+    memset(&s->estadisticas, 0, sizeof(s->estadisticas));
+    s->estadisticas.dia = -1;
+    for(int n = 0; n < NIVELES_SERIE; n++) {
+        memset(&s->acumulado[n], 0, sizeof(s->acumulado[n]));
+        s->acumulado[n].actual = -1;
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            float *a = anillo(s, n, c);
+            for(int64_t i = 0; i < largo_nivel[n]; i++) a[i] = -1;
+        }
+    }
+}
+
+// Seqlock: el escritor deja la secuencia impar mientras cambia las
+// estadísticas y el lector reintenta si la vio impar o cambió al terminar
+static void empezar_escritura(SerieZona *s) {
+    uint32_t n = atomic_load_explicit(&s->secuencia, memory_order_relaxed);
+    atomic_store_explicit(&s->secuencia, n + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void terminar_escritura(SerieZona *s) {
+    uint32_t n = atomic_load_explicit(&s->secuencia, memory_order_relaxed);
+    atomic_store_explicit(&s->secuencia, n + 1, memory_order_release);
+}
+
+// Copia coherente de las estadísticas, sin bloquear al escritor
+void leer_estadisticas(const SerieZona *s, EstadisticasSerie *copia) {
+    uint32_t antes, despues;
+    do {
+        antes = atomic_load_explicit(&s->secuencia, memory_order_acquire);
+        memcpy(copia, &s->estadisticas, sizeof(*copia));
+        atomic_thread_fence(memory_order_acquire);
+        despues = atomic_load_explicit(&s->secuencia, memory_order_relaxed);
+    } while((antes & 1) || antes != despues);
+}
+
+// Corre las ventanas hasta 'dia': por cada día que pasa los pesos de la
+// semana bajan uno (la ponderada pierde la suma de la semana) y sale el día
+// más viejo de cada ventana. Se llama antes de que el anillo diario marque
+// los días nuevos, así que los que salen todavía se leen de ahí.
+static void avanzar_ventanas(SerieZona *s, int64_t dia) {
+    EstadisticasSerie *e = &s->estadisticas;
+    int64_t pasos = e->dia < 0 ? DIAS_HISTORICO : dia - e->dia;
+    for(int64_t p = 0; p < pasos && (e->dias_mes > 0 || e->dias_semana > 0); p++) {
+        int64_t sale_mes = e->dia + p - (DIAS_HISTORICO - 1);
+        int64_t sale_semana = e->dia + p - (DIAS_SEMANA - 1);
+        int en_mes = valor_serie(s, NIVEL_DIA, sale_mes, 0) >= 0;
+        int en_semana = valor_serie(s, NIVEL_DIA, sale_semana, 0) >= 0;
+        e->peso_semana -= e->dias_semana;
+        e->dias_mes -= en_mes;
+        e->dias_semana -= en_semana;
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            e->ponderada_semana[c] -= e->suma_semana[c];
+            if(en_mes) e->suma_mes[c] -= valor_serie(s, NIVEL_DIA, sale_mes, c);
+            if(en_semana) e->suma_semana[c] -= valor_serie(s, NIVEL_DIA, sale_semana, c);
+        }
+    }
+    // Ventana vacía: a cero exacto, sin el resto del redondeo
+    if(e->dias_mes == 0) memset(e->suma_mes, 0, sizeof(e->suma_mes));
+    if(e->dias_semana == 0) {
+        memset(e->suma_semana, 0, sizeof(e->suma_semana));
+        memset(e->ponderada_semana, 0, sizeof(e->ponderada_semana));
+        e->peso_semana = 0;
+    }
+    e->dia = dia;
+}
+
+// Promedio exponencial con la varianza, pesando por el tiempo transcurrido
+// (las lecturas pueden no ser regulares); las que llegan fuera de orden no
+// cuentan
+static void actualizar_exponencial(EstadisticasSerie *e, int64_t tiempo, const float *valores) {
+    if(e->ultima == 0) {
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) e->media[c] = valores[c];
+    } else {
+        if(tiempo < e->ultima) return;
+        int64_t paso = tiempo > e->ultima ? tiempo - e->ultima : 1;
+        double alfa = 1 - exp(-(double)paso / TAU_EWMA);
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            double d = valores[c] - e->media[c];
+            e->media[c] += alfa * d;
+            e->varianza[c] = (1 - alfa) * (e->varianza[c] + alfa * d * d);
+        }
+    }
+    e->ultima = tiempo;
+}
+
+// Función para sumar una lectura a los tres niveles; en cada nivel la
+// ranura del intervalo queda con el promedio de sus lecturas. Una lectura
+// de un intervalo anterior al actual no entra en ese nivel. Devuelve 0 si
+// no entró en ninguno (es de un día anterior).
+int agregar_a_serie(SerieZona *s, int64_t tiempo, const float *valores) {
+    EstadisticasSerie *e = &s->estadisticas;
+    int64_t dia = tiempo / SEGUNDOS_DIA;
+    if(dia < s->acumulado[NIVEL_DIA].actual) return 0;
+    
+    // El promedio del día cambia de 'antes' (-1 = día sin lecturas) al nuevo
+    float antes[NUM_CONTAMINANTES];
+    int dia_nuevo = dia > s->acumulado[NIVEL_DIA].actual;
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+        antes[c] = dia_nuevo ? -1 : valor_serie(s, NIVEL_DIA, dia, c);
+    }
+    empezar_escritura(s);
+    if(dia_nuevo) avanzar_ventanas(s, dia);
+    
+    for(int n = 0; n < NIVELES_SERIE; n++) {
+        AcumuladorSerie *ac = &s->acumulado[n];
+        int64_t intervalo = tiempo / duracion_nivel[n], largo = largo_nivel[n];
+        if(intervalo < ac->actual) continue;
+        if(intervalo > ac->actual) {
+            // Sin lecturas previas el anillo ya está en -1
+            int64_t desde = ac->actual < 0 ? intervalo
+                          : intervalo - ac->actual > largo ? intervalo - largo + 1 : ac->actual + 1;
+            for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+                float *a = anillo(s, n, c);
+                for(int64_t i = desde; i < intervalo; i++) a[i % largo] = -1;
+            }
+            memset(ac->suma, 0, sizeof(ac->suma));
+            ac->lecturas = 0;
+            ac->actual = intervalo;
+        }
+        ac->lecturas++;
+        for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+            ac->suma[c] += valores[c];
+            anillo(s, n, c)[intervalo % largo] = (float)(ac->suma[c] / ac->lecturas);
+        }
+    }
+    
+    if(antes[0] < 0) {
+        e->dias_mes++;
+        e->dias_semana++;
+        e->peso_semana += DIAS_SEMANA;
+    }
+    for(int c = 0; c < NUM_CONTAMINANTES; c++) {
+        double cambio = (double)s->dias[c][dia % DIAS_SERIE] - (antes[c] < 0 ? 0 : antes[c]);
+        e->suma_mes[c] += cambio;
+        e->suma_semana[c] += cambio;
+        e->ponderada_semana[c] += DIAS_SEMANA * cambio;
+    }
+    actualizar_exponencial(e, tiempo, valores);
+    terminar_escritura(s);
+    return 1;
+}
+
+// Promedio de un intervalo, o -1 si no tuvo lecturas o ya salió del anillo
+float valor_serie(const SerieZona *s, int nivel, int64_t intervalo, int contaminante) {
+    int64_t actual = s->acumulado[nivel].actual, largo = largo_nivel[nivel];
+    if(actual < 0 || intervalo < 0 || intervalo > actual || intervalo <= actual - largo) return -1;
+    switch(nivel) {
+        case NIVEL_MINUTO: return s->minutos[contaminante][intervalo % largo];
+        case NIVEL_HORA: return s->horas[contaminante][intervalo % largo];
+        default: return s->dias[contaminante][intervalo % largo];
+    }
+}
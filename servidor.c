@@ -0,0 +1,764 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include "planificador.h"
+
+// Modo servidor: el planificador atiende un protocolo de líneas por stdin o
+// por un socket Unix. Cada petición es una línea y cada respuesta también,
+// empezando con "ok" o "error:". Los nombres con espacios van entre
+// comillas ("" es una comilla dentro del nombre).
+//
+//   agregar nombre cantidad ganancia [Recurso/Período=consumo ...]
+//   editar producto cantidad|ganancia N | nombre nuevo | consumo [R/P=c ...]
+//   borrar producto
+//   limite Recurso/Período N
+//   buscar texto           -> ok nombre cantidad ganancia R/P=c ...
+//   calcular               -> ok viable|inviable productos=N excedidas=N R/P=demanda/límite ...
+//   plan                   -> ok optimo|limite|voraz unidades=N demanda=N ganancia=N
+//   prioridad              -> ok exacto|voraz unidades=N demanda=N ganancia=N
+//   salir
+//
+// Las consultas (buscar, calcular, plan, prioridad) toman el catálogo para lectura y
+// corren a la vez; las altas, ediciones y bajas lo toman para escritura.
+// Con diario, un cambio se responde recién cuando está en disco.
+
+#define MAX_LINEA 16384
+#define MAX_TOKENS 1024
+#define MAX_PENDIENTE 65536     // respuesta sin enviar que deja de leer al cliente
+#define MAX_HILOS_SERVIDOR 64
+
+typedef struct {
+    char *datos;
+    size_t usado;
+    size_t capacidad;
+    size_t enviado;
+    int sinMemoria;
+} Salida;
+
+typedef struct Cliente {
+    int fd;
+    int cerrando;               // salir, fin de la entrada o línea inválida
+    char entrada[MAX_LINEA];
+    size_t usadoEntrada;
+    Salida salida;
+    struct Cliente *anterior;
+    struct Cliente *siguiente;
+} Cliente;
+
+typedef struct {
+    Catalogo *cat;
+    Diario *diario;             // NULL si los cambios no se anotan
+    pthread_rwlock_t candado;
+    int epoll;
+    int escucha;
+    int senales;
+    int terminar;               // atómico
+    pthread_mutex_t mutexClientes;
+    Cliente *clientes;
+} Servidor;
+
+static void responder(Salida *s, const char *formato, ...) {
+    for(;;) {
+        va_list args;
+        size_t libre = s->capacidad - s->usado;
+        va_start(args, formato);
+        int n = vsnprintf(s->datos ? s->datos + s->usado : NULL, libre, formato, args);
+        va_end(args);
+        if(n < 0) return;
+        if((size_t)n < libre) {
+            s->usado += (size_t)n;
+            return;
+        }
+        size_t nueva = s->capacidad ? s->capacidad * 2 : 256;
+        while(nueva < s->usado + (size_t)n + 1) nueva *= 2;
+        char *d = realloc(s->datos, nueva);
+        if(d == NULL) {
+            s->sinMemoria = 1;
+            return;
+        }
+        s->datos = d;
+        s->capacidad = nueva;
+    }
+}
+
+// Escribe un nombre entre comillas si hace falta para volver a leerlo
+static void responderNombre(Salida *s, const char *nombre) {
+    if(nombre[0] != '\0' && strpbrk(nombre, " \t\"") == NULL) {
+        responder(s, "%s", nombre);
+        return;
+    }
+    responder(s, "\"");
+    for(const char *c = nombre; *c; c++) {
+        if(*c == '"') responder(s, "\"\"");
+        else responder(s, "%c", *c);
+    }
+    responder(s, "\"");
+}
+
+// Parte la línea en palabras (en el lugar); -1 si una comilla no cierra o
+// hay demasiadas
+static int partirLinea(char *linea, char **tokens) {
+    int n = 0;
+    char *c = linea;
+    for(;;) {
+        while(*c == ' ' || *c == '\t') c++;
+        if(*c == '\0') return n;
+        if(n == MAX_TOKENS) return -1;
+        char *destino = c;
+        tokens[n++] = c;
+        if(*c == '"') {
+            c++;
+            for(;;) {
+                if(*c == '\0') return -1;
+                if(*c == '"' && c[1] != '"') break;
+                if(*c == '"') c++;
+                *destino++ = *c++;
+            }
+            c++;
+            if(*c != '\0' && *c != ' ' && *c != '\t') return -1;
+        } else {
+            while(*c && *c != ' ' && *c != '\t') *destino++ = *c++;
+        }
+        int fin = *c == '\0';
+        *destino = '\0';
+        if(fin) return n;
+        c++;
+    }
+}
+
+static int leerNumero(const char *texto, long long maximo, long long *valor) {
+    char *fin;
+    errno = 0;
+    long long v = strtoll(texto, &fin, 10);
+    if(fin == texto || *fin != '\0' || errno != 0 || v < 0 || v > maximo) return 0;
+    *valor = v;
+    return 1;
+}
+
+// "Recurso/Período=consumo" para cada token; devuelve cuántos o -1
+static long leerConsumos(const ModeloCapacidad *m, char **tokens, int n, ElementoConsumo *consumo,
+                         const char **error) {
+    for(int t = 0; t < n; t++) {
+        char *igual = strrchr(tokens[t], '=');
+        long long valor;
+        if(igual == NULL) {
+            *error = "se esperaba Recurso/Período=consumo";
+            return -1;
+        }
+        *igual = '\0';
+        int fila = buscarFila(m, tokens[t]);
+        if(fila < 0) {
+            *error = "recurso o período desconocido";
+            return -1;
+        }
+        if(!leerNumero(igual + 1, INT_MAX, &valor)) {
+            *error = "consumo inválido";
+            return -1;
+        }
+        consumo[t].fila = (uint32_t)fila;
+        consumo[t].valor = (int)valor;
+    }
+    return n;
+}
+
+static void responderProducto(const Catalogo *cat, size_t i, Salida *s) {
+    size_t k;
+    const ElementoConsumo *consumo = consumoProducto(cat, i, &k);
+    responder(s, "ok ");
+    responderNombre(s, nombreProducto(cat, i));
+    responder(s, " %d %d", cat->cantidades[i], cat->ganancias[i]);
+    for(size_t e = 0; e < k; e++) {
+        char fila[2 * MAX_NOMBRE];
+        nombreFila(&cat->modelo, (int)consumo[e].fila, fila, sizeof(fila));
+        responder(s, " %s=%d", fila, consumo[e].valor);
+    }
+    responder(s, "\n");
+}
+
+static void responderCalculo(const Catalogo *cat, Salida *s) {
+    const ModeloCapacidad *m = &cat->modelo;
+    responder(s, "ok %s productos=%zu excedidas=%zu", m->excedidas == 0 ? "viable" : "inviable",
+              cat->cantidad, m->excedidas);
+    for(int f = 0; f < filasModelo(m); f++) {
+        char fila[2 * MAX_NOMBRE];
+        nombreFila(m, f, fila, sizeof(fila));
+        responder(s, " %s=%lld/%lld", fila, (long long)demandaFila(m, f, NULL), (long long)m->limites[f]);
+    }
+    responder(s, "\n");
+}
+
+// Como "Calcular producción" (ver evaluarEscenario): el plan por prioridad
+// y branch and bound solo en catálogos chicos, así el candado de lectura no
+// queda tomado sin límite
+static void responderPlan(const Catalogo *cat, Salida *s) {
+    Escenario actual;
+    ResultadoEscenario r;
+    if(!crearEscenario(&actual, cat, "Actual")) {
+        responder(s, "error: sin memoria\n");
+        return;
+    }
+    int ok = evaluarEscenario(&actual, &r);
+    liberarEscenario(&actual);
+    if(ok) {
+        const char *estado = r.estado == PLAN_OPTIMO ? "optimo" : r.estado == PLAN_LIMITE_NODOS ? "limite" : "voraz";
+        responder(s, "ok %s unidades=%lld demanda=%lld ganancia=%lld\n", estado, r.producidas, r.demanda, r.ganancia);
+    } else {
+        responder(s, "error: sin memoria\n");
+    }
+}
+
+static void responderPrioridad(const Catalogo *cat, Salida *s) {
+    ResultadoPrioridad r;
+    Escenario actual;
+    long long demanda = 0, ganancia = 0;
+    double *plan = malloc((cat->cantidad + 1) * sizeof(double));
+    int ok = plan != NULL && crearEscenario(&actual, cat, "Actual");
+    if(ok) {
+        ok = planPorPrioridad(&actual, plan, &r);
+        liberarEscenario(&actual);
+    }
+    if(!ok) {
+        free(plan);
+        responder(s, "error: sin memoria\n");
+        return;
+    }
+    for(size_t i = 0; i < cat->cantidad; i++) {
+        demanda += cat->cantidades[i];
+        ganancia += (long long)plan[i] * cat->ganancias[i];
+    }
+    responder(s, "ok %s unidades=%lld demanda=%lld ganancia=%lld\n",
+              r.exacto ? "exacto" : "voraz", r.producidas, demanda, ganancia);
+    free(plan);
+}
+
+// Interpreta un alta, edición o baja como un cambio del catálogo (el que
+// se anota en el diario); se llama con el catálogo tomado para escritura
+static const char *leerCambio(Catalogo *cat, char **tokens, int n, ElementoConsumo *consumo, RegistroDiario *r) {
+    const char *error = NULL;
+    long long valor, ganancia;
+
+    memset(r, 0, sizeof(*r));
+    if(filasModelo(&cat->modelo) == 0) return "falta el modelo de capacidad";
+    if(strcmp(tokens[0], "agregar") == 0) {
+        if(n < 4) return "uso: agregar nombre cantidad ganancia [R/P=consumo ...]";
+        if(tokens[1][0] == '\0' || strlen(tokens[1]) >= MAX_NOMBRE) return "nombre inválido";
+        if(!leerNumero(tokens[2], INT_MAX, &valor) || !leerNumero(tokens[3], INT_MAX, &ganancia)) {
+            return "cantidad o ganancia inválida";
+        }
+        long k = leerConsumos(&cat->modelo, tokens + 4, n - 4, consumo, &error);
+        if(k < 0) return error;
+        *r = (RegistroDiario){ REGISTRO_AGREGAR, 0, tokens[1], valor, (int)ganancia, (size_t)k, consumo };
+        return NULL;
+    }
+    if(strcmp(tokens[0], "limite") == 0) {
+        if(n != 3) return "uso: limite Recurso/Período N";
+        int fila = buscarFila(&cat->modelo, tokens[1]);
+        if(fila < 0) return "recurso o período desconocido";
+        if(!leerNumero(tokens[2], INT64_MAX, &valor)) return "límite inválido";
+        r->tipo = REGISTRO_LIMITE;
+        r->indice = (size_t)fila;
+        r->valor = valor;
+        return NULL;
+    }
+
+    // editar y borrar buscan el producto como el menú
+    if(n < 2 || tokens[1][0] == '\0') return "falta el producto";
+    long indice = buscarEnCatalogo(cat, tokens[1]);
+    if(indice < 0) return "producto no encontrado";
+    r->indice = (size_t)indice;
+    if(strcmp(tokens[0], "borrar") == 0) {
+        if(n != 2) return "uso: borrar producto";
+        r->tipo = REGISTRO_QUITAR;
+    } else if(n >= 3 && strcmp(tokens[2], "consumo") == 0) {
+        long k = leerConsumos(&cat->modelo, tokens + 3, n - 3, consumo, &error);
+        if(k < 0) return error;
+        r->tipo = REGISTRO_CONSUMO;
+        r->k = (size_t)k;
+        r->consumo = consumo;
+    } else if(n != 4) {
+        return "uso: editar producto cantidad|ganancia|nombre|consumo valor";
+    } else if(strcmp(tokens[2], "nombre") == 0) {
+        if(tokens[3][0] == '\0' || strlen(tokens[3]) >= MAX_NOMBRE) return "nombre inválido";
+        r->tipo = REGISTRO_NOMBRE;
+        r->nombre = tokens[3];
+    } else if(strcmp(tokens[2], "cantidad") == 0 || strcmp(tokens[2], "ganancia") == 0) {
+        if(!leerNumero(tokens[3], INT_MAX, &valor)) return "valor inválido";
+        r->tipo = tokens[2][0] == 'c' ? REGISTRO_CANTIDAD : REGISTRO_GANANCIA;
+        r->valor = valor;
+    } else {
+        return "campo desconocido";
+    }
+    return NULL;
+}
+
+// Atiende una línea y deja la respuesta en 's'; devuelve 0 si el cliente
+// pidió salir
+static int atenderLinea(Servidor *srv, char *linea, Salida *s) {
+    char *tokens[MAX_TOKENS];
+    int n = partirLinea(linea, tokens);
+    if(n < 0) {
+        responder(s, "error: línea inválida\n");
+        return 1;
+    }
+    if(n == 0) return 1;
+
+    const char *orden = tokens[0];
+    if(strcmp(orden, "salir") == 0) {
+        responder(s, "ok\n");
+        return 0;
+    }
+    if(strcmp(orden, "buscar") == 0 || strcmp(orden, "calcular") == 0 || strcmp(orden, "plan") == 0 ||
+       strcmp(orden, "prioridad") == 0) {
+        pthread_rwlock_rdlock(&srv->candado);
+        if(orden[0] == 'c') {
+            responderCalculo(srv->cat, s);
+        } else if(strcmp(orden, "plan") == 0) {
+            responderPlan(srv->cat, s);
+        } else if(orden[0] == 'p') {
+            responderPrioridad(srv->cat, s);
+        } else {
+            long i = n == 2 ? buscarEnCatalogo(srv->cat, tokens[1]) : -1;
+            if(i >= 0) responderProducto(srv->cat, (size_t)i, s);
+            else responder(s, n == 2 ? "error: producto no encontrado\n" : "error: uso: buscar texto\n");
+        }
+        pthread_rwlock_unlock(&srv->candado);
+        return 1;
+    }
+    if(strcmp(orden, "agregar") == 0 || strcmp(orden, "editar") == 0 ||
+       strcmp(orden, "borrar") == 0 || strcmp(orden, "limite") == 0) {
+        ElementoConsumo consumo[MAX_TOKENS];
+        RegistroDiario r;
+        uint64_t posicion = 0;
+        size_t agregado = 0;
+        pthread_rwlock_wrlock(&srv->candado);
+        const char *error = leerCambio(srv->cat, tokens, n, consumo, &r);
+        if(error == NULL && !aplicarRegistro(srv->cat, &r)) error = "sin memoria";
+        if(error == NULL) agregado = srv->cat->cantidad - 1;
+        if(error == NULL && srv->diario) {
+            posicion = anotarRegistro(srv->diario, &r);
+            if(diarioGrande(srv->diario)) compactarDiario(srv->diario, srv->cat);
+        }
+        pthread_rwlock_unlock(&srv->candado);
+        // Se espera al disco fuera del candado: mientras tanto otros cambios
+        // se anotan y entran en la misma escritura
+        if(error == NULL && srv->diario && !confirmarDiario(srv->diario, posicion)) {
+            error = "no se pudo escribir el diario";
+        }
+        if(error) responder(s, "error: %s\n", error);
+        else if(r.tipo == REGISTRO_AGREGAR) responder(s, "ok %zu\n", agregado);
+        else responder(s, "ok\n");
+        return 1;
+    }
+    responder(s, "error: orden desconocida (agregar, editar, borrar, limite, buscar, calcular, plan, prioridad, salir)\n");
+    return 1;
+}
+
+// Los escritores tienen prioridad: con consultas sin pausa una edición no
+// esperaría nunca
+static int iniciarCandado(pthread_rwlock_t *candado) {
+    pthread_rwlockattr_t atributos;
+    pthread_rwlockattr_init(&atributos);
+    pthread_rwlockattr_setkind_np(&atributos, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    int ok = pthread_rwlock_init(candado, &atributos) == 0;
+    pthread_rwlockattr_destroy(&atributos);
+    return ok;
+}
+
+// Protocolo por la entrada estándar, una petición a la vez
+int servirEntrada(Catalogo *cat, Diario *diario, FILE *entrada, FILE *salida) {
+    Servidor srv;
+    Salida s = { NULL, 0, 0, 0, 0 };
+    char *linea = malloc(MAX_LINEA);
+    memset(&srv, 0, sizeof(srv));
+    srv.cat = cat;
+    srv.diario = diario;
+    if(linea == NULL || !iniciarCandado(&srv.candado)) {
+        free(linea);
+        return 0;
+    }
+    int seguir = 1;
+    while(seguir && fgets(linea, MAX_LINEA, entrada)) {
+        size_t largo = strlen(linea);
+        if(largo == MAX_LINEA - 1 && linea[largo - 1] != '\n') {
+            responder(&s, "error: línea demasiado larga\n");
+            seguir = 0;
+        } else {
+            linea[strcspn(linea, "\r\n")] = '\0';
+            seguir = atenderLinea(&srv, linea, &s);
+        }
+        if(s.sinMemoria) break;
+        fwrite(s.datos, 1, s.usado, salida);
+        fflush(salida);
+        s.usado = 0;
+    }
+    pthread_rwlock_destroy(&srv.candado);
+    free(s.datos);
+    free(linea);
+    return !s.sinMemoria;
+}
+
+static size_t pendiente(const Cliente *c) {
+    return c->salida.usado - c->salida.enviado;
+}
+
+// Envía lo que el socket acepte; 0 si la conexión se cayó
+static int enviarSalida(Cliente *c) {
+    Salida *s = &c->salida;
+    while(s->enviado < s->usado) {
+        ssize_t n = send(c->fd, s->datos + s->enviado, s->usado - s->enviado, MSG_NOSIGNAL);
+        if(n > 0) {
+            s->enviado += (size_t)n;
+        } else if(n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    s->usado = s->enviado = 0;
+    return 1;
+}
+
+// Atiende las líneas completas que ya llegaron, hasta que se acumule
+// demasiada respuesta sin enviar
+static void procesarLineas(Servidor *srv, Cliente *c) {
+    size_t inicio = 0;
+    while(!c->cerrando && pendiente(c) < MAX_PENDIENTE) {
+        char *fin = memchr(c->entrada + inicio, '\n', c->usadoEntrada - inicio);
+        if(fin == NULL) break;
+        *fin = '\0';
+        if(fin > c->entrada + inicio && fin[-1] == '\r') fin[-1] = '\0';
+        if(!atenderLinea(srv, c->entrada + inicio, &c->salida)) c->cerrando = 1;
+        inicio = (size_t)(fin - c->entrada) + 1;
+    }
+    if(c->salida.sinMemoria) c->cerrando = 1;
+    c->usadoEntrada -= inicio;
+    memmove(c->entrada, c->entrada + inicio, c->usadoEntrada);
+    if(!c->cerrando && c->usadoEntrada == MAX_LINEA) {
+        responder(&c->salida, "error: línea demasiado larga\n");
+        c->cerrando = 1;
+    }
+}
+
+static void cerrarCliente(Servidor *srv, Cliente *c) {
+    pthread_mutex_lock(&srv->mutexClientes);
+    if(c->anterior) c->anterior->siguiente = c->siguiente;
+    else srv->clientes = c->siguiente;
+    if(c->siguiente) c->siguiente->anterior = c->anterior;
+    pthread_mutex_unlock(&srv->mutexClientes);
+    close(c->fd);
+    free(c->salida.datos);
+    free(c);
+}
+
+// Con EPOLLONESHOT un cliente lo atiende un solo hilo a la vez, así su
+// estado no necesita candado; al terminar se vuelve a armar
+static void atenderCliente(Servidor *srv, Cliente *c, uint32_t eventos) {
+    int ok = !(eventos & EPOLLERR) && enviarSalida(c);
+    while(ok) {
+        procesarLineas(srv, c);
+        if(pendiente(c) >= MAX_PENDIENTE) {
+            // Si el socket se lleva todo se sigue con las líneas que ya
+            // llegaron; si no, se espera a poder escribir
+            ok = enviarSalida(c);
+            if(ok && pendiente(c) == 0) continue;
+            break;
+        }
+        if(c->cerrando) break;
+        ssize_t n = recv(c->fd, c->entrada + c->usadoEntrada, MAX_LINEA - c->usadoEntrada, 0);
+        if(n > 0) {
+            c->usadoEntrada += (size_t)n;
+        } else if(n == 0) {
+            c->cerrando = 1;
+        } else if(errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if(errno != EINTR) {
+            ok = 0;
+        }
+    }
+    if(ok) ok = enviarSalida(c);
+    if(!ok || (c->cerrando && pendiente(c) == 0)) {
+        cerrarCliente(srv, c);
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = (pendiente(c) ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+    ev.data.ptr = c;
+    if(epoll_ctl(srv->epoll, EPOLL_CTL_MOD, c->fd, &ev) < 0) cerrarCliente(srv, c);
+}
+
+static void aceptarClientes(Servidor *srv) {
+    for(;;) {
+        int fd = accept4(srv->escucha, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0) {
+            if(errno == EINTR || errno == ECONNABORTED) continue;
+            break;              // EAGAIN, o sin descriptores: se reintenta con el próximo evento
+        }
+        Cliente *c = calloc(1, sizeof(Cliente));
+        if(c == NULL) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        pthread_mutex_lock(&srv->mutexClientes);
+        c->siguiente = srv->clientes;
+        if(srv->clientes) srv->clientes->anterior = c;
+        srv->clientes = c;
+        pthread_mutex_unlock(&srv->mutexClientes);
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLONESHOT;
+        ev.data.ptr = c;
+        if(epoll_ctl(srv->epoll, EPOLL_CTL_ADD, fd, &ev) < 0) cerrarCliente(srv, c);
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = &srv->escucha;
+    epoll_ctl(srv->epoll, EPOLL_CTL_MOD, srv->escucha, &ev);
+}
+
+// Todos los hilos esperan en el mismo epoll y toman un evento por vez, así
+// una consulta lenta (plan) no retiene los eventos de otros clientes
+static void *atenderEventos(void *arg) {
+    Servidor *srv = arg;
+    while(!__atomic_load_n(&srv->terminar, __ATOMIC_RELAXED)) {
+        struct epoll_event ev;
+        int n = epoll_wait(srv->epoll, &ev, 1, -1);
+        if(n < 0 && errno != EINTR) break;
+        if(n <= 0) continue;
+        if(ev.data.ptr == &srv->senales) __atomic_store_n(&srv->terminar, 1, __ATOMIC_RELAXED);
+        else if(ev.data.ptr == &srv->escucha) aceptarClientes(srv);
+        else atenderCliente(srv, ev.data.ptr, ev.events);
+    }
+    return NULL;
+}
+
+// Escucha en un socket Unix hasta recibir SIGINT o SIGTERM (hilos 0 = uno
+// por núcleo, al menos 4 para que un plan largo no frene las consultas)
+int servirSocket(Catalogo *cat, Diario *diario, const char *ruta, int hilos) {
+    Servidor srv;
+    struct sockaddr_un dir;
+    sigset_t senales, anteriores;
+    pthread_t ids[MAX_HILOS_SERVIDOR];
+    int lanzados = 0;
+
+    memset(&srv, 0, sizeof(srv));
+    memset(&dir, 0, sizeof(dir));
+    if(strlen(ruta) >= sizeof(dir.sun_path)) return 0;
+    dir.sun_family = AF_UNIX;
+    strcpy(dir.sun_path, ruta);
+    if(hilos <= 0) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = nucleos > 4 ? (int)nucleos : 4;
+    }
+    if(hilos > MAX_HILOS_SERVIDOR) hilos = MAX_HILOS_SERVIDOR;
+
+    srv.cat = cat;
+    srv.diario = diario;
+    srv.escucha = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(srv.escucha < 0) return 0;
+    int enlazado = bind(srv.escucha, (struct sockaddr *)&dir, sizeof(dir)) == 0;
+    if(!enlazado && errno == EADDRINUSE) {
+        // Un socket que nadie atiende quedó de una ejecución anterior
+        int prueba = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int activo = prueba >= 0 && connect(prueba, (struct sockaddr *)&dir, sizeof(dir)) == 0;
+        if(prueba >= 0) close(prueba);
+        if(!activo && unlink(ruta) == 0) enlazado = bind(srv.escucha, (struct sockaddr *)&dir, sizeof(dir)) == 0;
+    }
+    if(!enlazado || listen(srv.escucha, SOMAXCONN) < 0) {
+        close(srv.escucha);
+        return 0;
+    }
+
+    // Las señales de fin llegan por un descriptor que despierta a todos los hilos
+    sigemptyset(&senales);
+    sigaddset(&senales, SIGINT);
+    sigaddset(&senales, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &senales, &anteriores);
+    srv.senales = signalfd(-1, &senales, SFD_NONBLOCK | SFD_CLOEXEC);
+    srv.epoll = epoll_create1(EPOLL_CLOEXEC);
+    int ok = srv.senales >= 0 && srv.epoll >= 0 && iniciarCandado(&srv.candado);
+    if(ok) {
+        struct epoll_event ev;
+        pthread_mutex_init(&srv.mutexClientes, NULL);
+        ev.events = EPOLLIN;
+        ev.data.ptr = &srv.senales;
+        ok = epoll_ctl(srv.epoll, EPOLL_CTL_ADD, srv.senales, &ev) == 0;
+        ev.events = EPOLLIN | EPOLLONESHOT;
+        ev.data.ptr = &srv.escucha;
+        ok = ok && epoll_ctl(srv.epoll, EPOLL_CTL_ADD, srv.escucha, &ev) == 0;
+        if(ok) {
+            printf("Servidor escuchando en %s (%d hilos)\n", ruta, hilos);
+            fflush(stdout);
+            for(int h = 1; h < hilos; h++) {
+                if(pthread_create(&ids[lanzados], NULL, atenderEventos, &srv) == 0) lanzados++;
+            }
+            atenderEventos(&srv);
+            for(int h = 0; h < lanzados; h++) pthread_join(ids[h], NULL);
+
+            // La señal queda pendiente hasta leerla; si no, llegaría al
+            // restaurar la máscara y terminaría el programa
+            struct signalfd_siginfo info;
+            while(read(srv.senales, &info, sizeof(info)) == sizeof(info));
+        }
+        while(srv.clientes) cerrarCliente(&srv, srv.clientes);
+        pthread_mutex_destroy(&srv.mutexClientes);
+        pthread_rwlock_destroy(&srv.candado);
+    }
+    if(srv.epoll >= 0) close(srv.epoll);
+    if(srv.senales >= 0) close(srv.senales);
+    close(srv.escucha);
+    unlink(ruta);
+    pthread_sigmask(SIG_SETMASK, &anteriores, NULL);
+    return ok;
+}
+
+// Generador de carga: cada cliente manda una petición y espera la
+// respuesta antes de la siguiente (lazo cerrado), y anota cuánto tardó
+typedef struct {
+    const char *ruta;
+    int numero;
+    long peticiones;
+    int escrituras;             // porcentaje de ediciones
+    double *latencias;          // segundos, una por petición
+    long errores;
+    int ok;
+} ClienteCarga;
+
+static double segundosEntre(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) + (b->tv_nsec - a->tv_nsec) / 1e9;
+}
+
+// Manda una línea y lee la respuesta (una línea, de la que se guarda el
+// principio); 0 si la conexión se cayó
+static int pedir(int fd, const char *peticion, char *respuesta, size_t tam) {
+    char resto[4096];
+    size_t largo = strlen(peticion), enviado = 0;
+    while(enviado < largo) {
+        ssize_t n = send(fd, peticion + enviado, largo - enviado, MSG_NOSIGNAL);
+        if(n <= 0) return 0;
+        enviado += (size_t)n;
+    }
+    size_t usado = 0;
+    for(;;) {
+        int lleno = usado == tam - 1;
+        ssize_t n = recv(fd, lleno ? resto : respuesta + usado, lleno ? sizeof(resto) : tam - 1 - usado, 0);
+        if(n <= 0) return 0;
+        if(!lleno) usado += (size_t)n;
+        if((lleno ? resto : respuesta + usado - n)[n - 1] == '\n') break;
+    }
+    respuesta[usado] = '\0';
+    return 1;
+}
+
+static void *enviarCarga(void *arg) {
+    ClienteCarga *c = arg;
+    struct sockaddr_un dir;
+    char peticion[128], respuesta[4096];
+    unsigned semilla = (unsigned)c->numero * 2654435761u + 1;
+
+    memset(&dir, 0, sizeof(dir));
+    dir.sun_family = AF_UNIX;
+    snprintf(dir.sun_path, sizeof(dir.sun_path), "%s", c->ruta);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0 || connect(fd, (struct sockaddr *)&dir, sizeof(dir)) < 0) {
+        if(fd >= 0) close(fd);
+        return NULL;
+    }
+
+    // Cada cliente edita su propio producto, sin consumo para no cambiar
+    // la viabilidad del catálogo que se está midiendo
+    snprintf(peticion, sizeof(peticion), "agregar carga-%d 0 0\n", c->numero);
+    c->ok = pedir(fd, peticion, respuesta, sizeof(respuesta));
+    for(long i = 0; c->ok && i < c->peticiones; i++) {
+        int r = rand_r(&semilla) % 100;
+        if(r < c->escrituras) {
+            snprintf(peticion, sizeof(peticion), "editar carga-%d cantidad %d\n", c->numero, rand_r(&semilla) % 1000);
+        } else if(r % 2) {
+            snprintf(peticion, sizeof(peticion), "calcular\n");
+        } else {
+            snprintf(peticion, sizeof(peticion), "buscar carga-%d\n", c->numero);
+        }
+        struct timespec antes, despues;
+        clock_gettime(CLOCK_MONOTONIC, &antes);
+        c->ok = pedir(fd, peticion, respuesta, sizeof(respuesta));
+        clock_gettime(CLOCK_MONOTONIC, &despues);
+        c->latencias[i] = segundosEntre(&antes, &despues);
+        if(c->ok && strncmp(respuesta, "ok", 2) != 0) c->errores++;
+    }
+    snprintf(peticion, sizeof(peticion), "borrar carga-%d\n", c->numero);
+    if(c->ok) pedir(fd, peticion, respuesta, sizeof(respuesta));
+    close(fd);
+    return NULL;
+}
+
+static int porLatencia(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int generarCarga(const char *ruta, int clientes, long peticiones, int escrituras) {
+    ClienteCarga *c = calloc((size_t)clientes, sizeof(ClienteCarga));
+    pthread_t *ids = malloc((size_t)clientes * sizeof(pthread_t));
+    double *latencias = malloc((size_t)clientes * (size_t)peticiones * sizeof(double));
+    struct timespec inicio, fin;
+    int lanzados = 0;
+    if(c == NULL || ids == NULL || latencias == NULL) {
+        printf("Error: No hay memoria para la carga\n");
+        free(c);
+        free(ids);
+        free(latencias);
+        return 1;
+    }
+
+    printf("%d clientes x %ld peticiones contra %s (%d%% ediciones)\n", clientes, peticiones, ruta, escrituras);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for(int i = 0; i < clientes; i++) {
+        c[i].ruta = ruta;
+        c[i].numero = i;
+        c[i].peticiones = peticiones;
+        c[i].escrituras = escrituras;
+        c[i].latencias = latencias + (size_t)i * (size_t)peticiones;
+        if(pthread_create(&ids[i], NULL, enviarCarga, &c[i]) != 0) break;
+        lanzados++;
+    }
+    for(int i = 0; i < lanzados; i++) pthread_join(ids[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    // Solo cuentan los clientes que terminaron todas sus peticiones
+    size_t total = 0;
+    long errores = 0;
+    int caidos = clientes - lanzados;
+    for(int i = 0; i < lanzados; i++) {
+        if(!c[i].ok) {
+            caidos++;
+            continue;
+        }
+        memmove(latencias + total, c[i].latencias, (size_t)peticiones * sizeof(double));
+        total += (size_t)peticiones;
+        errores += c[i].errores;
+    }
+    double segundos = segundosEntre(&inicio, &fin);
+    if(caidos) printf("Clientes que no pudieron conectarse o perdieron la conexión: %d\n", caidos);
+    if(total > 0) {
+        qsort(latencias, total, sizeof(double), porLatencia);
+        printf("Peticiones: %zu en %.3f s (%.0f por segundo), con error: %ld\n", total, segundos, total / segundos, errores);
+        printf("Latencia: p50 %.1f us, p99 %.1f us, máxima %.1f us\n", latencias[total / 2] * 1e6,
+               latencias[(size_t)(total * 0.99)] * 1e6, latencias[total - 1] * 1e6);
+    }
+    free(c);
+    free(ids);
+    free(latencias);
+    return total > 0 && caidos == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+#define _GNU_SOURCE            // MAP_NORESERVE
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "monitor.h"
+
+// Espacio de direcciones que se reserva al abrir el almacén para que crezca
+// sin moverse; sin permisos no ocupa memoria ni disco
+#define RESERVA_ALMACEN ((size_t)1 << 40)
+
+// Función para dejar una zona vacía, sin lecturas ni serie
+void iniciar_zona(Zona *zona, const char *nombre, size_t largo) {
+    memset(zona, 0, offsetof(Zona, serie));
+    if(largo >= MAX_NOMBRE_ZONA) largo = MAX_NOMBRE_ZONA - 1;
+    memcpy(zona->nombre, nombre, largo);
+    zona->nombre[largo] = '\0';
+    iniciar_serie(&zona->serie);
+}
+
+static uint32_t hash_nombre(const char *nombre, size_t largo) {
+    uint32_t h = 2166136261u;   // FNV-1a
+    for(size_t i = 0; i < largo; i++) {
+        h ^= (unsigned char)nombre[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Ranura del nombre, o la libre donde iría
+static size_t ranura_zona(const RegistroZonas *reg, const char *nombre, size_t largo) {
+    size_t r = hash_nombre(nombre, largo) & reg->mascara;
+    while(reg->tabla[r] != 0) {
+        const char *otro = reg->zonas[reg->tabla[r] - 1].nombre;
+        if(strncmp(otro, nombre, largo) == 0 && otro[largo] == '\0') break;
+        r = (r + 1) & reg->mascara;
+    }
+    return r;
+}
+
+static int cabecera_valida(const CabeceraAlmacen *c, size_t tam) {
+    return memcmp(c->magia, MAGIA_ALMACEN, 4) == 0 && c->version == VERSION_ALMACEN &&
+           c->tam_zona == sizeof(Zona) && c->num_zonas <= c->capacidad &&
+           tam == sizeof(CabeceraAlmacen) + (size_t)c->capacidad * sizeof(Zona);
+}
+
+// Tabla hash con el doble de ranuras que la capacidad, armada con las zonas
+// que ya hay
+static int armar_tabla(RegistroZonas *reg) {
+    size_t ranuras = 16;
+    while(ranuras < 2 * (size_t)reg->capacidad) ranuras *= 2;
+    int *tabla = calloc(ranuras, sizeof(int));
+    if(tabla == NULL) return 0;
+    free(reg->tabla);
+    reg->tabla = tabla;
+    reg->mascara = ranuras - 1;
+    for(int i = 0; i < reg->num_zonas; i++) {
+        reg->tabla[ranura_zona(reg, reg->zonas[i].nombre, strlen(reg->zonas[i].nombre))] = i + 1;
+    }
+    return 1;
+}
+
+// Reserva las direcciones para el almacén (al menos 'tam' bytes); si el
+// límite de memoria virtual no deja reservar tanto se prueba con menos
+static void *reservar_direcciones(size_t tam, size_t *reserva) {
+    for(size_t r = RESERVA_ALMACEN; ; r /= 2) {
+        if(r < tam) r = tam;
+        void *base = mmap(NULL, r, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if(base != MAP_FAILED) {
+            *reserva = r;
+            return base;
+        }
+        if(r == tam) return MAP_FAILED;
+    }
+}
+
+// Función para abrir el almacén de zonas: con ruta se mapea el archivo (y se
+// crea con 'capacidad' zonas si no existe); sin ruta queda en memoria. El
+// archivo nuevo es disperso: solo ocupa disco lo que se escribió. El mapa
+// empieza al principio de una reserva de direcciones donde después crece.
+int abrir_registro(RegistroZonas *reg, const char *ruta, int capacidad) {
+    memset(reg, 0, sizeof(*reg));
+    reg->fd = -1;
+    if(capacidad < 1) capacidad = 1;
+    size_t tam = sizeof(CabeceraAlmacen) + (size_t)capacidad * sizeof(Zona);
+    int fd = -1, nuevo = 1;
+    if(ruta != NULL) {
+        struct stat st;
+        fd = open(ruta, O_RDWR | O_CREAT, 0644);
+        if(fd < 0 || fstat(fd, &st) != 0) {
+            if(fd >= 0) close(fd);
+            return 0;
+        }
+        nuevo = st.st_size == 0;
+        if(nuevo ? ftruncate(fd, (off_t)tam) != 0 : st.st_size < (off_t)sizeof(CabeceraAlmacen)) {
+            close(fd);
+            return 0;
+        }
+        if(!nuevo) tam = (size_t)st.st_size;
+    }
+
+    size_t reserva;
+    void *base = reservar_direcciones(tam, &reserva);
+    void *mapa = base;
+    if(base != MAP_FAILED && fd >= 0) {
+        mapa = mmap(base, tam, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    } else if(base != MAP_FAILED && mprotect(base, tam, PROT_READ | PROT_WRITE) != 0) {
+        mapa = MAP_FAILED;
+    }
+    if(mapa == MAP_FAILED) {
+        if(base != MAP_FAILED) munmap(base, reserva);
+        if(fd >= 0) close(fd);
+        return 0;
+    }
+
+    CabeceraAlmacen *c = mapa;
+    if(nuevo) {
+        memset(c, 0, sizeof(*c));
+        c->version = VERSION_ALMACEN;
+        c->tam_zona = sizeof(Zona);
+        c->capacidad = (uint32_t)capacidad;
+        memcpy(c->magia, MAGIA_ALMACEN, 4);
+    } else if(!cabecera_valida(c, tam)) {
+        munmap(mapa, reserva);
+        close(fd);
+        return 0;
+    }
+    reg->almacen = c;
+    reg->tam_mapa = tam;
+    reg->tam_reserva = reserva;
+    reg->fd = fd;
+    reg->zonas = (Zona *)(c + 1);
+    reg->capacidad = (int)c->capacidad;
+    reg->num_zonas = (int)c->num_zonas;
+    if(!armar_tabla(reg)) {
+        cerrar_registro(reg);
+        return 0;
+    }
+    return 1;
+}
+
+// Función para duplicar la capacidad: agranda el archivo (si hay) y el mapa
+// dentro de la reserva, sin moverlo, así quien lee zonas sin candado desde
+// otro hilo no pierde las direcciones. Si algo falla el registro queda como
+// estaba (la cabecera se escribe al final).
+static int crecer_registro(RegistroZonas *reg) {
+    if(reg->capacidad > INT32_MAX / 2) return 0;
+    int anterior = reg->capacidad, capacidad = anterior * 2;
+    size_t tam = sizeof(CabeceraAlmacen) + (size_t)capacidad * sizeof(Zona);
+    if(tam > reg->tam_reserva) return 0;
+
+    // La tabla primero: solo lee las zonas que ya hay, y si después falla el
+    // mapa una tabla más grande sirve igual para la capacidad vieja
+    reg->capacidad = capacidad;
+    int ok = armar_tabla(reg);
+    reg->capacidad = anterior;
+    if(!ok) return 0;
+
+    // Se mapea desde la primera página que todavía no lo está; mapear más
+    // allá del fin del archivo vale mientras no se toque antes de agrandarlo
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    size_t mapeado = (reg->tam_mapa + pagina - 1) / pagina * pagina;
+    char *desde = (char *)reg->almacen + mapeado;
+    if(mapeado < tam && reg->fd >= 0) {
+        if(mmap(desde, tam - mapeado, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, reg->fd, (off_t)mapeado) == MAP_FAILED) return 0;
+    } else if(mapeado < tam && mprotect(desde, tam - mapeado, PROT_READ | PROT_WRITE) != 0) {
+        return 0;
+    }
+    if(reg->fd >= 0 && ftruncate(reg->fd, (off_t)tam) != 0) return 0;
+
+    reg->tam_mapa = tam;
+    reg->capacidad = capacidad;
+    reg->almacen->capacidad = (uint32_t)capacidad;
+    return 1;
+}
+
+// Función para cerrar el almacén; con archivo, espera a que quede en disco
+void cerrar_registro(RegistroZonas *reg) {
+    if(reg->almacen != NULL) {
+        msync(reg->almacen, reg->tam_mapa, MS_SYNC);
+        munmap(reg->almacen, reg->tam_reserva);
+    }
+    if(reg->fd >= 0) close(reg->fd);
+    free(reg->tabla);
+    memset(reg, 0, sizeof(*reg));
+    reg->fd = -1;
+}
+
+// Índice de la zona con ese nombre (no necesita terminar en '\0'), o -1
+int buscar_zona(const RegistroZonas *reg, const char *nombre, size_t largo) {
+    if(largo >= MAX_NOMBRE_ZONA) return -1;
+    return reg->tabla[ranura_zona(reg, nombre, largo)] - 1;
+}
+
+// Índice de la zona, creándola si no existe; -1 si el registro no pudo
+// crecer o el nombre es demasiado largo
+int registrar_zona(RegistroZonas *reg, const char *nombre, size_t largo) {
+    if(largo >= MAX_NOMBRE_ZONA) return -1;
+    size_t r = ranura_zona(reg, nombre, largo);
+    if(reg->tabla[r] != 0) return reg->tabla[r] - 1;
+    if(reg->num_zonas == reg->capacidad) {
+        if(!crecer_registro(reg)) return -1;
+        r = ranura_zona(reg, nombre, largo);
+    }
+    iniciar_zona(&reg->zonas[reg->num_zonas], nombre, largo);
+    reg->tabla[r] = ++reg->num_zonas;
+    reg->almacen->num_zonas = (uint32_t)reg->num_zonas;
+    return reg->num_zonas - 1;
+}